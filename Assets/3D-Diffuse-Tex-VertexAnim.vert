@@ -0,0 +1,53 @@
+#version 150
+
+in vec3 vPos;
+in vec3 vNormal;
+in vec2 vUV1;
+
+out vec4 fColor;
+out vec2 fUV1;
+
+// Built-in uniforms
+uniform mat4 gViewMatrix;
+uniform mat4 gProjMatrix;
+uniform mat4 gWorldToProjMatrix;
+uniform mat4 gObjectToWorldMatrix;
+
+// User-defined uniforms
+uniform vec4 uColor = vec4(1.0f, 1.0f, 1.0f, 1.0f);
+
+// Vertex animation uniforms
+// Positions holds x/y/z of every vertex of every keyframe, one float per texel.
+// From/To are offsets of the two keyframes to blend between, and Blend is how far to blend.
+uniform samplerBuffer uVertexAnimPositions;
+uniform int uVertexAnimFrom;
+uniform int uVertexAnimTo;
+uniform float uVertexAnimBlend;
+uniform int uVertexAnimVertexCount;
+
+vec3 GetKeyframePosition(int keyframeOffset)
+{
+    int offset = keyframeOffset + gl_VertexID * 3;
+    return vec3(texelFetch(uVertexAnimPositions, offset).r,
+                texelFetch(uVertexAnimPositions, offset + 1).r,
+                texelFetch(uVertexAnimPositions, offset + 2).r);
+}
+
+void main()
+{
+    // Pass through color attribute.
+	fColor = uColor;
+    
+    // Pass through the UV attribute.
+    fUV1 = vUV1;
+    
+    // Blend between keyframe positions. Vertices the animation doesn't have keep their mesh position.
+    vec3 pos = vPos;
+    if(gl_VertexID < uVertexAnimVertexCount)
+    {
+        pos = mix(GetKeyframePosition(uVertexAnimFrom), GetKeyframePosition(uVertexAnimTo), uVertexAnimBlend);
+    }
+    
+    // Transform position obj->world->view->proj
+    gl_Position = gWorldToProjMatrix * gObjectToWorldMatrix * vec4(pos, 1.0f);
+}
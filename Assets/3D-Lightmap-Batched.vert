@@ -0,0 +1,25 @@
+#version 150
+
+in vec3 vPos;
+in vec2 vUV1;
+in vec2 vUV2;
+
+out vec2 fUV1;
+out vec2 fUV2;
+
+// Built-in uniforms
+uniform mat4 gViewMatrix;
+uniform mat4 gProjMatrix;
+uniform mat4 gWorldToProjMatrix;
+uniform mat4 gObjectToWorldMatrix;
+
+void main()
+{
+    // Pass through the UV attributes.
+    // Light map UVs already have per-surface offset/scale applied, so many surfaces can be drawn at once.
+    fUV1 = vUV1;
+    fUV2 = vUV2;
+    
+    // Transform position obj->world->view->proj
+    gl_Position = gWorldToProjMatrix * gObjectToWorldMatrix * vec4(vPos, 1.0f);
+}
@@ -12,8 +12,10 @@
 #include "GameProgress.h"
 #include "GKActor.h"
 #include "IniParser.h"
+#include "LocationManager.h"
 #include "Scene.h"
 #include "Services.h"
+#include "SheepScript.h"
 #include "StringUtil.h"
 #include "Timeblock.h"
 
@@ -94,6 +96,7 @@ void ActionManager::ClearActionSets()
 {
 	mActionSets.clear();
 	mCaseLogic.clear();
+	mCaseLogicCache.Clear();
 	mNounToEnum.clear();
 	mNouns.clear();
 	mVerbToEnum.clear();
@@ -483,7 +486,7 @@ bool ActionManager::IsCaseMet(const Action* action, VerbType verbType) const
 		int v = mVerbToEnum.at(action->verb);
 		
 		// Evaluate our condition logic with our n$ and v$ values.
-		return Services::GetSheep()->Evaluate(it->second, n, v);
+		return EvaluateCaseLogic(it->second, n, v);
 	}
 	
 	// Check global case conditions.
@@ -614,3 +617,10 @@ void ActionManager::OnActionExecuteFinished()
 	mLastAction = mCurrentAction;
 	mCurrentAction = nullptr;
 }
+
+bool ActionManager::EvaluateCaseLogic(SheepScript* script, int n, int v) const
+{
+	return mCaseLogicCache.Evaluate(script, n, v,
+									Services::Get<GameProgress>()->GetChangeCount(),
+									Services::Get<LocationManager>()->GetChangeCount());
+}
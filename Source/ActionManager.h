@@ -11,6 +11,7 @@
 #include <unordered_map>
 #include <vector>
 
+#include "CaseLogicCache.h"
 #include "NVC.h"
 #include "Type.h"
 
@@ -104,6 +105,9 @@ private:
 	// Cases must be stored here (rather than in Action Sets) because cases can be shared (especially global/inventory ones).
     std::unordered_map<std::string, SheepScript*> mCaseLogic;
 	
+	// Case logic is evaluated a lot, so results are cached until game progress or location changes.
+	mutable CaseLogicCache mCaseLogicCache;
+	
 	// Nouns and verbs that are currently active. Pulled out of action sets as they are loaded.
 	// We do this to support the Sheep-eval feature of specifying n$ and v$ variables as wildcards for current noun/verb.
 	// To use these, we must map each active noun/verb to an integer and back again.
@@ -137,6 +141,7 @@ private:
 	// Returns true if the case for an action is met.
 	// A case can be a global condition, or some user-defined script to evaluate.
 	bool IsCaseMet(const Action* item, VerbType verbType = VerbType::Normal) const;
+	bool EvaluateCaseLogic(SheepScript* script, int n, int v) const;
 	
 	// Called when action bar is canceled (press cancel button).
 	void OnActionBarCanceled();
@@ -12,7 +12,11 @@
 
 Actor::Actor()
 {
-    GEngine::Instance()->AddActor(this);
+	// There's no engine when actors are created by unit tests.
+	if(GEngine::Instance() != nullptr)
+	{
+		GEngine::Instance()->AddActor(this);
+	}
 	
 	// Add transform component.
 	mTransform = AddComponent<Transform>();
@@ -20,7 +24,10 @@ Actor::Actor()
 
 Actor::Actor(TransformType transformType)
 {
-	GEngine::Instance()->AddActor(this);
+	if(GEngine::Instance() != nullptr)
+	{
+		GEngine::Instance()->AddActor(this);
+	}
 	
 	// Add transform component.
 	if(transformType == TransformType::Transform)
@@ -38,11 +45,13 @@ Actor::~Actor()
 	//NOTE: GEngine class handles calling "delete". Others should call Destroy if needed.
 	
     // Delete all components and clear list.
-    for(auto& component : mComponents)
+    for(size_t i = 0; i < mComponents.size(); ++i)
     {
-        delete component;
+        mComponentDestroyers[i](mComponents[i]);
     }
     mComponents.clear();
+	mComponentDestroyers.clear();
+	mComponentsByType.clear();
 }
 
 void Actor::Update(float deltaTime)
@@ -6,6 +6,7 @@
 // Any object that exists in the game world and has position/rotation/scale.
 //
 #pragma once
+#include <unordered_map>
 #include <vector>
 
 #include "Vector3.h"
@@ -13,6 +14,7 @@
 #include "Matrix4.h"
 
 #include "Component.h"
+#include "ComponentPool.h"
 #include "InputManager.h"
 #include "Transform.h"
 #include "Services.h"
@@ -95,25 +97,60 @@ private:
     // The components that are attached to this actor.
     std::vector<Component*> mComponents;
 	
+	// Components live in per-type pools (see ComponentPool), so each component needs the matching function to destroy it.
+	// Parallel to the components list.
+	std::vector<void (*)(Component*)> mComponentDestroyers;
+	
+	// Results of GetComponent, keyed by the requested type. A null entry means no component of that type was found.
+	// Components are almost always added when an actor is created and then looked up many times, so this avoids repeated scans.
+	std::unordered_map<Type, Component*> mComponentsByType;
+	
+	template<class T> static void DestroyComponent(Component* component);
+	
 	void AddChild(Actor* child);
 	void RemoveChild(Actor* child);
 };
 
 template<class T> T* Actor::AddComponent()
 {
-    T* component = new T(this);
+    T* component = ComponentPool<T>::Create(this);
     mComponents.push_back(component);
+	mComponentDestroyers.push_back(&Actor::DestroyComponent<T>);
+	
+	// Any earlier lookup that found nothing may match the new component.
+	for(auto& entry : mComponentsByType)
+	{
+		if(entry.second == nullptr && component->IsTypeOf(entry.first))
+		{
+			entry.second = component;
+		}
+	}
     return component;
 }
 
 template<class T> T* Actor::GetComponent()
 {
+	auto it = mComponentsByType.find(T::GetType());
+	if(it != mComponentsByType.end())
+	{
+		return static_cast<T*>(it->second);
+	}
+	
+	// Not looked up before, so find it. Subclasses count (e.g. a RectTransform is a Transform).
+	Component* found = nullptr;
     for(auto& component : mComponents)
     {
         if(component->IsTypeOf(T::GetType()))
         {
-            return static_cast<T*>(component);
+            found = component;
+            break;
         }
     }
-    return nullptr;
+	mComponentsByType[T::GetType()] = found;
+    return static_cast<T*>(found);
+}
+
+template<class T> void Actor::DestroyComponent(Component* component)
+{
+	ComponentPool<T>::Destroy(static_cast<T*>(component));
 }
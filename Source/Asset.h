@@ -17,7 +17,15 @@ public:
     
     std::string GetName() { return mName; }
     std::string GetNameNoExtension();
+	
+	// Assets with references are never unloaded by the asset manager.
+	void AddRef() { ++mRefCount; }
+	void Release() { --mRefCount; }
+	int GetRefCount() const { return mRefCount; }
     
 protected:
     std::string mName;
+	
+private:
+	int mRefCount = 0;
 };
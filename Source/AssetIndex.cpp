@@ -0,0 +1,145 @@
+//
+// AssetIndex.cpp
+//
+// Clark Kromenaker
+//
+#include "AssetIndex.h"
+
+#include "BarnFile.h"
+#include "FileSystem.h"
+#include "StringUtil.h"
+
+bool AssetIndex::AddSearchPath(const std::string& searchPath)
+{
+	// Find the search path's directory and get all files in it.
+	std::string directoryPath;
+	std::vector<std::string> fileNames;
+	if(!Path::FindFullDirectoryPath(searchPath, directoryPath) || !Directory::GetFiles(directoryPath, fileNames))
+	{
+		return false;
+	}
+
+	// Make sure we can just append file names to the directory path.
+	if(!directoryPath.empty() && directoryPath.back() != '/' && directoryPath.back() != Path::kSeparator)
+	{
+		directoryPath += Path::kSeparator;
+	}
+
+	for(auto& fileName : fileNames)
+	{
+		// Search paths are added in priority order, so don't replace a file from an earlier search path.
+		AssetLocation& location = mLocations[StringUtil::ToUpperCopy(fileName)];
+		if(location.filePath.empty())
+		{
+			location.filePath = directoryPath + fileName;
+		}
+	}
+	return true;
+}
+
+void AssetIndex::AddBarn(const std::string& barnName, BarnFile* barn)
+{
+	mBarns.emplace_back(StringUtil::ToUpperCopy(barnName), barn);
+	IndexBarn(mBarns.back().first, barn);
+}
+
+void AssetIndex::RemoveBarn(const std::string& barnName)
+{
+	std::string upperBarnName = StringUtil::ToUpperCopy(barnName);
+	for(auto it = mBarns.begin(); it != mBarns.end(); ++it)
+	{
+		if(it->first == upperBarnName)
+		{
+			mBarns.erase(it);
+			break;
+		}
+	}
+
+	// Entries may refer to the removed barn, so rebuild the barn portion of the index.
+	// Remaining barns are re-added in their original order, so precedence doesn't change.
+	for(auto it = mLocations.begin(); it != mLocations.end();)
+	{
+		it->second.barn = nullptr;
+		it->second.barnAsset = nullptr;
+		if(it->second.filePath.empty())
+		{
+			it = mLocations.erase(it);
+		}
+		else
+		{
+			++it;
+		}
+	}
+	for(auto& entry : mBarns)
+	{
+		IndexBarn(entry.first, entry.second);
+	}
+}
+
+std::string AssetIndex::GetFilePath(const std::string& assetName) const
+{
+	auto it = mLocations.find(StringUtil::ToUpperCopy(assetName));
+	return it != mLocations.end() ? it->second.filePath : std::string();
+}
+
+bool AssetIndex::FindInBarn(const std::string& assetName, BarnFile*& outBarn, const BarnAsset*& outBarnAsset) const
+{
+	auto it = mLocations.find(StringUtil::ToUpperCopy(assetName));
+	if(it == mLocations.end() || it->second.barnAsset == nullptr) { return false; }
+
+	outBarn = it->second.barn;
+	outBarnAsset = it->second.barnAsset;
+	return true;
+}
+
+void AssetIndex::IndexBarn(const std::string& barnName, BarnFile* barn)
+{
+	for(auto& entry : barn->GetAssets())
+	{
+		// If another barn already has this asset's data, keep using that one.
+		AssetLocation& location = mLocations[StringUtil::ToUpperCopy(entry.first)];
+		if(location.barn != nullptr) { continue; }
+
+		// Pointer assets redirect to the barn containing the data.
+		// If that barn isn't loaded yet, save the pointer - it'll be resolved if that barn is loaded later.
+		const BarnAsset& asset = entry.second;
+		if(asset.IsPointer())
+		{
+			location.barnAsset = &asset;
+
+			std::string pointedToBarnName = StringUtil::ToUpperCopy(asset.barnFileName);
+			for(auto& loadedBarn : mBarns)
+			{
+				if(loadedBarn.first != pointedToBarnName) { continue; }
+				BarnAsset* pointedToAsset = loadedBarn.second->GetAsset(entry.first);
+				if(pointedToAsset != nullptr)
+				{
+					location.barn = loadedBarn.second;
+					location.barnAsset = pointedToAsset;
+				}
+				break;
+			}
+		}
+		else
+		{
+			location.barn = barn;
+			location.barnAsset = &asset;
+		}
+	}
+
+	// Resolve pointers from previously added barns to this barn.
+	for(auto& entry : mLocations)
+	{
+		AssetLocation& location = entry.second;
+		if(location.barn == nullptr && location.barnAsset != nullptr &&
+		   StringUtil::ToUpperCopy(location.barnAsset->barnFileName) == barnName)
+		{
+			BarnAsset* pointedToAsset = barn->GetAsset(location.barnAsset->name);
+			if(pointedToAsset != nullptr)
+			{
+				location.barn = barn;
+				location.barnAsset = pointedToAsset;
+			}
+		}
+	}
+}
@@ -0,0 +1,56 @@
+//
+// AssetIndex.h
+//
+// Clark Kromenaker
+//
+// Index of where assets can be loaded from: a loose file in a search path, a loaded barn, or both.
+// Updated as search paths are added and barns are loaded, so finding an asset is a single lookup,
+// without touching the file system or searching each barn.
+//
+#pragma once
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+class BarnFile;
+class BarnAsset;
+
+class AssetIndex
+{
+public:
+	// Adds the files in a search path. Search paths added earlier take precedence.
+	// Returns false if the search path's contents can't be listed.
+	bool AddSearchPath(const std::string& searchPath);
+
+	// Adds or removes a loaded barn's assets. If several barns have an asset, barns added earlier take precedence.
+	// Pointer assets are redirected to the barn containing the data, whenever that barn is added.
+	void AddBarn(const std::string& barnName, BarnFile* barn);
+	void RemoveBarn(const std::string& barnName);
+
+	// Full path to an asset's loose file in an indexed search path, or empty if there isn't one.
+	std::string GetFilePath(const std::string& assetName) const;
+
+	// Returns true if a loaded barn has the asset, and outputs the barn containing the asset's data.
+	// If the asset is only a pointer to a barn that isn't loaded, the barn is null, and the barn asset is the pointer.
+	bool FindInBarn(const std::string& assetName, BarnFile*& outBarn, const BarnAsset*& outBarnAsset) const;
+
+private:
+	struct AssetLocation
+	{
+		// Full path to a loose file in a search path, if any.
+		std::string filePath;
+
+		// Barn containing the asset, if any.
+		BarnFile* barn = nullptr;
+		const BarnAsset* barnAsset = nullptr;
+	};
+
+	// Keyed by uppercase asset name.
+	std::unordered_map<std::string, AssetLocation> mLocations;
+
+	// Barns in the order added, keyed by uppercase barn name - needed to rebuild the index when a barn is removed.
+	std::vector<std::pair<std::string, BarnFile*>> mBarns;
+
+	void IndexBarn(const std::string& barnName, BarnFile* barn);
+};
@@ -0,0 +1,42 @@
+//
+// AssetLoadBatch.cpp
+//
+// Clark Kromenaker
+//
+#include "AssetLoadBatch.h"
+
+#include "BarnFile.h"
+#include "Services.h"
+
+AssetLoadBatch::~AssetLoadBatch()
+{
+	WaitForExtracts();
+}
+
+AssetLoadBatch::Item* AssetLoadBatch::Add(const std::string& name)
+{
+	if(!mNames.insert(name).second) { return nullptr; }
+	mItems.emplace_back();
+	mItems.back().name = name;
+	return &mItems.back();
+}
+
+void AssetLoadBatch::Extract(Item* item, BarnFile* barn, unsigned int bufferSize)
+{
+	item->bufferSize = bufferSize;
+	item->buffer = new char[bufferSize];
+	++mPendingExtractCount;
+	Services::GetJobs()->Enqueue([this, item, barn]() {
+		if(!barn->Extract(item->name, item->buffer, item->bufferSize))
+		{
+			item->extractFailed = true;
+		}
+		--mPendingExtractCount;
+	});
+}
+
+void AssetLoadBatch::WaitForExtracts()
+{
+	if(mPendingExtractCount == 0) { return; }
+	Services::GetJobs()->WaitForCount(mPendingExtractCount);
+}
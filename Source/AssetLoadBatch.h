@@ -0,0 +1,56 @@
+//
+// AssetLoadBatch.h
+//
+// Clark Kromenaker
+//
+// A batch of assets being loaded together. Each asset appears in the batch once, in the order added.
+// Assets that must be extracted from a barn are extracted in parallel on worker threads.
+//
+#pragma once
+#include <atomic>
+#include <deque>
+#include <string>
+#include <unordered_set>
+
+class BarnFile;
+
+class AssetLoadBatch
+{
+public:
+	// An asset in the batch, along with the buffer it'll be created from.
+	struct Item
+	{
+		std::string name;
+		char* buffer = nullptr;
+		unsigned int bufferSize = 0;
+		bool bufferIsView = false;
+		bool prefetched = false;
+
+		// Set by the worker thread if the asset couldn't be extracted from its barn.
+		bool extractFailed = false;
+	};
+
+	// Waits for any extractions still running, since they write to this batch's items.
+	~AssetLoadBatch();
+
+	// Adds an asset to the batch. Returns null if the asset is already in the batch.
+	Item* Add(const std::string& name);
+
+	// Allocates the item's buffer and extracts the asset's data into it on a worker thread.
+	void Extract(Item* item, BarnFile* barn, unsigned int bufferSize);
+
+	// Blocks until this batch's extractions are done.
+	// The pool may also be running unrelated jobs (e.g. prefetches), which this doesn't wait on.
+	void WaitForExtracts();
+
+	// Items in the order added. Buffers are owned by whoever takes them from the items.
+	std::deque<Item>& GetItems() { return mItems; }
+
+private:
+	// Items don't move as more are added, so worker threads can hold pointers to them.
+	std::deque<Item> mItems;
+	std::unordered_set<std::string> mNames;
+
+	// Number of this batch's extractions that haven't finished yet.
+	std::atomic<int> mPendingExtractCount { 0 };
+};
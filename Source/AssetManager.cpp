@@ -6,22 +6,46 @@
 //
 #include "AssetManager.h"
 
+#include <algorithm>
 #include <cstring>
 #include <fstream>
 #include <iostream>
 #include <sstream>
 #include <string>
 
+#include "AssetLoadBatch.h"
 #include "FileSystem.h"
+#include "Services.h"
 #include "StringUtil.h"
 
+// Approximate memory used by an asset.
+// Most assets are about the size of the data they're created from, but texture pixels are expanded to 32-bit color.
+static unsigned int GetAssetByteCount(Asset* /*asset*/, unsigned int dataSize)
+{
+	return dataSize;
+}
+
+static unsigned int GetAssetByteCount(Texture* texture, unsigned int /*dataSize*/)
+{
+	return texture->GetWidth() * texture->GetHeight() * 4;
+}
+
 AssetManager::AssetManager()
 {
-    
+	// Default budgets for the asset types that take up the most memory as the player moves from scene to scene.
+	// Unreferenced assets beyond these budgets are unloaded after each scene load.
+	mMemoryBudgets["Texture"] = 128 * 1024 * 1024;
+	mMemoryBudgets["BSP"] = 32 * 1024 * 1024;
+	mMemoryBudgets["Lightmap"] = 32 * 1024 * 1024;
+	mMemoryBudgets["Model"] = 32 * 1024 * 1024;
+	mMemoryBudgets["VertexAnimation"] = 64 * 1024 * 1024;
 }
 
 AssetManager::~AssetManager()
 {
+	// Let any in-progress extractions finish up - they may be reading from barns we're about to delete.
+	ClearPrefetchedAssets();
+	
 	// All the loaded stuff has to be unloaded!
 	UnloadAssets(mLoadedShaders);
 	
@@ -54,6 +78,13 @@ void AssetManager::AddSearchPath(const std::string& searchPath)
         return;
     }
     mSearchPaths.push_back(searchPath);
+	
+	// Index the files in the search path now, so finding assets doesn't need to query the file system.
+	// If that fails, fall back on searching the path for each asset.
+	if(!mAssetIndex.AddSearchPath(searchPath))
+	{
+		mUnindexedSearchPaths.push_back(searchPath);
+	}
 }
 
 bool AssetManager::LoadBarn(const std::string& barnName)
@@ -75,8 +106,11 @@ bool AssetManager::LoadBarn(const std::string& barnName)
     }
     
     // Load barn file.
-    BarnFile* barn = new BarnFile(assetPath);
+    BarnFile* barn = new BarnFile(assetPath, mMemoryMapBarns);
     mLoadedBarns[dictKey] = barn;
+	
+	// Add barn's assets to the asset index.
+	mAssetIndex.AddBarn(dictKey, barn);
 	return true;
 }
 
@@ -90,12 +124,18 @@ void AssetManager::UnloadBarn(const std::string& barnName)
     auto iter = mLoadedBarns.find(dictKey);
     if(iter == mLoadedBarns.end()) { return; }
     
+    // Worker threads may be extracting from this barn - wait for them before deleting it.
+    Services::GetJobs()->WaitForCount(mPendingPrefetchCount);
+    
     // Delete barn.
     BarnFile* barn = iter->second;
     delete barn;
     
     // Remove from map.
     mLoadedBarns.erase(dictKey);
+	
+	// Remove the deleted barn's assets from the asset index.
+	mAssetIndex.RemoveBarn(dictKey);
 }
 
 void AssetManager::WriteBarnAssetToFile(const std::string& assetName)
@@ -151,6 +191,21 @@ Texture* AssetManager::LoadTexture(const std::string& name)
     return LoadAsset<Texture>(SanitizeAssetName(name, ".BMP"), &mLoadedTextures);
 }
 
+void AssetManager::LoadModels(const std::vector<std::string>& names)
+{
+	LoadAssets<Model>(names, ".MOD", &mLoadedModels);
+}
+
+void AssetManager::LoadTextures(const std::vector<std::string>& names)
+{
+	LoadAssets<Texture>(names, ".BMP", &mLoadedTextures);
+}
+
+void AssetManager::PrefetchTextures(const std::vector<std::string>& names)
+{
+	PrefetchAssets<Texture>(names, ".BMP", &mLoadedTextures, true);
+}
+
 GAS* AssetManager::LoadGAS(const std::string& name)
 {
     return LoadAsset<GAS>(SanitizeAssetName(name, ".GAS"), &mLoadedGases);
@@ -181,6 +236,16 @@ NVC* AssetManager::LoadNVC(const std::string& name)
     return LoadAsset<NVC>(SanitizeAssetName(name, ".NVC"), &mLoadedActionSets);
 }
 
+void AssetManager::PrefetchSIFs(const std::vector<std::string>& names)
+{
+	PrefetchAssets<SceneInitFile>(names, ".SIF", &mLoadedSIFs, false);
+}
+
+void AssetManager::PrefetchSceneAssets(const std::vector<std::string>& names)
+{
+	PrefetchAssets<SceneAsset>(names, ".SCN", &mLoadedSceneAssets, false);
+}
+
 BSP* AssetManager::LoadBSP(const std::string& name)
 {
     return LoadAsset<BSP>(SanitizeAssetName(name, ".BSP"), &mLoadedBSPs);
@@ -191,6 +256,31 @@ BSPLightmap* AssetManager::LoadBSPLightmap(const std::string& name)
     return LoadAsset<BSPLightmap>(SanitizeAssetName(name, ".MUL"), &mLoadedBSPLightmaps);
 }
 
+void AssetManager::PrefetchBSPs(const std::vector<std::string>& names)
+{
+	PrefetchAssets<BSP>(names, ".BSP", &mLoadedBSPs, false);
+}
+
+void AssetManager::PrefetchBSPLightmaps(const std::vector<std::string>& names)
+{
+	PrefetchAssets<BSPLightmap>(names, ".MUL", &mLoadedBSPLightmaps, true);
+}
+
+void AssetManager::ClearPrefetchedAssets()
+{
+	// Jobs write to the prefetched entries, so they must be done first.
+	Services::GetJobs()->WaitForCount(mPendingPrefetchCount);
+	for(auto& entry : mPrefetchedAssets)
+	{
+		delete[] entry.second.buffer;
+		if(entry.second.asset != nullptr)
+		{
+			entry.second.deleteAsset(entry.second.asset);
+		}
+	}
+	mPrefetchedAssets.clear();
+}
+
 SheepScript* AssetManager::LoadSheep(const std::string& name)
 {
     return LoadAsset<SheepScript>(SanitizeAssetName(name, ".SHP"), &mLoadedSheeps);
@@ -262,6 +352,38 @@ char* AssetManager::LoadRaw(const std::string& name, unsigned int& outBufferSize
 	return CreateAssetBuffer(name, outBufferSize);
 }
 
+void AssetManager::EvictUnusedAssets()
+{
+	// Assets that depend on other assets go first, since dependencies can't be unloaded until their dependents are.
+	EvictAssets(mLoadedSIFs, "SIF");
+	EvictAssets(mLoadedSceneAssets, "Scene");
+	EvictAssets(mLoadedBSPs, "BSP");
+	EvictAssets(mLoadedGases, "GAS");
+	EvictAssets(mLoadedModels, "Model");
+	EvictAssets(mLoadedAnimations, "Animation");
+	EvictAssets(mLoadedVertexAnimations, "VertexAnimation");
+	EvictAssets(mLoadedBSPLightmaps, "Lightmap");
+	EvictAssets(mLoadedTextures, "Texture");
+}
+
+void AssetManager::DumpMemoryUsage()
+{
+	DumpMemoryUsage(mLoadedAudios, "Audio");
+	DumpMemoryUsage(mLoadedSoundtracks, "Soundtrack");
+	DumpMemoryUsage(mLoadedYaks, "Yak");
+	DumpMemoryUsage(mLoadedModels, "Model");
+	DumpMemoryUsage(mLoadedTextures, "Texture");
+	DumpMemoryUsage(mLoadedGases, "GAS");
+	DumpMemoryUsage(mLoadedAnimations, "Animation");
+	DumpMemoryUsage(mLoadedVertexAnimations, "VertexAnimation");
+	DumpMemoryUsage(mLoadedSIFs, "SIF");
+	DumpMemoryUsage(mLoadedSceneAssets, "Scene");
+	DumpMemoryUsage(mLoadedActionSets, "NVC");
+	DumpMemoryUsage(mLoadedBSPs, "BSP");
+	DumpMemoryUsage(mLoadedBSPLightmaps, "Lightmap");
+	DumpMemoryUsage(mLoadedSheeps, "Sheep");
+}
+
 BarnFile* AssetManager::GetBarn(const std::string& barnName)
 {
 	// We want our dictionary key to be all uppercase.
@@ -281,35 +403,22 @@ BarnFile* AssetManager::GetBarn(const std::string& barnName)
 
 BarnFile* AssetManager::GetBarnContainingAsset(const std::string& fileName)
 {
-	// Iterate over all loaded barn files to find the asset.
-	for(const auto& entry : mLoadedBarns)
+	// Look up the asset in the index.
+	BarnFile* barn = nullptr;
+	const BarnAsset* barnAsset = nullptr;
+	if(!mAssetIndex.FindInBarn(fileName, barn, barnAsset))
 	{
-		BarnAsset* asset = entry.second->GetAsset(fileName);
-		if(asset != nullptr)
-		{
-			// If the asset is a pointer, we need to redirect to the correct BarnFile.
-			// If the correct Barn isn't available, spit out an error and fail.
-			if(asset->IsPointer())
-			{
-				auto it = mLoadedBarns.find(asset->barnFileName);
-				if(it != mLoadedBarns.end())
-				{
-					return it->second;
-				}
-				else
-				{
-					std::cout << "Asset " << fileName << " exists in Barn " << asset->barnFileName << ", but that Barn is not loaded!" << std::endl;
-				}
-			}
-			else
-			{
-				return entry.second;
-			}
-		}
+		// Didn't find the Barn containing this asset.
+		return nullptr;
 	}
 	
-	// Didn't find the Barn containing this asset.
-	return nullptr;
+	// If the asset is a pointer, and the correct Barn isn't available, spit out an error and fail.
+	if(barn == nullptr)
+	{
+		std::cout << "Asset " << fileName << " exists in Barn " << barnAsset->barnFileName << ", but that Barn is not loaded!" << std::endl;
+		return nullptr;
+	}
+	return barn;
 }
 
 std::string AssetManager::SanitizeAssetName(const std::string& assetName, const std::string& expectedExtension)
@@ -332,8 +441,19 @@ std::string AssetManager::SanitizeAssetName(const std::string& assetName, const
 
 std::string AssetManager::GetAssetPath(const std::string& fileName)
 {
-	std::string assetPath;
-	for(const std::string& searchPath : mSearchPaths)
+	// Files in indexed search paths can be found without touching the file system.
+	std::string assetPath = mAssetIndex.GetFilePath(fileName);
+	if(!assetPath.empty()) { return assetPath; }
+	
+	// Files created after their search path was indexed (saves, dumps, etc) and files in subdirectories aren't in the index,
+	// so anything not in the index is searched for the slow way, with a file system query per search path.
+	// Barn assets skip this, so they load without touching the file system - which means a loose file that
+	// overrides a barn asset must exist when its search path is added. Search paths that couldn't be indexed are always searched.
+	BarnFile* barn = nullptr;
+	const BarnAsset* barnAsset = nullptr;
+	bool inBarn = mAssetIndex.FindInBarn(fileName, barn, barnAsset);
+	const std::vector<std::string>& searchPaths = inBarn ? mUnindexedSearchPaths : mSearchPaths;
+	for(const std::string& searchPath : searchPaths)
 	{
 		if(Path::FindFullPath(fileName, searchPath, assetPath))
 		{
@@ -356,39 +476,215 @@ T* AssetManager::LoadAsset(const std::string& assetName, std::unordered_map<std:
         auto it = cache->find(upperName);
         if(it != cache->end())
         {
+			mResidency.Use(it->second);
             return it->second;
         }
     }
 	
-	// Retrieve the buffer, from which we'll create the asset.
+	// The asset may have already been created on a worker thread (see PrefetchAssets).
 	unsigned int bufferSize = 0;
-	char* buffer = CreateAssetBuffer(upperName, bufferSize);
+	Asset* prefetchedAsset = TakePrefetchedAsset(upperName, bufferSize);
+	if(prefetchedAsset != nullptr)
+	{
+		return CacheAsset<T>(upperName, static_cast<T*>(prefetchedAsset), bufferSize, std::vector<Asset*>(), cache);
+	}
+	
+	// Retrieve the buffer, from which we'll create the asset.
+	// This may be a read-only view into a memory-mapped barn, which avoids an allocation and copy.
+	bool bufferIsView = false;
+	char* buffer = CreateAssetBuffer(upperName, bufferSize, &bufferIsView);
+	return CreateAsset<T>(upperName, buffer, bufferSize, bufferIsView, cache);
+}
+
+template<class T>
+void AssetManager::LoadAssets(const std::vector<std::string>& assetNames, const std::string& expectedExtension, std::unordered_map<std::string, T*>* cache)
+{
+	// Each asset is only loaded once, even if it appears in the batch several times.
+	AssetLoadBatch batch;
+	
+	// Figure out where each asset's data comes from.
+	for(auto& assetName : assetNames)
+	{
+		if(assetName.empty()) { continue; }
+		
+		// Skip assets that are already loaded, or already in the batch.
+		std::string upperName = SanitizeAssetName(assetName, expectedExtension);
+		if(cache != nullptr && cache->find(upperName) != cache->end()) { continue; }
+		AssetLoadBatch::Item* item = batch.Add(upperName);
+		if(item == nullptr) { continue; }
+		
+		// Prefetched assets may still be extracting - grab those once this batch's workers are done.
+		if(mPrefetchedAssets.find(upperName) != mPrefetchedAssets.end())
+		{
+			item->prefetched = true;
+			continue;
+		}
+		
+		// Loose files take precedence over barn assets - those are just read directly.
+		// Same for barn assets that can be viewed in-place; no extraction needed.
+		BarnFile* barn = GetAssetPath(upperName).empty() ? GetBarnContainingAsset(upperName) : nullptr;
+		BarnAsset* barnAsset = barn != nullptr ? barn->GetAsset(upperName) : nullptr;
+		if(barnAsset == nullptr || barn->GetAssetView(upperName, item->bufferSize) != nullptr)
+		{
+			item->buffer = CreateAssetBuffer(upperName, item->bufferSize, &item->bufferIsView);
+			continue;
+		}
+		
+		// This asset must be extracted from its barn - let a worker thread do it.
+		batch.Extract(item, barn, barnAsset->uncompressedSize);
+	}
 	
+	// Wait for this batch's extractions to complete.
+	batch.WaitForExtracts();
+	
+	// Create assets on this thread, in the order requested.
+	for(auto& item : batch.GetItems())
+	{
+		// Don't create an asset from a buffer that was never filled in.
+		if(item.extractFailed)
+		{
+			std::cout << "Asset " << item.name << " could not be extracted!" << std::endl;
+			delete[] item.buffer;
+			continue;
+		}
+		
+		// Prefetched assets may have been created on a worker thread already, so let LoadAsset sort those out.
+		if(item.prefetched)
+		{
+			LoadAsset<T>(item.name, cache);
+			continue;
+		}
+		CreateAsset<T>(item.name, item.buffer, item.bufferSize, item.bufferIsView, cache);
+	}
+}
+
+template<class T>
+void AssetManager::PrefetchAssets(const std::vector<std::string>& assetNames, const std::string& expectedExtension, std::unordered_map<std::string, T*>* cache, bool createOnWorker)
+{
+	for(auto& assetName : assetNames)
+	{
+		if(assetName.empty()) { continue; }
+		
+		// Skip anything already loaded or prefetched.
+		std::string upperName = SanitizeAssetName(assetName, expectedExtension);
+		if(cache != nullptr && cache->find(upperName) != cache->end()) { continue; }
+		if(mPrefetchedAssets.find(upperName) != mPrefetchedAssets.end()) { continue; }
+		
+		// Loose files aren't prefetched, and neither are uncompressed barn assets - those are cheap to read (or viewed in-place).
+		if(!GetAssetPath(upperName).empty()) { continue; }
+		BarnFile* barn = GetBarnContainingAsset(upperName);
+		if(barn == nullptr) { continue; }
+		BarnAsset* barnAsset = barn->GetAsset(upperName);
+		if(barnAsset == nullptr || barnAsset->compressionType == CompressionType::None) { continue; }
+		
+		// Extract the asset on a worker thread.
+		PrefetchedAsset& prefetchedAsset = mPrefetchedAssets[upperName];
+		prefetchedAsset.bufferSize = barnAsset->uncompressedSize;
+		prefetchedAsset.buffer = new char[prefetchedAsset.bufferSize];
+		
+		// Map entries don't move as the map grows, and aren't removed until this job is done, so the pointer stays valid.
+		PrefetchedAsset* extractingAsset = &prefetchedAsset;
+		extractingAsset->deleteAsset = [](Asset* asset) { delete static_cast<T*>(asset); };
+		extractingAsset->pendingCount = 1;
+		++mPendingPrefetchCount;
+		Services::GetJobs()->Enqueue([this, barn, upperName, extractingAsset, createOnWorker]() {
+			if(!barn->Extract(upperName, extractingAsset->buffer, extractingAsset->bufferSize))
+			{
+				// Drop the data, so it's loaded (and the failure reported) the normal way later.
+				delete[] extractingAsset->buffer;
+				extractingAsset->buffer = nullptr;
+				extractingAsset->failed = true;
+			}
+			else if(createOnWorker)
+			{
+				extractingAsset->asset = new T(upperName, extractingAsset->buffer, extractingAsset->bufferSize);
+				delete[] extractingAsset->buffer;
+				extractingAsset->buffer = nullptr;
+			}
+			
+			// Once the entry's count is zero, the main thread may take and erase it - so the entry can't be touched after that.
+			--extractingAsset->pendingCount;
+			--mPendingPrefetchCount;
+		});
+	}
+}
+
+template<class T>
+T* AssetManager::CreateAsset(const std::string& assetName, char* buffer, unsigned int bufferSize, bool bufferIsView, std::unordered_map<std::string, T*>* cache)
+{
 	// If no buffer could be found, we're in trouble!
 	if(buffer == nullptr)
 	{
-		std::cout << "Asset " << upperName << " could not be loaded!" << std::endl;
+		std::cout << "Asset " << assetName << " could not be loaded!" << std::endl;
 		return nullptr;
 	}
 	
 	// Generate asset from the BARN bytes.
-	T* asset = new T(upperName, buffer, bufferSize);
+	// Any assets requested during creation are dependencies of this asset.
+	mResidency.BeginDependencies();
+	T* asset = new T(assetName, buffer, bufferSize);
+	std::vector<Asset*> dependencies = mResidency.EndDependencies();
 	
 	// Delete the buffer after use (or it'll leak).
-	delete[] buffer;
-	
+	// Views are owned by the barn, so those must NOT be deleted.
+	if(!bufferIsView)
+	{
+		delete[] buffer;
+	}
+	return CacheAsset<T>(assetName, asset, bufferSize, std::move(dependencies), cache);
+}
+
+template<class T>
+T* AssetManager::CacheAsset(const std::string& assetName, T* asset, unsigned int bufferSize, std::vector<Asset*> dependencies, std::unordered_map<std::string, T*>* cache)
+{
 	// Add entry in cache, if we have a cache.
+	// Only cached assets are tracked for residency - uncached assets are owned by whoever loaded them.
 	if(cache != nullptr)
 	{
-		(*cache)[upperName] = asset;
+		(*cache)[assetName] = asset;
+		mResidency.Add(asset, GetAssetByteCount(asset, bufferSize), std::move(dependencies));
+		mResidency.Use(asset);
 	}
         
-	//std::cout << "Loaded asset " << upperName << std::endl;
+	//std::cout << "Loaded asset " << assetName << std::endl;
 	return asset;
 }
 
-char* AssetManager::CreateAssetBuffer(const std::string& assetName, unsigned int& outBufferSize)
+Asset* AssetManager::TakePrefetchedAsset(const std::string& assetName, unsigned int& outBufferSize)
 {
+	// Only prefetched assets that were created on a worker thread are taken here.
+	auto prefetchIt = mPrefetchedAssets.find(assetName);
+	if(prefetchIt == mPrefetchedAssets.end()) { return nullptr; }
+	Services::GetJobs()->WaitForCount(prefetchIt->second.pendingCount);
+	
+	Asset* asset = prefetchIt->second.asset;
+	if(asset != nullptr)
+	{
+		outBufferSize = prefetchIt->second.bufferSize;
+		mPrefetchedAssets.erase(prefetchIt);
+	}
+	return asset;
+}
+
+char* AssetManager::CreateAssetBuffer(const std::string& assetName, unsigned int& outBufferSize, bool* outIsView)
+{
+	// If the asset was prefetched, hand over the extracted data (waiting for extraction to finish, if need be).
+	// If extraction failed, there's no data - just load the asset as usual.
+	auto prefetchIt = mPrefetchedAssets.find(assetName);
+	if(prefetchIt != mPrefetchedAssets.end())
+	{
+		Services::GetJobs()->WaitForCount(prefetchIt->second.pendingCount);
+		
+		char* buffer = prefetchIt->second.buffer;
+		outBufferSize = prefetchIt->second.bufferSize;
+		bool failed = prefetchIt->second.failed;
+		mPrefetchedAssets.erase(prefetchIt);
+		if(!failed)
+		{
+			return buffer;
+		}
+	}
+	
 	// First, see if the asset exists at any asset search path.
 	// If so, we load the asset directly from file.
 	// Loose files take precedence over packaged barn assets.
@@ -421,6 +717,18 @@ char* AssetManager::CreateAssetBuffer(const std::string& assetName, unsigned int
 	BarnFile* barn = GetBarnContainingAsset(assetName);
 	if(barn != nullptr)
 	{
+		// If the caller can accept a view, and the barn can provide one, use the asset data in-place.
+		// Assets only read from the buffer they're created with, so handing out read-only memory is fine.
+		if(outIsView != nullptr)
+		{
+			const char* view = barn->GetAssetView(assetName, outBufferSize);
+			*outIsView = (view != nullptr);
+			if(view != nullptr)
+			{
+				return const_cast<char*>(view);
+			}
+		}
+		
 		// Extract bytes from the barn file contents.
 		BarnAsset* barnAsset = barn->GetAsset(assetName);
 		if(barnAsset == nullptr)
@@ -456,3 +764,51 @@ void AssetManager::UnloadAssets(std::unordered_map<std::string, T*>& cache)
 	// Clear the cache.
 	cache.clear();
 }
+
+template<class T>
+void AssetManager::EvictAssets(std::unordered_map<std::string, T*>& cache, const std::string& assetType)
+{
+	// No budget means no limit.
+	auto budgetIt = mMemoryBudgets.find(assetType);
+	if(budgetIt == mMemoryBudgets.end() || budgetIt->second == 0) { return; }
+	
+	std::vector<Asset*> assets;
+	assets.reserve(cache.size());
+	for(auto& entry : cache)
+	{
+		assets.push_back(entry.second);
+	}
+	
+	// Unload whatever unused assets are needed to get back within budget.
+	for(Asset* asset : mResidency.GetAssetsToEvict(assets, budgetIt->second))
+	{
+		mResidency.Remove(asset);
+		cache.erase(asset->GetName());
+		delete static_cast<T*>(asset);
+	}
+}
+
+template<class T>
+void AssetManager::DumpMemoryUsage(const std::unordered_map<std::string, T*>& cache, const std::string& assetType)
+{
+	size_t totalBytes = 0;
+	int referencedCount = 0;
+	for(auto& entry : cache)
+	{
+		totalBytes += mResidency.GetByteCount(entry.second);
+		if(entry.second->GetRefCount() > 0)
+		{
+			++referencedCount;
+		}
+	}
+	
+	std::stringstream ss;
+	ss << assetType << ": " << cache.size() << " loaded (" << referencedCount << " referenced), ";
+	ss << (totalBytes / 1024) << " KB";
+	auto budgetIt = mMemoryBudgets.find(assetType);
+	if(budgetIt != mMemoryBudgets.end() && budgetIt->second > 0)
+	{
+		ss << " of " << (budgetIt->second / 1024) << " KB budget";
+	}
+	Services::GetReports()->Log("Dump", ss.str());
+}
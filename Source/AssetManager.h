@@ -5,10 +5,13 @@
 //  Created by Clark Kromenaker on 8/17/17.
 //
 #pragma once
+#include <atomic>
 #include <string>
 #include <vector>
 
 #include "Animation.h"
+#include "AssetIndex.h"
+#include "AssetResidency.h"
 #include "Audio.h"
 #include "BarnFile.h"
 #include "BSP.h"
@@ -39,6 +42,10 @@ public:
     bool LoadBarn(const std::string& barnName);
     void UnloadBarn(const std::string& barnName);
 	
+	// If true, barns are memory mapped when loaded, and uncompressed assets are read in-place (no copy).
+	// Only affects barns loaded after this is set.
+	void SetMemoryMapBarns(bool memoryMap) { mMemoryMapBarns = memoryMap; }
+	
 	// Write an asset from a bundle to a file.
     void WriteBarnAssetToFile(const std::string& assetName);
 	void WriteBarnAssetToFile(const std::string& assetName, const std::string& outputDir);
@@ -53,6 +60,26 @@ public:
     
     Model* LoadModel(const std::string& name);
     Texture* LoadTexture(const std::string& name);
+	
+	// Loads a batch of assets, so they're already cached when requested individually later.
+	// Barn assets are extracted/decompressed in parallel on worker threads, but the assets
+	// themselves are created on the calling thread (textures must create GPU resources on the main thread).
+	void LoadModels(const std::vector<std::string>& names);
+	void LoadTextures(const std::vector<std::string>& names);
+	
+	// Starts extracting assets on worker threads, without waiting for them to finish.
+	// When a prefetched asset is loaded later, the already extracted data is used.
+	// Only compressed barn assets are prefetched - anything else is quick to load on demand anyway.
+	// Textures and lightmaps don't load other assets or touch OpenGL when created, so those are also created on the worker thread.
+	void PrefetchTextures(const std::vector<std::string>& names);
+	void PrefetchSIFs(const std::vector<std::string>& names);
+	void PrefetchSceneAssets(const std::vector<std::string>& names);
+	void PrefetchBSPs(const std::vector<std::string>& names);
+	void PrefetchBSPLightmaps(const std::vector<std::string>& names);
+	bool IsPrefetchDone() const { return mPendingPrefetchCount == 0; }
+	
+	// Frees any prefetched assets that were never loaded (waiting for in-progress prefetches first).
+	void ClearPrefetchedAssets();
     
     GAS* LoadGAS(const std::string& name);
     Animation* LoadAnimation(const std::string& name);
@@ -74,15 +101,40 @@ public:
 	Shader* LoadShader(const std::string& vertName, const std::string& fragName);
 	
 	char* LoadRaw(const std::string& name, unsigned int& outBufferSize);
+	
+	// Any asset that's requested is referenced by the current scene, and those references are dropped when the scene's assets are released.
+	// Systems that hold on to assets across scene changes must acquire those assets, or they may be unloaded.
+	// Acquired assets stay loaded until released. Null and uncached assets are ignored.
+	void AcquireAsset(Asset* asset) { mResidency.Acquire(asset); }
+	void ReleaseAsset(Asset* asset) { mResidency.Release(asset); }
+	void ReleaseSceneAssets() { mResidency.ReleaseSceneAssets(); }
+	
+	// Sets max memory (in bytes) to use for an asset type (e.g. "Texture", "BSP"). Zero means no limit.
+	// Unreferenced assets are unloaded, least recently used first, to get each type back within its budget.
+	void SetMemoryBudget(const std::string& assetType, unsigned int bytes) { mMemoryBudgets[assetType] = bytes; }
+	void EvictUnusedAssets();
+	
+	// For debugging, outputs loaded asset counts and memory usage per asset type.
+	void DumpMemoryUsage();
     
 private:
     // A list of paths to search for assets.
     // In priority order, since we'll search in order, and stop when we find the item.
     std::vector<std::string> mSearchPaths;
+	
+	// Search paths whose contents couldn't be indexed (e.g. directory couldn't be read).
+	// These are still searched the slow way - a file system query per asset, even for barn assets.
+	std::vector<std::string> mUnindexedSearchPaths;
     
     // A map of loaded barn files. If an asset isn't found on any search path,
     // we then search each loaded barn file for the asset.
     std::unordered_map<std::string, BarnFile*> mLoadedBarns;
+	
+	// If true, newly loaded barns are memory mapped.
+	bool mMemoryMapBarns = true;
+	
+	// Where each asset in the search paths and loaded barns can be loaded from (loose files take precedence).
+	AssetIndex mAssetIndex;
     
     // A list of loaded assets, so we can just return existing assets if already loaded.
     std::unordered_map<std::string, Audio*> mLoadedAudios;
@@ -107,6 +159,35 @@ private:
 	
     std::unordered_map<std::string, Shader*> mLoadedShaders;
 	
+	// Asset data extracted ahead of time by PrefetchAssets, waiting to be loaded.
+	// An entry is only safe to use once its extraction job has finished.
+	struct PrefetchedAsset
+	{
+		// One while the extraction job is running, zero once it's done. Lets a load wait on just the asset it needs.
+		std::atomic<int> pendingCount { 0 };
+		
+		char* buffer = nullptr;
+		unsigned int bufferSize = 0;
+		
+		// If the asset was created on the worker thread, the asset (and the buffer is already deleted).
+		// Assets don't have a virtual destructor, so this also needs a function to delete the asset as the right type.
+		Asset* asset = nullptr;
+		void (*deleteAsset)(Asset*) = nullptr;
+		
+		// If true, extraction failed and there's no data.
+		bool failed = false;
+	};
+	std::unordered_map<std::string, PrefetchedAsset> mPrefetchedAssets;
+	
+	// Number of prefetch extraction jobs that haven't finished yet, across all prefetched assets.
+	std::atomic<int> mPendingPrefetchCount { 0 };
+	
+	// Tracks which cached assets are in use, and which could be unloaded.
+	AssetResidency mResidency;
+	
+	// Memory budget, in bytes, per asset type.
+	std::unordered_map<std::string, unsigned int> mMemoryBudgets;
+	
 	// Retrieve a barn bundle by name, or by contained asset.
 	BarnFile* GetBarn(const std::string& barnName);
 	BarnFile* GetBarnContainingAsset(const std::string& assetName);
@@ -116,7 +197,14 @@ private:
     std::string GetAssetPath(const std::string& fileName);
     
     template<class T> T* LoadAsset(const std::string& assetName, std::unordered_map<std::string, T*>* cache);
-	char* CreateAssetBuffer(const std::string& assetName, unsigned int& outBufferSize);
+	template<class T> void LoadAssets(const std::vector<std::string>& assetNames, const std::string& expectedExtension, std::unordered_map<std::string, T*>* cache);
+	template<class T> void PrefetchAssets(const std::vector<std::string>& assetNames, const std::string& expectedExtension, std::unordered_map<std::string, T*>* cache, bool createOnWorker);
+	template<class T> T* CreateAsset(const std::string& assetName, char* buffer, unsigned int bufferSize, bool bufferIsView, std::unordered_map<std::string, T*>* cache);
+	template<class T> T* CacheAsset(const std::string& assetName, T* asset, unsigned int bufferSize, std::vector<Asset*> dependencies, std::unordered_map<std::string, T*>* cache);
+	Asset* TakePrefetchedAsset(const std::string& assetName, unsigned int& outBufferSize);
+	char* CreateAssetBuffer(const std::string& assetName, unsigned int& outBufferSize, bool* outIsView = nullptr);
 	
 	template<class T> void UnloadAssets(std::unordered_map<std::string, T*>& cache);
+	template<class T> void EvictAssets(std::unordered_map<std::string, T*>& cache, const std::string& assetType);
+	template<class T> void DumpMemoryUsage(const std::unordered_map<std::string, T*>& cache, const std::string& assetType);
 };
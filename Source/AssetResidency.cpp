@@ -0,0 +1,133 @@
+//
+// AssetResidency.cpp
+//
+// Clark Kromenaker
+//
+#include "AssetResidency.h"
+
+#include <algorithm>
+
+#include "Asset.h"
+
+void AssetResidency::Add(Asset* asset, unsigned int byteCount, std::vector<Asset*> dependencies)
+{
+	AssetRecord& record = mRecords[asset];
+	record.byteCount = byteCount;
+	record.dependencies = std::move(dependencies);
+	for(Asset* dependency : record.dependencies)
+	{
+		mRecords[dependency].dependentCount++;
+	}
+}
+
+void AssetResidency::Remove(Asset* asset)
+{
+	auto it = mRecords.find(asset);
+	if(it == mRecords.end()) { return; }
+
+	// This asset no longer depends on anything.
+	for(Asset* dependency : it->second.dependencies)
+	{
+		mRecords[dependency].dependentCount--;
+	}
+	mRecords.erase(it);
+	mSceneAssets.erase(asset);
+}
+
+void AssetResidency::Use(Asset* asset)
+{
+	// Only assets we're tracking can be used.
+	auto it = mRecords.find(asset);
+	if(it == mRecords.end()) { return; }
+	it->second.lastUsed = ++mUseCounter;
+
+	// If another asset is being created, this asset is one of its dependencies.
+	if(!mDependencyStack.empty())
+	{
+		mDependencyStack.back().push_back(asset);
+	}
+
+	// Whoever requested this asset holds a reference to it, until the scene changes.
+	// The scene references each asset at most once.
+	if(mSceneAssets.insert(asset).second)
+	{
+		asset->AddRef();
+	}
+}
+
+void AssetResidency::ReleaseSceneAssets()
+{
+	for(Asset* asset : mSceneAssets)
+	{
+		asset->Release();
+	}
+	mSceneAssets.clear();
+}
+
+void AssetResidency::Acquire(Asset* asset)
+{
+	auto it = mRecords.find(asset);
+	if(it == mRecords.end()) { return; }
+	it->second.acquireCount++;
+	asset->AddRef();
+}
+
+void AssetResidency::Release(Asset* asset)
+{
+	// Only release references that were actually acquired, so a stray release can't drop the scene's reference.
+	auto it = mRecords.find(asset);
+	if(it == mRecords.end() || it->second.acquireCount == 0) { return; }
+	it->second.acquireCount--;
+	asset->Release();
+}
+
+void AssetResidency::BeginDependencies()
+{
+	mDependencyStack.emplace_back();
+}
+
+std::vector<Asset*> AssetResidency::EndDependencies()
+{
+	std::vector<Asset*> dependencies = std::move(mDependencyStack.back());
+	mDependencyStack.pop_back();
+	return dependencies;
+}
+
+unsigned int AssetResidency::GetByteCount(Asset* asset) const
+{
+	auto it = mRecords.find(asset);
+	return it != mRecords.end() ? it->second.byteCount : 0;
+}
+
+std::vector<Asset*> AssetResidency::GetAssetsToEvict(const std::vector<Asset*>& assets, unsigned int budget) const
+{
+	// Total up memory used, and find assets that could be unloaded.
+	// Assets can be unloaded if nothing references them, and no other loaded assets depend on them.
+	size_t totalBytes = 0;
+	std::vector<const std::pair<Asset* const, AssetRecord>*> unusedAssets;
+	for(Asset* asset : assets)
+	{
+		auto it = mRecords.find(asset);
+		if(it == mRecords.end()) { continue; }
+
+		totalBytes += it->second.byteCount;
+		if(asset->GetRefCount() == 0 && it->second.dependentCount == 0)
+		{
+			unusedAssets.push_back(&(*it));
+		}
+	}
+
+	// Unload least recently used assets until we're within budget.
+	std::vector<Asset*> evictedAssets;
+	if(totalBytes <= budget) { return evictedAssets; }
+	std::sort(unusedAssets.begin(), unusedAssets.end(), [](const std::pair<Asset* const, AssetRecord>* a, const std::pair<Asset* const, AssetRecord>* b) {
+		return a->second.lastUsed < b->second.lastUsed;
+	});
+	for(auto entry : unusedAssets)
+	{
+		if(totalBytes <= budget) { break; }
+		totalBytes -= entry->second.byteCount;
+		evictedAssets.push_back(entry->first);
+	}
+	return evictedAssets;
+}
@@ -0,0 +1,72 @@
+//
+// AssetResidency.h
+//
+// Clark Kromenaker
+//
+// Keeps track of which loaded assets are still in use, so the asset manager knows which ones it can unload.
+//
+// An asset is in use if anything references it, or if another loaded asset depends on it.
+// Assets referenced by a scene are released when the scene changes. Persistent systems acquire
+// the assets they hold, and those references last until released.
+//
+#pragma once
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+class Asset;
+
+class AssetResidency
+{
+public:
+	// Starts or stops tracking a loaded asset.
+	// Dependencies are assets this asset holds pointers to - those can't be unloaded before this asset is.
+	void Add(Asset* asset, unsigned int byteCount, std::vector<Asset*> dependencies);
+	void Remove(Asset* asset);
+
+	// Records that an asset was just requested. Untracked assets are ignored.
+	// The current scene references the asset until the scene's assets are released.
+	void Use(Asset* asset);
+	void ReleaseSceneAssets();
+
+	// References that last until released, for systems that hold assets across scenes.
+	void Acquire(Asset* asset);
+	void Release(Asset* asset);
+
+	// While an asset is being created, any assets it uses are its dependencies.
+	// These calls can be nested, if creating one asset creates another.
+	void BeginDependencies();
+	std::vector<Asset*> EndDependencies();
+
+	// Approximate memory used by an asset (zero if it isn't tracked).
+	unsigned int GetByteCount(Asset* asset) const;
+
+	// Of the given assets, returns the unused ones that must be unloaded to get their total memory within budget.
+	// Least recently used assets are unloaded first.
+	std::vector<Asset*> GetAssetsToEvict(const std::vector<Asset*>& assets, unsigned int budget) const;
+
+private:
+	struct AssetRecord
+	{
+		// Approximate memory used by the asset.
+		unsigned int byteCount = 0;
+
+		// Use counter value when the asset was last requested - smaller is less recently used.
+		unsigned int lastUsed = 0;
+
+		// Number of references taken with Acquire.
+		int acquireCount = 0;
+
+		// Assets this asset depends on, and the number of loaded assets that depend on this one.
+		std::vector<Asset*> dependencies;
+		int dependentCount = 0;
+	};
+	std::unordered_map<Asset*, AssetRecord> mRecords;
+	unsigned int mUseCounter = 0;
+
+	// Assets referenced by the current scene.
+	std::unordered_set<Asset*> mSceneAssets;
+
+	// While assets are being created, collects the assets each one requests.
+	std::vector<std::vector<Asset*>> mDependencyStack;
+};
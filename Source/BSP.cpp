@@ -5,8 +5,10 @@
 //
 #include "BSP.h"
 
+#include <algorithm>
 #include <bitset>
 #include <iostream>
+#include <map>
 
 #include "BinaryReader.h"
 #include "BSPActor.h"
@@ -16,6 +18,8 @@
 #include "Vector2.h"
 #include "Vector3.h"
 
+bool BSP::sBatchedRenderingEnabled = true;
+
 BSP::BSP(std::string name, char* data, int dataLength) : Asset(name)
 {
     ParseFromData(data, dataLength);
@@ -27,107 +31,91 @@ BSP::BSP(std::string name, char* data, int dataLength) : Asset(name)
     
     // Use lightmap shader for material.
     mMaterial.SetShader(lightmapShader);
+    
+    // Batched rendering uses a variant of the lightmap shader with precalculated lightmap UVs.
+    Shader* batchedLightmapShader = Services::GetAssets()->LoadShader("3D-Lightmap-Batched", "3D-Lightmap");
+    if(batchedLightmapShader != nullptr)
+    {
+        batchedLightmapShader->Activate();
+        batchedLightmapShader->SetUniformInt("uLightmap", 1);
+        mBatchMaterial.SetShader(batchedLightmapShader);
+    }
+    else
+    {
+        mHasBatches = false;
+    }
 }
 
-bool BSP::RaycastNearest(const Ray& ray, RaycastHit& outHitInfo)
+BSP::~BSP()
 {
-	// Values for tracking closest found hit.
-    outHitInfo.t = FLT_MAX;
-    std::string* closest = nullptr;
-	
-	// Iterate through all polygons in the BSP and see if the ray intersects
-	// with any triangles inside the polygon. Triangles within the BSP are made
-	// up of "triangle fans", so the first vertex in a polygon is shared by all triangles.
-    for(auto& polygon : mPolygons)
+    // This class owns the lightmap atlas textures, so we must delete them.
+    for(auto& texture : mLightmapAtlasTextures)
     {
-        BSPSurface& surface = mSurfaces[polygon.surfaceIndex];
-        if(!surface.interactive) { continue; }
-		
-        Vector3 p0 = mVertices[mVertexIndices[polygon.vertexIndexOffset]];
-        for(int i = 1; i < polygon.vertexIndexCount - 1; i++)
-        {
-            Vector3 p1 = mVertices[mVertexIndices[polygon.vertexIndexOffset + i]];
-            Vector3 p2 = mVertices[mVertexIndices[polygon.vertexIndexOffset + i + 1]];
-			RaycastHit hitInfo;
-			if(Collisions::TestRayTriangle(ray, p0, p1, p2, hitInfo))
-            {
-                if(hitInfo.t < outHitInfo.t)
-                {
-					// Save closest distance.
-                    outHitInfo.t = hitInfo.t;
-                    
-                    // Find surface for this polygon, and then name for the surface.
-                    closest = &mObjectNames[surface.objectIndex];
-                }
-            }
-        }
+        delete texture;
     }
+    mLightmapAtlasTextures.clear();
+}
+
+bool BSP::RaycastNearest(const Ray& ray, RaycastHit& outHitInfo)
+{
+	// The BVH contains the triangle fans of all polygons in the BSP, tagged with polygon index.
+	// Non-interactive surfaces can change at runtime, so they're filtered out during the query.
+	TriangleBVH::Hit hit;
+	if(!mBVH.RaycastNearest(ray, hit, [this](int polygonIndex) {
+		return mSurfaces[mPolygons[polygonIndex].surfaceIndex].interactive;
+	}))
+	{
+		outHitInfo.t = FLT_MAX;
+		return false;
+	}
 	
-	// If no closest object was found, no hits occurred. Early out.
-	if(closest == nullptr) { return false; }
-	
-	// Otherwise, fill in out hit info and return.
-	outHitInfo.name = *closest;
+	// Fill in out hit info and return.
+	outHitInfo.t = hit.t;
+	outHitInfo.name = mObjectNames[mSurfaces[mPolygons[hit.id].surfaceIndex].objectIndex];
 	return true;
 }
 
 bool BSP::RaycastSingle(const Ray& ray, std::string name, RaycastHit& outHitInfo)
 {
-	for(auto& polygon : mPolygons)
+	// Couldn't find the given name?
+	int objectIndex = GetObjectIndex(name);
+	if(objectIndex == -1) { return false; }
+	
+	// We're only interested in intersections with a certain object.
+	// Each object has its own BVH, so only that object's polygons are tested.
+	TriangleBVH::Hit hit;
+	if(!mObjects[objectIndex].bvh.RaycastNearest(ray, hit, [this](int polygonIndex) {
+		return mSurfaces[mPolygons[polygonIndex].surfaceIndex].interactive;
+	}))
 	{
-		// We're only interested in intersections with a certain object.
-		// So, if this isn't the object, we can continue!
-        BSPSurface& surface = mSurfaces[polygon.surfaceIndex];
-        if(mObjectNames[surface.objectIndex] != name) { continue; }
-        if(!surface.interactive) { continue; }
-		
-        Vector3 p0 = mVertices[mVertexIndices[polygon.vertexIndexOffset]];
-        for(int i = 1; i < polygon.vertexIndexCount - 1; i++)
-		{
-            Vector3 p1 = mVertices[mVertexIndices[polygon.vertexIndexOffset + i]];
-            Vector3 p2 = mVertices[mVertexIndices[polygon.vertexIndexOffset + i + 1]];
-			if(Collisions::TestRayTriangle(ray, p0, p1, p2, outHitInfo))
-			{
-				// Save name of hit object.
-				outHitInfo.name = name;
-				return true;
-			}
-		}
+		// Ray didn't intersect object with given name.
+		return false;
 	}
 	
-	// Couldn't find the given name, or ray didn't intersect object with given name.
-	return false;
+	// Save hit distance and name of hit object.
+	outHitInfo.t = hit.t;
+	outHitInfo.name = name;
+	return true;
 }
 
 std::vector<RaycastHit> BSP::RaycastAll(const Ray& ray)
 {
-	std::vector<RaycastHit> hits;
+	std::vector<TriangleBVH::Hit> bvhHits;
+	mBVH.RaycastAll(ray, bvhHits, [this](int polygonIndex) {
+		return mSurfaces[mPolygons[polygonIndex].surfaceIndex].interactive;
+	});
 	
-	// Iterate through all polygons in the BSP and see if the ray intersects
-	// with any triangles inside the polygon. Triangles within the BSP are made
-	// up of "triangle fans", so the first vertex in a polygon is shared by all triangles.
-	for(auto& polygon : mPolygons)
+	// Convert to raycast hits, with hit object names.
+	std::vector<RaycastHit> hits;
+	hits.reserve(bvhHits.size());
+	for(auto& bvhHit : bvhHits)
 	{
-        BSPSurface& surface = mSurfaces[polygon.surfaceIndex];
-        if(!surface.interactive) { continue; }
-		
-        Vector3 p0 = mVertices[mVertexIndices[polygon.vertexIndexOffset]];
-        for(int i = 1; i < polygon.vertexIndexCount - 1; i++)
-		{
-            Vector3 p1 = mVertices[mVertexIndices[polygon.vertexIndexOffset + i]];
-            Vector3 p2 = mVertices[mVertexIndices[polygon.vertexIndexOffset + i + 1]];
-			RaycastHit hitInfo;
-			if(Collisions::TestRayTriangle(ray, p0, p1, p2, hitInfo))
-			{
-				// Save hit object name.
-                hitInfo.name = mObjectNames[surface.objectIndex];
-				
-				// Add to hit info vector.
-				hits.push_back(hitInfo);
-			}
-		}
+		RaycastHit hitInfo;
+		hitInfo.t = bvhHit.t;
+		hitInfo.name = mObjectNames[mSurfaces[mPolygons[bvhHit.id].surfaceIndex].objectIndex];
+		hits.push_back(hitInfo);
 	}
-
+	
 	// Return vector of hits.
 	return hits;
 }
@@ -150,205 +138,111 @@ bool BSP::RaycastPolygon(const Ray& ray, const BSPPolygon* polygon, RaycastHit&
 BSPActor* BSP::CreateBSPActor(const std::string& objectName)
 {
 	// Find index for object name or fail.
-	int objectIndex = -1;
-	for(int i = 0; i < mObjectNames.size(); i++)
-	{
-		if(StringUtil::EqualsIgnoreCase(mObjectNames[i], objectName))
-		{
-			objectIndex = i;
-			break;
-		}
-	}
+	int objectIndex = GetObjectIndex(objectName);
 	if(objectIndex == -1) { return nullptr; }
 	
 	// OK, we found it! Create the actor.
 	BSPActor* actor = new BSPActor(this, objectName);
 	
-	// Generate AABB from this BSP object's position data.
-	bool firstPoint = true;
-	AABB aabb;
-	for(int surfaceIndex = 0; surfaceIndex < mSurfaces.size(); surfaceIndex++)
+	// Give the actor this BSP object's surfaces and polygons.
+	const BSPObject& object = mObjects[objectIndex];
+	for(int surfaceIndex : object.surfaceIndexes)
 	{
-        if(mSurfaces[surfaceIndex].objectIndex == objectIndex)
-		{
-			actor->AddSurface(&mSurfaces[surfaceIndex]);
-			
-			for(int polygonIndex = 0; polygonIndex < mPolygons.size(); polygonIndex++)
-			{
-                if(mPolygons[polygonIndex].surfaceIndex == surfaceIndex)
-				{
-					actor->AddPolygon(&mPolygons[polygonIndex]);
-					
-                    int start = mPolygons[polygonIndex].vertexIndexOffset;
-                    int end = start + mPolygons[polygonIndex].vertexIndexCount;
-					for(int k = start; k < end; k++)
-					{
-						if(firstPoint)
-						{
-							aabb = AABB(mVertices[mVertexIndices[k]], mVertices[mVertexIndices[k]]);
-							firstPoint = false;
-						}
-						else
-						{
-							aabb.GrowToContain(mVertices[mVertexIndices[k]]);
-						}
-					}
-				}
-			}
-		}
+		actor->AddSurface(&mSurfaces[surfaceIndex]);
 	}
-	actor->SetAABB(aabb);
+	for(int polygonIndex : object.polygonIndexes)
+	{
+		actor->AddPolygon(&mPolygons[polygonIndex]);
+	}
+	actor->SetAABB(object.aabb);
 	
 	// Position actor at center of BSP object position.
-	actor->SetPosition(GetPosition(objectName));
+	actor->SetPosition(object.center);
 	return actor;
 }
 
 void BSP::SetVisible(std::string objectName, bool visible)
 {
-	// Find index of the object name.
-	int index = -1;
-	for(int i = 0; i < mObjectNames.size(); i++)
-	{
-		if(StringUtil::EqualsIgnoreCase(mObjectNames[i], objectName))
-		{
-			index = i;
-			break;
-		}
-	}
-	
 	// Can't hide an object if the passed name isn't present.
-	if(index == -1) { return; }
+	int objectIndex = GetObjectIndex(objectName);
+	if(objectIndex == -1) { return; }
 	
 	// All surfaces belonging to this object will be hidden.
-	for(auto& surface : mSurfaces)
+	for(int surfaceIndex : mObjects[objectIndex].surfaceIndexes)
 	{
-        if(surface.objectIndex == index)
-		{
-            surface.visible = visible;
-		}
+		mSurfaces[surfaceIndex].visible = visible;
 	}
 }
 
 void BSP::SetTexture(std::string objectName, Texture* texture)
 {
-	// Find index of the object name.
-	int index = -1;
-	for(int i = 0; i < mObjectNames.size(); i++)
-	{
-		if(StringUtil::EqualsIgnoreCase(mObjectNames[i], objectName))
-		{
-			index = i;
-			break;
-		}
-	}
-	
-	// Can't hide an object if the passed name isn't present.
-	if(index == -1) { return; }
+	// Can't set texture of an object if the passed name isn't present.
+	int objectIndex = GetObjectIndex(objectName);
+	if(objectIndex == -1) { return; }
 	
-	// All surfaces belonging to this object will be hidden.
-	for(auto& surface : mSurfaces)
+	// All surfaces belonging to this object will use the texture.
+	for(int surfaceIndex : mObjects[objectIndex].surfaceIndexes)
 	{
-        if(surface.objectIndex == index)
-		{
-            surface.texture = texture;
-		}
+		mSurfaces[surfaceIndex].texture = texture;
 	}
 }
 
 bool BSP::Exists(std::string objectName) const
 {
-	for(int i = 0; i < mObjectNames.size(); i++)
-	{
-		if(StringUtil::EqualsIgnoreCase(mObjectNames[i], objectName))
-		{
-			return true;
-		}
-	}
-	return false;
+	return GetObjectIndex(objectName) != -1;
 }
 
 bool BSP::IsVisible(std::string objectName) const
 {
-	// Find index of the object name.
-	int index = -1;
-	for(int i = 0; i < mObjectNames.size(); i++)
-	{
-		if(StringUtil::EqualsIgnoreCase(mObjectNames[i], objectName))
-		{
-			index = i;
-			break;
-		}
-	}
-	
 	// If can't find object name, it's certainly not visible...
-	if(index == -1) { return false; }
+	int objectIndex = GetObjectIndex(objectName);
+	if(objectIndex == -1) { return false; }
 	
 	// Find any surface belonging to this object and see if it is visible.
-	for(auto& surface : mSurfaces)
-	{
-        if(surface.objectIndex == index)
-		{
-            return surface.visible;
-		}
-	}
-	
 	// Worst case, no surfaces belong to this object. Must not be visible then!
-	return false;
+	const std::vector<int>& surfaceIndexes = mObjects[objectIndex].surfaceIndexes;
+	return !surfaceIndexes.empty() && mSurfaces[surfaceIndexes.front()].visible;
 }
 
 Vector3 BSP::GetPosition(const std::string& objectName) const
 {
-	// Find index of the object name.
-	int objectIndex = -1;
-	for(int i = 0; i < mObjectNames.size(); i++)
-	{
-		if(StringUtil::EqualsIgnoreCase(mObjectNames[i], objectName))
-		{
-			objectIndex = i;
-			break;
-		}
-	}
-	
 	// Couldn't find object!
 	//TODO: Maybe we should return true/false with an out parameter?
+	int objectIndex = GetObjectIndex(objectName);
 	if(objectIndex == -1) { return Vector3::Zero; }
 	
-	// Find index of a surface.
-	Vector3 pos = Vector3::Zero;
-	int vertexCount = 0;
-	for(int i = 0; i < mSurfaces.size(); i++)
-	{
-        if(mSurfaces[i].objectIndex == objectIndex)
-		{
-			for(int j = 0; j < mPolygons.size(); j++)
-			{
-                if(mPolygons[j].surfaceIndex == i)
-				{
-                    int start = mPolygons[j].vertexIndexOffset;
-                    int end = start + mPolygons[j].vertexIndexCount;
-					
-					for(int k = start; k < end; k++)
-					{
-						pos += mVertices[mVertexIndices[k]];
-						vertexCount++;
-					}
-				}
-			}
-		}
-	}
-	
-	// Get average position.
-	return pos / vertexCount;
+	// Object geometry never moves, so center is calculated once at load.
+	return mObjects[objectIndex].center;
 }
 
 void BSP::ApplyLightmap(const BSPLightmap& lightmap)
 {
-    const std::vector<Texture*>& lightmapTextures = lightmap.GetLightmapTextures();
-    for(int i = 0; i < mSurfaces.size(); ++i)
+    // Copy the lightmap into this BSP's atlas. Pages are reused, so applying another timeblock's lightmap only overwrites pixels.
+    lightmap.CopyToAtlas(mLightmapAtlasTextures);
+    
+    int count = Math::Min(static_cast<int>(mSurfaces.size()), lightmap.GetRegionCount());
+    for(int i = 0; i < count; ++i)
     {
-        mSurfaces[i].lightmapTexture = lightmapTextures[i];
+        BSPSurface& surface = mSurfaces[i];
+        const BSPLightmap::Region& region = lightmap.GetRegion(i);
+        surface.lightmapTexture = mLightmapAtlasTextures[region.page];
+        
+        // The file's offset/scale give a UV in the surface's own lightmap: (uv + offset) * scale.
+        // The atlas then maps that to: regionOffset + lightmapUV * regionScale.
+        // Combined, that's still (uv + offset') * scale', with scale' = scale * regionScale and offset' = offset + regionOffset / scale'.
+        // Always start from the file values, so applying a different timeblock's lightmap doesn't compound transforms.
+        Vector2 scale(surface.fileLightmapUvScale.x * region.uvScale.x,
+                      surface.fileLightmapUvScale.y * region.uvScale.y);
+        Vector2 offset = surface.fileLightmapUvOffset;
+        if(!Math::IsZero(scale.x)) { offset.x += region.uvOffset.x / scale.x; }
+        if(!Math::IsZero(scale.y)) { offset.y += region.uvOffset.y / scale.y; }
+        surface.lightmapUvScale = scale;
+        surface.lightmapUvOffset = offset;
     }
+    
+    // Batched geometry bakes lightmap UVs into vertices, so they must be updated.
+    // Batches themselves regroup on next render, since lightmap textures changed.
+    UpdateBatchLightmapUVs();
 }
 
 // For debugging BSP issues, helpful to track polygons rendered and tree depth.
@@ -357,6 +251,20 @@ int treeDepth = 0;
 
 void BSP::RenderOpaque(const Vector3& cameraPosition, const Vector3& cameraDirection)
 {
+    unsigned int startDrawCallCount = VertexArray::GetDrawCallCount();
+    
+    // Batched rendering draws all visible surfaces in a few draw calls, rather than drawing polygons while traversing the tree.
+    // The depth buffer takes care of draw order for opaque/alpha test geometry.
+    // The polygon set debug keys (see RenderTree) only affect tree rendering, so fall back on that while they're pressed.
+    bool polygonSetDebugKeyPressed = Services::GetInput()->IsKeyPressed(SDL_SCANCODE_Y) ||
+                                     Services::GetInput()->IsKeyPressed(SDL_SCANCODE_U);
+    if(sBatchedRenderingEnabled && mHasBatches && !polygonSetDebugKeyPressed)
+    {
+        RenderBatches(cameraPosition, cameraDirection);
+        mDrawCallCount = VertexArray::GetDrawCallCount() - startDrawCallCount;
+        return;
+    }
+    
     // Activate material for rendering.
     mMaterial.Activate(Matrix4::Identity);
     
@@ -369,6 +277,7 @@ void BSP::RenderOpaque(const Vector3& cameraPosition, const Vector3& cameraDirec
     //glPolygonMode(GL_FRONT_AND_BACK, GL_FILL);
     
     //std::cout << "Rendered " << renderedPolygonCount << " polygons." << std::endl;
+    mDrawCallCount = VertexArray::GetDrawCallCount() - startDrawCallCount;
 }
 
 void BSP::RenderTranslucent()
@@ -382,7 +291,8 @@ void BSP::RenderTranslucent()
     mAlphaPolygons = nullptr;
 }
 
-void BSP::RenderTree(const BSPNode& node, const Vector3& cameraPosition, const Vector3& cameraDirection)
+void BSP::GetTreeOrder(const BSPNode& node, const Vector3& cameraPosition, const Vector3& cameraDirection,
+                       bool& outRenderCurrent, int& outFirstNodeIndex, int& outSecondNodeIndex) const
 {
     // Check signed distance of point to plane to determine if point is in front of, behind, or on the plane.
     float signedDistance = mPlanes[node.planeIndex].GetSignedDistance(cameraPosition);
@@ -393,42 +303,51 @@ void BSP::RenderTree(const BSPNode& node, const Vector3& cameraPosition, const V
     
     // Determine render order for this node.
     // This makes a "front-to-back" renderer, resulting in no overdraw for opaque rendering.
-    bool renderCurrent = true;
-    int firstNodeIndex = -1;
-    int secondNodeIndex = -1;
+    outRenderCurrent = true;
+    outFirstNodeIndex = -1;
+    outSecondNodeIndex = -1;
     if(Math::IsZero(signedDistance))
     {
         // Point is on plane - render front and back trees. Don't render current node.
-        renderCurrent = false;
-        firstNodeIndex = node.frontChildIndex;
-        secondNodeIndex = node.backChildIndex;
+        outRenderCurrent = false;
+        outFirstNodeIndex = node.frontChildIndex;
+        outSecondNodeIndex = node.backChildIndex;
     }
     else if(signedDistance > 0.0f)
     {
         // Point is in front of plane - render front, then back trees.
-        firstNodeIndex = node.frontChildIndex;
-        secondNodeIndex = node.backChildIndex;
+        outFirstNodeIndex = node.frontChildIndex;
+        outSecondNodeIndex = node.backChildIndex;
         
         // If in front of plane AND facing away from plane, there's no need to render the back at all.
         float dot = Vector3::Dot(mPlanes[node.planeIndex].normal, cameraDirection);
         if(dot > kCameraFacingDot)
         {
-            secondNodeIndex = -1;
+            outSecondNodeIndex = -1;
         }
     }
     else
     {
         // Point is behind plane - render back, then front trees.
-        firstNodeIndex = node.backChildIndex;
-        secondNodeIndex = node.frontChildIndex;
+        outFirstNodeIndex = node.backChildIndex;
+        outSecondNodeIndex = node.frontChildIndex;
         
         // If behind plane AND facing away from plane, there's no need to render the front at all.
         float dot = Vector3::Dot(mPlanes[node.planeIndex].normal, cameraDirection);
         if(dot < -kCameraFacingDot)
         {
-            secondNodeIndex = -1;
+            outSecondNodeIndex = -1;
         }
     }
+}
+
+void BSP::RenderTree(const BSPNode& node, const Vector3& cameraPosition, const Vector3& cameraDirection)
+{
+    // Determine render order for this node, and which child trees can be skipped.
+    bool renderCurrent = true;
+    int firstNodeIndex = -1;
+    int secondNodeIndex = -1;
+    GetTreeOrder(node, cameraPosition, cameraDirection, renderCurrent, firstNodeIndex, secondNodeIndex);
     
     // Render first tree.
     if(firstNodeIndex >= 0 && firstNodeIndex < mNodes.size())
@@ -536,6 +455,265 @@ void BSP::RenderPolygon(BSPPolygon& polygon, bool translucent)
     mVertexArray.DrawTriangleFans(polygon.vertexIndexOffset, polygon.vertexIndexCount);
 }
 
+void BSP::BuildBatchGeometry()
+{
+    // Find polygons belonging to each surface.
+    std::vector<std::vector<int>> surfacePolygonIndexes(mSurfaces.size());
+    for(int polygonIndex = 0; polygonIndex < mPolygons.size(); polygonIndex++)
+    {
+        surfacePolygonIndexes[mPolygons[polygonIndex].surfaceIndex].push_back(polygonIndex);
+    }
+    
+    // Lightmap UVs differ per surface, so each surface needs its own copy of any vertex it uses.
+    // Track which batch vertex each BSP vertex maps to for the current surface.
+    std::vector<int> batchVertexIndexes(mVertices.size(), -1);
+    std::vector<int> batchVertexSurfaceIndexes(mVertices.size(), -1);
+    for(int surfaceIndex = 0; surfaceIndex < mSurfaces.size(); surfaceIndex++)
+    {
+        BSPSurface& surface = mSurfaces[surfaceIndex];
+        surface.triangleIndexOffset = static_cast<unsigned int>(mSurfaceTriangleIndexes.size());
+        for(int polygonIndex : surfacePolygonIndexes[surfaceIndex])
+        {
+            // Convert each triangle fan into a triangle list.
+            const BSPPolygon& polygon = mPolygons[polygonIndex];
+            for(int i = 1; i < polygon.vertexIndexCount - 1; i++)
+            {
+                unsigned short fanIndexes[3] = {
+                    mVertexIndices[polygon.vertexIndexOffset],
+                    mVertexIndices[polygon.vertexIndexOffset + i],
+                    mVertexIndices[polygon.vertexIndexOffset + i + 1]
+                };
+                for(unsigned short vertexIndex : fanIndexes)
+                {
+                    if(batchVertexSurfaceIndexes[vertexIndex] != surfaceIndex)
+                    {
+                        batchVertexSurfaceIndexes[vertexIndex] = surfaceIndex;
+                        batchVertexIndexes[vertexIndex] = static_cast<int>(mBatchVertices.size());
+                        mBatchVertices.push_back(mVertices[vertexIndex]);
+                        mBatchUVs.push_back(mUVs[vertexIndex]);
+                        mBatchVertexSurfaceIndexes.push_back(surfaceIndex);
+                    }
+                    mSurfaceTriangleIndexes.push_back(static_cast<unsigned short>(batchVertexIndexes[vertexIndex]));
+                }
+            }
+        }
+        surface.triangleIndexCount = static_cast<unsigned int>(mSurfaceTriangleIndexes.size()) - surface.triangleIndexOffset;
+    }
+    
+    // Indexes are 16-bit, so if duplicating vertices pushed us over the limit, this BSP can't be batched.
+    if(mBatchVertices.size() > 65535 || mBatchVertices.empty())
+    {
+        std::cout << "BSP " << GetName() << " has too many vertices for batched rendering - using per-polygon rendering." << std::endl;
+        mBatchVertices.clear();
+        mBatchUVs.clear();
+        mBatchVertexSurfaceIndexes.clear();
+        mSurfaceTriangleIndexes.clear();
+        return;
+    }
+    
+    // Calculate lightmap UVs and group surfaces into batches.
+    // Until the first render culls anything, every surface is in view.
+    mSurfacesInView.assign(mSurfaces.size(), true);
+    UpdateBatchLightmapUVs();
+    RebuildBatches();
+    
+    // Generate mesh definition.
+    MeshDefinition meshDefinition;
+    meshDefinition.meshUsage = MeshUsage::Dynamic;
+    
+    meshDefinition.vertexDefinition.layout = VertexDefinition::Layout::Packed;
+    meshDefinition.vertexDefinition.attributes.push_back(VertexAttribute::Position);
+    meshDefinition.vertexDefinition.attributes.push_back(VertexAttribute::UV1);
+    meshDefinition.vertexDefinition.attributes.push_back(VertexAttribute::UV2);
+    
+    meshDefinition.vertexCount = static_cast<int>(mBatchVertices.size());
+    
+    std::vector<float*> vertexData;
+    vertexData.push_back(reinterpret_cast<float*>(&mBatchVertices[0]));
+    vertexData.push_back(reinterpret_cast<float*>(&mBatchUVs[0]));
+    vertexData.push_back(reinterpret_cast<float*>(&mBatchLightmapUVs[0]));
+    meshDefinition.vertexData = &vertexData[0];
+    
+    meshDefinition.indexCount = static_cast<int>(mBatchIndexes.size());
+    meshDefinition.indexData = &mBatchIndexes[0];
+    
+    // Create vertex array.
+    mBatchVertexArray = VertexArray(meshDefinition);
+    mHasBatches = true;
+}
+
+void BSP::UpdateBatchLightmapUVs()
+{
+    // Same calculation the per-polygon lightmap shader does, but done once up front.
+    mBatchLightmapUVs.resize(mBatchUVs.size());
+    for(int i = 0; i < mBatchUVs.size(); i++)
+    {
+        const BSPSurface& surface = mSurfaces[mBatchVertexSurfaceIndexes[i]];
+        mBatchLightmapUVs[i] = Vector2((mBatchUVs[i].x + surface.lightmapUvOffset.x) * surface.lightmapUvScale.x,
+                                       (mBatchUVs[i].y + surface.lightmapUvOffset.y) * surface.lightmapUvScale.y);
+    }
+    
+    // If vertex array already exists, update its lightmap UVs.
+    if(mHasBatches)
+    {
+        mBatchVertexArray.ChangeVertexData(VertexAttribute::Semantic::UV2, &mBatchLightmapUVs[0]);
+    }
+}
+
+void BSP::RebuildBatches()
+{
+    // Group surfaces by texture/lightmap pair.
+    mBatches.clear();
+    std::map<std::pair<Texture*, Texture*>, int> batchIndexes;
+    for(int surfaceIndex = 0; surfaceIndex < mSurfaces.size(); surfaceIndex++)
+    {
+        BSPSurface& surface = mSurfaces[surfaceIndex];
+        if(surface.triangleIndexCount == 0) { continue; }
+        
+        auto key = std::make_pair(surface.texture, surface.lightmapTexture);
+        auto it = batchIndexes.find(key);
+        if(it == batchIndexes.end())
+        {
+            it = batchIndexes.insert(std::make_pair(key, static_cast<int>(mBatches.size()))).first;
+            mBatches.emplace_back();
+            mBatches.back().texture = surface.texture;
+            mBatches.back().lightmapTexture = surface.lightmapTexture;
+        }
+        
+        BSPBatch& batch = mBatches[it->second];
+        batch.surfaceIndexes.push_back(surfaceIndex);
+        batch.indexCapacity += surface.triangleIndexCount;
+    }
+    
+    // Reserve a range of the index buffer for each batch, and fill in visible surfaces.
+    mBatchIndexes.resize(mSurfaceTriangleIndexes.size());
+    unsigned int indexOffset = 0;
+    for(auto& batch : mBatches)
+    {
+        batch.indexOffset = indexOffset;
+        indexOffset += batch.indexCapacity;
+        FillBatchIndexes(batch);
+    }
+    
+    // If vertex array already exists, replace all its indexes.
+    if(mHasBatches)
+    {
+        mBatchVertexArray.ChangeIndexData(&mBatchIndexes[0], static_cast<unsigned int>(mBatchIndexes.size()));
+    }
+}
+
+void BSP::FillBatchIndexes(BSPBatch& batch)
+{
+    // Copy indexes of visible, in view surfaces into this batch's part of the index buffer.
+    batch.indexCount = 0;
+    batch.surfaceVisible.resize(batch.surfaceIndexes.size());
+    for(int i = 0; i < batch.surfaceIndexes.size(); i++)
+    {
+        const BSPSurface& surface = mSurfaces[batch.surfaceIndexes[i]];
+        batch.surfaceVisible[i] = surface.visible && mSurfacesInView[batch.surfaceIndexes[i]];
+        if(!batch.surfaceVisible[i]) { continue; }
+        
+        std::copy(mSurfaceTriangleIndexes.begin() + surface.triangleIndexOffset,
+                  mSurfaceTriangleIndexes.begin() + surface.triangleIndexOffset + surface.triangleIndexCount,
+                  mBatchIndexes.begin() + batch.indexOffset + batch.indexCount);
+        batch.indexCount += surface.triangleIndexCount;
+    }
+}
+
+void BSP::FindSurfacesInView(const BSPNode& node, const Vector3& cameraPosition, const Vector3& cameraDirection)
+{
+    // Same traversal and culling as RenderTree, but only notes which surfaces would be drawn.
+    bool renderCurrent = true;
+    int firstNodeIndex = -1;
+    int secondNodeIndex = -1;
+    GetTreeOrder(node, cameraPosition, cameraDirection, renderCurrent, firstNodeIndex, secondNodeIndex);
+    
+    if(firstNodeIndex >= 0 && firstNodeIndex < mNodes.size())
+    {
+        FindSurfacesInView(mNodes[firstNodeIndex], cameraPosition, cameraDirection);
+    }
+    if(renderCurrent)
+    {
+        if(node.polygonIndex != 65535)
+        {
+            for(int i = node.polygonIndex; i < node.polygonIndex + node.polygonCount; i++)
+            {
+                mSurfacesInView[mPolygons[i].surfaceIndex] = true;
+            }
+        }
+        if(node.polygonIndex2 != 65535)
+        {
+            for(int i = node.polygonIndex2; i < node.polygonIndex2 + node.polygonCount2; i++)
+            {
+                mSurfacesInView[mPolygons[i].surfaceIndex] = true;
+            }
+        }
+    }
+    if(secondNodeIndex >= 0 && secondNodeIndex < mNodes.size())
+    {
+        FindSurfacesInView(mNodes[secondNodeIndex], cameraPosition, cameraDirection);
+    }
+}
+
+void BSP::RenderBatches(const Vector3& cameraPosition, const Vector3& cameraDirection)
+{
+    // Cull using the tree, like tree rendering does. A surface is drawn whole if any of its polygons aren't culled.
+    std::fill(mSurfacesInView.begin(), mSurfacesInView.end(), false);
+    FindSurfacesInView(mNodes[mRootNodeIndex], cameraPosition, cameraDirection);
+    
+    // Surfaces can be changed directly (e.g. by BSP actors), and culling changes as the camera moves, so check for changes since last render.
+    // A texture change means surfaces must be regrouped. A visibility change only requires refilling that surface's batch.
+    bool regroup = false;
+    for(auto& batch : mBatches)
+    {
+        bool visibilityChanged = false;
+        for(int i = 0; i < batch.surfaceIndexes.size(); i++)
+        {
+            const BSPSurface& surface = mSurfaces[batch.surfaceIndexes[i]];
+            if(surface.texture != batch.texture || surface.lightmapTexture != batch.lightmapTexture)
+            {
+                regroup = true;
+                break;
+            }
+            visibilityChanged |= ((surface.visible && mSurfacesInView[batch.surfaceIndexes[i]]) != batch.surfaceVisible[i]);
+        }
+        if(regroup) { break; }
+        
+        if(visibilityChanged)
+        {
+            FillBatchIndexes(batch);
+            mBatchVertexArray.ChangeIndexData(&mBatchIndexes[batch.indexOffset], batch.indexOffset, batch.indexCapacity);
+        }
+    }
+    if(regroup)
+    {
+        RebuildBatches();
+    }
+    
+    // Activate material for rendering.
+    mBatchMaterial.Activate(Matrix4::Identity);
+    
+    // One draw call per batch.
+    for(auto& batch : mBatches)
+    {
+        if(batch.indexCount == 0) { continue; }
+        
+        if(batch.texture != nullptr)
+        {
+            batch.texture->Activate(0);
+        }
+        else
+        {
+            Texture::Deactivate();
+        }
+        if(batch.lightmapTexture != nullptr)
+        {
+            batch.lightmapTexture->Activate(1);
+        }
+        mBatchVertexArray.DrawTriangles(batch.indexOffset, batch.indexCount);
+    }
+}
+
 void BSP::ParseFromData(char *data, int dataLength)
 {
     BinaryReader reader(data, dataLength);
@@ -573,15 +751,20 @@ void BSP::ParseFromData(char *data, int dataLength)
     }
     
     // Iterate and read surfaces.
+    // Texture names are collected so all textures can be loaded as one batch afterwards.
+    std::vector<std::string> surfaceTextureNames;
+    surfaceTextureNames.reserve(surfaceCount);
     for(int i = 0; i < surfaceCount; i++)
     {
         BSPSurface surface;
         surface.objectIndex = reader.ReadUInt();
         
-        surface.texture = Services::GetAssets()->LoadTexture(reader.ReadString(32));
+        surfaceTextureNames.push_back(reader.ReadString(32));
         
         surface.lightmapUvOffset = reader.ReadVector2();
         surface.lightmapUvScale = reader.ReadVector2();
+        surface.fileLightmapUvOffset = surface.lightmapUvOffset;
+        surface.fileLightmapUvScale = surface.lightmapUvScale;
         
         reader.ReadFloat(); // Unknown - I had assumed this was a scale earlier, but I'm not sure.
         
@@ -615,6 +798,13 @@ void BSP::ParseFromData(char *data, int dataLength)
         mSurfaces.push_back(surface);
     }
     
+    // Load all surface textures at once - much faster than loading one at a time, since barn extraction happens in parallel.
+    Services::GetAssets()->LoadTextures(surfaceTextureNames);
+    for(int i = 0; i < surfaceCount; i++)
+    {
+        mSurfaces[i].texture = Services::GetAssets()->LoadTexture(surfaceTextureNames[i]);
+    }
+    
     // Iterate and read nodes.
     for(int i = 0; i < nodeCount; i++)
     {
@@ -715,6 +905,9 @@ void BSP::ParseFromData(char *data, int dataLength)
     }
     */
     
+    // Geometry is static, so per-object data and raycast acceleration structures only need to be built once.
+    BuildObjects();
+    
     // Generate mesh definition.
     MeshDefinition meshDefinition;
     meshDefinition.meshUsage = MeshUsage::Static;
@@ -735,4 +928,92 @@ void BSP::ParseFromData(char *data, int dataLength)
     
     // Create vertex array.
     mVertexArray = VertexArray(meshDefinition);
+    
+    // Also create geometry for batched rendering.
+    BuildBatchGeometry();
+}
+
+int BSP::GetObjectIndex(const std::string& objectName) const
+{
+	// Object names are case-insensitive, so names are stored upper-case.
+	auto it = mObjectIndexes.find(StringUtil::ToUpperCopy(objectName));
+	return it != mObjectIndexes.end() ? it->second : -1;
+}
+
+void BSP::BuildObjects()
+{
+	// Map names to object indexes. If names are duplicated, the first object with the name is used.
+	mObjects.resize(mObjectNames.size());
+	for(int i = 0; i < mObjectNames.size(); i++)
+	{
+		mObjectIndexes.insert(std::make_pair(StringUtil::ToUpperCopy(mObjectNames[i]), i));
+	}
+	
+	// Record which surfaces and polygons belong to each object.
+	// Surfaces with a bad object index aren't part of any object, so they can't be found by name or hit by raycasts.
+	for(int surfaceIndex = 0; surfaceIndex < mSurfaces.size(); surfaceIndex++)
+	{
+		unsigned int objectIndex = mSurfaces[surfaceIndex].objectIndex;
+		if(objectIndex >= mObjects.size())
+		{
+			std::cout << "BSP " << GetName() << " surface " << surfaceIndex << " has invalid object index " << objectIndex << " - ignoring it." << std::endl;
+			continue;
+		}
+		mObjects[objectIndex].surfaceIndexes.push_back(surfaceIndex);
+	}
+	for(int polygonIndex = 0; polygonIndex < mPolygons.size(); polygonIndex++)
+	{
+		unsigned int objectIndex = mSurfaces[mPolygons[polygonIndex].surfaceIndex].objectIndex;
+		if(objectIndex >= mObjects.size()) { continue; }
+		mObjects[objectIndex].polygonIndexes.push_back(polygonIndex);
+	}
+	
+	for(auto& object : mObjects)
+	{
+		// Calculate AABB and center (average vertex position) of each object.
+		Vector3 pos = Vector3::Zero;
+		int vertexCount = 0;
+		for(int polygonIndex : object.polygonIndexes)
+		{
+			int start = mPolygons[polygonIndex].vertexIndexOffset;
+			int end = start + mPolygons[polygonIndex].vertexIndexCount;
+			for(int k = start; k < end; k++)
+			{
+				const Vector3& vertex = mVertices[mVertexIndices[k]];
+				if(vertexCount == 0)
+				{
+					object.aabb = AABB(vertex, vertex);
+				}
+				else
+				{
+					object.aabb.GrowToContain(vertex);
+				}
+				pos += vertex;
+				vertexCount++;
+			}
+		}
+		if(vertexCount > 0)
+		{
+			object.center = pos / vertexCount;
+		}
+		
+		// Add triangles of each polygon to the object's BVH.
+		// Triangles within the BSP are made up of "triangle fans", so the first vertex in a polygon is shared by all triangles.
+		for(int polygonIndex : object.polygonIndexes)
+		{
+			const BSPPolygon& polygon = mPolygons[polygonIndex];
+			Vector3 p0 = mVertices[mVertexIndices[polygon.vertexIndexOffset]];
+			for(int i = 1; i < polygon.vertexIndexCount - 1; i++)
+			{
+				Vector3 p1 = mVertices[mVertexIndices[polygon.vertexIndexOffset + i]];
+				Vector3 p2 = mVertices[mVertexIndices[polygon.vertexIndexOffset + i + 1]];
+				mBVH.AddTriangle(p0, p1, p2, polygonIndex);
+				object.bvh.AddTriangle(p0, p1, p2, polygonIndex);
+			}
+		}
+		object.bvh.Build();
+	}
+	
+	// BVH for the entire BSP is built from all objects' triangles.
+	mBVH.Build();
 }
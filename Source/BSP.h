@@ -12,11 +12,13 @@
 #include <unordered_map>
 #include <vector>
 
+#include "AABB.h"
 #include "Material.h"
 #include "Mesh.h"
 #include "Plane.h"
 #include "Ray.h"
 #include "Collisions.h"
+#include "TriangleBVH.h"
 #include "Vector2.h"
 #include "Vector3.h"
 
@@ -76,14 +78,19 @@ struct BSPSurface
     Texture* texture = nullptr;
     
     // An optional lightmap texture - applied from a lightmap asset.
-    //TODO: this works OK, but it'd be more efficient to use a lightmap atlas instead of many individual textures.
+    // This is one of the BSP's lightmap atlas pages, shared by many surfaces.
     Texture* lightmapTexture = nullptr;
     
     // UVs used for the lightmap are often different from the UVs used for diffuse textures.
     // The surface defines offset/scale to apply to each UV to properly render a lightmap on that surface.
+    // When a lightmap is applied, its atlas transform is folded into these values.
     Vector2 lightmapUvOffset;
     Vector2 lightmapUvScale;
     
+    // Offset/scale as read from the BSP file, before any atlas transform is folded in.
+    Vector2 fileLightmapUvOffset;
+    Vector2 fileLightmapUvScale;
+    
     // Flags defining surface properties.
     unsigned int flags = 0;
     
@@ -100,12 +107,53 @@ struct BSPSurface
 	
 	// If true, interactive (can be hit by raycasts).
 	bool interactive = true;
+    
+    // For batched rendering, this surface's polygons are triangulated into a triangle list.
+    // This is an offset + count into the batched triangle index list.
+    unsigned int triangleIndexOffset = 0;
+    unsigned int triangleIndexCount = 0;
+};
+
+// For batched rendering, surfaces using the same textures are drawn together with one draw call.
+struct BSPBatch
+{
+    // Textures used by all surfaces in this batch.
+    Texture* texture = nullptr;
+    Texture* lightmapTexture = nullptr;
+    
+    // Surfaces in this batch, and whether each was drawn (visible and not culled) when the batch's indexes were last filled.
+    std::vector<int> surfaceIndexes;
+    std::vector<bool> surfaceVisible;
+    
+    // Range of the batched index buffer reserved for this batch - enough to hold every surface in the batch.
+    // Only visible surfaces' indexes are filled in, so count may be less than capacity.
+    unsigned int indexOffset = 0;
+    unsigned int indexCapacity = 0;
+    unsigned int indexCount = 0;
+};
+
+// An object is a named group of surfaces (see above).
+// Data is precomputed at load, since object geometry never moves.
+struct BSPObject
+{
+    // Surfaces and polygons belonging to this object.
+    std::vector<int> surfaceIndexes;
+    std::vector<int> polygonIndexes;
+    
+    // Bounds and center (average vertex position) of the object's geometry.
+    AABB aabb;
+    Vector3 center;
+    
+    // Acceleration structure for raycasts against only this object.
+    // Triangles are tagged with polygon index.
+    TriangleBVH bvh;
 };
 
 class BSP : public Asset
 {
 public:
     BSP(std::string name, char* data, int dataLength);
+    ~BSP();
     
 	BSPActor* CreateBSPActor(const std::string& objectName);
 	
@@ -126,8 +174,17 @@ public:
     
     void RenderOpaque(const Vector3& cameraPosition, const Vector3& cameraDirection);
     void RenderTranslucent();
+    
+    // Number of draw calls issued during the last opaque render.
+    unsigned int GetDrawCallCount() const { return mDrawCallCount; }
+    
+    // If enabled, BSP is rendered with a few draw calls per texture pair, rather than one draw call per polygon.
+    static void SetBatchedRenderingEnabled(bool enabled) { sBatchedRenderingEnabled = enabled; }
+    static bool IsBatchedRenderingEnabled() { return sBatchedRenderingEnabled; }
 	
 private:
+    static bool sBatchedRenderingEnabled;
+    
     // Identifies the root node in the node list.
     // Rendering always starts from this node.
     unsigned int mRootNodeIndex = 0;
@@ -153,6 +210,12 @@ private:
     // Each BSP map is logically divided into objects.
     std::vector<std::string> mObjectNames;
     
+    // Per-object data, indexed by object index.
+    std::vector<BSPObject> mObjects;
+    
+    // Maps upper-case object name to object index, for fast case-insensitive lookups.
+    std::unordered_map<std::string, int> mObjectIndexes;
+    
     // Vertex attributes for BSP mesh.
     std::vector<Vector3> mVertices;
     std::vector<Vector2> mUVs;
@@ -166,8 +229,54 @@ private:
     // Material for rendering BSP.
 	Material mMaterial;
     
+    // Atlas textures that surface lightmaps are copied into when a lightmap is applied.
+    // Unlike most Textures, this asset owns these Textures, and is responsible for cleanup!
+    std::vector<Texture*> mLightmapAtlasTextures;
+    
+    // For batched rendering, a copy of the BSP geometry triangulated per surface.
+    // Each surface gets its own copy of its vertices, with lightmap UVs (offset/scale already applied) as a vertex attribute.
+    std::vector<Vector3> mBatchVertices;
+    std::vector<Vector2> mBatchUVs;
+    std::vector<Vector2> mBatchLightmapUVs;
+    std::vector<int> mBatchVertexSurfaceIndexes;
+    
+    // Triangle list indexes for each surface, and the index buffer contents built from them (grouped by batch).
+    std::vector<unsigned short> mSurfaceTriangleIndexes;
+    std::vector<unsigned short> mBatchIndexes;
+    
+    // Batches of surfaces that can be drawn together.
+    std::vector<BSPBatch> mBatches;
+    
+    // For batched rendering, whether each surface has polygons in a part of the tree that wasn't culled this frame.
+    std::vector<bool> mSurfacesInView;
+    
+    // Vertex array and material used for batched rendering.
+    // Vertex array is empty if the BSP couldn't be batched.
+    VertexArray mBatchVertexArray;
+    Material mBatchMaterial;
+    bool mHasBatches = false;
+    
+    // Draw calls issued during last opaque render.
+    unsigned int mDrawCallCount = 0;
+	
+	// Acceleration structure for raycasts against the entire BSP.
+	// Triangles are tagged with polygon index.
+	TriangleBVH mBVH;
+    
+    void GetTreeOrder(const BSPNode& node, const Vector3& cameraPosition, const Vector3& cameraDirection,
+                      bool& outRenderCurrent, int& outFirstNodeIndex, int& outSecondNodeIndex) const;
     void RenderTree(const BSPNode& node, const Vector3& cameraPosition, const Vector3& cameraDirection);
     void RenderPolygon(BSPPolygon& polygon, bool translucent);
     
+    void BuildBatchGeometry();
+    void UpdateBatchLightmapUVs();
+    void RebuildBatches();
+    void FillBatchIndexes(BSPBatch& batch);
+    void FindSurfacesInView(const BSPNode& node, const Vector3& cameraPosition, const Vector3& cameraDirection);
+    void RenderBatches(const Vector3& cameraPosition, const Vector3& cameraDirection);
+    
     void ParseFromData(char* data, int dataLength);
+	void BuildObjects();
+	
+	int GetObjectIndex(const std::string& objectName) const;
 };
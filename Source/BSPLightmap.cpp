@@ -6,6 +6,7 @@
 #include "BSPLightmap.h"
 
 #include "BinaryReader.h"
+#include "RectPacker.h"
 #include "Texture.h"
 
 BSPLightmap::BSPLightmap(std::string name, char* data, int dataLength) :
@@ -26,23 +27,44 @@ BSPLightmap::BSPLightmap(std::string name, char* data, int dataLength) :
     unsigned int bitmapCount = reader.ReadUInt();
     
     // Iterate and read in each bitmap in turn.
+    mLightmapTextures.reserve(bitmapCount);
     for(unsigned int i = 0; i < bitmapCount; i++)
     {
         // The texture will be read in using the same reader object.
         // This should leave the reader ready to read in the NEXT texture (assuming no texture parsing bugs).
-        Texture* texture = new Texture(reader);
-        texture->SetFilterMode(Texture::FilterMode::Bilinear);
-        texture->SetWrapMode(Texture::WrapMode::Clamp);
-        mLightmapTextures.push_back(texture);
+        mLightmapTextures.push_back(new Texture(reader));
     }
     
-    /*
-    // Write out for debugging...
-    for(int i = 0; i < mLightmapTextures.size(); i++)
+    // Figure out where each lightmap goes in the atlas, including its border.
+    // Packing only depends on lightmap sizes. Lightmaps for other timeblocks of the same BSP have the same sizes, so they get the same layout.
+    RectPacker packer(kAtlasSize, kAtlasSize);
+    for(auto& texture : mLightmapTextures)
     {
-        mLightmapTextures[i]->WriteToFile(GetNameNoExtension() + "_lm_" + std::to_string(i) + ".bmp");
+        packer.Add(texture->GetWidth() + kAtlasBorder * 2, texture->GetHeight() + kAtlasBorder * 2);
+    }
+    packer.Pack();
+    
+    for(int i = 0; i < packer.GetPageCount(); i++)
+    {
+        mPageWidths.push_back(packer.GetPageWidth(i));
+        mPageHeights.push_back(packer.GetPageHeight(i));
+    }
+    
+    mRegions.resize(bitmapCount);
+    for(unsigned int i = 0; i < bitmapCount; i++)
+    {
+        const RectPacker::Placement& placement = packer.GetPlacement(i);
+        Region& region = mRegions[i];
+        region.page = placement.page;
+        region.x = placement.x + kAtlasBorder;
+        region.y = placement.y + kAtlasBorder;
+        
+        // Texture pixels are stored from the top-left, and UVs are flipped to match, so no need to flip Y here.
+        float pageWidth = static_cast<float>(mPageWidths[region.page]);
+        float pageHeight = static_cast<float>(mPageHeights[region.page]);
+        region.uvOffset = Vector2(region.x / pageWidth, region.y / pageHeight);
+        region.uvScale = Vector2(mLightmapTextures[i]->GetWidth() / pageWidth, mLightmapTextures[i]->GetHeight() / pageHeight);
     }
-    */
 }
 
 BSPLightmap::~BSPLightmap()
@@ -54,3 +76,66 @@ BSPLightmap::~BSPLightmap()
     }
     mLightmapTextures.clear();
 }
+
+void BSPLightmap::CopyToAtlas(std::vector<Texture*>& atlasTextures) const
+{
+    // Make sure there's a page of the right size for each page in the layout.
+    // Extra pages from a previous layout are deleted.
+    for(size_t i = mPageWidths.size(); i < atlasTextures.size(); i++)
+    {
+        delete atlasTextures[i];
+    }
+    atlasTextures.resize(mPageWidths.size(), nullptr);
+    for(size_t i = 0; i < atlasTextures.size(); i++)
+    {
+        Texture*& atlas = atlasTextures[i];
+        if(atlas != nullptr && static_cast<int>(atlas->GetWidth()) == mPageWidths[i] && static_cast<int>(atlas->GetHeight()) == mPageHeights[i]) { continue; }
+        
+        delete atlas;
+        atlas = new Texture(mPageWidths[i], mPageHeights[i], Color32::Black);
+        atlas->SetFilterMode(Texture::FilterMode::Bilinear);
+        atlas->SetWrapMode(Texture::WrapMode::Clamp);
+    }
+    
+    // Copy each lightmap into its place in the atlas.
+    for(size_t i = 0; i < mRegions.size(); i++)
+    {
+        const Texture& source = *mLightmapTextures[i];
+        const Region& region = mRegions[i];
+        Texture& atlas = *atlasTextures[region.page];
+        
+        int width = source.GetWidth();
+        int height = source.GetHeight();
+        int x = region.x;
+        int y = region.y;
+        Texture::CopyPixels(source, atlas, x, y);
+        if(width <= 0 || height <= 0) { continue; }
+        
+        // Fill border by extending the lightmap's edge pixels outwards (top, bottom, left, right, then corners).
+        for(int b = 1; b <= kAtlasBorder; b++)
+        {
+            Texture::CopyPixels(source, 0, 0, width, 1, atlas, x, y - b);
+            Texture::CopyPixels(source, 0, height - 1, width, 1, atlas, x, y + height - 1 + b);
+            Texture::CopyPixels(source, 0, 0, 1, height, atlas, x - b, y);
+            Texture::CopyPixels(source, width - 1, 0, 1, height, atlas, x + width - 1 + b, y);
+        }
+        for(int by = 1; by <= kAtlasBorder; by++)
+        {
+            for(int bx = 1; bx <= kAtlasBorder; bx++)
+            {
+                Texture::CopyPixels(source, 0, 0, 1, 1, atlas, x - bx, y - by);
+                Texture::CopyPixels(source, width - 1, 0, 1, 1, atlas, x + width - 1 + bx, y - by);
+                Texture::CopyPixels(source, 0, height - 1, 1, 1, atlas, x - bx, y + height - 1 + by);
+                Texture::CopyPixels(source, width - 1, height - 1, 1, 1, atlas, x + width - 1 + bx, y + height - 1 + by);
+            }
+        }
+    }
+    
+    /*
+    // Write out for debugging...
+    for(int i = 0; i < atlasTextures.size(); i++)
+    {
+        atlasTextures[i]->WriteToFile(GetNameNoExtension() + "_lm_" + std::to_string(i) + ".bmp");
+    }
+    */
+}
@@ -3,8 +3,8 @@
 //
 // Clark Kromenaker
 //
-// A lightmap for BSP geometry. Contains an array of textures meant to
-// be applied to BSP surfaces to give the appearance of light and shadows.
+// A lightmap for BSP geometry. Contains textures meant to be applied
+// to BSP surfaces to give the appearance of light and shadows.
 //
 // Each lightmap is meant for a specific BSP geometry. A BSP may have multiple
 // lightmaps (e.g. a lightmap for morning, one for evening, one for night).
@@ -12,25 +12,63 @@
 // In-memory representation of .MUL files. The MUL file format is basically
 // a blob containing one or more BMP files.
 //
+// The MUL contains one small bitmap per BSP surface. Rather than render with hundreds
+// of tiny textures, they are packed into one or a few atlas textures, owned by the BSP.
+//
 #pragma once
 #include "Asset.h"
 
 #include <string>
 #include <vector>
 
+#include "Vector2.h"
+
 class Texture;
 
 class BSPLightmap : public Asset
 {
 public:
+    // Where a single surface's lightmap goes in the atlas.
+    struct Region
+    {
+        // Atlas page containing this surface's lightmap, and position of the lightmap's top-left corner on that page.
+        int page = 0;
+        int x = 0;
+        int y = 0;
+        
+        // Maps a 0-1 UV in the original lightmap to a UV in the atlas: atlasUV = uvOffset + uv * uvScale.
+        Vector2 uvOffset;
+        Vector2 uvScale = Vector2::One;
+    };
+    
     BSPLightmap(std::string name, char* data, int dataLength);
     ~BSPLightmap();
     
-    const std::vector<Texture*>& GetLightmapTextures() const { return mLightmapTextures; }
+    // Order is important, and aligns with order of surfaces in BSP file.
+    int GetRegionCount() const { return static_cast<int>(mRegions.size()); }
+    const Region& GetRegion(int index) const { return mRegions[index]; }
+    
+    // Copies every lightmap into the atlas textures, creating or replacing any pages that are missing or the wrong size.
+    // Pages that already exist have their pixels overwritten. Lightmaps for other timeblocks of the same BSP
+    // have the same layout, so switching timeblocks reuses the same textures.
+    void CopyToAtlas(std::vector<Texture*>& atlasTextures) const;
     
 private:
-    // Textures loaded from the MUL file.
-    // Order is important, and aligns with order of surfaces in BSP file.
+    // Max size of each atlas page. Most scenes fit in a single page.
+    static const int kAtlasSize = 1024;
+    
+    // Pixels around each lightmap in the atlas, filled by extending the lightmap's edge pixels outwards.
+    // Keeps bilinear filtering at a lightmap's edge, and UVs slightly outside the lightmap, from pulling in a neighbor's pixels.
+    static const int kAtlasBorder = 4;
+    
+    // Textures for bitmaps in the MUL file. These are only copied into the atlas - never rendered directly.
     // Unlike most Textures, this asset owns these Textures, and is responsible for cleanup!
     std::vector<Texture*> mLightmapTextures;
+    
+    // One region per bitmap in the MUL file.
+    std::vector<Region> mRegions;
+    
+    // Size of each atlas page.
+    std::vector<int> mPageWidths;
+    std::vector<int> mPageHeights;
 };
@@ -6,6 +6,8 @@
 //
 #include "BarnFile.h"
 
+#include <algorithm>
+#include <cstring>
 #include <fstream>
 #include <iostream>
 #include <vector>
@@ -13,15 +15,38 @@
 #include "minilzo.h"
 #include "zlib.h"
 
+#include "BinaryReader.h"
 #include "FileSystem.h"
+#include "MemoryMappedFile.h"
 #include "Texture.h"
 
-BarnFile::BarnFile(const std::string& filePath) :
-    mName(filePath),
-    mReader(filePath)
+BarnFile::BarnFile(const std::string& filePath, bool memoryMap) :
+    mName(filePath)
 {
+	// If desired, map the entire file into memory, so assets can be read without seeking/copying through a stream.
+	if(memoryMap)
+	{
+		mMappedFile = new MemoryMappedFile(filePath);
+		if(!mMappedFile->IsMapped())
+		{
+			std::cout << "Can't memory map barn file at " << filePath << " - falling back to file stream." << std::endl;
+			delete mMappedFile;
+			mMappedFile = nullptr;
+		}
+	}
+	
+	// Read from the mapping if we have one; otherwise, read from a file stream.
+	if(mMappedFile != nullptr)
+	{
+		mReader = new BinaryReader(mMappedFile->GetData(), mMappedFile->GetLength());
+	}
+	else
+	{
+		mReader = new BinaryReader(filePath);
+	}
+	
     // Make sure we can actually read this file.
-    if(!mReader.OK())
+    if(!mReader->OK())
     {
 		std::cout << "Can't read barn file at " << filePath << std::endl;
         return;
@@ -29,8 +54,8 @@ BarnFile::BarnFile(const std::string& filePath) :
     
 	// 8 bytes: two specific 4-byte ints must appear at the beginning of the file.
     // In text form, this is a string "GK3!Barn".
-    unsigned int gameIdentifier = mReader.ReadUInt();
-    unsigned int barnIdentifier = mReader.ReadUInt();
+    unsigned int gameIdentifier = mReader->ReadUInt();
+    unsigned int barnIdentifier = mReader->ReadUInt();
     if(gameIdentifier != kGameIdentifier && barnIdentifier != kBarnIdentifier)
     {
 		std::cout << "Invalid file type!" << std::endl;
@@ -40,64 +65,64 @@ BarnFile::BarnFile(const std::string& filePath) :
     // 4-bytes: unknown constant value (65536)
 	// 4-bytes: unknown constant value (65536)
 	// 4-bytes: appears to be file size, or size of assets in BRN bundle.
-	mReader.Skip(12);
+	mReader->Skip(12);
     
     // This value indicates the offset past the file header data to what I'd
     // call the "table of contents" or "toc".
-    unsigned int tocOffset = mReader.ReadUInt();
+    unsigned int tocOffset = mReader->ReadUInt();
 
     // This additional header data can be read in if desired, but it
     // isn't really relevant to the file functionality.
     /*
     {
         // 4-bytes: EXE/Content build # (119 in both cases)
-        mReader.ReadUInt();
-        mReader.ReadUInt();
+        mReader->ReadUInt();
+        mReader->ReadUInt();
         
         // 4-bytes: unknown value
-        mReader.ReadUInt();
+        mReader->ReadUInt();
         
         // Two dates, 2-bytes per element.
         // The dates are both on the same day, just a few minutes apart.
         // Maybe like a build start/end time for the bundles?
         short year, month, day, hour, minute, second;
-        year = mReader.ReadShort();
-        month = mReader.ReadShort();
-        mReader.ReadShort(); // unknown value
-        day = mReader.ReadShort();
-        hour = mReader.ReadShort();
-        minute = mReader.ReadShort();
-        second = mReader.ReadShort();
+        year = mReader->ReadShort();
+        month = mReader->ReadShort();
+        mReader->ReadShort(); // unknown value
+        day = mReader->ReadShort();
+        hour = mReader->ReadShort();
+        minute = mReader->ReadShort();
+        second = mReader->ReadShort();
         cout << year << "/" << month << "/" << day << ", " << hour << ":" << minute << ":" << second << endl;
         
         // 2-bytes: unknown variable value.
-        mReader.ReadShort();
+        mReader->ReadShort();
         
-        year = mReader.ReadShort();
-        month = mReader.ReadShort();
-        mReader.ReadShort(); // unknown value
-        day = mReader.ReadShort();
-        hour = mReader.ReadShort();
-        minute = mReader.ReadShort();
-        second = mReader.ReadShort();
+        year = mReader->ReadShort();
+        month = mReader->ReadShort();
+        mReader->ReadShort(); // unknown value
+        day = mReader->ReadShort();
+        hour = mReader->ReadShort();
+        minute = mReader->ReadShort();
+        second = mReader->ReadShort();
         cout << year << "/" << month << "/" << day << ", " << hour << ":" << minute << ":" << second << endl;
         
         // 2-bytes: unknown variable value.
-        mReader.ReadShort();
+        mReader->ReadShort();
         
         // Copyright notice!
         char copyright[65];
-        mReader.Read(copyright, 64);
+        mReader->Read(copyright, 64);
         copyright[64] = '\0';
         cout << copyright << endl;
     }
     */
     
     // Seek to table of contents offset.
-    mReader.Seek(tocOffset);
+    mReader->Seek(tocOffset);
     
     // First value in toc is number of toc entries.
-    unsigned int tocEntryCount = mReader.ReadUInt();
+    unsigned int tocEntryCount = mReader->ReadUInt();
     
     // Each toc entry will specify a header offset and a data offset.
 	std::vector<unsigned int> headerOffsets;
@@ -112,17 +137,17 @@ BarnFile::BarnFile(const std::string& filePath) :
         // The type is either "DDir" or "Data".
         // DDir specifies a directory of assets.
         // Data specifies file offset to start reading actual data.
-        unsigned int type = mReader.ReadUInt();
+        unsigned int type = mReader->ReadUInt();
         
         // Some unknown values.
-        mReader.ReadUInt();
-        mReader.ReadUInt();
-        mReader.ReadUInt();
-        mReader.ReadUInt();
+        mReader->ReadUInt();
+        mReader->ReadUInt();
+        mReader->ReadUInt();
+        mReader->ReadUInt();
         
         // Read header and data offsets.
-        unsigned int headerOffset = mReader.ReadUInt();
-        unsigned int dataOffset = mReader.ReadUInt();
+        unsigned int headerOffset = mReader->ReadUInt();
+        unsigned int dataOffset = mReader->ReadUInt();
         
         // For DDir, we'll save the offsets so we can iterate over them below.
         // For Data, we'll just save the data offset value.
@@ -141,30 +166,30 @@ BarnFile::BarnFile(const std::string& filePath) :
     // The header specifies data that is common to all assets in the data section.
     for(int i = 0; i < headerOffsets.size(); i++)
     {
-        mReader.Seek(headerOffsets[i]);
+        mReader->Seek(headerOffsets[i]);
         
         // The name of the Barn file for these assets. NOTE that it appears
         // a Barn file can contain "pointers" to assets in other Barn files.
         // If this name is empty, it means the asset is contained within THIS Barn file.
         // However, if the name isn't empty, it means the asset is in another Barn file.
         char barnFileName[33];
-        mReader.Read(barnFileName, 32);
+        mReader->Read(barnFileName, 32);
         barnFileName[32] = '\0';
         
         // Unknown value.
-        mReader.ReadUInt();
+        mReader->ReadUInt();
         
         // A human-readable description for this Barn file.
         // Ex: "Gabriel Knight 3 Day 1/2/3 Common"
         char barnDescription[40];
-        mReader.Read(barnDescription, 40);
+        mReader->Read(barnDescription, 40);
         
         // Unknown value.
-        mReader.ReadUInt();
+        mReader->ReadUInt();
         
-        int numAssets = mReader.ReadUInt();
+        int numAssets = mReader->ReadUInt();
         
-		mReader.Seek(dataOffsets[i]);
+		mReader->Seek(dataOffsets[i]);
         for(int j = 0; j < numAssets; j++)
         {
             BarnAsset asset;
@@ -175,17 +200,17 @@ BarnFile::BarnFile(const std::string& filePath) :
             
             // Asset size, in bytes, but we need to read compression
             // value before we know whether this is compressed or uncompressed size.
-            unsigned int assetSize = mReader.ReadUInt();
+            unsigned int assetSize = mReader->ReadUInt();
             
             // Read in the asset offset. This is the offset from the start of the data section.
-            asset.offset = mReader.ReadUInt();
+            asset.offset = mReader->ReadUInt();
             
             // Unknown values.
-            mReader.ReadUInt();
-            mReader.ReadUByte();
+            mReader->ReadUInt();
+            mReader->ReadUByte();
             
             // Read in compression type.
-            asset.compressionType = (CompressionType)mReader.ReadUByte();
+            asset.compressionType = (CompressionType)mReader->ReadUByte();
             
             // Compression type 3 should just be treated as type none.
             // Not sure if type 3 is actually different in some way?
@@ -208,19 +233,19 @@ BarnFile::BarnFile(const std::string& filePath) :
                 // So, we can actually seek to that offset in the file and read the uncompressed size.
                 if(!asset.IsPointer())
                 {
-                    int pos = mReader.GetPosition();
-                    mReader.Seek(mDataOffset + asset.offset);
-                    asset.uncompressedSize = mReader.ReadUInt();
-                    mReader.Seek(pos);
+                    int pos = mReader->GetPosition();
+                    mReader->Seek(mDataOffset + asset.offset);
+                    asset.uncompressedSize = mReader->ReadUInt();
+                    mReader->Seek(pos);
                 }
             }
 			
             // Read in asset name. This name appears to be null-terminated (+1).
             // So, max size is 256 + 1 = 257.
             //TODO: Might be better to only store a char array of the correct length?
-            unsigned int assetNameLength = mReader.ReadUByte();
+            unsigned int assetNameLength = mReader->ReadUByte();
             char assetName[257];
-            mReader.Read(assetName, assetNameLength + 1);
+            mReader->Read(assetName, assetNameLength + 1);
             
             // Save asset name.
             asset.name = assetName;
@@ -233,9 +258,15 @@ BarnFile::BarnFile(const std::string& filePath) :
     }
 }
 
+BarnFile::~BarnFile()
+{
+	delete mReader;
+	delete mMappedFile;
+}
+
 bool BarnFile::CanRead() const
 {
-    return mReader.OK();
+    return mReader->OK();
 }
 
 BarnAsset* BarnFile::GetAsset(const std::string& assetName)
@@ -267,7 +298,7 @@ bool BarnFile::Extract(const std::string& assetName, char *buffer, int bufferSiz
     }
     
     // If the buffer provided is too small for the asset, we can't extract it. Ideally, the buffer is EXACTLY the right size!
-    if(bufferSize < asset->uncompressedSize)
+    if(bufferSize < 0 || static_cast<unsigned int>(bufferSize) < asset->uncompressedSize)
     {
 		std::cout << "Buffer is too small to cotain extracted asset." << std::endl;
         return false;
@@ -276,22 +307,104 @@ bool BarnFile::Extract(const std::string& assetName, char *buffer, int bufferSiz
     // Method used to extract will depend upon the compression type for the asset.
     if(asset->compressionType == CompressionType::None)
     {
+		// If memory mapped, the data can be copied straight out of the mapping.
+		if(mMappedFile != nullptr)
+		{
+			unsigned int viewSize = 0;
+			const char* assetData = GetAssetView(assetName, viewSize);
+			if(assetData == nullptr || viewSize > static_cast<unsigned int>(bufferSize)) { return false; }
+			std::memcpy(buffer, assetData, viewSize);
+			return true;
+		}
+		
         // Seek to the data possion and read the data into the buffer. Since it's already uncompressed, we're done!
         //cout << "Reading from offset " << mDataOffset + asset->offset << endl;
         //cout << "Reading " << asset->uncompressedSize << " bytes " << endl;
-        mReader.Seek(mDataOffset + asset->offset);
-        mReader.Read(buffer, asset->uncompressedSize);
+		std::lock_guard<std::mutex> lock(mReaderMutex);
+        mReader->Seek(mDataOffset + asset->offset);
+        if(mReader->Read(buffer, asset->uncompressedSize) != static_cast<int>(asset->uncompressedSize))
+		{
+			std::cout << "Asset " << assetName << " extends past the end of the Barn file!" << std::endl;
+			return false;
+		}
+		return true;
     }
-    else if(asset->compressionType == CompressionType::Zlib)
+	
+	// Compressed data is after an 8-byte header (containing the uncompressed size, among other things).
+	unsigned int compressedOffset = mDataOffset + 8 + asset->offset;
+	if(compressedOffset < asset->offset)
+	{
+		std::cout << "Asset " << assetName << " is past the end of the Barn file!" << std::endl;
+		return false;
+	}
+	
+	// If memory mapped, we can decompress directly from the mapped data.
+	// Otherwise, the compressed data must first be read into a temporary buffer.
+	// Either way, we only pass along as much compressed data as actually exists in the file.
+	const unsigned char* compressedData = nullptr;
+	unsigned int compressedSize = 0;
+	unsigned char* compressedBuffer = nullptr;
+	if(mMappedFile != nullptr)
+	{
+		if(compressedOffset >= mMappedFile->GetLength())
+		{
+			std::cout << "Asset " << assetName << " is past the end of the Barn file!" << std::endl;
+			return false;
+		}
+		compressedData = reinterpret_cast<const unsigned char*>(mMappedFile->GetData() + compressedOffset);
+		compressedSize = std::min(asset->compressedSize, mMappedFile->GetLength() - compressedOffset);
+	}
+	else
+	{
+		// Read compressed data into a buffer.
+		compressedBuffer = new unsigned char[asset->compressedSize];
+		std::lock_guard<std::mutex> lock(mReaderMutex);
+		mReader->Seek(compressedOffset);
+		compressedSize = mReader->Read(compressedBuffer, asset->compressedSize);
+		compressedData = compressedBuffer;
+	}
+	
+	// Decompress into the provided buffer.
+	bool result = Decompress(asset, compressedData, compressedSize, buffer, bufferSize);
+	
+	// Delete compressed data buffer, if we had to create one.
+	delete[] compressedBuffer;
+	return result;
+}
+
+const char* BarnFile::GetAssetView(const std::string& assetName, unsigned int& outBufferSize)
+{
+	// Can only view assets in-place if the barn is memory mapped.
+	if(mMappedFile == nullptr) { return nullptr; }
+	
+	// Asset must exist, must be in this barn, and must not be compressed.
+	BarnAsset* asset = GetAsset(assetName);
+	if(asset == nullptr || asset->IsPointer() || asset->compressionType != CompressionType::None)
+	{
+		return nullptr;
+	}
+	
+	// Make sure the data is actually within the mapped file.
+	// Compared against the remaining size, rather than adding offset and size, which could wrap around.
+	unsigned int fileSize = mMappedFile->GetLength();
+	if(mDataOffset > fileSize || asset->offset > fileSize - mDataOffset ||
+	   asset->uncompressedSize > fileSize - mDataOffset - asset->offset)
+	{
+		std::cout << "Asset " << assetName << " extends past the end of the Barn file!" << std::endl;
+		return nullptr;
+	}
+	
+	outBufferSize = asset->uncompressedSize;
+	return mMappedFile->GetData() + mDataOffset + asset->offset;
+}
+
+bool BarnFile::Decompress(BarnAsset* asset, const unsigned char* compressedData, unsigned int compressedSize, char* buffer, int bufferSize)
+{
+	if(asset->compressionType == CompressionType::Zlib)
     {
-        // Read compressed data into a buffer.
-        unsigned char* compressedBuffer = new unsigned char[asset->compressedSize];
-        mReader.Seek(mDataOffset + 8 + asset->offset);
-        mReader.Read(compressedBuffer, asset->compressedSize);
-    
         z_stream strm;
-        strm.next_in = compressedBuffer;
-        strm.avail_in = asset->compressedSize;
+        strm.next_in = const_cast<unsigned char*>(compressedData);
+        strm.avail_in = compressedSize;
         strm.next_out = (unsigned char*)buffer;
         strm.avail_out = bufferSize;
         strm.zalloc = Z_NULL;
@@ -303,7 +416,6 @@ bool BarnFile::Extract(const std::string& assetName, char *buffer, int bufferSiz
         if(result != Z_OK)
         {
 			std::cout << "Error when calling inflateInit: " << result << std::endl;
-            delete[] compressedBuffer;
             return false;
         }
         
@@ -312,7 +424,7 @@ bool BarnFile::Extract(const std::string& assetName, char *buffer, int bufferSiz
         if(result != Z_STREAM_END)
         {
 			std::cout << "Inflate didn't inflate entire stream, or an error occurred: " << result << std::endl;
-            delete[] compressedBuffer;
+			inflateEnd(&strm);
             return false;
         }
         
@@ -321,56 +433,25 @@ bool BarnFile::Extract(const std::string& assetName, char *buffer, int bufferSiz
         if(result != Z_OK)
         {
 			std::cout << "Error while ending inflate: " << result << std::endl;
-            delete[] compressedBuffer;
             return false;
         }
-
-        // Delete compressed data buffer.
-        delete[] compressedBuffer;
     }
     else if(asset->compressionType == CompressionType::Lzo)
     {
-		// Create buffer to hold compressed data.
-        unsigned char* compressedBuffer = new unsigned char[asset->compressedSize];
-		if(compressedBuffer == nullptr)
-		{
-			std::cout << "Out of memory" << std::endl;
-			return false;
-		}
-		
-		// Read compressed data into a buffer.
-        mReader.Seek(mDataOffset + 8 + asset->offset);
-        int readCount = mReader.Read(compressedBuffer, asset->compressedSize);
-		if(readCount != asset->compressedSize)
-		{
-			std::cout << "Didn't read desired number of bytes." << std::endl;
-			delete[] compressedBuffer;
-			return false;
-		}
-		
         // Make sure LZO library is initialized.
-		static bool initLzo = false;
+		// Function-local static init is thread-safe, so this only happens once, even if extracting on several threads.
+		static bool initLzo = (lzo_init() == LZO_E_OK);
 		if(!initLzo)
 		{
-			int initResult = lzo_init();
-			if(initResult == LZO_E_OK)
-			{
-				initLzo = true;
-			}
-			else
-			{
-				std::cout << "Failed to init LZO!" << std::endl;
-				delete[] compressedBuffer;
-				return false;
-			}
+			std::cout << "Failed to init LZO!" << std::endl;
+			return false;
 		}
 		
         // Decompress using LZO library. GK3 data appears to be compressed with lzo1x.
-		//std::cout << asset->name << ": decompressing " << asset->compressedSize << " bytes to a buffer of size " << bufferSize << std::endl;
-		int result = lzo1x_decompress((lzo_bytep)compressedBuffer, (lzo_uint)asset->compressedSize, (lzo_bytep)buffer, (lzo_uintp)&bufferSize, nullptr);
-		
-		// Delete compressed data buffer.
-		delete[] compressedBuffer;
+		// The "safe" version checks bounds, so truncated or corrupt data fails rather than reading past the end of the file.
+		//std::cout << asset->name << ": decompressing " << compressedSize << " bytes to a buffer of size " << bufferSize << std::endl;
+		lzo_uint decompressedSize = bufferSize;
+		int result = lzo1x_decompress_safe((const lzo_bytep)compressedData, (lzo_uint)compressedSize, (lzo_bytep)buffer, &decompressedSize, nullptr);
 		
 		// For some reason *most* GK3 data decompresses with result of LZO_E_INPUT_NOT_CONSUMED.
 		// This still works OK. It may indicate that "compressedSize" passed is larger than the compressed data.
@@ -383,7 +464,7 @@ bool BarnFile::Extract(const std::string& assetName, char *buffer, int bufferSiz
     }
     else
     {
-		std::cout << "Asset " << assetName << " has invalid compression type " << (int)asset->compressionType << std::endl;
+		std::cout << "Asset " << asset->name << " has invalid compression type " << (int)asset->compressionType << std::endl;
         return false;
     }
     
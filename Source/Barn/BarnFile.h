@@ -5,16 +5,22 @@
 //  Created by Clark Kromenaker on 8/4/17.
 //
 #pragma once
+#include <mutex>
 #include <string>
 #include <unordered_map>
 
 #include "BarnAsset.h"
-#include "BinaryReader.h"
+
+class BinaryReader;
+class MemoryMappedFile;
 
 class BarnFile
 {
 public:
-    BarnFile(const std::string& filePath);
+	// If memory mapped, the whole file is mapped into memory once, and assets are read directly from the mapping.
+	// Falls back to reading via a file stream if mapping fails.
+    BarnFile(const std::string& filePath, bool memoryMap = false);
+	~BarnFile();
 	
 	// Ensure we can actually read assets from this barn.
     bool CanRead() const;
@@ -22,9 +28,20 @@ public:
 	// Retrieves an asset handle, if it exists in this bundle.
     BarnAsset* GetAsset(const std::string& assetName);
 	
+	// All asset handles in this bundle, keyed by asset name.
+	const std::unordered_map<std::string, BarnAsset>& GetAssets() const { return mAssetMap; }
+	
 	// Extracts an asset into the provided buffer.
+	// Safe to call from multiple threads at once - decompression happens outside of any lock.
     bool Extract(const std::string& assetName, char* buffer, int bufferSize);
 	
+	// For uncompressed assets in a memory-mapped barn, returns a read-only pointer directly into the mapped data.
+	// No allocation or copy occurs, but the data is only valid while this barn is loaded.
+	// Returns null if the asset can't be viewed in-place (compressed, only a pointer, or barn isn't mapped).
+	const char* GetAssetView(const std::string& assetName, unsigned int& outBufferSize);
+	
+	bool IsMemoryMapped() const { return mMappedFile != nullptr; }
+	
 	// For debugging, write assets to file.
     bool WriteToFile(const std::string& assetName);
 	bool WriteToFile(const std::string& assetName, const std::string outputDir);
@@ -52,7 +69,15 @@ private:
     std::string mName;
     
     // Binary reader for extracting data.
-    BinaryReader mReader;
+	// Reads from the memory mapping if the barn is mapped, or from a file stream otherwise.
+    BinaryReader* mReader = nullptr;
+	
+	// Guards the reader, which has a single read position, when extracting from multiple threads.
+	// Not needed when reading from the memory mapping.
+	std::mutex mReaderMutex;
+	
+	// If memory mapped, the mapping of the entire barn file.
+	MemoryMappedFile* mMappedFile = nullptr;
     
     // Offset within the file to where the data is located.
     unsigned int mDataOffset = 0;
@@ -60,4 +85,7 @@ private:
     // Map of asset name to an asset handle.
     // The asset needs to be extracted before it can be used.
     std::unordered_map<std::string, BarnAsset> mAssetMap;
+	
+	// Decompresses an asset's compressed data into the provided buffer.
+	bool Decompress(BarnAsset* asset, const unsigned char* compressedData, unsigned int compressedSize, char* buffer, int bufferSize);
 };
@@ -0,0 +1,41 @@
+//
+// BufferTexture.cpp
+//
+// Clark Kromenaker
+//
+#include "BufferTexture.h"
+
+BufferTexture::BufferTexture(const float* data, int count) :
+	mCount(count)
+{
+	// Create buffer and copy data into it. The data never changes after this.
+	glGenBuffers(1, &mBufferId);
+	glBindBuffer(GL_TEXTURE_BUFFER, mBufferId);
+	glBufferData(GL_TEXTURE_BUFFER, count * sizeof(float), data, GL_STATIC_DRAW);
+	glBindBuffer(GL_TEXTURE_BUFFER, GL_NONE);
+	
+	// Create texture that reads from the buffer, one float per texel.
+	glGenTextures(1, &mTextureId);
+	glBindTexture(GL_TEXTURE_BUFFER, mTextureId);
+	glTexBuffer(GL_TEXTURE_BUFFER, GL_R32F, mBufferId);
+	glBindTexture(GL_TEXTURE_BUFFER, GL_NONE);
+}
+
+BufferTexture::~BufferTexture()
+{
+	glDeleteTextures(1, &mTextureId);
+	glDeleteBuffers(1, &mBufferId);
+}
+
+void BufferTexture::Activate(int textureUnit)
+{
+	glActiveTexture(GL_TEXTURE0 + textureUnit);
+	glBindTexture(GL_TEXTURE_BUFFER, mTextureId);
+}
+
+int BufferTexture::GetMaxCount()
+{
+	GLint maxCount = 0;
+	glGetIntegerv(GL_MAX_TEXTURE_BUFFER_SIZE, &maxCount);
+	return maxCount;
+}
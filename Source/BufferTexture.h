@@ -0,0 +1,41 @@
+//
+// BufferTexture.h
+//
+// Clark Kromenaker
+//
+// A big array of floats on the GPU that shaders can read from by index.
+// Good for data that's too big for uniforms, like vertex animation keyframes.
+//
+// In OpenGL, this is implemented using "Buffer Textures." A shader reads it with
+// a "samplerBuffer" uniform and texelFetch - each texel is one float.
+//
+// Data is copied to the GPU right away, so the source data can be discarded after creation.
+//
+#pragma once
+#include <GL/glew.h>
+
+class BufferTexture
+{
+public:
+	BufferTexture(const float* data, int count);
+	~BufferTexture();
+	
+	// BufferTextures contain handles to GPU resources, so don't allow copying!
+	BufferTexture(const BufferTexture& other) = delete;
+	BufferTexture& operator=(const BufferTexture& other) = delete;
+	
+	void Activate(int textureUnit);
+	
+	int GetCount() const { return mCount; }
+	
+	// Max number of floats a buffer texture can hold on this GPU. Can be as low as 65536.
+	static int GetMaxCount();
+	
+private:
+	// Number of floats in the buffer.
+	int mCount = 0;
+	
+	// The buffer holds the data, and the texture lets shaders read the buffer.
+	GLuint mBufferId = GL_NONE;
+	GLuint mTextureId = GL_NONE;
+};
@@ -0,0 +1,83 @@
+//
+// CaseLogicCache.cpp
+//
+// Clark Kromenaker
+//
+#include "CaseLogicCache.h"
+
+#include "Services.h"
+#include "SheepScript.h"
+#include "StringUtil.h"
+
+// Sys funcs that only read game progress or location.
+// Results of case logic that only calls these can be cached until game progress or location changes.
+static const char* kCacheableCaseLogicFunctions[] = {
+	"GetChatCount",
+	"GetFlag",
+	"GetGameVariableInt",
+	"GetNounVerbCount",
+	"GetScore",
+	"GetTopicCount",
+	"GetTopicCountInt",
+	"IsCurrentLocation",
+	"IsCurrentTime",
+	"WasLastLocation",
+	"WasLastTime"
+};
+
+bool CaseLogicCache::Evaluate(SheepScript* script, int n, int v, unsigned int gameProgressChangeCount, unsigned int locationChangeCount)
+{
+	// No script automatically equates to "true."
+	if(script == nullptr) { return true; }
+	
+	// First time seeing this case logic? See whether its results can be cached.
+	auto it = mResults.find(script);
+	if(it == mResults.end())
+	{
+		it = mResults.insert(std::make_pair(script, CaseLogicResults())).first;
+		it->second.cacheable = IsCacheable(script);
+	}
+	CaseLogicResults& caseLogicResults = it->second;
+	if(!caseLogicResults.cacheable)
+	{
+		return Services::GetSheep()->Evaluate(script, n, v);
+	}
+	
+	// If game progress or location changed, previous results may no longer be correct.
+	if(caseLogicResults.gameProgressChangeCount != gameProgressChangeCount ||
+	   caseLogicResults.locationChangeCount != locationChangeCount)
+	{
+		caseLogicResults.results.clear();
+		caseLogicResults.gameProgressChangeCount = gameProgressChangeCount;
+		caseLogicResults.locationChangeCount = locationChangeCount;
+	}
+	
+	// Use cached result, or evaluate and cache it.
+	uint64_t key = (static_cast<uint64_t>(static_cast<uint32_t>(n)) << 32) | static_cast<uint32_t>(v);
+	auto resultIt = caseLogicResults.results.find(key);
+	if(resultIt != caseLogicResults.results.end())
+	{
+		return resultIt->second;
+	}
+	bool result = Services::GetSheep()->Evaluate(script, n, v);
+	caseLogicResults.results[key] = result;
+	return result;
+}
+
+bool CaseLogicCache::IsCacheable(SheepScript* script)
+{
+	for(int i = 0; i < script->GetSysImportCount(); ++i)
+	{
+		bool cacheable = false;
+		for(auto& functionName : kCacheableCaseLogicFunctions)
+		{
+			if(StringUtil::EqualsIgnoreCase(script->GetSysImport(i)->name, functionName))
+			{
+				cacheable = true;
+				break;
+			}
+		}
+		if(!cacheable) { return false; }
+	}
+	return true;
+}
@@ -0,0 +1,44 @@
+//
+// CaseLogicCache.h
+//
+// Clark Kromenaker
+//
+// Caches results of NVC case logic.
+//
+// Case logic is evaluated a lot (e.g. for every action when showing the action bar), but usually only checks game progress.
+// So, results are cached per n$/v$ value, and reused until game progress or location changes.
+//
+#pragma once
+#include <cstdint>
+#include <unordered_map>
+
+class SheepScript;
+
+class CaseLogicCache
+{
+public:
+	// Evaluates case logic with the given n$/v$ values, or returns the cached result.
+	// Pass in GameProgress and LocationManager change counts: if either differs from when results were cached, they're thrown out.
+	bool Evaluate(SheepScript* script, int n, int v, unsigned int gameProgressChangeCount, unsigned int locationChangeCount);
+	
+	// Call when case logic scripts are unloaded, so results aren't reused for a new script at the same address.
+	void Clear() { mResults.clear(); }
+	
+	// True if the case logic only calls sys funcs that read game progress or location.
+	static bool IsCacheable(SheepScript* script);
+	
+private:
+	struct CaseLogicResults
+	{
+		// If false, the case logic checks something we can't track changes to - it must be evaluated every time.
+		bool cacheable = false;
+		
+		// Game progress and location change counts when results were cached.
+		unsigned int gameProgressChangeCount = 0;
+		unsigned int locationChangeCount = 0;
+		
+		// Results, keyed by n$ (high bits) and v$ (low bits).
+		std::unordered_map<uint64_t, bool> results;
+	};
+	std::unordered_map<SheepScript*, CaseLogicResults> mResults;
+};
@@ -319,6 +319,22 @@ CharacterManager::CharacterManager()
 		}
 		delete[] actorsBuffer;
 	}
+	
+	// Character configs are used for the whole game, so their assets must stay loaded across scenes.
+	for(auto& entry : mCharacterConfigs)
+	{
+		CharacterConfig& config = entry.second;
+		Asset* assets[] = {
+			config.walkStartAnim, config.walkStartTurnRightAnim, config.walkStartTurnLeftAnim, config.walkLoopAnim, config.walkStopAnim,
+			config.faceConfig.faceTexture, config.faceConfig.eyelidsTexture, config.faceConfig.foreheadTexture,
+			config.faceConfig.leftEyeTexture, config.faceConfig.rightEyeTexture, config.faceConfig.eyelidsAlphaChannel,
+			config.faceConfig.blinkAnim1, config.faceConfig.blinkAnim2
+		};
+		for(Asset* asset : assets)
+		{
+			Services::GetAssets()->AcquireAsset(asset);
+		}
+	}
 }
 
 CharacterConfig& CharacterManager::GetCharacterConfig(const std::string& identifier)
@@ -10,6 +10,13 @@
 #include "Ray.h"
 #include "Sphere.h"
 #include "Triangle.h"
+#include "TriangleBatch.h"
+
+// SSE2 is guaranteed on all x64 CPUs. Other targets (e.g. ARM) use the scalar path.
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+	#define COLLISIONS_USE_SSE
+	#include <emmintrin.h>
+#endif
 
 /*static*/ bool Collisions::TestSphereSphere(const Sphere& s1, const Sphere& s2)
 {
@@ -156,3 +163,156 @@
 	outHitInfo.t = t;
 	return true;
 }
+
+/*static*/ int Collisions::TestRayTriangles(const Ray& r, const TriangleBatch& triangles, RaycastHit& outHitInfo)
+{
+	return TestRayTriangles(r, triangles, 0, triangles.GetCount(), outHitInfo);
+}
+
+/*static*/ int Collisions::TestRayTriangles(const Ray& r, const TriangleBatch& triangles, int start, int count, RaycastHit& outHitInfo)
+{
+	// This is the same algorithm as TestRayTriangle, just for several triangles at once.
+	// Operations are done in the same order, so results match the single triangle test.
+	const float* p0X = triangles.GetP0X();
+	const float* p0Y = triangles.GetP0Y();
+	const float* p0Z = triangles.GetP0Z();
+	const float* e1X = triangles.GetEdge1X();
+	const float* e1Y = triangles.GetEdge1Y();
+	const float* e1Z = triangles.GetEdge1Z();
+	const float* e2X = triangles.GetEdge2X();
+	const float* e2Y = triangles.GetEdge2Y();
+	const float* e2Z = triangles.GetEdge2Z();
+	
+	int nearestIndex = -1;
+	float nearestT = FLT_MAX;
+	int index = start;
+	int end = start + count;
+	
+	#if defined(COLLISIONS_USE_SSE)
+	if(count >= 4)
+	{
+		// Ray values are the same for all triangles, so copy them to all four lanes once.
+		__m128 originX = _mm_set1_ps(r.origin.x);
+		__m128 originY = _mm_set1_ps(r.origin.y);
+		__m128 originZ = _mm_set1_ps(r.origin.z);
+		__m128 dirX = _mm_set1_ps(r.direction.x);
+		__m128 dirY = _mm_set1_ps(r.direction.y);
+		__m128 dirZ = _mm_set1_ps(r.direction.z);
+		
+		__m128 zero = _mm_setzero_ps();
+		__m128 one = _mm_set1_ps(1.0f);
+		__m128 epsilon = _mm_set1_ps(Math::kEpsilon);
+		__m128 absMask = _mm_castsi128_ps(_mm_set1_epi32(0x7FFFFFFF));
+		__m128 noHit = _mm_set1_ps(FLT_MAX);
+		
+		// Track nearest hit per lane, and which triangle it was.
+		__m128 laneNearestT = noHit;
+		__m128i laneNearestIndex = _mm_set1_epi32(-1);
+		__m128i laneIndex = _mm_setr_epi32(index, index + 1, index + 2, index + 3);
+		__m128i four = _mm_set1_epi32(4);
+		
+		for(; index + 4 <= end; index += 4)
+		{
+			__m128 edge1X = _mm_loadu_ps(e1X + index);
+			__m128 edge1Y = _mm_loadu_ps(e1Y + index);
+			__m128 edge1Z = _mm_loadu_ps(e1Z + index);
+			__m128 edge2X = _mm_loadu_ps(e2X + index);
+			__m128 edge2Y = _mm_loadu_ps(e2Y + index);
+			__m128 edge2Z = _mm_loadu_ps(e2Z + index);
+			
+			// p = Cross(direction, e2)
+			__m128 pX = _mm_sub_ps(_mm_mul_ps(dirY, edge2Z), _mm_mul_ps(dirZ, edge2Y));
+			__m128 pY = _mm_sub_ps(_mm_mul_ps(dirZ, edge2X), _mm_mul_ps(dirX, edge2Z));
+			__m128 pZ = _mm_sub_ps(_mm_mul_ps(dirX, edge2Y), _mm_mul_ps(dirY, edge2X));
+			
+			// a = Dot(e1, p) - if zero, ray is parallel to triangle plane.
+			__m128 a = _mm_add_ps(_mm_add_ps(_mm_mul_ps(edge1X, pX), _mm_mul_ps(edge1Y, pY)), _mm_mul_ps(edge1Z, pZ));
+			__m128 hitMask = _mm_cmpge_ps(_mm_and_ps(a, absMask), epsilon);
+			__m128 f = _mm_div_ps(one, a);
+			
+			// s = origin - p0
+			__m128 sX = _mm_sub_ps(originX, _mm_loadu_ps(p0X + index));
+			__m128 sY = _mm_sub_ps(originY, _mm_loadu_ps(p0Y + index));
+			__m128 sZ = _mm_sub_ps(originZ, _mm_loadu_ps(p0Z + index));
+			
+			// u = f * Dot(s, p)
+			__m128 u = _mm_mul_ps(f, _mm_add_ps(_mm_add_ps(_mm_mul_ps(sX, pX), _mm_mul_ps(sY, pY)), _mm_mul_ps(sZ, pZ)));
+			hitMask = _mm_and_ps(hitMask, _mm_and_ps(_mm_cmpge_ps(u, zero), _mm_cmple_ps(u, one)));
+			
+			// q = Cross(s, e1)
+			__m128 qX = _mm_sub_ps(_mm_mul_ps(sY, edge1Z), _mm_mul_ps(sZ, edge1Y));
+			__m128 qY = _mm_sub_ps(_mm_mul_ps(sZ, edge1X), _mm_mul_ps(sX, edge1Z));
+			__m128 qZ = _mm_sub_ps(_mm_mul_ps(sX, edge1Y), _mm_mul_ps(sY, edge1X));
+			
+			// v = f * Dot(direction, q)
+			__m128 v = _mm_mul_ps(f, _mm_add_ps(_mm_add_ps(_mm_mul_ps(dirX, qX), _mm_mul_ps(dirY, qY)), _mm_mul_ps(dirZ, qZ)));
+			hitMask = _mm_and_ps(hitMask, _mm_and_ps(_mm_cmpge_ps(v, zero), _mm_cmple_ps(_mm_add_ps(u, v), one)));
+			
+			// t = f * Dot(e2, q)
+			__m128 t = _mm_mul_ps(f, _mm_add_ps(_mm_add_ps(_mm_mul_ps(edge2X, qX), _mm_mul_ps(edge2Y, qY)), _mm_mul_ps(edge2Z, qZ)));
+			hitMask = _mm_and_ps(hitMask, _mm_cmpge_ps(t, zero));
+			
+			// Keep hits that are nearer than this lane's nearest so far.
+			__m128 nearerMask = _mm_and_ps(hitMask, _mm_cmplt_ps(t, laneNearestT));
+			laneNearestT = _mm_or_ps(_mm_and_ps(nearerMask, t), _mm_andnot_ps(nearerMask, laneNearestT));
+			__m128i nearerIndexMask = _mm_castps_si128(nearerMask);
+			laneNearestIndex = _mm_or_si128(_mm_and_si128(nearerIndexMask, laneIndex), _mm_andnot_si128(nearerIndexMask, laneNearestIndex));
+			laneIndex = _mm_add_epi32(laneIndex, four);
+		}
+		
+		// Find nearest of the four lanes. On ties, prefer lower index, same as testing one at a time.
+		float laneT[4];
+		int laneNearest[4];
+		_mm_storeu_ps(laneT, laneNearestT);
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(laneNearest), laneNearestIndex);
+		for(int i = 0; i < 4; ++i)
+		{
+			if(laneNearest[i] < 0) { continue; }
+			if(laneT[i] < nearestT || (laneT[i] == nearestT && laneNearest[i] < nearestIndex))
+			{
+				nearestT = laneT[i];
+				nearestIndex = laneNearest[i];
+			}
+		}
+	}
+	#endif
+	
+	// Scalar path - handles any triangles left over from SIMD path, or all triangles if SIMD isn't available.
+	Vector3 origin = r.origin;
+	Vector3 direction = r.direction;
+	for(; index < end; ++index)
+	{
+		Vector3 e1(e1X[index], e1Y[index], e1Z[index]);
+		Vector3 e2(e2X[index], e2Y[index], e2Z[index]);
+		
+		Vector3 p = Vector3::Cross(direction, e2);
+		float a = Vector3::Dot(e1, p);
+		if(Math::IsZero(a)) { continue; }
+		
+		float f = 1.0f / a;
+		
+		Vector3 s = origin - Vector3(p0X[index], p0Y[index], p0Z[index]);
+		float u = f * Vector3::Dot(s, p);
+		if(u < 0.0f || u > 1.0f) { continue; }
+		
+		Vector3 q = Vector3::Cross(s, e1);
+		float v = f * Vector3::Dot(direction, q);
+		if(v < 0.0f || u + v > 1.0f) { continue; }
+		
+		float t = f * Vector3::Dot(e2, q);
+		if(t < 0.0f) { continue; }
+		
+		if(t < nearestT)
+		{
+			nearestT = t;
+			nearestIndex = index;
+		}
+	}
+	
+	// Pass "t" of nearest intersection out to caller.
+	if(nearestIndex >= 0)
+	{
+		outHitInfo.t = nearestT;
+	}
+	return nearestIndex;
+}
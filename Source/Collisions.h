@@ -17,6 +17,7 @@ class Plane;
 class Ray;
 class Sphere;
 class Triangle;
+class TriangleBatch;
 class Vector3;
 
 struct RaycastHit
@@ -54,6 +55,11 @@ public:
 	static bool TestRayTriangle(const Ray& r, const Triangle& t, RaycastHit& hitInfo);
 	static bool TestRayTriangle(const Ray& r, const Vector3& p0, const Vector3& p1, const Vector3& p2, RaycastHit& outHitInfo);
 	
+	// Tests a ray against many triangles at once (using SIMD when available).
+	// Returns index of the nearest triangle hit (and its "t" in hit info), or -1 if no triangles were hit.
+	static int TestRayTriangles(const Ray& r, const TriangleBatch& triangles, RaycastHit& outHitInfo);
+	static int TestRayTriangles(const Ray& r, const TriangleBatch& triangles, int start, int count, RaycastHit& outHitInfo);
+	
 	// Line Segment
 	static bool TestLineSegmentSphere(const LineSegment& ls, const Sphere& s);
 	static bool TestLineSegmentAABB(const LineSegment& ls, const AABB& aabb);
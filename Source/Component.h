@@ -18,6 +18,14 @@ public:
 	virtual ~Component() { }
     
 	void Update(float deltaTime);
+	
+	// Some components have CPU-heavy work that's safe to run in parallel with other components (e.g. sampling animations).
+	// After all actors update, components that have parallel work run ParallelUpdate, potentially on a worker thread.
+	// Once all parallel work is done, FinishParallelUpdate runs on the main thread, before rendering.
+	// ParallelUpdate must only change the component's own data - no GL, other actors/components, assets, or services.
+	virtual bool HasParallelWork() const { return false; }
+	virtual void ParallelUpdate() { }
+	virtual void FinishParallelUpdate() { }
     
     Actor* GetOwner() const { return mOwner; }
 	
@@ -0,0 +1,134 @@
+//
+// ComponentPool.h
+//
+// Clark Kromenaker
+//
+// Storage for all components of one type.
+//
+// Components are constructed in fixed-size chunks of contiguous memory, rather than
+// being individually heap allocated. Components of the same type end up next to each other,
+// which is friendlier to the cache when they're updated each frame, and it's possible
+// to iterate every component of a type without visiting each actor.
+//
+// Chunks never move, so component pointers stay valid as the pool grows.
+// A pool only holds components of exactly type T - for example, RectTransforms are
+// in the RectTransform pool, not the Transform pool.
+//
+#pragma once
+#include <new>
+#include <vector>
+
+class Actor;
+
+template<class T> class ComponentPool
+{
+public:
+	// Constructs a component in the pool.
+	static T* Create(Actor* owner);
+
+	// Destructs a component that was created by Create, and frees its memory for reuse.
+	static void Destroy(T* component);
+
+	// Calls the function for every component in the pool, in memory order.
+	// Components must not be created or destroyed during iteration.
+	template<class Function> static void ForEach(Function function);
+
+	static int GetCount() { return Get().mCount; }
+
+private:
+	static const int kChunkSize = 64;
+
+	struct Slot
+	{
+		// Must be first, so a component pointer is also a pointer to its slot.
+		alignas(T) unsigned char storage[sizeof(T)];
+
+		// Does this slot contain a constructed component?
+		bool used = false;
+	};
+
+	struct Chunk
+	{
+		Slot slots[kChunkSize];
+	};
+
+	// All allocated chunks.
+	std::vector<Chunk*> mChunks;
+
+	// Slots in allocated chunks that don't contain a component.
+	std::vector<Slot*> mFreeSlots;
+
+	// Number of components in the pool.
+	int mCount = 0;
+
+	ComponentPool() { }
+	~ComponentPool();
+
+	static ComponentPool& Get();
+};
+
+template<class T> ComponentPool<T>::~ComponentPool()
+{
+	// Only happens on exit, so any components still in the pool are just abandoned.
+	for(auto& chunk : mChunks)
+	{
+		delete chunk;
+	}
+	mChunks.clear();
+}
+
+template<class T> ComponentPool<T>& ComponentPool<T>::Get()
+{
+	static ComponentPool pool;
+	return pool;
+}
+
+template<class T> T* ComponentPool<T>::Create(Actor* owner)
+{
+	ComponentPool& pool = Get();
+
+	// Out of space? Add a chunk. Free slots are used in reverse, so this fills the chunk from the front.
+	if(pool.mFreeSlots.empty())
+	{
+		Chunk* chunk = new Chunk();
+		pool.mChunks.push_back(chunk);
+		for(int i = kChunkSize - 1; i >= 0; --i)
+		{
+			pool.mFreeSlots.push_back(&chunk->slots[i]);
+		}
+	}
+
+	Slot* slot = pool.mFreeSlots.back();
+	pool.mFreeSlots.pop_back();
+	T* component = new (slot->storage) T(owner);
+	slot->used = true;
+	++pool.mCount;
+	return component;
+}
+
+template<class T> void ComponentPool<T>::Destroy(T* component)
+{
+	if(component == nullptr) { return; }
+
+	ComponentPool& pool = Get();
+	Slot* slot = reinterpret_cast<Slot*>(component);
+	component->~T();
+	slot->used = false;
+	pool.mFreeSlots.push_back(slot);
+	--pool.mCount;
+}
+
+template<class T> template<class Function> void ComponentPool<T>::ForEach(Function function)
+{
+	ComponentPool& pool = Get();
+	for(auto& chunk : pool.mChunks)
+	{
+		for(int i = 0; i < kChunkSize; ++i)
+		{
+			if(chunk->slots[i].used)
+			{
+				function(reinterpret_cast<T*>(chunk->slots[i].storage));
+			}
+		}
+	}
+}
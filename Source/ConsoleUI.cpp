@@ -33,14 +33,11 @@ ConsoleUI::ConsoleUI(bool mini) : Actor(TransformType::RectTransform),
 	// Only difference between mini and full is a different background image.
 	UIImage* backgroundImage = background->AddComponent<UIImage>();
 	backgroundImage->SetRenderMode(UIImage::RenderMode::Tiled);
-	if(mini)
-	{
-		backgroundImage->SetTexture(Services::GetAssets()->LoadTexture("MINISNAKY"));
-	}
-	else
-	{
-		backgroundImage->SetTexture(Services::GetAssets()->LoadTexture("SNAKY"));
-	}
+	Texture* backgroundTexture = Services::GetAssets()->LoadTexture(mini ? "MINISNAKY" : "SNAKY");
+	backgroundImage->SetTexture(backgroundTexture);
+	
+	// The console sticks around across scenes, so its texture must stay loaded.
+	Services::GetAssets()->AcquireAsset(backgroundTexture);
 	mCanvas->AddWidget(backgroundImage);
 	
 	// Mini and full consoles have different anchoring properties.
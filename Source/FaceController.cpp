@@ -9,6 +9,7 @@
 
 #include "Animator.h"
 #include "CharacterManager.h"
+#include "MeshRenderer.h"
 #include "Texture.h"
 #include "Random.h"
 #include "Services.h"
@@ -27,6 +28,7 @@ FaceController::~FaceController()
 {
 	delete mDownSampledLeftEyeTexture;
 	delete mDownSampledRightEyeTexture;
+	delete mFaceTexture;
 }
 
 void FaceController::SetCharacterConfig(const CharacterConfig& characterConfig)
@@ -34,8 +36,17 @@ void FaceController::SetCharacterConfig(const CharacterConfig& characterConfig)
 	// Save character config.
 	mCharacterConfig = &characterConfig;
 	
-	// Save reference to face texture.
-	mFaceTexture = mCharacterConfig->faceConfig.faceTexture;
+	// Make a copy of the face texture to build the face in.
+	mFaceAssetTexture = mCharacterConfig->faceConfig.faceTexture;
+	delete mFaceTexture;
+	mFaceTexture = nullptr;
+	if(mFaceAssetTexture != nullptr)
+	{
+		mFaceTexture = new Texture(mFaceAssetTexture->GetWidth(), mFaceAssetTexture->GetHeight());
+		Texture::CopyPixels(*mFaceAssetTexture, *mFaceTexture, 0, 0);
+		mFaceTextureDirty = true;
+	}
+	mFaceModel = nullptr;
 	
 	// Grab references to default mouth/eyelids/forehead textures.
 	mDefaultMouthTexture = Services::GetAssets()->LoadTexture(mCharacterConfig->identifier + "_MOUTH00");
@@ -90,51 +101,51 @@ void FaceController::Clear(FaceElement element)
 void FaceController::SetMouth(Texture* texture)
 {
 	mCurrentMouthTexture = texture;
-	UpdateFaceTexture();
+	mFaceTextureDirty = true;
 }
 
 void FaceController::ClearMouth()
 {
 	mCurrentMouthTexture = mDefaultMouthTexture;
-	UpdateFaceTexture();
+	mFaceTextureDirty = true;
 }
 
 void FaceController::SetEyelids(Texture* texture)
 {
 	mCurrentEyelidsTexture = texture;
-	UpdateFaceTexture();
+	mFaceTextureDirty = true;
 }
 
 void FaceController::ClearEyelids()
 {
 	mCurrentEyelidsTexture = mDefaultEyelidsTexture;
-	UpdateFaceTexture();
+	mFaceTextureDirty = true;
 }
 
 void FaceController::SetForehead(Texture* texture)
 {
 	mCurrentForeheadTexture = texture;
-	UpdateFaceTexture();
+	mFaceTextureDirty = true;
 }
 
 void FaceController::ClearForehead()
 {
 	mCurrentForeheadTexture = mDefaultForeheadTexture;
-	UpdateFaceTexture();
+	mFaceTextureDirty = true;
 }
 
 void FaceController::SetEyes(Texture* texture)
 {
 	mCurrentLeftEyeTexture = texture;
 	mCurrentRightEyeTexture = texture;
-	UpdateFaceTexture();
+	mFaceTextureDirty = true;
 }
 
 void FaceController::ClearEyes()
 {
 	mCurrentLeftEyeTexture = mDefaultLeftEyeTexture;
 	mCurrentRightEyeTexture = mDefaultRightEyeTexture;
-	UpdateFaceTexture();
+	mFaceTextureDirty = true;
 }
 
 void FaceController::SetEye(EyeType eyeType, Texture* texture)
@@ -147,7 +158,7 @@ void FaceController::SetEye(EyeType eyeType, Texture* texture)
 	{
 		mCurrentRightEyeTexture = texture;
 	}
-	UpdateFaceTexture();
+	mFaceTextureDirty = true;
 }
 
 void FaceController::ClearEye(EyeType eyeType)
@@ -160,7 +171,7 @@ void FaceController::ClearEye(EyeType eyeType)
 	{
 		mCurrentRightEyeTexture = mDefaultRightEyeTexture;
 	}
-	UpdateFaceTexture();
+	mFaceTextureDirty = true;
 }
 
 void FaceController::Blink()
@@ -227,7 +238,7 @@ void FaceController::EyeJitter()
 	float maxY = mCharacterConfig->faceConfig.maxEyeJitterDistance.y;
 	mEyeJitterY = Random::Range(-maxY, maxY);
 	
-	UpdateFaceTexture();
+	mFaceTextureDirty = true;
 }
 
 void FaceController::DoExpression(const std::string& expression)
@@ -287,6 +298,13 @@ void FaceController::ClearMood()
 
 void FaceController::OnUpdate(float deltaTime)
 {
+	// Point the model's materials at this controller's face texture, if the model has changed.
+	if(mMeshRenderer != nullptr && mMeshRenderer->GetModel() != mFaceModel)
+	{
+		mFaceModel = mMeshRenderer->GetModel();
+		ApplyFaceTexture();
+	}
+	
 	// Count down and blink after some time.
 	mBlinkTimer -= deltaTime;
 	if(mBlinkTimer <= 0.0f)
@@ -307,6 +325,19 @@ void FaceController::OnUpdate(float deltaTime)
 	}
 }
 
+void FaceController::ParallelUpdate()
+{
+	UpdateFaceTexture();
+}
+
+void FaceController::FinishParallelUpdate()
+{
+	// Upload all changes to the GPU.
+	// Downsampled eyes are only used on the CPU to build the face, so only the face needs uploading.
+	mFaceTexture->UploadToGPU();
+	mFaceTextureDirty = false;
+}
+
 void FaceController::RollBlinkTimer()
 {
 	// Calculate wait milliseconds for next blink.
@@ -338,6 +369,7 @@ void FaceController::RollEyeJitterTimer()
 void FaceController::UpdateFaceTexture()
 {
 	// Can't do much if face texture is missing!
+	// Only changes pixels in RAM - uploading to the GPU is up to the caller.
 	if(mFaceTexture == nullptr) { return; }
 	
 	// Copy mouth texture.
@@ -364,8 +396,6 @@ void FaceController::UpdateFaceTexture()
 							  //0.25f, 0.25f, mEyeJitterX + leftEyeBias.x, mEyeJitterY + leftEyeBias.y);
 							  0.25f, 0.25f, 0.0f, 0.0f);
 		
-		mDownSampledLeftEyeTexture->UploadToGPU();
-		
 		const Vector2& leftEyeOffset = mCharacterConfig->faceConfig.leftEyeOffset;
 		Texture::BlendPixels(*mDownSampledLeftEyeTexture, *mFaceTexture, leftEyeOffset.x, leftEyeOffset.y);
 	}
@@ -387,8 +417,6 @@ void FaceController::UpdateFaceTexture()
 							  //0.25f, 0.25f, mEyeJitterX + rightEyeBias.x, mEyeJitterY + rightEyeBias.y);
 							  0.25f, 0.25f, 0.0f, 0.0f);
 							  
-		mDownSampledRightEyeTexture->UploadToGPU();
-		
 		const Vector2& rightEyeOffset = mCharacterConfig->faceConfig.rightEyeOffset;
 		Texture::BlendPixels(*mDownSampledRightEyeTexture, *mFaceTexture, rightEyeOffset.x, rightEyeOffset.y);
 	}
@@ -406,7 +434,22 @@ void FaceController::UpdateFaceTexture()
 		const Vector2& foreheadOffset = mCharacterConfig->faceConfig.foreheadOffset;
 		Texture::BlendPixels(*mCurrentForeheadTexture, *mFaceTexture, foreheadOffset.x, foreheadOffset.y);
 	}
-		
-	// Upload all changes to the GPU.
-	mFaceTexture->UploadToGPU();
+}
+
+void FaceController::ApplyFaceTexture()
+{
+	if(mFaceTexture == nullptr) { return; }
+	
+	// Any material using the face asset should use this controller's copy instead.
+	int materialIndex = 0;
+	Material* material = mMeshRenderer->GetMaterial(materialIndex);
+	while(material != nullptr)
+	{
+		if(material->GetDiffuseTexture() == mFaceAssetTexture)
+		{
+			material->SetDiffuseTexture(mFaceTexture);
+		}
+		++materialIndex;
+		material = mMeshRenderer->GetMaterial(materialIndex);
+	}
 }
@@ -11,6 +11,8 @@
 
 class Animation;
 struct CharacterConfig;
+class MeshRenderer;
+class Model;
 class Texture;
 
 enum class FaceElement
@@ -35,6 +37,9 @@ public:
 	
 	void SetCharacterConfig(const CharacterConfig& characterConfig);
 	
+	// The mesh renderer that displays the face. Its materials are pointed at this controller's face texture.
+	void SetMeshRenderer(MeshRenderer* meshRenderer) { mMeshRenderer = meshRenderer; }
+	
 	void Set(FaceElement element, Texture* texture);
 	void Clear(FaceElement element);
 	
@@ -64,6 +69,11 @@ public:
 	void SetMood(const std::string& mood);
 	void ClearMood();
 	
+	// Building the face texture is CPU-heavy, so it's done in parallel with other actors. Changes are uploaded after.
+	bool HasParallelWork() const override { return mFaceTextureDirty && mFaceTexture != nullptr; }
+	void ParallelUpdate() override;
+	void FinishParallelUpdate() override;
+	
 protected:
 	void OnUpdate(float deltaTime) override;
 	
@@ -71,10 +81,21 @@ private:
 	// The character config assigned by owner.
 	const CharacterConfig* mCharacterConfig = nullptr;
 	
+	// The face asset from disk. Actors using the same character config share it, so it's never written to.
+	Texture* mFaceAssetTexture = nullptr;
+	
 	// The "final" face texture, which is written to for the final result.
-	// Currently, we just write directly into the face asset from disk...maybe not smart.
+	// A copy of the face asset owned by this controller, so faces can be built in parallel.
 	Texture* mFaceTexture = nullptr;
 	
+	// Displays the face, and the model whose materials were last pointed at the face texture.
+	// Materials are recreated when the model changes, so they need to be pointed at it again.
+	MeshRenderer* mMeshRenderer = nullptr;
+	Model* mFaceModel = nullptr;
+	
+	// If true, face elements have changed, so the face texture needs to be rebuilt.
+	bool mFaceTextureDirty = false;
+	
 	// Whatever is currently set for each texture, so we can reconstruct the face whenever we need to.
 	Texture* mCurrentMouthTexture = nullptr;
 	Texture* mCurrentEyelidsTexture = nullptr;
@@ -117,4 +138,5 @@ private:
 	void RollEyeJitterTimer();
 
 	void UpdateFaceTexture();
+	void ApplyFaceTexture();
 };
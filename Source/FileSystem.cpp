@@ -5,6 +5,7 @@
 //
 #include "FileSystem.h"
 
+#include <climits>
 #include <fstream>
 
 #include "Platform.h"
@@ -12,6 +13,10 @@
 #include <CoreFoundation/CoreFoundation.h>
 #include <dirent.h>
 #include <sys/stat.h>
+#elif defined(PLATFORM_LINUX)
+#include <cerrno>
+#include <dirent.h>
+#include <sys/stat.h>
 #elif defined(PLATFORM_WINDOWS)
 #include <Windows.h>
 #endif
@@ -89,6 +94,35 @@ bool Path::FindFullPath(const std::string& fileName, const std::string& relative
 	return false;
 }
 
+bool Path::FindFullDirectoryPath(const std::string& relativeSearchPath, std::string& outPath)
+{
+#if defined(PLATFORM_MAC)
+	// Resources in the main bundle are found relative to the bundle's resources directory.
+	CFBundleRef bundleRef = CFBundleGetMainBundle();
+	if(bundleRef != nullptr)
+	{
+		CFURLRef resourcesUrl = CFBundleCopyResourcesDirectoryURL(bundleRef);
+		if(resourcesUrl != nullptr)
+		{
+			char resourcesPath[PATH_MAX];
+			bool gotPath = CFURLGetFileSystemRepresentation(resourcesUrl, true, reinterpret_cast<UInt8*>(resourcesPath), PATH_MAX);
+			CFRelease(resourcesUrl);
+			
+			if(gotPath)
+			{
+				outPath = std::string(resourcesPath) + kSeparator + relativeSearchPath;
+				if(Directory::Exists(outPath)) { return true; }
+			}
+		}
+	}
+	//NOTE: if not found in bundle, we purposely drop through to "failsafe" method below.
+#endif
+	
+	// Failsafe: assume the path is relative to the current working directory.
+	outPath = relativeSearchPath;
+	return Directory::Exists(outPath);
+}
+
 std::string Path::GetFileName(const std::string& path)
 {
 	// Make sure there's any content in the path argument.
@@ -135,7 +169,7 @@ std::string Path::GetFileNameNoExtension(const std::string& path)
 
 bool Directory::Exists(const std::string& path)
 {
-#if defined(PLATFORM_MAC)
+#if defined(PLATFORM_MAC) || defined(PLATFORM_LINUX)
 	DIR* directoryStream = opendir(path.c_str());
 	if (directoryStream == nullptr)
 	{
@@ -152,7 +186,7 @@ bool Directory::Exists(const std::string& path)
 	if (fileAttributes == INVALID_FILE_ATTRIBUTES) { return false; }
 
 	// If attribute has directory flag, it is a directory and it does exist!
-	if (fileAttributes & FILE_ATTRIBUTE_DIRECTORY != 0) { return true; }
+	if ((fileAttributes & FILE_ATTRIBUTE_DIRECTORY) != 0) { return true; }
 
 	// This is not a directory.
 	return false;
@@ -161,7 +195,7 @@ bool Directory::Exists(const std::string& path)
 
 bool Directory::Create(const std::string& path)
 {
-#if defined(PLATFORM_MAC)
+#if defined(PLATFORM_MAC) || defined(PLATFORM_LINUX)
 	// Makes the directory with Read/Write/Execute permissions for User and Group, Read/Execute for Other.
 	const int result = mkdir(path.c_str(), S_IRWXU | S_IRWXG | S_IROTH | S_IXOTH);
 
@@ -193,3 +227,46 @@ bool Directory::Create(const std::string& path)
 	return true;
 #endif
 }
+
+bool Directory::GetFiles(const std::string& path, std::vector<std::string>& outFileNames)
+{
+#if defined(PLATFORM_MAC) || defined(PLATFORM_LINUX)
+	DIR* directoryStream = opendir(path.c_str());
+	if(directoryStream == nullptr) { return false; }
+	
+	// Read each entry, skipping directories.
+	struct dirent* entry = nullptr;
+	while((entry = readdir(directoryStream)) != nullptr)
+	{
+		if(entry->d_type != DT_DIR)
+		{
+			outFileNames.push_back(entry->d_name);
+		}
+	}
+	closedir(directoryStream);
+	return true;
+#elif defined(PLATFORM_WINDOWS)
+	// The search pattern needs a wildcard to match everything in the directory.
+	std::string searchPattern = path;
+	if(!searchPattern.empty() && searchPattern.back() != '/' && searchPattern.back() != '\\')
+	{
+		searchPattern += Path::kSeparator;
+	}
+	searchPattern += "*";
+	
+	WIN32_FIND_DATAA findData;
+	HANDLE findHandle = FindFirstFileA(searchPattern.c_str(), &findData);
+	if(findHandle == INVALID_HANDLE_VALUE) { return false; }
+	
+	// Read each entry, skipping directories.
+	do
+	{
+		if((findData.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) == 0)
+		{
+			outFileNames.push_back(findData.cFileName);
+		}
+	} while(FindNextFileA(findHandle, &findData));
+	FindClose(findHandle);
+	return true;
+#endif
+}
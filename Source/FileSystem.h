@@ -8,6 +8,7 @@
 #pragma once
 #include <iostream>
 #include <string>
+#include <vector>
 
 #include "Platform.h"
 #include "StringTokenizer.h"
@@ -35,6 +36,12 @@ namespace Path
 	 * But on some platforms (like OSX), getting a resource that exists in the app bundle is not entirely straightforward.
 	 */
 	bool FindFullPath(const std::string& fileName, const std::string& relativeSearchPath, std::string& outPath);
+	
+	/**
+	 * Like FindFullPath, but for a directory: given a relative search path (like "Assets/"), determines if
+	 * the directory exists (return value) and a full path (via out variable) that can be used to access it.
+	 */
+	bool FindFullDirectoryPath(const std::string& relativeSearchPath, std::string& outPath);
 
 	/**
 	 * Given a path, returns the name of the file only.
@@ -68,6 +75,13 @@ namespace Directory
 	 */
 	bool Create(const std::string& path);
 	
+	/**
+	 * Gets the names of all files (not sub-directories) in the directory at path.
+	 *
+	 * Returns false if the directory couldn't be read.
+	 */
+	bool GetFiles(const std::string& path, std::vector<std::string>& outFileNames);
+	
 	/**
 	 * Makes one or more directories in a given path.
 	 *
@@ -211,4 +211,7 @@ void Font::ParseFromData(char* data, int dataLength)
 	{
 		mFontTexture = Services::GetAssets()->LoadTexture(GetNameNoExtension());
 	}
+	
+	// Fonts are used across scenes, so the font texture must stay loaded.
+	Services::GetAssets()->AcquireAsset(mFontTexture);
 }
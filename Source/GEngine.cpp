@@ -14,6 +14,7 @@
 #include "ConsoleUI.h"
 #include "Debug.h"
 #include "DialogueManager.h"
+#include "FaceController.h"
 #include "FootstepManager.h"
 #include "GameProgress.h"
 #include "InventoryManager.h"
@@ -22,6 +23,7 @@
 #include "Scene.h"
 #include "Services.h"
 #include "TextInput.h"
+#include "VertexAnimator.h"
 
 GEngine* GEngine::sInstance = nullptr;
 
@@ -40,6 +42,9 @@ bool GEngine::Initialize()
 	Services::SetConsole(&mConsole);
 	mConsole.SetReportStream(&mReportManager.GetReportStream("Console"));
 	
+	// Initialize worker threads before any subsystem queues jobs.
+	Services::SetJobs(&mThreadPool);
+	
     // Initialize asset manager.
     Services::SetAssets(&mAssetManager);
     
@@ -92,6 +97,7 @@ bool GEngine::Initialize()
     
     // Initialize sheep manager.
     Services::SetSheep(&mSheepManager);
+    mSheepManager.SetCacheDirectory("Cache/Sheep/");
     
     //SDL_Log(SDL_GetBasePath());
     //SDL_Log(SDL_GetPrefPath("Test", "GK3"));
@@ -141,6 +147,11 @@ bool GEngine::Initialize()
     Services::Set<VideoPlayer>(&mVideoPlayer);
     mVideoPlayer.Initialize();
     
+	// The scene loader decides when a loading scene is the current scene.
+	mSceneLoader.SetCurrentSceneCallback([this](Scene* scene) {
+		mScene = scene;
+	});
+	
 	// Create console UI - this persists for the entire game.
 	ConsoleUI* consoleUI = new ConsoleUI(false);
 	consoleUI->SetIsDestroyOnLoad(false);
@@ -209,6 +220,9 @@ void GEngine::Run()
 		
 		// After frame is done, check whether we need a scene change.
 		LoadSceneInternal();
+		
+		// If a scene is loading, do the next bit of loading.
+		mSceneLoader.Update();
     }
 }
 
@@ -257,6 +271,8 @@ void GEngine::ProcessInput()
     mInputManager.Update();
     
     // We'll poll for events here. Catch the quit event.
+    // While a scene is loading, text input is dropped - typing into the console could run commands that use the scene.
+    bool loading = mSceneLoader.IsLoading();
     SDL_Event event;
     while(SDL_PollEvent(&event))
     {
@@ -264,6 +280,7 @@ void GEngine::ProcessInput()
         {
 			case SDL_KEYDOWN:
 			{
+				if(loading) { break; }
 				if(event.key.keysym.sym == SDLK_BACKSPACE)
 				{
 					TextInput* textInput = mInputManager.GetTextInput();
@@ -319,7 +336,7 @@ void GEngine::ProcessInput()
 			{
 				//TODO: Make sure not copy or pasting.
 				TextInput* textInput = mInputManager.GetTextInput();
-				if(textInput != nullptr)
+				if(textInput != nullptr && !loading)
 				{
 					textInput->Insert(event.text.text);
 				}
@@ -367,24 +384,35 @@ void GEngine::Update()
     if(deltaTime > 0.05f) { deltaTime = 0.05f; }
     
     // Update all actors.
-    for(size_t i = 0; i < mActors.size(); i++)
+    // While a scene is loading, it isn't safe to use yet - so anything that could use the scene (actors, and the console UI
+    // and sheeps they run) is paused until loading finishes.
+    bool loading = mSceneLoader.IsLoading();
+    if(!loading)
     {
-        mActors[i]->Update(deltaTime);
+        for(size_t i = 0; i < mActors.size(); i++)
+        {
+            mActors[i]->Update(deltaTime);
+        }
+		UpdateParallelWork();
     }
 	
 	// Delete any destroyed actors.
 	DeleteDestroyedActors();
     
     // Also update audio system (before or after actors?)
-    mAudioManager.Update(deltaTime);
+    // This is also paused while loading, so nothing waiting on audio resumes before the scene is ready.
+    if(!loading)
+    {
+        mAudioManager.Update(deltaTime);
+    }
     
     // Update video playback.
     mVideoPlayer.Update();
     
     // TODO: Move to CursorManager or something.
-	// If a sheep is running, show "wait" cursor.
+	// If a scene is loading or a sheep is running, show "wait" cursor.
 	// If not, go back to normal cursor.
-	if(mActionManager.IsActionPlaying())
+	if(loading || mActionManager.IsActionPlaying())
 	{
 		UseWaitCursor();
 	}
@@ -406,6 +434,56 @@ void GEngine::Update()
 	Debug::Update(deltaTime);
 }
 
+void GEngine::UpdateParallelWork()
+{
+	// Gather up components that have CPU-heavy work to do this frame.
+	// Only a couple component types have parallel work, so walk their pools rather than every component of every actor.
+	mParallelWorkComponents.clear();
+	ComponentPool<VertexAnimator>::ForEach([this](VertexAnimator* vertexAnimator) {
+		if(vertexAnimator->HasParallelWork() && vertexAnimator->GetOwner()->IsActive())
+		{
+			mParallelWorkComponents.push_back(vertexAnimator);
+		}
+	});
+	
+	// Face changes are built even for inactive actors, so the face is up to date if they become active.
+	ComponentPool<FaceController>::ForEach([this](FaceController* faceController) {
+		if(faceController->HasParallelWork())
+		{
+			mParallelWorkComponents.push_back(faceController);
+		}
+	});
+	
+	// Do the work in parallel, and wait for it all to finish. The main thread helps out while waiting.
+	// One job per component, so the pool can balance out components that have more work than others.
+	if(mParallelUpdateEnabled && mParallelWorkComponents.size() > 1)
+	{
+		// Other systems may have jobs in the pool too, so only wait for these.
+		std::atomic<int> pendingCount(static_cast<int>(mParallelWorkComponents.size()));
+		for(auto& component : mParallelWorkComponents)
+		{
+			mThreadPool.Enqueue([component, &pendingCount]() {
+				component->ParallelUpdate();
+				--pendingCount;
+			});
+		}
+		mThreadPool.WaitForCount(pendingCount);
+	}
+	else
+	{
+		for(auto& component : mParallelWorkComponents)
+		{
+			component->ParallelUpdate();
+		}
+	}
+	
+	// Apply results on the main thread (e.g. uploading to the GPU).
+	for(auto& component : mParallelWorkComponents)
+	{
+		component->FinishParallelUpdate();
+	}
+}
+
 void GEngine::GenerateOutputs()
 {
     mRenderer.Render();
@@ -420,6 +498,9 @@ void GEngine::LoadSceneInternal()
 {
 	if(mSceneToLoad.empty()) { return; }
 	
+	// Can't change scenes in the middle of loading one - wait until done.
+	if(mSceneLoader.IsLoading()) { return; }
+	
 	// Delete the current scene, if any.
 	if(mScene != nullptr)
 	{
@@ -440,14 +521,12 @@ void GEngine::LoadSceneInternal()
 	// After destroy pass, delete destroyed actors.
 	DeleteDestroyedActors();
 	
-	// Create the new scene.
+	// Create the new scene and start loading it.
+	// Loading happens over the next several frames (see SceneLoader), so the game doesn't freeze during the load.
+	// The scene only becomes the current scene for good once it's done loading (see SceneLoader).
 	//TODO: Scene constructor should probably ONLY take a scene name.
 	//TODO: Internally, we can call to GameProgress or whatnot as needed, but that's very GK3-specific stuff.
-	mScene = new Scene(mSceneToLoad, Services::Get<GameProgress>()->GetTimeblock());
-	
-	// Load the scene - this is separate from constructor
-	// b/c load operations may need to reference the scene itself!
-	mScene->Load();
+	mSceneLoader.Start(mSceneToLoad, Services::Get<GameProgress>()->GetTimeblock());
 	
 	// Clear scene load request.
 	mSceneToLoad.clear();
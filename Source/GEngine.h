@@ -15,11 +15,14 @@
 #include "Console.h"
 #include "InputManager.h"
 #include "Renderer.h"
+#include "SceneLoader.h"
 #include "SheepManager.h"
 #include "ReportManager.h"
+#include "ThreadPool.h"
 #include "VideoPlayer.h"
 
 class Actor;
+class Component;
 class Scene;
 class Cursor;
 
@@ -41,9 +44,17 @@ public:
 	void LoadScene(std::string name) { mSceneToLoad = name; }
     Scene* GetScene() { return mScene; }
 	
+	// Scene loads are spread over several frames - query/observe load progress via the loader.
+	bool IsLoadingScene() const { return mSceneLoader.IsLoading(); }
+	SceneLoader* GetSceneLoader() { return &mSceneLoader; }
+	
 	void UseDefaultCursor();
 	void UseHighlightCursor();
 	void UseWaitCursor();
+	
+	// If disabled, components' parallel work runs one after another on the main thread. Useful for debugging and profiling.
+	void SetParallelUpdateEnabled(bool enabled) { mParallelUpdateEnabled = enabled; }
+	bool IsParallelUpdateEnabled() const { return mParallelUpdateEnabled; }
     
 private:
     // Only one instance of GEngine can exist.
@@ -53,6 +64,10 @@ private:
 	// False by default, but set to true after initialization.
 	bool mRunning = false;
     
+	// Worker threads shared by all subsystems.
+	// Declared before the subsystems, so it's destroyed after them - they may wait on jobs when destroyed.
+	ThreadPool mThreadPool;
+	
     // Subsystems.
     Renderer mRenderer;
     AudioManager mAudioManager;
@@ -66,6 +81,12 @@ private:
     
     // A list of all actors that currently exist in the game.
     std::vector<Actor*> mActors;
+	
+	// Run components' parallel work each frame on the thread pool (see Component::HasParallelWork)?
+	bool mParallelUpdateEnabled = true;
+	
+	// Components with parallel work this frame. Kept around to avoid reallocating every frame.
+	std::vector<Component*> mParallelWorkComponents;
     
     // The currently active scene. There can be only one at a time (sure about that?).
     Scene* mScene = nullptr;
@@ -74,6 +95,9 @@ private:
 	// Scene loads happen at the end of a frame, to avoid a scene change mid-frame.
 	std::string mSceneToLoad;
 	
+	// Loads the scene over several frames after a scene change.
+	SceneLoader mSceneLoader;
+	
 	// Cursors - maybe move these into a manager at some point?
 	Cursor* mActiveCursor = nullptr;
 	Cursor* mDefaultCursor = nullptr;
@@ -86,6 +110,7 @@ private:
     
     void ProcessInput();
     void Update();
+    void UpdateParallelWork();
     void GenerateOutputs();
 	
 	void LoadSceneInternal();
@@ -52,6 +52,7 @@ GKActor::GKActor(const std::string& identifier) : GKObject(),
 	// Create and configure face controller.
 	mFaceController = AddComponent<FaceController>();
 	mFaceController->SetCharacterConfig(config);
+	mFaceController->SetMeshRenderer(mMeshRenderer);
 	
 	// Add walker and configure it.
 	mWalker = AddComponent<Walker>();
@@ -23,7 +23,7 @@ namespace Math
     
     inline float Sqrt(float val)
     {
-        return std::sqrtf(val);
+        return std::sqrt(val);
     }
     
     inline float InvSqrt(float val)
@@ -31,12 +31,12 @@ namespace Math
         //TODO: this could be replaced by a faster (but approximate) calculation
         //TODO: the famous "fast inverse square root!"
         //TODO: https://www.slideshare.net/maksym_zavershynskyi/fast-inverse-square-root
-        return (1.0f / std::sqrtf(val));
+        return (1.0f / std::sqrt(val));
     }
     
     inline bool IsZero(float val)
     {
-		return (std::fabsf(val) < kEpsilon);
+		return (std::fabs(val) < kEpsilon);
     }
     
     inline bool AreEqual(float a, float b)
@@ -62,32 +62,32 @@ namespace Math
     
     inline float Sin(float radians)
     {
-        return std::sinf(radians);
+        return std::sin(radians);
     }
     
     inline float Asin(float ratio)
     {
-        return std::asinf(ratio);
+        return std::asin(ratio);
     }
     
     inline float Cos(float radians)
     {
-        return std::cosf(radians);
+        return std::cos(radians);
     }
     
     inline float Acos(float ratio)
     {
-        return std::acosf(ratio);
+        return std::acos(ratio);
     }
     
     inline float Tan(float radians)
     {
-        return std::tanf(radians);
+        return std::tan(radians);
     }
     
     inline float Atan(float ratio)
     {
-        return std::atanf(ratio);
+        return std::atan(ratio);
     }
 
 	inline float Atan2(float y, float x)
@@ -14,6 +14,7 @@ TYPE_DEF_BASE(GameProgress);
 
 void GameProgress::SetScore(int score)
 {
+	++mChangeCount;
 	mScore = Math::Clamp(score, 0, kMaxScore);
 }
 
@@ -24,6 +25,7 @@ void GameProgress::IncreaseScore(int points)
 
 void GameProgress::SetTimeblock(const Timeblock& timeblock)
 {
+	++mChangeCount;
 	mLastTimeblock = mTimeblock;
 	mTimeblock = timeblock;
 	
@@ -47,12 +49,16 @@ bool GameProgress::GetFlag(const std::string& flagName) const
 
 void GameProgress::SetFlag(const std::string& flagName)
 {
+	++mChangeCount;
+	
 	// Doesn't matter whether we are setting an already set flag.
 	mGameFlags.insert(flagName);
 }
 
 void GameProgress::ClearFlag(const std::string& flagName)
 {
+	++mChangeCount;
+	
 	// Erase the flag from the container to "clear" it.
 	auto it = mGameFlags.find(flagName);
 	if(it != mGameFlags.end())
@@ -73,11 +79,13 @@ int GameProgress::GetGameVariable(const std::string& varName) const
 
 void GameProgress::SetGameVariable(const std::string& varName, int value)
 {
+	++mChangeCount;
 	mGameVariables[StringUtil::ToLowerCopy(varName)] = value;
 }
 
 void GameProgress::IncGameVariable(const std::string& varName)
 {
+	++mChangeCount;
 	++mGameVariables[StringUtil::ToLowerCopy(varName)];
 }
 
@@ -93,11 +101,13 @@ int GameProgress::GetChatCount(const std::string& noun) const
 
 void GameProgress::SetChatCount(const std::string& noun, int count)
 {
+	++mChangeCount;
 	mChatCounts[StringUtil::ToLowerCopy(noun)] = count;
 }
 
 void GameProgress::IncChatCount(const std::string& noun)
 {
+	++mChangeCount;
 	++mChatCounts[StringUtil::ToLowerCopy(noun)];
 }
 
@@ -119,6 +129,8 @@ int GameProgress::GetTopicCount(const std::string& noun, const std::string& topi
 
 void GameProgress::SetTopicCount(const std::string& noun, const std::string& topic, int count)
 {
+	++mChangeCount;
+	
 	// Key is noun+topic.
 	// Make sure it's all lowercase, for consistency.
 	std::string key = noun + topic;
@@ -128,6 +140,8 @@ void GameProgress::SetTopicCount(const std::string& noun, const std::string& top
 
 void GameProgress::IncTopicCount(const std::string& noun, const std::string& topic)
 {
+	++mChangeCount;
+	
 	// Key is noun+topic.
 	// Make sure it's all lowercase, for consistency.
 	std::string key = noun + topic;
@@ -153,6 +167,8 @@ int GameProgress::GetNounVerbCount(const std::string& noun, const std::string& v
 
 void GameProgress::SetNounVerbCount(const std::string& noun, const std::string& verb, int count)
 {
+	++mChangeCount;
+	
 	// Key is noun+verb.
 	// Make sure it's all lowercase, for consistency.
 	std::string key = noun + verb;
@@ -162,6 +178,8 @@ void GameProgress::SetNounVerbCount(const std::string& noun, const std::string&
 
 void GameProgress::IncNounVerbCount(const std::string& noun, const std::string& verb)
 {
+	++mChangeCount;
+	
 	// Key is noun+verb.
 	// Make sure it's all lowercase, for consistency.
 	std::string key = noun + verb;
@@ -50,6 +50,10 @@ public:
 	void SetNounVerbCount(const std::string& noun, const std::string& verb, int count);
 	void IncNounVerbCount(const std::string& noun, const std::string& verb);
 	
+	// Incremented whenever any game progress changes.
+	// Compare against a previous value to know whether anything derived from game progress is out of date.
+	unsigned int GetChangeCount() const { return mChangeCount; }
+	
 private:
 	// Score tracking.
     const int kMaxScore = 965; //TODO: Should be loaded from GAME.CFG
@@ -77,5 +81,8 @@ private:
 	// Maps a variable name to an integer value.
 	// For general game logic variables.
 	std::unordered_map<std::string, int> mGameVariables;
+	
+	// Number of times game progress has changed.
+	unsigned int mChangeCount = 0;
 };
 
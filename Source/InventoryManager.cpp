@@ -66,8 +66,10 @@ InventoryManager::InventoryManager()
 				textures.listTexture->UploadToGPU();
 			}
 			
-			// Save to map.
+			// Save to map. Inventory textures are used across scenes, so they must stay loaded.
 			mInventoryItems[StringUtil::ToLowerCopy(entry.key)] = textures;
+			Services::GetAssets()->AcquireAsset(textures.closeupTexture);
+			Services::GetAssets()->AcquireAsset(textures.listTexture);
 	    }
 	}
 	delete[] buffer;
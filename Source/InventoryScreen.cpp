@@ -34,10 +34,22 @@ InventoryScreen::InventoryScreen() : Actor(TransformType::RectTransform)
 	UIButton* exitButton = exitButtonActor->AddComponent<UIButton>();
 	mCanvas->AddWidget(exitButton);
 	
-	exitButton->SetUpTexture(Services::GetAssets()->LoadTexture("EXITN.BMP"));
-	exitButton->SetDownTexture(Services::GetAssets()->LoadTexture("EXITD.BMP"));
-	exitButton->SetHoverTexture(Services::GetAssets()->LoadTexture("EXITHOV.BMP"));
-	exitButton->SetDisabledTexture(Services::GetAssets()->LoadTexture("EXITDIS.BMP"));
+	Texture* exitTextures[] = {
+		Services::GetAssets()->LoadTexture("EXITN.BMP"),
+		Services::GetAssets()->LoadTexture("EXITD.BMP"),
+		Services::GetAssets()->LoadTexture("EXITHOV.BMP"),
+		Services::GetAssets()->LoadTexture("EXITDIS.BMP")
+	};
+	exitButton->SetUpTexture(exitTextures[0]);
+	exitButton->SetDownTexture(exitTextures[1]);
+	exitButton->SetHoverTexture(exitTextures[2]);
+	exitButton->SetDisabledTexture(exitTextures[3]);
+	
+	// This screen is kept across scenes, so its textures must stay loaded.
+	for(Texture* texture : exitTextures)
+	{
+		Services::GetAssets()->AcquireAsset(texture);
+	}
 	exitButton->SetPressCallback(std::bind(&InventoryScreen::Hide, this));
 	
 	RectTransform* exitButtonRectTransform = exitButtonActor->GetComponent<RectTransform>();
@@ -50,7 +62,9 @@ InventoryScreen::InventoryScreen() : Actor(TransformType::RectTransform)
 	// Create active inventory item highlight, but hide by default.
 	Actor* activeHighlightActor = new Actor(TransformType::RectTransform);
 	mActiveHighlightImage = activeHighlightActor->AddComponent<UIImage>();
-	mActiveHighlightImage->SetTextureAndSize(Services::GetAssets()->LoadTexture("INV_HIGHLIGHT.BMP"));
+	Texture* highlightTexture = Services::GetAssets()->LoadTexture("INV_HIGHLIGHT.BMP");
+	mActiveHighlightImage->SetTextureAndSize(highlightTexture);
+	Services::GetAssets()->AcquireAsset(highlightTexture);
 	mActiveHighlightImage->SetEnabled(false);
 	mCanvas->AddWidget(mActiveHighlightImage);
 	
@@ -0,0 +1,35 @@
+//
+// LoadSequence.cpp
+//
+// Clark Kromenaker
+//
+#include "LoadSequence.h"
+
+void LoadSequence::Start(std::vector<std::function<void()>> steps)
+{
+	mSteps = std::move(steps);
+	mNextStepIndex = 0;
+}
+
+void LoadSequence::Update()
+{
+	if(!IsLoading()) { return; }
+	if(mReadyCheck != nullptr && !mReadyCheck()) { return; }
+
+	if(mBeforeStep != nullptr)
+	{
+		mBeforeStep();
+	}
+	mSteps[mNextStepIndex]();
+	++mNextStepIndex;
+	if(mAfterStep != nullptr)
+	{
+		mAfterStep();
+	}
+}
+
+float LoadSequence::GetProgress() const
+{
+	if(mSteps.empty()) { return 1.0f; }
+	return static_cast<float>(mNextStepIndex) / static_cast<float>(mSteps.size());
+}
@@ -0,0 +1,46 @@
+//
+// LoadSequence.h
+//
+// Clark Kromenaker
+//
+// A series of load steps, spread out over several frames - at most one step runs per update.
+// A step only runs once whatever it needs is ready (e.g. assets it uses are done prefetching).
+//
+#pragma once
+#include <cstddef>
+#include <functional>
+#include <vector>
+
+class LoadSequence
+{
+public:
+	// Starts over with a new series of steps, to be run in order.
+	void Start(std::vector<std::function<void()>> steps);
+
+	// Performs the next step, if it's ready. Call once per frame.
+	void Update();
+
+	bool IsLoading() const { return mNextStepIndex < mSteps.size(); }
+
+	// Fraction of steps done, from 0 to 1.
+	float GetProgress() const;
+
+	// If set, the next step only runs once this returns true.
+	void SetReadyCheck(std::function<bool()> readyCheck) { mReadyCheck = readyCheck; }
+
+	// Called right before and right after each step runs.
+	// When called after the final step, the sequence is no longer loading.
+	void SetStepCallbacks(std::function<void()> beforeStep, std::function<void()> afterStep)
+	{
+		mBeforeStep = beforeStep;
+		mAfterStep = afterStep;
+	}
+
+private:
+	std::vector<std::function<void()>> mSteps;
+	size_t mNextStepIndex = 0;
+
+	std::function<bool()> mReadyCheck = nullptr;
+	std::function<void()> mBeforeStep = nullptr;
+	std::function<void()> mAfterStep = nullptr;
+};
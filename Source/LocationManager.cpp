@@ -177,6 +177,7 @@ void LocationManager::SetLocation(const std::string& location)
 {
 	mLastLocation = mLocation;
 	mLocation = location;
+	++mChangeCount;
 }
 
 std::string LocationManager::GetLocationDisplayName() const
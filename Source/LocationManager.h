@@ -27,6 +27,9 @@ public:
 	std::string GetLocation() const { return mLocation; }
 	std::string GetLastLocation() const { return mLastLocation; }
 	void SetLocation(const std::string& location);
+	
+	// Incremented whenever the current location changes.
+	unsigned int GetChangeCount() const { return mChangeCount; }
     
     std::string GetLocationDisplayName() const;
     std::string GetLocationDisplayName(const std::string& location) const;
@@ -59,6 +62,7 @@ private:
 	// Current and last location.
 	std::string mLocation = "non";
 	std::string mLastLocation = "non";
+	unsigned int mChangeCount = 0;
 	
 	// Location counts for actors. We track lifetime times an actor visits a location AND per-timeblock counts.
 	// Key is actorName+location (e.g. gabrielr25) or actorName+locationId+timeblockCode (e.g. gabrielr25110a).
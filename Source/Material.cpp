@@ -5,6 +5,7 @@
 //
 #include "Material.h"
 
+#include "BufferTexture.h"
 #include "Matrix4.h"
 #include "Shader.h"
 #include "Texture.h"
@@ -63,9 +64,27 @@ void Material::Activate(const Matrix4& objectToWorldMatrix)
         mShader->SetUniformColor(entry.first.c_str(), entry.second);
     }
     
+    // Set user-defined float and int values.
+    for(auto& entry : mFloats)
+    {
+        mShader->SetUniformFloat(entry.first.c_str(), entry.second);
+    }
+    for(auto& entry : mInts)
+    {
+        mShader->SetUniformInt(entry.first.c_str(), entry.second);
+    }
+    
     // Set user-defined textures.
     int textureUnit = 0;
     for(auto& entry : mTextures)
+    {
+        mShader->SetUniformInt(entry.first.c_str(), textureUnit);
+        entry.second->Activate(textureUnit);
+        ++textureUnit;
+    }
+    
+    // Buffer textures use the texture units after regular textures.
+    for(auto& entry : mBufferTextures)
     {
         mShader->SetUniformInt(entry.first.c_str(), textureUnit);
         entry.second->Activate(textureUnit);
@@ -95,6 +114,28 @@ Texture* Material::GetTexture(const std::string& name) const
     return nullptr;
 }
 
+void Material::SetFloat(const std::string& name, float value)
+{
+    mFloats[name] = value;
+}
+
+void Material::SetInt(const std::string& name, int value)
+{
+    mInts[name] = value;
+}
+
+void Material::SetBufferTexture(const std::string& name, BufferTexture* bufferTexture)
+{
+    if(bufferTexture != nullptr)
+    {
+        mBufferTextures[name] = bufferTexture;
+    }
+    else
+    {
+        mBufferTextures.erase(name);
+    }
+}
+
 bool Material::IsTranslucent()
 {
 	//TODO: Maybe use render queue value for this?
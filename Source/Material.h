@@ -13,6 +13,7 @@
 #include "Color32.h"
 #include "Matrix4.h"
 
+class BufferTexture;
 class Shader;
 class Texture;
 
@@ -38,6 +39,16 @@ public:
     void SetTexture(const std::string& name, Texture* texture);
     Texture* GetTexture(const std::string& name) const;
     
+    void SetFloat(const std::string& name, float value);
+    void SetInt(const std::string& name, int value);
+    
+    // Removes a uniform, so it's no longer set when the material is activated.
+    void RemoveFloat(const std::string& name) { mFloats.erase(name); }
+    void RemoveInt(const std::string& name) { mInts.erase(name); }
+    
+    // Passing null removes the buffer texture.
+    void SetBufferTexture(const std::string& name, BufferTexture* bufferTexture);
+    
     // Helpers for setting/getting frequently accessed shader uniforms.
     void SetColor(const Color32& color) { SetColor("uColor", color); }
     
@@ -56,6 +67,9 @@ private:
     
     std::unordered_map<std::string, Color32> mColors;
     std::unordered_map<std::string, Texture*> mTextures;
+    std::unordered_map<std::string, float> mFloats;
+    std::unordered_map<std::string, int> mInts;
+    std::unordered_map<std::string, BufferTexture*> mBufferTextures;
     
     //TODO: Opaque vs. transparent? Render queue value?
 };
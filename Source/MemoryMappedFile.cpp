@@ -0,0 +1,99 @@
+//
+// MemoryMappedFile.cpp
+//
+// Clark Kromenaker
+//
+#include "MemoryMappedFile.h"
+
+#include <iostream>
+
+#include "Platform.h"
+#if defined(PLATFORM_MAC) || defined(PLATFORM_LINUX)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#elif defined(PLATFORM_WINDOWS)
+#include <Windows.h>
+#endif
+
+MemoryMappedFile::MemoryMappedFile(const std::string& filePath)
+{
+#if defined(PLATFORM_MAC) || defined(PLATFORM_LINUX)
+	// Open the file and figure out how big it is.
+	int fileDescriptor = open(filePath.c_str(), O_RDONLY);
+	if(fileDescriptor < 0)
+	{
+		std::cout << "MemoryMappedFile can't open file " << filePath << "!" << std::endl;
+		return;
+	}
+
+	struct stat fileStats;
+	if(fstat(fileDescriptor, &fileStats) != 0 || fileStats.st_size <= 0)
+	{
+		close(fileDescriptor);
+		return;
+	}
+
+	// Map the whole file as read-only. The file descriptor isn't needed after the mapping exists.
+	void* data = mmap(nullptr, static_cast<size_t>(fileStats.st_size), PROT_READ, MAP_PRIVATE, fileDescriptor, 0);
+	close(fileDescriptor);
+	if(data == MAP_FAILED)
+	{
+		std::cout << "MemoryMappedFile can't map file " << filePath << "!" << std::endl;
+		return;
+	}
+	mData = static_cast<const char*>(data);
+	mLength = static_cast<unsigned int>(fileStats.st_size);
+#elif defined(PLATFORM_WINDOWS)
+	// Open the file and figure out how big it is.
+	HANDLE fileHandle = CreateFileA(filePath.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+	if(fileHandle == INVALID_HANDLE_VALUE)
+	{
+		std::cout << "MemoryMappedFile can't open file " << filePath << "!" << std::endl;
+		return;
+	}
+
+	LARGE_INTEGER fileSize;
+	if(!GetFileSizeEx(fileHandle, &fileSize) || fileSize.QuadPart <= 0)
+	{
+		CloseHandle(fileHandle);
+		return;
+	}
+
+	// Create a read-only mapping object and map a view of the whole file.
+	// On 32-bit builds, this can fail for large files due to lack of address space.
+	HANDLE mappingHandle = CreateFileMappingA(fileHandle, NULL, PAGE_READONLY, 0, 0, NULL);
+	if(mappingHandle == NULL)
+	{
+		std::cout << "MemoryMappedFile can't map file " << filePath << "!" << std::endl;
+		CloseHandle(fileHandle);
+		return;
+	}
+
+	void* data = MapViewOfFile(mappingHandle, FILE_MAP_READ, 0, 0, 0);
+	if(data == nullptr)
+	{
+		std::cout << "MemoryMappedFile can't map file " << filePath << "!" << std::endl;
+		CloseHandle(mappingHandle);
+		CloseHandle(fileHandle);
+		return;
+	}
+	mFileHandle = fileHandle;
+	mMappingHandle = mappingHandle;
+	mData = static_cast<const char*>(data);
+	mLength = static_cast<unsigned int>(fileSize.QuadPart);
+#endif
+}
+
+MemoryMappedFile::~MemoryMappedFile()
+{
+	if(mData == nullptr) { return; }
+#if defined(PLATFORM_MAC) || defined(PLATFORM_LINUX)
+	munmap(const_cast<char*>(mData), mLength);
+#elif defined(PLATFORM_WINDOWS)
+	UnmapViewOfFile(mData);
+	CloseHandle(mMappingHandle);
+	CloseHandle(mFileHandle);
+#endif
+}
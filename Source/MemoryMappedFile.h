@@ -0,0 +1,38 @@
+//
+// MemoryMappedFile.h
+//
+// Clark Kromenaker
+//
+// A read-only view of an entire file, mapped into memory by the OS.
+// Reading from the mapping avoids seeking and copying through a file stream;
+// pages are loaded on demand and shared with the OS file cache.
+//
+#pragma once
+#include <string>
+
+class MemoryMappedFile
+{
+public:
+	MemoryMappedFile(const std::string& filePath);
+	~MemoryMappedFile();
+
+	// Mapping can fail (file missing, not enough address space, etc).
+	// Only use data if this returns true!
+	bool IsMapped() const { return mData != nullptr; }
+
+	const char* GetData() const { return mData; }
+	unsigned int GetLength() const { return mLength; }
+
+private:
+	// Start of mapped data, and length of that data in bytes.
+	const char* mData = nullptr;
+	unsigned int mLength = 0;
+
+	// Platform-specific handles needed to unmap later.
+	void* mFileHandle = nullptr;
+	void* mMappingHandle = nullptr;
+
+	// Copying would lead to double unmapping - not allowed.
+	MemoryMappedFile(const MemoryMappedFile&) = delete;
+	MemoryMappedFile& operator=(const MemoryMappedFile&) = delete;
+};
@@ -8,6 +8,7 @@
 #include "GKActor.h"
 #include "IniParser.h"
 #include "SheepCompiler.h"
+#include "SheepManager.h"
 #include "SheepScript.h"
 #include "StringUtil.h"
 
@@ -159,8 +160,7 @@ void NVC::ParseFromData(char *data, int dataLength)
 					action.scriptText += '}';
 				}
 				
-				// Compile and save script.
-				action.script = Services::GetSheep()->Compile("Case Evaluation", action.scriptText);
+				// Script is compiled later, along with all other scripts in this NVC.
             }
 		}
         
@@ -185,10 +185,27 @@ void NVC::ParseFromData(char *data, int dataLength)
 		}
 	}
 	
+	// Scripts are compiled in one batch, which is much faster than compiling them one at a time.
+	// Action scripts are first in the batch, followed by case logic scripts.
+	std::vector<SheepBatchItem> batch;
+	std::vector<Action*> batchActions;
+	for(auto& action : mActions)
+	{
+		if(!action->scriptText.empty())
+		{
+			SheepBatchItem item;
+			item.name = "Case Evaluation";
+			item.sheep = action->scriptText;
+			batch.push_back(item);
+			batchActions.push_back(action);
+		}
+	}
+	
     // Some "CASE" values are special, and handled by the system (like ALL, GABE_ALL, GRACE_ALL)
     // But an NVC item can also specify a custom case value. In that case,
     // this section maps the case value to a sheep expression to evaluate, to see whether the case is met.
     IniSection logicSection = parser.GetSection("LOGIC");
+	std::vector<std::string> batchCaseLabels;
     for(auto& line : logicSection.lines)
     {
         // Only add this case entry if it isn't a duplicate entry.
@@ -205,11 +222,28 @@ void NVC::ParseFromData(char *data, int dataLength)
         if(it == mCaseLogic.end())
         {
 			//TODO: Again, should save string value somewhere???
-            mCaseLogic[caseLabel] = Services::GetSheep()->CompileEval(first.value);
+            mCaseLogic[caseLabel] = nullptr;
+			SheepBatchItem item;
+			item.name = "Case Evaluation";
+			item.sheep = first.value;
+			item.eval = true;
+			batch.push_back(item);
+			batchCaseLabels.push_back(caseLabel);
         }
         else
         {
             std::cout << "Multiple case labels for " << caseLabel << std::endl;
         }
     }
+	
+	// Compile and save scripts.
+	Services::GetSheep()->CompileBatch(batch);
+	for(int i = 0; i < batchActions.size(); ++i)
+	{
+		batchActions[i]->script = batch[i].script;
+	}
+	for(int i = 0; i < batchCaseLabels.size(); ++i)
+	{
+		mCaseLogic[batchCaseLabels[i]] = batch[batchActions.size() + i].script;
+	}
 }
@@ -17,6 +17,9 @@
 	#endif
 #elif defined(_WIN32)
 	#define PLATFORM_WINDOWS
+#elif defined(__linux__)
+	// Only used for command-line tools (e.g. SheepRunner) - the game itself doesn't run on Linux.
+	#define PLATFORM_LINUX
 #else
 	#error "Unknown Platform"
 #endif
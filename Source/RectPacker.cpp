@@ -0,0 +1,94 @@
+//
+// RectPacker.cpp
+//
+// Clark Kromenaker
+//
+#include "RectPacker.h"
+
+#include <algorithm>
+
+RectPacker::RectPacker(int pageWidth, int pageHeight) :
+	mPageWidth(pageWidth),
+	mPageHeight(pageHeight)
+{
+
+}
+
+int RectPacker::Add(int width, int height)
+{
+	mWidths.push_back(width);
+	mHeights.push_back(height);
+	mPlacements.emplace_back();
+	return static_cast<int>(mWidths.size()) - 1;
+}
+
+void RectPacker::Pack()
+{
+	mPageWidths.clear();
+	mPageHeights.clear();
+
+	// Place tallest rects first, so each shelf's height is set by its first rect.
+	// Ties are broken by width, then by index, so the layout is always the same for the same input.
+	std::vector<int> order(mWidths.size());
+	for(int i = 0; i < order.size(); ++i)
+	{
+		order[i] = i;
+	}
+	std::sort(order.begin(), order.end(), [this](int a, int b) {
+		if(mHeights[a] != mHeights[b]) { return mHeights[a] > mHeights[b]; }
+		if(mWidths[a] != mWidths[b]) { return mWidths[a] > mWidths[b]; }
+		return a < b;
+	});
+
+	// Current page and shelf being filled.
+	int page = -1;
+	int shelfX = 0;
+	int shelfY = 0;
+	int shelfHeight = 0;
+	for(int index : order)
+	{
+		int width = mWidths[index];
+		int height = mHeights[index];
+		Placement& placement = mPlacements[index];
+
+		// Too big for a page? Give it a page all to itself.
+		if(width > mPageWidth || height > mPageHeight)
+		{
+			placement.page = static_cast<int>(mPageWidths.size());
+			placement.x = 0;
+			placement.y = 0;
+			mPageWidths.push_back(width);
+			mPageHeights.push_back(height);
+			continue;
+		}
+
+		// Start a new shelf if this rect doesn't fit on the current one.
+		if(page >= 0 && shelfX + width > mPageWidth)
+		{
+			shelfY += shelfHeight;
+			shelfX = 0;
+			shelfHeight = 0;
+		}
+
+		// Start a new page if there's no room for another shelf.
+		if(page < 0 || shelfY + height > mPageHeight)
+		{
+			page = static_cast<int>(mPageWidths.size());
+			mPageWidths.push_back(0);
+			mPageHeights.push_back(0);
+			shelfX = 0;
+			shelfY = 0;
+			shelfHeight = 0;
+		}
+
+		placement.page = page;
+		placement.x = shelfX;
+		placement.y = shelfY;
+		shelfX += width;
+		shelfHeight = std::max(shelfHeight, height);
+
+		// Grow page to fit.
+		mPageWidths[page] = std::max(mPageWidths[page], shelfX);
+		mPageHeights[page] = std::max(mPageHeights[page], shelfY + shelfHeight);
+	}
+}
@@ -0,0 +1,57 @@
+//
+// RectPacker.h
+//
+// Clark Kromenaker
+//
+// Packs many small rectangles into a few larger "pages" without overlap.
+// Useful for building texture atlases out of many small textures.
+//
+// Uses a simple "shelf" algorithm: rectangles are sorted tallest-first and placed
+// left-to-right in rows. Packing is deterministic - the same set of sizes always
+// produces the same layout.
+//
+#pragma once
+#include <vector>
+
+class RectPacker
+{
+public:
+	struct Placement
+	{
+		// Page the rect was placed on.
+		int page = -1;
+
+		// Position of the rect's top-left corner on the page.
+		int x = 0;
+		int y = 0;
+	};
+
+	RectPacker(int pageWidth, int pageHeight);
+
+	// Adds a rect to be packed. Returns the rect's index.
+	int Add(int width, int height);
+
+	// Places all added rects. Any rect larger than a page gets a page of its own.
+	void Pack();
+
+	const Placement& GetPlacement(int index) const { return mPlacements[index]; }
+
+	// Pages are only as big as needed to fit the rects placed on them.
+	int GetPageCount() const { return static_cast<int>(mPageWidths.size()); }
+	int GetPageWidth(int page) const { return mPageWidths[page]; }
+	int GetPageHeight(int page) const { return mPageHeights[page]; }
+
+private:
+	// Maximum page size.
+	int mPageWidth = 0;
+	int mPageHeight = 0;
+
+	// Sizes of added rects, and where each one was placed.
+	std::vector<int> mWidths;
+	std::vector<int> mHeights;
+	std::vector<Placement> mPlacements;
+
+	// Used size of each page.
+	std::vector<int> mPageWidths;
+	std::vector<int> mPageHeights;
+};
@@ -24,6 +24,7 @@
 #include "Skybox.h"
 #include "Texture.h"
 #include "UICanvas.h"
+#include "VertexArray.h"
 
 float line_vertices[] = {
 	0.0f, 0.0f, 0.0f,
@@ -260,6 +261,9 @@ void Renderer::Shutdown()
 
 void Renderer::Render()
 {
+	unsigned int startDrawCallCount = VertexArray::GetDrawCallCount();
+	mBSPDrawCallCount = 0;
+	
 	// Enable opaque rendering (no blend, write to & test depth buffer).
 	// Do this BEFORE clear to avoid some glitchy graphics.
 	glDisable(GL_BLEND); // do not perform alpha blending (opaque rendering)
@@ -305,6 +309,7 @@ void Renderer::Render()
         if(mBSP != nullptr)
         {
             mBSP->RenderOpaque(mCamera->GetOwner()->GetPosition(), mCamera->GetOwner()->GetForward());
+            mBSPDrawCallCount = mBSP->GetDrawCallCount();
         }
         
         // OPAQUE MESH RENDERING
@@ -361,6 +366,9 @@ void Renderer::Render()
     // Any debug commands from earlier are queued internally, and only drawn when this is called!
     Debug::Render();
     
+    // Save draw call count for profiling.
+    mDrawCallCount = VertexArray::GetDrawCallCount() - startDrawCallCount;
+    
 	// Present to window.
 	SDL_GL_SwapWindow(mWindow);
 }
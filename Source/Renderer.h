@@ -45,6 +45,10 @@ public:
 	
 	Vector2 GetWindowSize() { return Vector2(static_cast<float>(mScreenWidth), static_cast<float>(mScreenHeight)); }
     
+    // Draw calls issued during the last rendered frame - in total, and for BSP geometry only.
+    unsigned int GetDrawCallCount() const { return mDrawCallCount; }
+    unsigned int GetBSPDrawCallCount() const { return mBSPDrawCallCount; }
+    
 private:
     // Screen's width and height, in pixels.
     int mScreenWidth = 1024;
@@ -65,6 +69,10 @@ private:
     // A BSP to render.
     BSP* mBSP = nullptr;
     
+    // Draw call counts for the last rendered frame.
+    unsigned int mDrawCallCount = 0;
+    unsigned int mBSPDrawCallCount = 0;
+    
     // A skybox to render.
 	Material mSkyboxMaterial;
     Skybox* mSkybox = nullptr;
@@ -83,7 +83,8 @@ std::string ReportStream::BuildOutputString(const std::string& content)
 			}
 			outputStr << " " << SystemUtil::GetCurrentUserName() << " ";
 		}
-		if((mContent & ReportContent::Timeblock) != ReportContent::None)
+		// Timeblock and location aren't available if the game isn't running (e.g. in tools).
+		if((mContent & ReportContent::Timeblock) != ReportContent::None && Services::Get<GameProgress>() != nullptr)
 		{
 			if(outputStr.tellp() > 5)
 			{
@@ -91,7 +92,7 @@ std::string ReportStream::BuildOutputString(const std::string& content)
 			}
 			outputStr << " TB: '" << Services::Get<GameProgress>()->GetTimeblock() << "' ";
 		}
-		if((mContent & ReportContent::Location) != ReportContent::None)
+		if((mContent & ReportContent::Location) != ReportContent::None && Services::Get<LocationManager>() != nullptr)
 		{
 			if(outputStr.tellp()> 5)
 			{
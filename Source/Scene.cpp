@@ -59,6 +59,20 @@ Scene::~Scene()
 }
 
 void Scene::Load()
+{
+	// Ignore if already loaded.
+	if(mSceneData != nullptr) { return; }
+	
+	BeginLoad();
+	
+	// Resolve scene asset and geometry for the scene.
+	mSceneData->ResolveSceneAsset();
+	mSceneData->ResolveGeometry();
+	
+	FinishLoad();
+}
+
+void Scene::BeginLoad()
 {
 	// If this is true, we are calling load when scene is already loaded!
 	if(mSceneData != nullptr)
@@ -72,15 +86,15 @@ void Scene::Load()
 	
 	// It's generally important that we know how our "ego" will be as soon as possible.
 	// This is because the scene loading *itself* may check who ego is to do certain things!
-	const SceneActor* egoSceneActor = mSceneData->DetermineWhoEgoWillBe();
+	mEgoSceneActor = mSceneData->DetermineWhoEgoWillBe();
 	//TODO: If no ego, I guess we fail loading!?
-	if(egoSceneActor == nullptr)
+	if(mEgoSceneActor == nullptr)
 	{
 		std::cout << "No ego actor could be predicted for scene!" << std::endl;
 	}
 	else
 	{
-		mEgoName = egoSceneActor->noun;
+		mEgoName = mEgoSceneActor->noun;
 	}
 	
 	// Set location.
@@ -95,8 +109,16 @@ void Scene::Load()
     new StatusOverlay();
 	
 	// Based on location, timeblock, and game progress, resolve what data we will load into the current scene.
-	// After calling this, SceneData will have interpreted all data from SIFs and determined exactly what we should and should not load/use for the scene right now.
-	mSceneData->ResolveSceneData();
+	// This first step only resolves general settings - the rest is resolved over the course of the load.
+	mSceneData->ResolveGeneralSettings();
+}
+
+void Scene::FinishLoad()
+{
+	if(mSceneData == nullptr) { return; }
+	
+	// After this, SceneData will have interpreted all data from SIFs and determined exactly what we should and should not load/use for the scene right now.
+	mSceneData->ResolveObjects();
 	
 	// Set BSP to be rendered.
     Services::GetRenderer()->SetBSP(mSceneData->GetBSP());
@@ -169,7 +191,7 @@ void Scene::Load()
 	for(auto& actorDef : sceneActorDatas)
 	{
 		// NEVER spawn an ego who is not our current ego!
-		if(actorDef->ego && actorDef != egoSceneActor) { continue; }
+		if(actorDef->ego && actorDef != mEgoSceneActor) { continue; }
 		
 		// The actor's 3-letter identifier (GAB, GRA, etc) can be derived from the name of the model.
 		std::string identifier;
@@ -220,7 +242,7 @@ void Scene::Load()
 		//TODO: If hidden, hide.
 		
 		// If this is our ego, save a reference to it.
-		if(actorDef->ego && actorDef == egoSceneActor)
+		if(actorDef->ego && actorDef == mEgoSceneActor)
 		{
 			mEgo = actor;
 		}
@@ -318,6 +340,9 @@ void Scene::Load()
 		}
 	}
 	
+	// Done loading scene assets. Assets from previous scenes that weren't needed by this scene can be unloaded, if over budget.
+	Services::GetAssets()->EvictUnusedAssets();
+	
 	// Check for and run "scene enter" actions.
 	Services::Get<ActionManager>()->ExecuteAction("SCENE", "ENTER");
 }
@@ -329,6 +354,9 @@ void Scene::Unload()
 	
 	delete mSceneData;
 	mSceneData = nullptr;
+	
+	// Assets used during this scene are no longer referenced by it.
+	Services::GetAssets()->ReleaseSceneAssets();
 }
 
 bool Scene::InitEgoPosition(const std::string& positionName)
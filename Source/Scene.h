@@ -51,6 +51,13 @@ public:
 	void Load();
 	void Unload();
 	
+	// Load can also be split up, so loading can be spread over several frames (see SceneLoader).
+	// BeginLoad reads SIFs and general settings. Between the two calls, the scene data's
+	// scene asset and geometry must be resolved. FinishLoad then spawns everything in the scene.
+	void BeginLoad();
+	void FinishLoad();
+	SceneData* GetSceneData() const { return mSceneData; }
+	
     bool InitEgoPosition(const std::string& positionName);
 	void SetCameraPosition(const std::string& cameraName);
 	
@@ -114,6 +121,9 @@ private:
 	std::string mEgoName;
     GKActor* mEgo = nullptr;
 	
+	// Scene data for ego, determined at start of load.
+	const SceneActor* mEgoSceneActor = nullptr;
+	
 	void ExecuteAction(const Action* action);
 };
 
@@ -29,6 +29,14 @@ const SceneActor* SceneData::DetermineWhoEgoWillBe() const
 }
 
 void SceneData::ResolveSceneData()
+{
+	ResolveGeneralSettings();
+	ResolveSceneAsset();
+	ResolveGeometry();
+	ResolveObjects();
+}
+
+void SceneData::ResolveGeneralSettings()
 {
 	// We need a SIF, at least.
 	if(mGeneralSIF == nullptr) { return; }
@@ -44,9 +52,19 @@ void SceneData::ResolveSceneData()
 		GeneralBlock specificBlock = mSpecificSIF->FindCurrentGeneralBlock();
 		mGeneralSettings.TakeOverridesFrom(specificBlock);
 	}
+}
+
+void SceneData::ResolveSceneAsset()
+{
+	if(mGeneralSIF == nullptr) { return; }
 	
 	// Load the desired scene asset - chosen based on settings block.
 	mSceneAsset = Services::GetAssets()->LoadSceneAsset(mGeneralSettings.sceneAssetName);
+}
+
+void SceneData::ResolveGeometry()
+{
+	if(mGeneralSIF == nullptr) { return; }
 	
 	// Load the BSP data, which is specified by the scene model.
 	// If this is null, the game will still work...but there's no BSP geometry!
@@ -84,6 +102,11 @@ void SceneData::ResolveSceneData()
 		mWalkerBoundary->SetSize(mGeneralSettings.walkerBoundarySize);
 		mWalkerBoundary->SetOffset(mGeneralSettings.walkerBoundaryOffset);
 	}
+}
+
+void SceneData::ResolveObjects()
+{
+	if(mGeneralSIF == nullptr) { return; }
 	
 	// Build list of actors to use in the scene based on contents of the two SIFs.
 	AddActorBlocks(mGeneralSIF->GetActorBlocks());
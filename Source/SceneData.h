@@ -40,12 +40,22 @@ public:
 	const SceneActor* DetermineWhoEgoWillBe() const;
 	void ResolveSceneData();
 	
+	// Resolution can also be done in steps, so the work can be spread over several frames.
+	// Steps must be done in this order - ResolveSceneData just does them all at once.
+	void ResolveGeneralSettings();
+	void ResolveSceneAsset();
+	void ResolveGeometry();
+	void ResolveObjects();
+	
 	// SCENE SETTINGS
+	const std::string& GetSceneAssetName() const { return mGeneralSettings.sceneAssetName; }
+	SceneAsset* GetSceneAsset() const { return mSceneAsset; }
 	BSP* GetBSP() const { return mBSP; }
 	Skybox* GetSkybox() const { return mSkybox; }
 	WalkerBoundary* GetWalkerBoundary() const { return mWalkerBoundary; }
 	const std::string& GetFloorModelName() const { return mGeneralSettings.floorModelName; }
 	const std::string& GetCameraBoundsModelName() const { return mGeneralSettings.cameraBoundsModelName; }
+	const std::string& GetWalkerBoundaryTextureName() const { return mGeneralSettings.walkerBoundaryTextureName; }
 	
 	// ACTORS/MODELS
 	const std::vector<const SceneActor*>& GetActors() const { return mActors; }
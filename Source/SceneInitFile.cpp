@@ -513,6 +513,25 @@ void SceneInitFile::ParseFromData(char *data, int dataLength)
     
     // Read in actors.
     std::vector<IniSection> actorSections = parser.GetSections("ACTORS");
+	
+	// Actor models are loaded as one batch up front, which lets barn extraction happen in parallel.
+	// The per-actor loads below then just pull from the asset cache.
+	std::vector<std::string> actorModelNames;
+	for(auto& section : actorSections)
+	{
+		for(auto& line : section.lines)
+		{
+			for(auto& keyValue : line.entries)
+			{
+				if(StringUtil::EqualsIgnoreCase(keyValue.key, "model"))
+				{
+					actorModelNames.push_back(keyValue.value);
+				}
+			}
+		}
+	}
+	Services::GetAssets()->LoadModels(actorModelNames);
+	
     for(auto& section : actorSections)
     {
 		mActors.emplace_back();
@@ -590,6 +609,7 @@ void SceneInitFile::ParseFromData(char *data, int dataLength)
     
     // Read in models.
     std::vector<IniSection> modelSections = parser.GetSections("MODELS");
+	std::vector<std::string> propModelNames;
     for(auto& section : modelSections)
     {
 		mModels.emplace_back();
@@ -656,16 +676,31 @@ void SceneInitFile::ParseFromData(char *data, int dataLength)
                 }
 			}
             
-            // After parsing all the data, if this is a prop, load the model.
+            // After parsing all the data, if this is a prop, we'll need to load the model.
             // For non-props, we don't load a model - the model is baked into the BSP.
             if(!model.name.empty() &&
                (model.type == SceneModel::Type::Prop ||
                 model.type == SceneModel::Type::GasProp))
             {
-                model.model = Services::GetAssets()->LoadModel(model.name);
+                propModelNames.push_back(model.name);
             }
         }
     }
+	
+	// Load all prop models as one batch, then hook them up.
+	Services::GetAssets()->LoadModels(propModelNames);
+	for(auto& modelBlock : mModels)
+	{
+		for(auto& model : modelBlock.items)
+		{
+			if(!model.name.empty() &&
+			   (model.type == SceneModel::Type::Prop ||
+				model.type == SceneModel::Type::GasProp))
+			{
+				model.model = Services::GetAssets()->LoadModel(model.name);
+			}
+		}
+	}
     
     // Read in regions and triggers.
     std::vector<IniSection> regionSections = parser.GetSections("REGIONS");
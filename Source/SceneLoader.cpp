@@ -0,0 +1,81 @@
+//
+// SceneLoader.cpp
+//
+// Clark Kromenaker
+//
+#include "SceneLoader.h"
+
+#include "Scene.h"
+#include "SceneAsset.h"
+#include "Services.h"
+
+SceneLoader::SceneLoader()
+{
+	// Wait until assets needed by the next step are extracted.
+	// This keeps the frame loop running, rather than blocking on decompression.
+	mSteps.SetReadyCheck([]() {
+		return Services::GetAssets()->IsPrefetchDone();
+	});
+	
+	// The scene is only current during each step, since it's not safe to use otherwise until it's done loading.
+	mSteps.SetStepCallbacks([this]() {
+		if(mCurrentSceneCallback != nullptr)
+		{
+			mCurrentSceneCallback(mScene);
+		}
+	}, [this]() {
+		if(mSteps.IsLoading() && mCurrentSceneCallback != nullptr)
+		{
+			mCurrentSceneCallback(nullptr);
+		}
+		if(mProgressCallback != nullptr)
+		{
+			mProgressCallback(GetProgress());
+		}
+	});
+}
+
+void SceneLoader::Start(const std::string& location, const Timeblock& timeblock)
+{
+	mScene = new Scene(location, timeblock);
+	
+	// The first step needs the general and specific SIFs, so start extracting those.
+	Services::GetAssets()->PrefetchSIFs({ location, location + timeblock.ToString() });
+	
+	// After each step, prefetch anything the following step will need.
+	mSteps.Start({
+		[this]() {
+			mScene->BeginLoad();
+			
+			SceneData* sceneData = mScene->GetSceneData();
+			Services::GetAssets()->PrefetchSceneAssets({ sceneData->GetSceneAssetName() });
+			Services::GetAssets()->PrefetchBSPLightmaps({ sceneData->GetSceneAssetName() });
+			Services::GetAssets()->PrefetchTextures({ sceneData->GetWalkerBoundaryTextureName() });
+		},
+		[this]() {
+			SceneData* sceneData = mScene->GetSceneData();
+			sceneData->ResolveSceneAsset();
+			
+			SceneAsset* sceneAsset = sceneData->GetSceneAsset();
+			if(sceneAsset != nullptr)
+			{
+				Services::GetAssets()->PrefetchBSPs({ sceneAsset->GetBSPName() });
+			}
+		},
+		[this]() {
+			mScene->GetSceneData()->ResolveGeometry();
+		},
+		[this]() {
+			mScene->FinishLoad();
+			mScene = nullptr;
+			
+			// Anything prefetched but never used isn't needed anymore.
+			Services::GetAssets()->ClearPrefetchedAssets();
+		}
+	});
+	
+	if(mProgressCallback != nullptr)
+	{
+		mProgressCallback(GetProgress());
+	}
+}
@@ -0,0 +1,62 @@
+//
+// SceneLoader.h
+//
+// Clark Kromenaker
+//
+// Loads a scene in steps, spread out over several frames, so the game loop keeps running during a scene change.
+//
+// Before each step, the assets that step needs are prefetched (extracted and decompressed on worker threads).
+// Lightmaps and textures are also parsed on the worker threads. The step itself runs on the main thread once that
+// data is ready, since creating other assets loads more assets or touches OpenGL, and scene setup touches pretty much
+// every other system. Texture uploads already happen lazily on first use, so those end up spread over the first few
+// frames of the new scene.
+//
+// The loading scene is only the current scene while a load step is running. Load steps need it to be current
+// (e.g. SIF conditions ask for the ego's name), but the rest of the frame can't reach it until it's fully loaded.
+//
+#pragma once
+#include <functional>
+#include <string>
+
+#include "LoadSequence.h"
+
+class Scene;
+class Timeblock;
+
+class SceneLoader
+{
+public:
+	SceneLoader();
+	
+	// Creates a scene and starts loading it.
+	void Start(const std::string& location, const Timeblock& timeblock);
+	
+	// Performs the next load step, if the assets it needs are ready. Call once per frame.
+	void Update() { mSteps.Update(); }
+	
+	bool IsLoading() const { return mSteps.IsLoading(); }
+	
+	// Load progress, from 0 to 1.
+	float GetProgress() const { return mSteps.GetProgress(); }
+	
+	// Called with current progress each time a load step completes.
+	void SetProgressCallback(std::function<void(float)> callback) { mProgressCallback = callback; }
+	
+	// Called to change the current scene: with the loading scene before each load step, and with null after each step.
+	// Once the final step is done, the scene is left as the current scene.
+	void SetCurrentSceneCallback(std::function<void(Scene*)> callback) { mCurrentSceneCallback = callback; }
+	
+private:
+	// Load steps, in order:
+	// 1) Parse SIFs, determine general settings
+	// 2) Load scene asset (SCN)
+	// 3) Load BSP, lightmap, skybox, walker boundary
+	// 4) Spawn actors/models, run scene enter actions
+	LoadSequence mSteps;
+	
+	// The scene being loaded.
+	Scene* mScene = nullptr;
+	
+	std::function<void(float)> mProgressCallback = nullptr;
+	std::function<void(Scene*)> mCurrentSceneCallback = nullptr;
+};
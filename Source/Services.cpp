@@ -13,5 +13,6 @@ AudioManager* Services::sAudio = nullptr;
 SheepManager* Services::sSheep = nullptr;
 ReportManager* Services::sReportManager = nullptr;
 Console* Services::sConsole = nullptr;
+ThreadPool* Services::sJobs = nullptr;
 
 std::unordered_map<Type, void*> Services::sTypeToInstancePointer;
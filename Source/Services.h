@@ -21,6 +21,7 @@
 #include "InputManager.h"
 #include "Renderer.h"
 #include "SheepManager.h"
+#include "ThreadPool.h"
 #include "Type.h"
 
 class Services
@@ -47,6 +48,10 @@ public:
 	static Console* GetConsole() { return sConsole; }
 	static void SetConsole(Console* console) { sConsole = console; }
 	
+	// Worker threads shared by all systems. Systems wait on their own jobs with ThreadPool::WaitForCount.
+	static ThreadPool* GetJobs() { return sJobs; }
+	static void SetJobs(ThreadPool* jobs) { sJobs = jobs; }
+	
 	template<class T> static void Set(T* instance);
 	template<class T> static T* Get();
     
@@ -58,6 +63,7 @@ private:
     static SheepManager* sSheep;
 	static ReportManager* sReportManager;
 	static Console* sConsole;
+	static ThreadPool* sJobs;
 	
 	// General-purpose mapping from class Type to class instance.
 	// Use "Set" to add an entry and "Get" to retrieve an entry.
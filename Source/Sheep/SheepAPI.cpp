@@ -5,10 +5,11 @@
 //
 #include "SheepAPI.h"
 
-#include <functional> // for std::hash
+#include <limits> // for budget clamping
 #include <sstream> // for int->hex
 
 #include "Animator.h"
+#include "BSP.h"
 #include "Camera.h"
 #include "CharacterManager.h"
 #include "DialogueManager.h"
@@ -20,11 +21,13 @@
 #include "InventoryManager.h"
 #include "LocationManager.h"
 #include "Random.h"
+#include "Renderer.h"
 #include "Scene.h"
 #include "Services.h"
 #include "SoundtrackPlayer.h"
 #include "StringUtil.h"
 #include "VerbManager.h"
+#include "VertexAnimator.h"
 
 // Required for macros to work correctly with "string" instead of "std::string".
 using namespace std;
@@ -36,195 +39,6 @@ using namespace std;
 #define DEV_FUNC true
 #define REL_FUNC false
 
-// A big array of all our defined system functions.
-// This is populated at program start and then never changed.
-std::vector<SysFuncDecl> sysFuncs;
-
-// Maps from system function name (or hash) to index in the sysFuncs vector.
-// We can't map to SysFuncDecl& because vector might move memory around when populating the list.
-// It IS OK to get references after initial population, since the vector never changes!
-std::map<std::string, int> nameToSysFunc;
-std::unordered_map<size_t, int> hashToSysFunc;
-
-size_t CalcHashForSysFunc(const SysImport& sysImport)
-{
-	// This is a variation of Bernstein hash, also called djb2.
-	// Original uses values 5381/33 instead of 17/31.
-	// It's actually unknown why these values result in a good hash...hope it works out!
-	size_t res = 17;
-	std::string lowerName = StringUtil::ToLowerCopy(sysImport.name);
-	res = res * 31 + std::hash<string>()(lowerName);
-	res = res * 31 + std::hash<int>()((int)sysImport.argumentTypes.size());
-	for(auto& argType : sysImport.argumentTypes)
-	{
-		res = res * 31 + std::hash<char>()(argType);
-	}
-	return res;
-}
-
-// A list of every defined system function. Add to this by calling AddSysFuncDecl.
-// Functions are added by using RegFuncX macros, which in turn call AddSysFuncDecl and put function pointers into call maps.
-void AddSysFuncDecl(const std::string& name, char retType, std::initializer_list<char> argTypes, bool waitable, bool dev)
-{
-	SysFuncDecl sysFunc;
-	sysFunc.name = name;
-	sysFunc.returnType = retType;
-	for(auto argType : argTypes)
-	{
-		sysFunc.argumentTypes.push_back(argType);
-	}
-	sysFunc.waitable = waitable;
-	sysFunc.devOnly = dev;
-	
-	sysFuncs.push_back(sysFunc);
-	
-	// Store a mapping from name and hash to index in the vector of system functions.
-	// We can't store references because std::vector can move items around on us during population of the vector.
-	nameToSysFunc[StringUtil::ToLowerCopy(name)] = (int)sysFuncs.size() - 1;
-	hashToSysFunc[CalcHashForSysFunc(sysFunc)] = (int)sysFuncs.size() - 1;
-}
-
-SysFuncDecl* GetSysFuncDecl(const std::string& name)
-{
-	auto it = nameToSysFunc.find(name);
-	if(it != nameToSysFunc.end())
-	{
-		return &sysFuncs[it->second];
-	}
-	return nullptr;
-}
-
-SysFuncDecl* GetSysFuncDecl(const SysImport* sysImport)
-{
-	size_t hash = CalcHashForSysFunc(*sysImport);
-	auto it = hashToSysFunc.find(hash);
-	if(it != hashToSysFunc.end())
-	{
-		return &sysFuncs[it->second];
-	}
-	return nullptr;
-}
-
-// Maps from function name to a function pointer.
-// Each map is for a different number of arguments (0-8).
-std::map<std::string, Value (*)(const Value&)> map0;
-std::map<std::string, Value (*)(const Value&)> map1;
-std::map<std::string, Value (*)(const Value&, const Value&)> map2;
-std::map<std::string, Value (*)(const Value&, const Value&, const Value&)> map3;
-std::map<std::string, Value (*)(const Value&, const Value&, const Value&,
-                                const Value&)> map4;
-std::map<std::string, Value (*)(const Value&, const Value&, const Value&,
-                                const Value&, const Value&)> map5;
-std::map<std::string, Value (*)(const Value&, const Value&, const Value&,
-                                const Value&, const Value&, const Value&)> map6;
-std::map<std::string, Value (*)(const Value&, const Value&, const Value&,
-                                const Value&, const Value&, const Value&,
-                                const Value&)> map7;
-std::map<std::string, Value (*)(const Value&, const Value&, const Value&,
-                                const Value&, const Value&, const Value&,
-                                const Value&, const Value&)> map8;
-
-Value CallSysFunc(const std::string& name)
-{
-	auto it = map0.find(name);
-	if(it != map0.end())
-	{
-		return it->second(0);
-	}
-	else
-	{
-		std::cout << "Couldn't find SysFunc0 " << name << std::endl;
-		return Value(0);
-	}
-}
-
-Value CallSysFunc(const std::string& name, const Value& x1)
-{
-	auto it = map1.find(name);
-	if(it != map1.end())
-	{
-		return it->second(x1);
-	}
-	else
-	{
-		std::cout << "Couldn't find SysFunc1 " << name << std::endl;
-		return Value(0);
-	}
-}
-
-Value CallSysFunc(const std::string& name, const Value& x1, const Value& x2)
-{
-	auto it = map2.find(name);
-	if(it != map2.end())
-	{
-		return it->second(x1, x2);
-	}
-	else
-	{
-		std::cout << "Couldn't find SysFunc2 " << name << std::endl;
-		return Value(0);
-	}
-}
-
-Value CallSysFunc(const std::string& name, const Value& x1, const Value& x2, const Value& x3)
-{
-	auto it = map3.find(name);
-	if(it != map3.end())
-	{
-		return it->second(x1, x2, x3);
-	}
-	else
-	{
-		std::cout << "Couldn't find SysFunc3 " << name << std::endl;
-		return Value(0);
-	}
-}
-
-Value CallSysFunc(const std::string& name, const Value& x1, const Value& x2, const Value& x3,
-                  const Value& x4)
-{
-	auto it = map4.find(name);
-	if(it != map4.end())
-	{
-		return it->second(x1, x2, x3, x4);
-	}
-	else
-	{
-		std::cout << "Couldn't find SysFunc4 " << name << std::endl;
-		return Value(0);
-	}
-}
-
-Value CallSysFunc(const std::string& name, const Value& x1, const Value& x2, const Value& x3,
-                  const Value& x4, const Value& x5)
-{
-	auto it = map5.find(name);
-	if(it != map5.end())
-	{
-		return it->second(x1, x2, x3, x4, x5);
-	}
-	else
-	{
-		std::cout << "Couldn't find SysFunc5 " << name << std::endl;
-		return Value(0);
-	}
-}
-
-Value CallSysFunc(const std::string& name, const Value& x1, const Value& x2, const Value& x3,
-                  const Value& x4, const Value& x5, const Value& x6)
-{
-	auto it = map6.find(name);
-	if(it != map6.end())
-	{
-		return it->second(x1, x2, x3, x4, x5, x6);
-	}
-	else
-	{
-		std::cout << "Couldn't find SysFunc6 " << name << std::endl;
-		return Value(0);
-	}
-}
-
 // Helper for reporting back to Sheep VM that an error occurred.
 void ExecError()
 {
@@ -1409,7 +1223,76 @@ RegFunc1(SetCameraFOV, void, float, IMMEDIATE, REL_FUNC);
 //DumpDebugFlags
 //DumpFile
 //DumpLockedObjects
-//DumpMemoryUsage
+
+shpvoid DumpMemoryUsage()
+{
+	Services::GetAssets()->DumpMemoryUsage();
+	return 0;
+}
+RegFunc0(DumpMemoryUsage, void, IMMEDIATE, DEV_FUNC);
+
+shpvoid SetAssetMemoryBudget(std::string assetType, int megabytes)
+{
+	// Bytes overflow an int past 2GB, so compute in 64-bit and clamp to the largest budget possible.
+	unsigned long long bytes = megabytes > 0 ? static_cast<unsigned long long>(megabytes) * 1024 * 1024 : 0;
+	unsigned long long maxBytes = std::numeric_limits<unsigned int>::max();
+	Services::GetAssets()->SetMemoryBudget(assetType, static_cast<unsigned int>(bytes < maxBytes ? bytes : maxBytes));
+	return 0;
+}
+RegFunc2(SetAssetMemoryBudget, void, string, int, IMMEDIATE, DEV_FUNC);
+
+shpvoid DumpDrawCallCount()
+{
+	Renderer* renderer = Services::GetRenderer();
+	std::stringstream ss;
+	ss << "Draw calls last frame: " << renderer->GetDrawCallCount() << " (BSP: " << renderer->GetBSPDrawCallCount() << ")";
+	Services::GetReports()->Log("Dump", ss.str());
+	return 0;
+}
+RegFunc0(DumpDrawCallCount, void, IMMEDIATE, DEV_FUNC);
+
+shpvoid EnableBSPBatching()
+{
+	BSP::SetBatchedRenderingEnabled(true);
+	return 0;
+}
+RegFunc0(EnableBSPBatching, void, IMMEDIATE, DEV_FUNC);
+
+shpvoid DisableBSPBatching()
+{
+	BSP::SetBatchedRenderingEnabled(false);
+	return 0;
+}
+RegFunc0(DisableBSPBatching, void, IMMEDIATE, DEV_FUNC);
+
+shpvoid EnableGPUVertexAnimation()
+{
+	VertexAnimator::SetGPUAnimationEnabled(true);
+	return 0;
+}
+RegFunc0(EnableGPUVertexAnimation, void, IMMEDIATE, DEV_FUNC);
+
+shpvoid DisableGPUVertexAnimation()
+{
+	VertexAnimator::SetGPUAnimationEnabled(false);
+	return 0;
+}
+RegFunc0(DisableGPUVertexAnimation, void, IMMEDIATE, DEV_FUNC);
+
+shpvoid EnableParallelUpdate()
+{
+	GEngine::Instance()->SetParallelUpdateEnabled(true);
+	return 0;
+}
+RegFunc0(EnableParallelUpdate, void, IMMEDIATE, DEV_FUNC);
+
+shpvoid DisableParallelUpdate()
+{
+	GEngine::Instance()->SetParallelUpdateEnabled(false);
+	return 0;
+}
+RegFunc0(DisableParallelUpdate, void, IMMEDIATE, DEV_FUNC);
+
 //DumpPathFileMap
 //DumpUsedPaths
 //DumpUsedFiles
@@ -1516,6 +1399,27 @@ RegFunc2(Extract, void, string, string, IMMEDIATE, REL_FUNC);
 //DumpRawSheep
 //DumpSheepEngine
 
+shpvoid EnableSheepProfiler()
+{
+	Services::GetSheep()->GetProfiler().SetEnabled(true);
+	return 0;
+}
+RegFunc0(EnableSheepProfiler, void, IMMEDIATE, DEV_FUNC);
+
+shpvoid DisableSheepProfiler()
+{
+	Services::GetSheep()->GetProfiler().SetEnabled(false);
+	return 0;
+}
+RegFunc0(DisableSheepProfiler, void, IMMEDIATE, DEV_FUNC);
+
+shpvoid DumpSheepProfile()
+{
+	Services::GetReports()->Log("Dump", Services::GetSheep()->GetProfiler().GetReport());
+	return 0;
+}
+RegFunc0(DumpSheepProfile, void, IMMEDIATE, DEV_FUNC);
+
 //ExecCommand
 //FindCommand
 //HelpCommand
@@ -7,46 +7,21 @@
 // All functions that can be called from sheep are in this header.
 //
 #pragma once
-#include <initializer_list>
-#include <map>
 #include <string>
 
 #include "SheepScript.h"
-#include "Value.h"
-
-// A "full" system function declaration.
-// Contains extra data about a function that is helpful, but doesn't uniquely identify the function signature.
-// Inherits from SysImport because that DOES uniquely identify the signature!
-struct SysFuncDecl : public SysImport
-{
-	// If true, this function can be "waited" upon.
-	// If false, it executes and returns immediately.
-	bool waitable = false;
-	
-	// If true, this function can only work in dev builds.
-	bool devOnly = false;
-	
-	//TODO: For in-game help output, we may need to store argument names AND description text.
-	// For example, HelpCommand("AddStreamContent") outputs this:
-	/*
-	 ----- 'Dump' * 03/16/2019 * 11:39:21 -----
-	 ** [DEBUG] AddStreamContent(string streamName, string content) **
-	 Adds an additional content type to the stream. Possible values for the 'content' parameter are: 'begin' (report headers), 'content' (report content), 'end' (report footers), 'category' (the category of the report), 'date' (the date the report was made), 'time' (the time the report was made), 'debug' (file/line debug info), 'timeblock' (the current timeblock if there is one), and 'location' (the current game scene location if there is one).
-	*/
-};
-
-void AddSysFuncDecl(const std::string& name, char retType, std::initializer_list<char> argTypes, bool waitable, bool dev);
-SysFuncDecl* GetSysFuncDecl(const std::string& name);
-SysFuncDecl* GetSysFuncDecl(const SysImport* sysImport);
-
-// Functions for calling functions of various argument lengths.
-Value CallSysFunc(const std::string& name);
-Value CallSysFunc(const std::string& name, const Value& x1);
-Value CallSysFunc(const std::string& name, const Value& x1, const Value& x2);
-Value CallSysFunc(const std::string& name, const Value& x1, const Value& x2, const Value& x3);
-Value CallSysFunc(const std::string& name, const Value& x1, const Value& x2, const Value& x3, const Value& x4);
-Value CallSysFunc(const std::string& name, const Value& x1, const Value& x2, const Value& x3, const Value& x4, const Value& x5);
-Value CallSysFunc(const std::string& name, const Value& x1, const Value& x2, const Value& x3, const Value& x4, const Value& x5, const Value& x6);
+#include "SheepSysFuncs.h"
+
+// Convert sheep stack values to the argument types system functions expect.
+template<typename T> T GetSysFuncArg(SheepValue& value);
+template<> inline int GetSysFuncArg<int>(SheepValue& value) { return value.GetInt(); }
+template<> inline float GetSysFuncArg<float>(SheepValue& value) { return value.GetFloat(); }
+template<> inline std::string GetSysFuncArg<std::string>(SheepValue& value) { return value.GetString(); }
+
+// Store a system function's return value in a result.
+inline void SetSysFuncResult(SysFuncResult& result, int value) { result.value = SheepValue(value); }
+inline void SetSysFuncResult(SysFuncResult& result, float value) { result.value = SheepValue(value); }
+inline void SetSysFuncResult(SysFuncResult& result, const std::string& value) { result.stringValue = value; }
 
 // These are used in the below macros to convert keywords into integers using ## macro operator.
 #define void_TYPE 0
@@ -55,74 +30,68 @@ Value CallSysFunc(const std::string& name, const Value& x1, const Value& x2, con
 #define string_TYPE 3
 
 // Macros that register functions of various argument lengths with the system.
-// Creates a function with same name as the actual function, but which uses generic "Value" args and return type.
-// The generic function just calls the real function with correct argument types.
-
-// Also registers an entry in the function map with a pointer to the "generic function".
-// Flow is: Look Up in Map -> Calls Generic Function -> Calls Actual Function
+// Creates a "call" function that converts args on the sheep stack to the correct types, calls the real function, and stores the result.
+// The call function is registered with the function declaration, and sheep scripts bind to it when they load.
+// Flow is: VM Calls Call Function -> Calls Actual Function
 #define RegFunc0(name, ret, waitable, dev)          					\
-    Value name(const Value& x1) {                   					\
-        return name();                              					\
+    void name##_Call(SheepValue* args, SysFuncResult& result) {			\
+        SetSysFuncResult(result, name());								\
     }                                               					\
     struct name##_ {                                					\
         name##_() {                                 					\
-            map0[#name]=&name;                      					\
-            AddSysFuncDecl(#name, ret##_TYPE, { }, waitable, dev); 		\
+            AddSysFuncDecl(#name, ret##_TYPE, { }, waitable, dev, &name##_Call); \
         }                                           					\
     } name##_instance
 
 #define RegFunc1(name, ret, t1, waitable, dev)                     		\
-    Value name(const Value& x1) {                   					\
-        return name(x1.to<t1>());                   					\
+    void name##_Call(SheepValue* args, SysFuncResult& result) {			\
+        SetSysFuncResult(result, name(GetSysFuncArg<t1>(args[0])));	\
     }                                               					\
     struct name##_ {                                					\
         name##_() {                                 					\
-            map1[#name]=&name;                      					\
-            AddSysFuncDecl(#name, ret##_TYPE, { t1##_TYPE }, waitable, dev);			\
+            AddSysFuncDecl(#name, ret##_TYPE, { t1##_TYPE }, waitable, dev, &name##_Call); \
         }                                           					\
     } name##_instance
 
 #define RegFunc2(name, ret, t1, t2, waitable, dev)                      \
-    Value name(const Value& x1, const Value& x2) {          			\
-        return name(x1.to<t1>(), x2.to<t2>());              			\
+    void name##_Call(SheepValue* args, SysFuncResult& result) {			\
+        SetSysFuncResult(result, name(GetSysFuncArg<t1>(args[0]), GetSysFuncArg<t2>(args[1]))); \
     }                                                       			\
     struct name##_ {                                        			\
         name##_() {                                         			\
-            map2[#name]=&name;                              			\
-            AddSysFuncDecl(#name, ret##_TYPE, { t1##_TYPE, t2##_TYPE }, waitable, dev); \
+            AddSysFuncDecl(#name, ret##_TYPE, { t1##_TYPE, t2##_TYPE }, waitable, dev, &name##_Call); \
         }                                                   			\
     } name##_instance
 
-#define RegFunc3(name, ret, t1, t2, t3, waitable, dev)                      \
-	Value name(const Value& x1, const Value& x2, const Value& x3) {          			\
-		return name(x1.to<t1>(), x2.to<t2>(), x3.to<t3>());              			\
+#define RegFunc3(name, ret, t1, t2, t3, waitable, dev)                  \
+	void name##_Call(SheepValue* args, SysFuncResult& result) {			\
+		SetSysFuncResult(result, name(GetSysFuncArg<t1>(args[0]), GetSysFuncArg<t2>(args[1]), GetSysFuncArg<t3>(args[2]))); \
 	}                                                       			\
 	struct name##_ {                                        			\
 		name##_() {                                         			\
-			map3[#name]=&name;                              			\
-			AddSysFuncDecl(#name, ret##_TYPE, { t1##_TYPE, t2##_TYPE, t3##_TYPE }, waitable, dev); \
+			AddSysFuncDecl(#name, ret##_TYPE, { t1##_TYPE, t2##_TYPE, t3##_TYPE }, waitable, dev, &name##_Call); \
 		}                                                   			\
 	} name##_instance
 
-#define RegFunc4(name, ret, t1, t2, t3, t4, waitable, dev)                      \
-	Value name(const Value& x1, const Value& x2, const Value& x3, const Value& x4) {          			\
-		return name(x1.to<t1>(), x2.to<t2>(), x3.to<t3>(), x4.to<t4>());              			\
+#define RegFunc4(name, ret, t1, t2, t3, t4, waitable, dev)              \
+	void name##_Call(SheepValue* args, SysFuncResult& result) {			\
+		SetSysFuncResult(result, name(GetSysFuncArg<t1>(args[0]), GetSysFuncArg<t2>(args[1]), GetSysFuncArg<t3>(args[2]), \
+									  GetSysFuncArg<t4>(args[3]))); 	\
 	}                                                       			\
 	struct name##_ {                                        			\
 		name##_() {                                         			\
-			map4[#name]=&name;                              			\
-			AddSysFuncDecl(#name, ret##_TYPE, { t1##_TYPE, t2##_TYPE, t3##_TYPE, t4##_TYPE }, waitable, dev); \
+			AddSysFuncDecl(#name, ret##_TYPE, { t1##_TYPE, t2##_TYPE, t3##_TYPE, t4##_TYPE }, waitable, dev, &name##_Call); \
 		}                                                   			\
 	} name##_instance
 
-#define RegFunc5(name, ret, t1, t2, t3, t4, t5, waitable, dev)                      \
-	Value name(const Value& x1, const Value& x2, const Value& x3, const Value& x4, const Value& x5) {          			\
-		return name(x1.to<t1>(), x2.to<t2>(), x3.to<t3>(), x4.to<t4>(), x5.to<t5>());              			\
+#define RegFunc5(name, ret, t1, t2, t3, t4, t5, waitable, dev)          \
+	void name##_Call(SheepValue* args, SysFuncResult& result) {			\
+		SetSysFuncResult(result, name(GetSysFuncArg<t1>(args[0]), GetSysFuncArg<t2>(args[1]), GetSysFuncArg<t3>(args[2]), \
+									  GetSysFuncArg<t4>(args[3]), GetSysFuncArg<t5>(args[4]))); \
 	}                                                       			\
 	struct name##_ {                                        			\
 		name##_() {                                         			\
-			map5[#name]=&name;                              			\
-			AddSysFuncDecl(#name, ret##_TYPE, { t1##_TYPE, t2##_TYPE, t3##_TYPE, t4##_TYPE, t5##_TYPE }, waitable, dev); \
+			AddSysFuncDecl(#name, ret##_TYPE, { t1##_TYPE, t2##_TYPE, t3##_TYPE, t4##_TYPE, t5##_TYPE }, waitable, dev, &name##_Call); \
 		}                                                   			\
 	} name##_instance
 
@@ -399,7 +368,15 @@ shpvoid ToggleDebugFlag(std::string flagName);
 shpvoid DumpDebugFlags();
 shpvoid DumpFile(std::string filename);
 shpvoid DumpLockedObjects();
-shpvoid DumpMemoryUsage();
+shpvoid DumpMemoryUsage(); // DEV
+shpvoid SetAssetMemoryBudget(std::string assetType, int megabytes); // DEV
+shpvoid DumpDrawCallCount(); // DEV
+shpvoid EnableBSPBatching(); // DEV
+shpvoid DisableBSPBatching(); // DEV
+shpvoid EnableGPUVertexAnimation(); // DEV
+shpvoid DisableGPUVertexAnimation(); // DEV
+shpvoid EnableParallelUpdate(); // DEV
+shpvoid DisableParallelUpdate(); // DEV
 shpvoid DumpPathFileMap();
 shpvoid DumpUsedPaths();
 shpvoid DumpUsedFiles();
@@ -438,6 +415,10 @@ shpvoid DumpCommands(); // DEV
 shpvoid DumpRawSheep(std::string sheepName); // DEV
 shpvoid DumpSheepEngine(); // DEV
 
+shpvoid EnableSheepProfiler(); // DEV
+shpvoid DisableSheepProfiler(); // DEV
+shpvoid DumpSheepProfile(); // DEV
+
 shpvoid ExecCommand(std::string sheepCommand); // DEV, WAIT
 shpvoid FindCommand(std::string commandGuess); // DEV
 shpvoid HelpCommand(std::string commandName); // DEV
@@ -44,7 +44,12 @@ SheepScript* SheepCompiler::Compile(const std::string& name, const std::string&
 SheepScript* SheepCompiler::Compile(const std::string& name, std::istream& stream)
 {
 	// Make sure we can read our stream.
-    if(!stream.good() || stream.eof()) { return nullptr; }
+	mWarningCount = 0;
+    if(!stream.good() || stream.eof())
+	{
+		Report("SheepCompilerError", "Can't compile sheep '" + name + "' - the stream can't be read.");
+		return nullptr;
+	}
 	
 	// Delete any pre-existing scanner and create a new one.
 	// The scanner is used to split the sheep script text into individual tokens.
@@ -69,6 +74,10 @@ SheepScript* SheepCompiler::Compile(const std::string& name, std::istream& strea
         int result = mParser->parse();
         if(result == 0)
         {
+			if(mOptimize)
+			{
+				builder.Optimize();
+			}
             SheepScript* sheepScript = new SheepScript(name, builder);
             return sheepScript;
         }
@@ -85,6 +94,12 @@ SheepScript* SheepCompiler::Compile(const std::string& name, std::istream& strea
     }
 }
 
+void SheepCompiler::TakeQueuedReports(std::vector<std::pair<std::string, std::string>>& outReports)
+{
+	outReports.swap(mQueuedReports);
+	mQueuedReports.clear();
+}
+
 void SheepCompiler::Warning(SheepScriptBuilder* builder, const Sheep::location& location, const std::string& message)
 {
 	int line = location.begin.line;
@@ -96,7 +111,8 @@ void SheepCompiler::Warning(SheepScriptBuilder* builder, const Sheep::location&
 	std::string reportMsg = StringUtil::Format("GK3 compiler warning at '%s' (line %d, col %d) <%s>\n%s",
 											   name.c_str(), line, col, section.c_str(),
 											   message.c_str());
-	Services::GetReports()->Log("SheepCompilerWarning", reportMsg);
+	Report("SheepCompilerWarning", reportMsg);
+	++mWarningCount;
 }
 
 void SheepCompiler::Error(SheepScriptBuilder* builder, const Sheep::location& location, const std::string& message)
@@ -110,5 +126,17 @@ void SheepCompiler::Error(SheepScriptBuilder* builder, const Sheep::location& lo
 	std::string reportMsg = StringUtil::Format("GK3 compiler error at '%s' (line %d, col %d) <%s>\n%s",
 											   name.c_str(), line, col, section.c_str(),
 											   message.c_str());
-	Services::GetReports()->Log("SheepCompilerError", reportMsg);
+	Report("SheepCompilerError", reportMsg);
+}
+
+void SheepCompiler::Report(const std::string& streamName, const std::string& message)
+{
+	if(mQueueReports)
+	{
+		mQueuedReports.emplace_back(streamName, message);
+	}
+	else
+	{
+		Services::GetReports()->Log(streamName, message);
+	}
 }
@@ -10,6 +10,8 @@
 #include <istream>
 #include <map>
 #include <string>
+#include <utility>
+#include <vector>
 
 #include "SheepScanner.h"
 #include "sheep.tab.hh"
@@ -26,13 +28,40 @@ public:
     SheepScript* Compile(const std::string& name, const std::string& sheep);
     SheepScript* Compile(const std::string& name, std::istream& stream);
 	
+	// If true, compiled bytecode is optimized (see SheepOptimizer).
+	void SetOptimize(bool optimize) { mOptimize = optimize; }
+	bool GetOptimize() const { return mOptimize; }
+	
+	// Reporting isn't thread-safe. So, when compiling on another thread, warnings and errors should be queued,
+	// and then logged later on the main thread.
+	void SetQueueReports(bool queueReports) { mQueueReports = queueReports; }
+	
+	// Moves queued reports (stream name, message) out of the compiler, to be logged later.
+	void TakeQueuedReports(std::vector<std::pair<std::string, std::string>>& outReports);
+	
+	// Logs a message to a report stream, or queues it if queueing reports.
+	void Report(const std::string& streamName, const std::string& message);
+	
 	void Warning(SheepScriptBuilder* builder, const Sheep::location& location, const std::string& message);
     void Error(SheepScriptBuilder* builder, const Sheep::location& location, const std::string& message);
 	
+	// Number of warnings from the most recent compile.
+	int GetWarningCount() const { return mWarningCount; }
+	
 private:
 	// Scanner, generated by Flex, used to parse text to tokens.
     SheepScanner* mScanner = nullptr;
 	
 	// Parser, generated by Bison, used to parse tokens into language grammer.
     Sheep::Parser* mParser = nullptr;
+	
+	// Whether to optimize compiled bytecode.
+	bool mOptimize = true;
+	
+	// If queueing reports, report stream names and messages waiting to be logged.
+	bool mQueueReports = false;
+	std::vector<std::pair<std::string, std::string>> mQueuedReports;
+	
+	// Number of warnings from the most recent compile.
+	int mWarningCount = 0;
 };
@@ -5,28 +5,122 @@
 //
 #include "SheepManager.h"
 
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <sstream>
+
+#include "FileSystem.h"
 #include "Services.h"
+#include "SheepScript.h"
+#include "SheepSysFuncs.h"
 #include "StringUtil.h"
 
+// Changes whenever the compiler's output changes, so scripts cached by an older version aren't used.
+static const int kCacheVersion = 1;
+
+SheepManager::~SheepManager()
+{
+	for(auto& compiler : mBatchCompilers)
+	{
+		delete compiler;
+	}
+}
+
 SheepScript* SheepManager::Compile(const char* filePath)
 {
-    return mCompiler.Compile(filePath);
+	// Grab file name w/o extension as context.
+	std::ifstream inFile(filePath);
+	return Compile(Path::GetFileNameNoExtension(filePath), inFile);
 }
 
 SheepScript* SheepManager::Compile(const std::string& name, const std::string& sheep)
 {
-    return mCompiler.Compile(name, sheep);
+	CreateCacheDirectory();
+    return CompileCached(mCompiler, name, sheep);
 }
 
 SheepScript* SheepManager::Compile(const std::string& name, std::istream& stream)
 {
-    return mCompiler.Compile(name, stream);
+	// Make sure we can read our stream.
+	if(!stream.good())
+	{
+		mCompiler.Report("SheepCompilerError", "Can't compile sheep '" + name + "' - the stream can't be read.");
+		return nullptr;
+	}
+	std::string sheep((std::istreambuf_iterator<char>(stream)), std::istreambuf_iterator<char>());
+	CreateCacheDirectory();
+	return CompileCached(mCompiler, name, sheep);
 }
 
 SheepScript* SheepManager::CompileEval(const std::string& sheep)
 {
 	std::string fullSheep = StringUtil::Format(mEvalHusk, sheep.c_str());
-	return mCompiler.Compile("Case Evaluation", fullSheep);
+	CreateCacheDirectory();
+	return CompileCached(mCompiler, "Case Evaluation", fullSheep);
+}
+
+void SheepManager::CompileBatch(std::vector<SheepBatchItem>& items)
+{
+	if(items.empty()) { return; }
+	
+	// Done up front, so jobs don't all try to create it at once.
+	CreateCacheDirectory();
+	
+	// One job per worker, plus one for this thread (which helps while waiting).
+	// Each job keeps taking the next uncompiled item until there are none left, so a few slow items don't hold up the rest.
+	ThreadPool* jobs = Services::GetJobs();
+	int jobCount = std::min(static_cast<int>(items.size()), static_cast<int>(jobs->GetThreadCount()) + 1);
+	while(mBatchCompilers.size() < jobCount)
+	{
+		SheepCompiler* compiler = new SheepCompiler();
+		compiler->SetQueueReports(true);
+		mBatchCompilers.push_back(compiler);
+	}
+	
+	// Each item's warnings/errors, so they can be logged in item order, no matter which job compiled it.
+	std::vector<std::vector<std::pair<std::string, std::string>>> itemReports(items.size());
+	
+	// The pool is shared with other systems, so only wait for this batch's jobs.
+	std::atomic<int> nextIndex(0);
+	std::atomic<int> pendingCount(jobCount);
+	for(int i = 0; i < jobCount; ++i)
+	{
+		SheepCompiler* compiler = mBatchCompilers[i];
+		compiler->SetOptimize(mCompiler.GetOptimize());
+		jobs->Enqueue([this, compiler, i, &items, &itemReports, &nextIndex, &pendingCount]() {
+			int index = nextIndex++;
+			while(index < items.size())
+			{
+				SheepBatchItem& item = items[index];
+				if(item.eval)
+				{
+					std::string fullSheep = StringUtil::Format(mEvalHusk, item.sheep.c_str());
+					item.script = CompileCached(*compiler, item.name, fullSheep, i);
+				}
+				else
+				{
+					item.script = CompileCached(*compiler, item.name, item.sheep, i);
+				}
+				compiler->TakeQueuedReports(itemReports[index]);
+				index = nextIndex++;
+			}
+			--pendingCount;
+		});
+	}
+	jobs->WaitForCount(pendingCount);
+	
+	// Now that we're back on this thread, log any warnings/errors, in the same order as compiling one at a time would.
+	for(auto& reports : itemReports)
+	{
+		for(auto& report : reports)
+		{
+			Services::GetReports()->Log(report.first, report.second);
+		}
+	}
 }
 
 void SheepManager::Execute(const std::string& sheepName, const std::string& functionName, std::function<void()> finishCallback)
@@ -61,3 +155,100 @@ bool SheepManager::Evaluate(SheepScript* script, int n, int v)
 	// Otherwise, do it "for real."
 	return mVirtualMachine.Evaluate(script, n, v);
 }
+
+void SheepManager::CreateCacheDirectory()
+{
+	if(mCacheDirectory.empty() || mCacheDirectoryCreated) { return; }
+	
+	// If the directory can't be created, caching is disabled.
+	mCacheDirectoryCreated = Directory::CreateAll(mCacheDirectory);
+	if(!mCacheDirectoryCreated)
+	{
+		std::cout << "Can't create sheep cache directory " << mCacheDirectory << " - compiled sheep won't be cached." << std::endl;
+		mCacheDirectory.clear();
+	}
+}
+
+SheepScript* SheepManager::CompileCached(SheepCompiler& compiler, const std::string& name, const std::string& sheep, int jobIndex)
+{
+	// May be called from a worker thread (see CompileBatch), so this shouldn't change any manager state.
+	if(mCacheDirectory.empty())
+	{
+		return compiler.Compile(name, sheep);
+	}
+	
+	// If this sheep was compiled before, load the compiled script.
+	std::string cachePath = GetCachePath(sheep);
+	std::ifstream cacheFile(cachePath, std::ios::in | std::ios::binary);
+	if(cacheFile.good())
+	{
+		std::vector<char> data((std::istreambuf_iterator<char>(cacheFile)), std::istreambuf_iterator<char>());
+		if(!data.empty())
+		{
+			// A valid script always has some bytecode. If not, the cached file is bad - just compile again.
+			SheepScript* script = new SheepScript(name, &data[0], static_cast<int>(data.size()));
+			if(script->GetBytecodeLength() > 0)
+			{
+				// Warnings are only reported when compiling, so mention that there were some.
+				std::ifstream warningsFile(cachePath + ".warnings");
+				if(warningsFile.good())
+				{
+					compiler.Report("SheepCompilerWarning", "Sheep '" + name + "' was loaded from the compiled sheep cache, so its compile warnings weren't reported. Delete " + cachePath + " to see them.");
+				}
+				return script;
+			}
+			delete script;
+		}
+	}
+	cacheFile.close();
+	
+	// Compile it. Compile errors aren't cached, so they'll be reported every time.
+	SheepScript* script = compiler.Compile(name, sheep);
+	if(script == nullptr) { return nullptr; }
+	
+	// Save compiled script for next time.
+	// Writes to a temporary file first, so a partially written file is never loaded.
+	// Each batch job uses its own temporary file, in case two jobs compile the same sheep at once.
+	std::string tempPath = cachePath + ".tmp" + std::to_string(jobIndex);
+	if(script->WriteToFile(tempPath))
+	{
+		std::remove(cachePath.c_str());
+		std::rename(tempPath.c_str(), cachePath.c_str());
+		
+		// Note that this sheep has warnings, so cache hits can say so.
+		std::string warningsPath = cachePath + ".warnings";
+		if(compiler.GetWarningCount() > 0)
+		{
+			std::ofstream warningsFile(warningsPath);
+		}
+		else
+		{
+			std::remove(warningsPath.c_str());
+		}
+	}
+	else
+	{
+		std::remove(tempPath.c_str());
+	}
+	return script;
+}
+
+std::string SheepManager::GetCachePath(const std::string& sheep) const
+{
+	// FNV-1a hash of the sheep text. Anything that changes the compiled output is hashed too.
+	uint64_t hash = 14695981039346656037ull;
+	for(char c : sheep)
+	{
+		hash = (hash ^ static_cast<unsigned char>(c)) * 1099511628211ull;
+	}
+	hash = (hash ^ static_cast<uint64_t>(kCacheVersion)) * 1099511628211ull;
+	hash = (hash ^ (mCompiler.GetOptimize() ? 1u : 0u)) * 1099511628211ull;
+	
+	// System function declarations decide which calls compile, and how.
+	hash = (hash ^ GetSysFuncDeclsHash()) * 1099511628211ull;
+	
+	// Length is part of the file name too, to make collisions even less likely.
+	std::stringstream ss;
+	ss << std::hex << hash << "_" << std::dec << sheep.size() << ".shp";
+	return Path::Combine({ mCacheDirectory, ss.str() });
+}
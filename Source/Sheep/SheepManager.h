@@ -8,17 +8,36 @@
 //
 #pragma once
 #include <stack>
+#include <vector>
 
 #include "SheepCompiler.h"
 #include "SheepVM.h"
 
+// A sheep to compile as part of a batch.
+struct SheepBatchItem
+{
+	std::string name;
+	std::string sheep;
+	
+	// If true, the sheep is an expression to evaluate, and is wrapped like in CompileEval.
+	bool eval = false;
+	
+	// Set to the compiled script, or null if compilation failed.
+	SheepScript* script = nullptr;
+};
+
 class SheepManager
 {
 public:
+	~SheepManager();
+	
     SheepScript* Compile(const char* filePath);
     SheepScript* Compile(const std::string& name, const std::string& sheep);
     SheepScript* Compile(const std::string& name, std::istream& stream);
 	SheepScript* CompileEval(const std::string& sheep);
+	
+	// Compiles many independent sheeps at once, spread across worker threads.
+	void CompileBatch(std::vector<SheepBatchItem>& items);
     
 	void Execute(const std::string& sheepName, const std::string& functionName, std::function<void()> finishCallback);
 	void Execute(SheepScript* script, std::function<void()> finishCallback);
@@ -31,6 +50,12 @@ public:
 	bool IsAnyRunning() const { return mVirtualMachine.IsAnyRunning(); }
 	void FlagExecutionError() { mVirtualMachine.FlagExecutionError(); }
 	
+	SheepProfiler& GetProfiler() { return mVirtualMachine.GetProfiler(); }
+	
+	// Compiled scripts are cached on disk, keyed by a hash of the sheep text, so the same text isn't compiled again on later runs.
+	// The cache is off until a directory is set (the engine sets one on startup). An empty directory disables it again.
+	void SetCacheDirectory(const std::string& directory) { mCacheDirectory = directory; mCacheDirectoryCreated = false; }
+	
 private:
 	// Compiles text-based sheep script into sheep bytecode, represented as a SheepScript asset.
     SheepCompiler mCompiler;
@@ -39,4 +64,17 @@ private:
 	SheepVM mVirtualMachine;
 	
 	std::string mEvalHusk = "symbols { int n$ = 0; int v$ = 0; } code { X$() %s }";
+	
+	// Directory to store compiled scripts in. Relative paths are relative to the working directory.
+	// Empty by default, so tools and tests always compile fresh and don't leave files behind.
+	std::string mCacheDirectory;
+	bool mCacheDirectoryCreated = false;
+	
+	// Compiler for each batch job. Jobs run on the shared thread pool (see Services::GetJobs).
+	// Each compiler has its own scanner and parser, so they can compile at the same time.
+	std::vector<SheepCompiler*> mBatchCompilers;
+	
+	void CreateCacheDirectory();
+	SheepScript* CompileCached(SheepCompiler& compiler, const std::string& name, const std::string& sheep, int jobIndex = 0);
+	std::string GetCachePath(const std::string& sheep) const;
 };
@@ -0,0 +1,584 @@
+//
+// SheepOptimizer.cpp
+//
+// Clark Kromenaker
+//
+#include "SheepOptimizer.h"
+
+#include <climits>
+#include <cstring>
+
+#include "GMath.h"
+
+SheepOptimizer::SheepOptimizer(const std::vector<char>& bytecode) :
+	mBytecode(bytecode)
+{
+
+}
+
+void SheepOptimizer::AddEntryPoint(int offset)
+{
+	mEntryOffsets.push_back(offset);
+}
+
+bool SheepOptimizer::Optimize()
+{
+	if(!Decode()) { return false; }
+	UpdateEntries();
+
+	// Keep applying optimizations until there's nothing left to do.
+	// One optimization often exposes another (e.g. folding "1 + 2" exposes "3 + 4" in "1 + 2 + 4").
+	int endIndex = static_cast<int>(mInstructions.size()) - 1;
+	bool changed = true;
+	while(changed)
+	{
+		changed = false;
+		for(int i = 0; i < endIndex; ++i)
+		{
+			if(mInstructions[i].removed) { continue; }
+
+			// SitnSpin does nothing.
+			if(mInstructions[i].instruction == SheepInstruction::SitnSpin)
+			{
+				Remove(i);
+				changed = true;
+				continue;
+			}
+
+			if(OptimizePushPop(i) || FoldConstants(i) || FoldConversions(i) || FoldBranchIfZero(i) || ThreadBranch(i))
+			{
+				changed = true;
+			}
+		}
+	}
+
+	Encode();
+	return true;
+}
+
+int SheepOptimizer::GetOptimizedOffset(int offset) const
+{
+	int index = GetInstructionIndex(offset);
+	if(index < 0) { return -1; }
+	return mInstructions[index].optimizedOffset;
+}
+
+bool SheepOptimizer::Decode()
+{
+	mInstructions.clear();
+
+	int offset = 0;
+	int size = static_cast<int>(mBytecode.size());
+	while(offset < size)
+	{
+		Instruction instruction;
+		instruction.offset = offset;
+		unsigned char value = static_cast<unsigned char>(mBytecode[offset]);
+		instruction.instruction = static_cast<SheepInstruction>(value);
+
+		// Unknown instructions can't be optimized safely.
+		if(value == 0x0C || value > static_cast<unsigned char>(SheepInstruction::DebugBreakpoint))
+		{
+			return false;
+		}
+
+		switch(instruction.instruction)
+		{
+		case SheepInstruction::CallSysFunctionV:
+		case SheepInstruction::CallSysFunctionI:
+		case SheepInstruction::CallSysFunctionF:
+		case SheepInstruction::CallSysFunctionS:
+		case SheepInstruction::Branch:
+		case SheepInstruction::BranchGoto:
+		case SheepInstruction::BranchIfZero:
+		case SheepInstruction::StoreI:
+		case SheepInstruction::StoreF:
+		case SheepInstruction::StoreS:
+		case SheepInstruction::LoadI:
+		case SheepInstruction::LoadF:
+		case SheepInstruction::LoadS:
+		case SheepInstruction::PushI:
+		case SheepInstruction::PushF:
+		case SheepInstruction::PushS:
+		case SheepInstruction::IToF:
+		case SheepInstruction::FToI:
+			instruction.hasArg = true;
+			break;
+		default:
+			break;
+		}
+
+		// Operand is 4 bytes, little-endian. Floats are stored as their raw bytes.
+		if(instruction.hasArg)
+		{
+			if(offset + 5 > size) { return false; }
+			unsigned int arg = static_cast<unsigned char>(mBytecode[offset + 1]) |
+							   static_cast<unsigned char>(mBytecode[offset + 2]) << 8 |
+							   static_cast<unsigned char>(mBytecode[offset + 3]) << 16 |
+							   static_cast<unsigned int>(static_cast<unsigned char>(mBytecode[offset + 4])) << 24;
+			memcpy(&instruction.intArg, &arg, sizeof(int));
+			offset += 5;
+		}
+		else
+		{
+			offset += 1;
+		}
+		mInstructions.push_back(instruction);
+	}
+
+	// Add an instruction to represent the end of the bytecode. It's never removed or output.
+	Instruction end;
+	end.instruction = SheepInstruction::ReturnV;
+	end.offset = size;
+	mInstructions.push_back(end);
+
+	// Convert branch offsets to instruction indexes.
+	for(auto& instruction : mInstructions)
+	{
+		if(instruction.instruction == SheepInstruction::Branch ||
+		   instruction.instruction == SheepInstruction::BranchGoto ||
+		   instruction.instruction == SheepInstruction::BranchIfZero)
+		{
+			instruction.branchIndex = GetInstructionIndex(instruction.intArg);
+		}
+	}
+	return true;
+}
+
+void SheepOptimizer::Encode()
+{
+	// Calculate new offsets. Removed instructions get the offset of the next instruction that wasn't removed.
+	int offset = 0;
+	for(auto& instruction : mInstructions)
+	{
+		instruction.optimizedOffset = offset;
+		if(!instruction.removed && &instruction != &mInstructions.back())
+		{
+			offset += instruction.hasArg ? 5 : 1;
+		}
+	}
+
+	// Output remaining instructions.
+	std::vector<char> bytecode;
+	bytecode.reserve(offset);
+	for(int i = 0; i < static_cast<int>(mInstructions.size()) - 1; ++i)
+	{
+		const Instruction& instruction = mInstructions[i];
+		if(instruction.removed) { continue; }
+		bytecode.push_back(static_cast<char>(instruction.instruction));
+
+		if(instruction.hasArg)
+		{
+			// Branches use the new offset of the instruction branched to. Invalid branches stay invalid.
+			int intArg = instruction.intArg;
+			if(IsBranch(i))
+			{
+				intArg = instruction.branchIndex >= 0 ? mInstructions[instruction.branchIndex].optimizedOffset : -1;
+			}
+
+			unsigned int arg = 0;
+			memcpy(&arg, &intArg, sizeof(int));
+			bytecode.push_back(arg & 0xFF);
+			bytecode.push_back((arg >> 8) & 0xFF);
+			bytecode.push_back((arg >> 16) & 0xFF);
+			bytecode.push_back((arg >> 24) & 0xFF);
+		}
+	}
+	mBytecode.swap(bytecode);
+}
+
+void SheepOptimizer::UpdateEntries()
+{
+	for(auto& instruction : mInstructions)
+	{
+		instruction.isEntry = false;
+	}
+	for(auto& offset : mEntryOffsets)
+	{
+		int index = GetInstructionIndex(offset);
+		if(index >= 0)
+		{
+			mInstructions[index].isEntry = true;
+		}
+	}
+	for(int i = 0; i < mInstructions.size(); ++i)
+	{
+		if(IsBranch(i) && mInstructions[i].branchIndex >= 0)
+		{
+			mInstructions[mInstructions[i].branchIndex].isEntry = true;
+		}
+	}
+}
+
+int SheepOptimizer::GetNextIndex(int index) const
+{
+	// Skip removed instructions. The end instruction is never removed, so this always finds something.
+	int lastIndex = static_cast<int>(mInstructions.size()) - 1;
+	++index;
+	while(index < lastIndex && mInstructions[index].removed)
+	{
+		++index;
+	}
+	return index < lastIndex ? index : lastIndex;
+}
+
+int SheepOptimizer::GetInstructionIndex(int offset) const
+{
+	// Instructions are sorted by offset, so binary search.
+	int low = 0;
+	int high = static_cast<int>(mInstructions.size()) - 1;
+	while(low <= high)
+	{
+		int mid = (low + high) / 2;
+		if(mInstructions[mid].offset == offset) { return mid; }
+		if(mInstructions[mid].offset < offset)
+		{
+			low = mid + 1;
+		}
+		else
+		{
+			high = mid - 1;
+		}
+	}
+	return -1;
+}
+
+bool SheepOptimizer::OptimizePushPop(int index)
+{
+	int next = GetNextIndex(index);
+	if(mInstructions[next].isEntry) { return false; }
+	SheepInstruction instruction = mInstructions[index].instruction;
+
+	// A value that's pushed and then popped right away does nothing.
+	// Loading a variable has no side effects, so that counts too.
+	if(IsPush(index) ||
+	   instruction == SheepInstruction::LoadI ||
+	   instruction == SheepInstruction::LoadF ||
+	   instruction == SheepInstruction::LoadS)
+	{
+		if(mInstructions[next].instruction == SheepInstruction::Pop)
+		{
+			Remove(index);
+			Remove(next);
+			return true;
+		}
+	}
+
+	// Pushing a string is PushS followed by GetString.
+	if(instruction == SheepInstruction::PushS && mInstructions[next].instruction == SheepInstruction::GetString)
+	{
+		int pop = GetNextIndex(next);
+		if(!mInstructions[pop].isEntry && mInstructions[pop].instruction == SheepInstruction::Pop)
+		{
+			Remove(index);
+			Remove(next);
+			Remove(pop);
+			return true;
+		}
+	}
+	return false;
+}
+
+bool SheepOptimizer::FoldConstants(int index)
+{
+	// Folded expressions must compute exactly what the VM would compute at runtime - see SheepVM.
+	Instruction& first = mInstructions[index];
+	if(!IsPush(index)) { return false; }
+
+	int next = GetNextIndex(index);
+	Instruction& second = mInstructions[next];
+	if(second.isEntry) { return false; }
+
+	// Unary operations on a constant.
+	if(first.instruction == SheepInstruction::PushI)
+	{
+		if(second.instruction == SheepInstruction::NegateI)
+		{
+			first.intArg = static_cast<int>(0u - static_cast<unsigned int>(first.intArg));
+			Remove(next);
+			return true;
+		}
+		if(second.instruction == SheepInstruction::Not)
+		{
+			first.intArg = first.intArg == 0 ? 1 : 0;
+			Remove(next);
+			return true;
+		}
+	}
+	else if(first.instruction == SheepInstruction::PushF && second.instruction == SheepInstruction::NegateF)
+	{
+		first.floatArg *= -1.0f;
+		Remove(next);
+		return true;
+	}
+
+	// Binary operations on two constants of the same type.
+	if(second.instruction != first.instruction) { return false; }
+	int operation = GetNextIndex(next);
+	if(mInstructions[operation].isEntry) { return false; }
+	SheepInstruction operationInstruction = mInstructions[operation].instruction;
+
+	if(first.instruction == SheepInstruction::PushI)
+	{
+		// Unsigned math wraps on overflow, rather than being undefined.
+		int int1 = first.intArg;
+		int int2 = second.intArg;
+		unsigned int uint1 = static_cast<unsigned int>(int1);
+		unsigned int uint2 = static_cast<unsigned int>(int2);
+		int result = 0;
+		switch(operationInstruction)
+		{
+		case SheepInstruction::AddI:
+			result = static_cast<int>(uint1 + uint2);
+			break;
+		case SheepInstruction::SubtractI:
+			result = static_cast<int>(uint1 - uint2);
+			break;
+		case SheepInstruction::MultiplyI:
+			result = static_cast<int>(uint1 * uint2);
+			break;
+		case SheepInstruction::DivideI:
+			// Dividing by zero is left to the VM, so the error is still reported at runtime.
+			if(int2 == 0 || (int1 == INT_MIN && int2 == -1)) { return false; }
+			result = int1 / int2;
+			break;
+		case SheepInstruction::Modulo:
+			if(int2 == 0 || (int1 == INT_MIN && int2 == -1)) { return false; }
+			result = int1 % int2;
+			break;
+		case SheepInstruction::IsEqualI:
+			result = int1 == int2 ? 1 : 0;
+			break;
+		case SheepInstruction::IsNotEqualI:
+			result = int1 != int2 ? 1 : 0;
+			break;
+		case SheepInstruction::IsGreaterI:
+			result = int1 > int2 ? 1 : 0;
+			break;
+		case SheepInstruction::IsLessI:
+			result = int1 < int2 ? 1 : 0;
+			break;
+		case SheepInstruction::IsGreaterEqualI:
+			result = int1 >= int2 ? 1 : 0;
+			break;
+		case SheepInstruction::IsLessEqualI:
+			result = int1 <= int2 ? 1 : 0;
+			break;
+		case SheepInstruction::And:
+			result = int1 && int2 ? 1 : 0;
+			break;
+		case SheepInstruction::Or:
+			result = int1 || int2 ? 1 : 0;
+			break;
+		default:
+			return false;
+		}
+		first.intArg = result;
+	}
+	else
+	{
+		// Float comparisons result in an int.
+		float float1 = first.floatArg;
+		float float2 = second.floatArg;
+		switch(operationInstruction)
+		{
+		case SheepInstruction::AddF:
+			first.floatArg = float1 + float2;
+			break;
+		case SheepInstruction::SubtractF:
+			first.floatArg = float1 - float2;
+			break;
+		case SheepInstruction::MultiplyF:
+			first.floatArg = float1 * float2;
+			break;
+		case SheepInstruction::DivideF:
+			if(Math::AreEqual(float2, 0.0f)) { return false; }
+			first.floatArg = float1 / float2;
+			break;
+		case SheepInstruction::IsEqualF:
+			first.instruction = SheepInstruction::PushI;
+			first.intArg = Math::AreEqual(float1, float2) ? 1 : 0;
+			break;
+		case SheepInstruction::IsNotEqualF:
+			first.instruction = SheepInstruction::PushI;
+			first.intArg = !Math::AreEqual(float1, float2) ? 1 : 0;
+			break;
+		case SheepInstruction::IsGreaterF:
+			first.instruction = SheepInstruction::PushI;
+			first.intArg = float1 > float2 ? 1 : 0;
+			break;
+		case SheepInstruction::IsLessF:
+			first.instruction = SheepInstruction::PushI;
+			first.intArg = float1 < float2 ? 1 : 0;
+			break;
+		case SheepInstruction::IsGreaterEqualF:
+			first.instruction = SheepInstruction::PushI;
+			first.intArg = float1 >= float2 ? 1 : 0;
+			break;
+		case SheepInstruction::IsLessEqualF:
+			first.instruction = SheepInstruction::PushI;
+			first.intArg = float1 <= float2 ? 1 : 0;
+			break;
+		default:
+			return false;
+		}
+	}
+	Remove(next);
+	Remove(operation);
+	return true;
+}
+
+bool SheepOptimizer::FoldConversions(int index)
+{
+	Instruction& first = mInstructions[index];
+	if(!IsPush(index)) { return false; }
+
+	int next = GetNextIndex(index);
+	if(mInstructions[next].isEntry) { return false; }
+
+	// Conversion of the top of the stack: convert the constant instead.
+	const Instruction& second = mInstructions[next];
+	if(second.intArg == 0)
+	{
+		if(first.instruction == SheepInstruction::PushI && second.instruction == SheepInstruction::IToF)
+		{
+			first.instruction = SheepInstruction::PushF;
+			first.floatArg = static_cast<float>(first.intArg);
+			Remove(next);
+			return true;
+		}
+		if(first.instruction == SheepInstruction::PushF && second.instruction == SheepInstruction::FToI)
+		{
+			first.instruction = SheepInstruction::PushI;
+			first.intArg = static_cast<int>(first.floatArg);
+			Remove(next);
+			return true;
+		}
+	}
+
+	// Conversion of the value under the top of the stack, where both values are constants.
+	if(IsPush(next))
+	{
+		int conversion = GetNextIndex(next);
+		const Instruction& third = mInstructions[conversion];
+		if(third.isEntry || third.intArg != 1) { return false; }
+		if(first.instruction == SheepInstruction::PushI && third.instruction == SheepInstruction::IToF)
+		{
+			first.instruction = SheepInstruction::PushF;
+			first.floatArg = static_cast<float>(first.intArg);
+			Remove(conversion);
+			return true;
+		}
+		if(first.instruction == SheepInstruction::PushF && third.instruction == SheepInstruction::FToI)
+		{
+			first.instruction = SheepInstruction::PushI;
+			first.intArg = static_cast<int>(first.floatArg);
+			Remove(conversion);
+			return true;
+		}
+	}
+	return false;
+}
+
+bool SheepOptimizer::FoldBranchIfZero(int index)
+{
+	// A constant condition always or never branches (e.g. "if(1)").
+	Instruction& first = mInstructions[index];
+	if(first.instruction != SheepInstruction::PushI) { return false; }
+
+	int next = GetNextIndex(index);
+	const Instruction& second = mInstructions[next];
+	if(second.isEntry || second.instruction != SheepInstruction::BranchIfZero) { return false; }
+
+	if(first.intArg == 0)
+	{
+		first.instruction = SheepInstruction::Branch;
+		first.branchIndex = second.branchIndex;
+		Remove(next);
+	}
+	else
+	{
+		Remove(index);
+		Remove(next);
+	}
+	return true;
+}
+
+bool SheepOptimizer::ThreadBranch(int index)
+{
+	if(!IsBranch(index)) { return false; }
+	Instruction& branch = mInstructions[index];
+	if(branch.branchIndex < 0) { return false; }
+
+	// Instruction actually branched to (if the original was removed, it's the next one after).
+	int target = branch.branchIndex;
+	if(mInstructions[target].removed)
+	{
+		target = GetNextIndex(target);
+	}
+
+	// If that's an unconditional branch, go straight to where it goes.
+	// Limit how far this goes, in case of infinite loops (e.g. two gotos that go to each other).
+	for(int i = 0; i < 16 && target != index; ++i)
+	{
+		const Instruction& targetInstruction = mInstructions[target];
+		if(targetInstruction.removed || targetInstruction.branchIndex < 0 ||
+		   (targetInstruction.instruction != SheepInstruction::Branch && targetInstruction.instruction != SheepInstruction::BranchGoto))
+		{
+			break;
+		}
+		target = targetInstruction.branchIndex;
+		if(mInstructions[target].removed)
+		{
+			target = GetNextIndex(target);
+		}
+	}
+
+	// Branching to the next instruction does nothing (except BranchIfZero still pops the condition).
+	if(target == GetNextIndex(index))
+	{
+		if(branch.instruction == SheepInstruction::BranchIfZero)
+		{
+			branch.instruction = SheepInstruction::Pop;
+			branch.hasArg = false;
+			branch.branchIndex = -1;
+		}
+		else
+		{
+			Remove(index);
+		}
+		return true;
+	}
+
+	if(target != branch.branchIndex)
+	{
+		branch.branchIndex = target;
+		mInstructions[target].isEntry = true;
+		return true;
+	}
+	return false;
+}
+
+void SheepOptimizer::Remove(int index)
+{
+	// If execution could jump to this instruction, it now jumps to the next one instead.
+	mInstructions[index].removed = true;
+	if(mInstructions[index].isEntry)
+	{
+		mInstructions[GetNextIndex(index)].isEntry = true;
+	}
+}
+
+bool SheepOptimizer::IsBranch(int index) const
+{
+	SheepInstruction instruction = mInstructions[index].instruction;
+	return instruction == SheepInstruction::Branch ||
+		   instruction == SheepInstruction::BranchGoto ||
+		   instruction == SheepInstruction::BranchIfZero;
+}
+
+bool SheepOptimizer::IsPush(int index) const
+{
+	SheepInstruction instruction = mInstructions[index].instruction;
+	return instruction == SheepInstruction::PushI || instruction == SheepInstruction::PushF;
+}
@@ -0,0 +1,94 @@
+//
+// SheepOptimizer.h
+//
+// Clark Kromenaker
+//
+// Performs simple "peephole" optimizations on compiled sheep bytecode.
+//
+// The sheep compiler generates very straightforward stack code. For example, "1 + 2"
+// pushes two values and adds them at runtime, and nested if/else blocks branch to
+// branches. The optimizer looks for short patterns like these and replaces them with
+// fewer instructions:
+//  - Constant expressions are folded (e.g. PushI 1, PushI 2, AddI => PushI 3).
+//  - Values that are pushed and immediately popped are removed.
+//  - Branches to branches jump straight to the final destination.
+//  - Branches to the very next instruction, and SitnSpin padding, are removed.
+//
+// The output is still regular bytecode, so it executes on the VM like any other sheep.
+//
+#pragma once
+#include <vector>
+
+#include "SheepVM.h"
+
+class SheepOptimizer
+{
+public:
+	SheepOptimizer(const std::vector<char>& bytecode);
+
+	// Offsets that may be executed from outside the bytecode (e.g. function start offsets).
+	// Patterns are never optimized across these offsets, in addition to any branch targets.
+	void AddEntryPoint(int offset);
+
+	// Returns false if the bytecode couldn't be optimized (e.g. unknown instructions), in which case it's left unchanged.
+	bool Optimize();
+
+	const std::vector<char>& GetBytecode() const { return mBytecode; }
+
+	// Converts an offset in the original bytecode to the matching offset in the optimized bytecode.
+	// Returns -1 if the original offset isn't the start of an instruction.
+	int GetOptimizedOffset(int offset) const;
+
+private:
+	struct Instruction
+	{
+		SheepInstruction instruction = SheepInstruction::SitnSpin;
+
+		// Operand, for instructions that have one.
+		bool hasArg = false;
+		union
+		{
+			int intArg = 0;
+			float floatArg;
+		};
+
+		// For branches, index of the instruction branched to (or -1 if invalid).
+		int branchIndex = -1;
+
+		// Offset in original bytecode, and offset in optimized bytecode.
+		int offset = 0;
+		int optimizedOffset = 0;
+
+		// If true, the instruction was optimized away.
+		bool removed = false;
+
+		// If true, execution can jump to this instruction from somewhere other than the previous instruction.
+		bool isEntry = false;
+	};
+
+	// Bytecode (original, then optimized after calling Optimize).
+	std::vector<char> mBytecode;
+
+	// Decoded instructions. There's always one extra "end" instruction, representing the end of the bytecode.
+	std::vector<Instruction> mInstructions;
+
+	// Entry point offsets.
+	std::vector<int> mEntryOffsets;
+
+	bool Decode();
+	void Encode();
+
+	void UpdateEntries();
+	int GetNextIndex(int index) const;
+	int GetInstructionIndex(int offset) const;
+
+	bool OptimizePushPop(int index);
+	bool FoldConstants(int index);
+	bool FoldConversions(int index);
+	bool FoldBranchIfZero(int index);
+	bool ThreadBranch(int index);
+
+	void Remove(int index);
+	bool IsBranch(int index) const;
+	bool IsPush(int index) const;
+};
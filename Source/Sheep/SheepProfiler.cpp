@@ -0,0 +1,96 @@
+//
+// SheepProfiler.cpp
+//
+// Clark Kromenaker
+//
+#include "SheepProfiler.h"
+
+#include <algorithm>
+#include <iomanip>
+#include <sstream>
+#include <vector>
+
+static int64_t GetNanoseconds(SheepProfiler::Clock::time_point startTime, SheepProfiler::Clock::time_point endTime)
+{
+	return std::chrono::duration_cast<std::chrono::nanoseconds>(endTime - startTime).count();
+}
+
+static void AddTime(SheepProfiler::Record& record, int64_t nanoseconds)
+{
+	record.totalNanoseconds += nanoseconds;
+	record.maxNanoseconds = std::max(record.maxNanoseconds, nanoseconds);
+}
+
+static void AppendRecords(std::stringstream& ss, const std::unordered_map<std::string, SheepProfiler::Record>& records, bool includeInstructions)
+{
+	// Sort by total time, most expensive first. Ties are sorted by name, so output is consistent.
+	std::vector<const std::pair<const std::string, SheepProfiler::Record>*> sorted;
+	sorted.reserve(records.size());
+	for(auto& entry : records)
+	{
+		sorted.push_back(&entry);
+	}
+	std::sort(sorted.begin(), sorted.end(), [](const std::pair<const std::string, SheepProfiler::Record>* a,
+											   const std::pair<const std::string, SheepProfiler::Record>* b) {
+		if(a->second.totalNanoseconds != b->second.totalNanoseconds)
+		{
+			return a->second.totalNanoseconds > b->second.totalNanoseconds;
+		}
+		return a->first < b->first;
+	});
+	
+	for(auto& entry : sorted)
+	{
+		const SheepProfiler::Record& record = entry->second;
+		ss << "  " << entry->first << ": " << record.callCount << " calls, ";
+		if(includeInstructions)
+		{
+			ss << record.instructionCount << " instructions, ";
+		}
+		ss << (record.totalNanoseconds / 1000000.0) << " ms total, " << (record.maxNanoseconds / 1000000.0) << " ms max" << std::endl;
+	}
+}
+
+void SheepProfiler::SetEnabled(bool enabled)
+{
+	if(enabled && !mEnabled)
+	{
+		Clear();
+	}
+	mEnabled = enabled;
+}
+
+void SheepProfiler::Clear()
+{
+	mFunctionRecords.clear();
+	mSysFuncRecords.clear();
+}
+
+void SheepProfiler::AddFunctionSample(const std::string& name, bool started, int instructionCount, Clock::time_point startTime, Clock::time_point endTime)
+{
+	Record& record = mFunctionRecords[name];
+	if(started)
+	{
+		++record.callCount;
+	}
+	record.instructionCount += instructionCount;
+	AddTime(record, GetNanoseconds(startTime, endTime));
+}
+
+void SheepProfiler::AddSysFuncSample(const std::string& name, Clock::time_point startTime, Clock::time_point endTime)
+{
+	Record& record = mSysFuncRecords[name];
+	++record.callCount;
+	AddTime(record, GetNanoseconds(startTime, endTime));
+}
+
+std::string SheepProfiler::GetReport() const
+{
+	std::stringstream ss;
+	ss << std::fixed << std::setprecision(3);
+	ss << "Sheep functions:" << std::endl;
+	AppendRecords(ss, mFunctionRecords, true);
+	ss << "System functions:" << std::endl;
+	AppendRecords(ss, mSysFuncRecords, false);
+	return ss.str();
+}
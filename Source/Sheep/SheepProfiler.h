@@ -0,0 +1,63 @@
+//
+// SheepProfiler.h
+//
+// Clark Kromenaker
+//
+// Records how much time is spent executing sheep, to help track down scripts that cause hitches.
+//
+// When enabled, the VM reports each sheep function it executes (instruction count and time)
+// and each system function it calls (time). Times are "inclusive" - if a system function
+// executes more sheep, that time counts toward both the system function and the sheep.
+//
+// Profiling is off by default. When off, the VM doesn't record anything.
+//
+#pragma once
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+
+class SheepProfiler
+{
+public:
+	typedef std::chrono::steady_clock Clock;
+	
+	struct Record
+	{
+		// Times executed/called.
+		int callCount = 0;
+		
+		// Number of sheep instructions executed (zero for system functions).
+		int64_t instructionCount = 0;
+		
+		// Total time, and longest single execution, in nanoseconds.
+		// A sheep function that waits is executed in multiple pieces - each piece counts separately toward the longest time.
+		int64_t totalNanoseconds = 0;
+		int64_t maxNanoseconds = 0;
+	};
+	
+	// Enabling the profiler clears any previously recorded data.
+	void SetEnabled(bool enabled);
+	bool IsEnabled() const { return mEnabled; }
+	
+	void Clear();
+	
+	// Records execution of a sheep function (e.g. "Script:Function$"). If "started" is false, it's a continuation of a previous call (e.g. after a wait).
+	void AddFunctionSample(const std::string& name, bool started, int instructionCount, Clock::time_point startTime, Clock::time_point endTime);
+	
+	// Records a call to a system function.
+	void AddSysFuncSample(const std::string& name, Clock::time_point startTime, Clock::time_point endTime);
+	
+	const std::unordered_map<std::string, Record>& GetFunctionRecords() const { return mFunctionRecords; }
+	const std::unordered_map<std::string, Record>& GetSysFuncRecords() const { return mSysFuncRecords; }
+	
+	// Creates a report of recorded data, most expensive first.
+	std::string GetReport() const;
+	
+private:
+	bool mEnabled = false;
+	
+	// Records, keyed by function name.
+	std::unordered_map<std::string, Record> mFunctionRecords;
+	std::unordered_map<std::string, Record> mSysFuncRecords;
+};
@@ -6,15 +6,21 @@
 //
 #include "SheepScript.h"
 
+#include <algorithm>
 #include <iostream>
 
 #include "BinaryReader.h"
+#include "BinaryWriter.h"
+#include "SheepAPI.h"
 #include "SheepScriptBuilder.h"
 #include "StringUtil.h"
 
 SheepScript::SheepScript(std::string name, char* data, int dataLength) : Asset(name)
 {
     ParseFromData(data, dataLength);
+	ResolveStringVariables();
+	BindSysImports();
+	DecodeBytecode();
 }
 
 SheepScript::SheepScript(const std::string& name, SheepScriptBuilder& builder) : Asset(name)
@@ -30,6 +36,9 @@ SheepScript::SheepScript(const std::string& name, SheepScriptBuilder& builder) :
     mBytecodeLength = (int)bytecodeVec.size();
     mBytecode = new char[mBytecodeLength];
     std::copy(bytecodeVec.begin(), bytecodeVec.end(), mBytecode);
+	ResolveStringVariables();
+	BindSysImports();
+	DecodeBytecode();
 }
 
 SysImport* SheepScript::GetSysImport(int index)
@@ -48,6 +57,12 @@ std::string* SheepScript::GetStringConst(int offset)
 	return nullptr;
 }
 
+int SheepScript::GetInstructionIndex(int bytecodeOffset) const
+{
+	if(bytecodeOffset < 0 || bytecodeOffset >= mInstructionIndexes.size()) { return -1; }
+	return mInstructionIndexes[bytecodeOffset];
+}
+
 int SheepScript::GetFunctionOffset(std::string functionName)
 {
 	// All sheep functions are case-insensitive. So, we only use lowercase names for consistency.
@@ -70,6 +85,234 @@ void SheepScript::Dump()
     std::cout << "--------------------------------------------------------------------------" << std::endl;
 }
 
+bool SheepScript::WriteToFile(const std::string& filePath)
+{
+	BinaryWriter writer(filePath.c_str());
+	if(!writer.OK()) { return false; }
+	
+	// File identifier, version (unused), then header/content sizes, which are filled in at the end.
+	writer.WriteString("GK3Sheep");
+	writer.WriteInt(0);
+	writer.Skip(12);
+	
+	// Offsets of each section, relative to the end of the header. Also filled in at the end.
+	const int kSectionCount = 5;
+	writer.WriteInt(kSectionCount);
+	int sectionOffsetsPosition = writer.GetPosition();
+	writer.Skip(4 * kSectionCount);
+	int headerSize = writer.GetPosition();
+	
+	int sectionOffsets[kSectionCount];
+	sectionOffsets[0] = writer.GetPosition() - headerSize;
+	WriteSysImportsSection(writer);
+	sectionOffsets[1] = writer.GetPosition() - headerSize;
+	WriteStringConstsSection(writer);
+	sectionOffsets[2] = writer.GetPosition() - headerSize;
+	WriteVariablesSection(writer);
+	sectionOffsets[3] = writer.GetPosition() - headerSize;
+	WriteFunctionsSection(writer);
+	sectionOffsets[4] = writer.GetPosition() - headerSize;
+	WriteCodeSection(writer);
+	int contentSize = writer.GetPosition() - headerSize;
+	
+	// Go back and fill in header.
+	writer.Seek(12);
+	writer.WriteInt(headerSize);
+	writer.WriteInt(headerSize);
+	writer.WriteInt(contentSize);
+	writer.Seek(sectionOffsetsPosition);
+	for(int i = 0; i < kSectionCount; i++)
+	{
+		writer.WriteInt(sectionOffsets[i]);
+	}
+	return writer.OK();
+}
+
+static void WriteSectionName(BinaryWriter& writer, const std::string& name)
+{
+	// Section names are always 12 bytes, padded with nulls.
+	writer.WriteString(name);
+	for(int i = static_cast<int>(name.size()); i < 12; i++)
+	{
+		writer.WriteUByte(0);
+	}
+}
+
+static void WriteName(BinaryWriter& writer, const std::string& name)
+{
+	// Length doesn't include the null terminator, but the null terminator is written.
+	writer.WriteShort(static_cast<int16_t>(name.size()));
+	writer.WriteString(name);
+	writer.WriteUByte(0);
+}
+
+void SheepScript::WriteSysImportsSection(BinaryWriter& writer)
+{
+	int count = static_cast<int>(mSysImports.size());
+	int headerSize = 12 + 16 + 4 * count;
+	
+	// Each import is a name, return type, argument count, and argument types.
+	std::vector<int> offsets;
+	int size = 0;
+	for(auto& sysImport : mSysImports)
+	{
+		offsets.push_back(size);
+		size += 2 + static_cast<int>(sysImport.name.size()) + 1 + 2 + static_cast<int>(sysImport.argumentTypes.size());
+	}
+	
+	WriteSectionName(writer, "SysImports");
+	writer.WriteInt(headerSize);
+	writer.WriteInt(headerSize);
+	writer.WriteInt(size);
+	writer.WriteInt(count);
+	for(int offset : offsets)
+	{
+		writer.WriteInt(offset);
+	}
+	for(auto& sysImport : mSysImports)
+	{
+		WriteName(writer, sysImport.name);
+		writer.WriteSByte(sysImport.returnType);
+		writer.WriteSByte(static_cast<int8_t>(sysImport.argumentTypes.size()));
+		for(char argumentType : sysImport.argumentTypes)
+		{
+			writer.WriteSByte(argumentType);
+		}
+	}
+}
+
+void SheepScript::WriteStringConstsSection(BinaryWriter& writer)
+{
+	// Bytecode refers to strings by offset, so each string must be written at the same offset it was read from.
+	std::vector<int> offsets;
+	int size = 0;
+	for(auto& entry : mStringConsts)
+	{
+		offsets.push_back(entry.first);
+		size = std::max(size, entry.first + static_cast<int>(entry.second.size()) + 1);
+	}
+	std::sort(offsets.begin(), offsets.end());
+	
+	int count = static_cast<int>(offsets.size());
+	int headerSize = 12 + 16 + 4 * count;
+	WriteSectionName(writer, "StringConsts");
+	writer.WriteInt(headerSize);
+	writer.WriteInt(headerSize);
+	writer.WriteInt(size);
+	writer.WriteInt(count);
+	for(int offset : offsets)
+	{
+		writer.WriteInt(offset);
+	}
+	
+	// Any gaps between strings are filled with nulls.
+	std::vector<char> data(size, '\0');
+	for(auto& entry : mStringConsts)
+	{
+		std::copy(entry.second.begin(), entry.second.end(), data.begin() + entry.first);
+	}
+	if(size > 0)
+	{
+		writer.Write(&data[0], size);
+	}
+}
+
+void SheepScript::WriteVariablesSection(BinaryWriter& writer)
+{
+	// Each variable is an empty name, a type, and a 4-byte default value.
+	int count = static_cast<int>(mVariables.size());
+	int headerSize = 12 + 16 + 4 * count;
+	int variableSize = 2 + 1 + 4 + 4;
+	
+	WriteSectionName(writer, "Variables");
+	writer.WriteInt(headerSize);
+	writer.WriteInt(headerSize);
+	writer.WriteInt(variableSize * count);
+	writer.WriteInt(count);
+	for(int i = 0; i < count; i++)
+	{
+		writer.WriteInt(variableSize * i);
+	}
+	for(auto& variable : mVariables)
+	{
+		WriteName(writer, "");
+		switch(variable.type)
+		{
+		default:
+		case SheepValueType::Int:
+			writer.WriteInt(1);
+			writer.WriteInt(variable.intValue);
+			break;
+		case SheepValueType::Float:
+			writer.WriteInt(2);
+			writer.WriteFloat(variable.floatValue);
+			break;
+		case SheepValueType::String:
+		{
+			// String variables point to a string const - find its offset.
+			int offset = -1;
+			for(auto& entry : mStringConsts)
+			{
+				if(entry.second.c_str() == variable.stringValue)
+				{
+					offset = entry.first;
+					break;
+				}
+			}
+			writer.WriteInt(3);
+			writer.WriteInt(offset);
+			break;
+		}
+		}
+	}
+}
+
+void SheepScript::WriteFunctionsSection(BinaryWriter& writer)
+{
+	// Each function is a name, 2 unknown bytes, and a code offset.
+	int count = static_cast<int>(mFunctions.size());
+	int headerSize = 12 + 16 + 4 * count;
+	std::vector<int> offsets;
+	int size = 0;
+	for(auto& entry : mFunctions)
+	{
+		offsets.push_back(size);
+		size += 2 + static_cast<int>(entry.first.size()) + 1 + 2 + 4;
+	}
+	
+	WriteSectionName(writer, "Functions");
+	writer.WriteInt(headerSize);
+	writer.WriteInt(headerSize);
+	writer.WriteInt(size);
+	writer.WriteInt(count);
+	for(int offset : offsets)
+	{
+		writer.WriteInt(offset);
+	}
+	for(auto& entry : mFunctions)
+	{
+		WriteName(writer, entry.first);
+		writer.WriteShort(0);
+		writer.WriteInt(entry.second);
+	}
+}
+
+void SheepScript::WriteCodeSection(BinaryWriter& writer)
+{
+	// Always one block of code, at offset zero.
+	int headerSize = 12 + 16 + 4;
+	WriteSectionName(writer, "Code");
+	writer.WriteInt(headerSize);
+	writer.WriteInt(headerSize);
+	writer.WriteInt(mBytecodeLength);
+	writer.WriteInt(1);
+	writer.WriteInt(0);
+	if(mBytecodeLength > 0)
+	{
+		writer.Write(mBytecode, mBytecodeLength);
+	}
+}
+
 void SheepScript::ParseFromData(char *data, int dataLength)
 {
     BinaryReader reader(data, dataLength);
@@ -234,8 +477,9 @@ void SheepScript::ParseVariablesSection(BinaryReader& reader)
         else if(type == 3)
         {
             value.type = SheepValueType::String;
-            reader.ReadInt();
-            value.stringValue = nullptr;
+            
+            // Default value is a string const offset. String consts may not be parsed yet, so this is resolved later.
+            value.intValue = reader.ReadInt();
         }
         else
         {
@@ -304,3 +548,126 @@ void SheepScript::ParseCodeSection(BinaryReader& reader)
     mBytecode = new char[mBytecodeLength];
     reader.Read(mBytecode, mBytecodeLength);
 }
+
+void SheepScript::ResolveStringVariables()
+{
+	// String variables hold a string const offset until now. Point them to the string const itself.
+	// String consts aren't modified after load, so these pointers stay valid for the life of the script.
+	for(auto& variable : mVariables)
+	{
+		if(variable.type != SheepValueType::String) { continue; }
+		std::string* str = GetStringConst(variable.intValue);
+		variable.stringValue = str != nullptr ? str->c_str() : "";
+	}
+}
+
+void SheepScript::BindSysImports()
+{
+	// Look up each import's system function once, so the VM can call it directly.
+	for(auto& sysImport : mSysImports)
+	{
+		SysFuncDecl* sysFunc = GetSysFuncDecl(&sysImport);
+		if(sysFunc != nullptr)
+		{
+			sysImport.call = sysFunc->call;
+		}
+		else
+		{
+			std::cout << "Sheep " << mName << " uses undeclared function " << sysImport.name << std::endl;
+		}
+	}
+}
+
+void SheepScript::DecodeBytecode()
+{
+	mInstructions.clear();
+	
+	// One extra entry, so the offset just past the end of the bytecode maps to the final ReturnV.
+	mInstructionIndexes.assign(mBytecodeLength + 1, -1);
+	
+	BinaryReader reader(mBytecode, mBytecodeLength);
+	while(reader.OK() && reader.GetPosition() < mBytecodeLength)
+	{
+		SheepDecodedInstruction decoded;
+		decoded.bytecodeOffset = reader.GetPosition();
+		unsigned char instruction = reader.ReadUByte();
+		decoded.instruction = (SheepInstruction)instruction;
+		
+		// Read operand, for instructions that have one.
+		switch(decoded.instruction)
+		{
+		case SheepInstruction::CallSysFunctionV:
+		case SheepInstruction::CallSysFunctionI:
+		case SheepInstruction::CallSysFunctionF:
+		case SheepInstruction::CallSysFunctionS:
+			// Null if the index is invalid - VM will report the error when the instruction executes.
+			decoded.sysImport = GetSysImport(reader.ReadInt());
+			break;
+		case SheepInstruction::PushF:
+			decoded.floatArg = reader.ReadFloat();
+			break;
+		case SheepInstruction::PushS:
+		{
+			// Look up the string const now, so the VM can push it directly.
+			int offset = reader.ReadInt();
+			std::string* str = GetStringConst(offset);
+			if(str == nullptr)
+			{
+				std::cout << "Sheep " << mName << " uses invalid string const offset " << offset << std::endl;
+			}
+			decoded.stringArg = str != nullptr ? str->c_str() : "";
+			break;
+		}
+		case SheepInstruction::Branch:
+		case SheepInstruction::BranchGoto:
+		case SheepInstruction::BranchIfZero:
+		case SheepInstruction::StoreI:
+		case SheepInstruction::StoreF:
+		case SheepInstruction::StoreS:
+		case SheepInstruction::LoadI:
+		case SheepInstruction::LoadF:
+		case SheepInstruction::LoadS:
+		case SheepInstruction::PushI:
+		case SheepInstruction::IToF:
+		case SheepInstruction::FToI:
+			decoded.intArg = reader.ReadInt();
+			break;
+		default:
+			// Unknown instructions are kept, so the VM can report them when executed.
+			// They all use the unused 0x0C value (so VM dispatch stays in range), with the original byte as the operand.
+			if(instruction == 0x0C || instruction > (unsigned char)SheepInstruction::DebugBreakpoint)
+			{
+				decoded.instruction = (SheepInstruction)0x0C;
+				decoded.intArg = instruction;
+			}
+			break;
+		}
+		
+		// Truncated instruction at the end of the bytecode - the VM would stop here anyway.
+		if(!reader.OK()) { break; }
+		
+		mInstructionIndexes[decoded.bytecodeOffset] = static_cast<int>(mInstructions.size());
+		mInstructions.push_back(decoded);
+	}
+	
+	// Running off the end of the bytecode ends the thread, same as a return.
+	SheepDecodedInstruction end;
+	end.instruction = SheepInstruction::ReturnV;
+	end.bytecodeOffset = mBytecodeLength;
+	mInstructionIndexes[mBytecodeLength] = static_cast<int>(mInstructions.size());
+	mInstructions.push_back(end);
+	
+	// Convert branch targets from bytecode offsets to instruction indexes.
+	// A branch to the middle of an instruction (or out of bounds) can't be decoded, so it ends the thread.
+	int endIndex = static_cast<int>(mInstructions.size()) - 1;
+	for(auto& decoded : mInstructions)
+	{
+		if(decoded.instruction == SheepInstruction::Branch ||
+		   decoded.instruction == SheepInstruction::BranchGoto ||
+		   decoded.instruction == SheepInstruction::BranchIfZero)
+		{
+			int index = GetInstructionIndex(decoded.intArg);
+			decoded.intArg = index >= 0 ? index : endIndex;
+		}
+	}
+}
@@ -14,8 +14,13 @@
 #include "SheepVM.h"
 
 class BinaryReader;
+class BinaryWriter;
 class SheepScriptBuilder;
 
+// Calls a system function with args taken straight from a sheep stack (args[0] is the first argument).
+// Each system function has one of these, generated by the RegFuncX macros.
+typedef void (*SysFuncCall)(SheepValue* args, SysFuncResult& result);
+
 struct SysImport
 {
 	// Name of the function.
@@ -34,6 +39,10 @@ struct SysImport
 	// If true, this function can only work in dev builds.
 	bool devOnly = false;
 	
+	// Function to call. For imports in a script, this is bound when the script loads.
+	// Null if no system function matches this import's signature.
+	SysFuncCall call = nullptr;
+	
 	//TODO: For in-game help output, we may need to store argument names AND description text.
 	// For example, HelpCommand("AddStreamContent") outputs this:
 	/*
@@ -43,6 +52,25 @@ struct SysImport
 	*/
 };
 
+// A single bytecode instruction, decoded ahead of time so the VM doesn't need to parse bytecode while executing.
+// Operands are resolved where possible (e.g. branch targets are instruction indexes, sysfunc indexes are pointers).
+struct SheepDecodedInstruction
+{
+	SheepInstruction instruction = SheepInstruction::SitnSpin;
+	
+	// Operand, if this instruction has one. Which one is valid depends on the instruction.
+	union
+	{
+		int intArg = 0;		// Push/Load/Store/IToF/FToI, or instruction index for branches
+		float floatArg;		// PushF
+		const char* stringArg; // PushS (points to string const)
+		SysImport* sysImport; // CallSysFunction*
+	};
+	
+	// Offset of this instruction in the original bytecode.
+	int bytecodeOffset = 0;
+};
+
 class SheepScript : public Asset
 {
 public:
@@ -50,17 +78,29 @@ public:
     SheepScript(const std::string& name, SheepScriptBuilder& builder);
     
     SysImport* GetSysImport(int index);
+    int GetSysImportCount() const { return static_cast<int>(mSysImports.size()); }
     
     std::string* GetStringConst(int offset);
     
-    std::vector<SheepValue> GetVariables() { return mVariables; }
+    // String variables point to string consts owned by this script.
+    const std::vector<SheepValue>& GetVariables() const { return mVariables; }
     
     int GetFunctionOffset(std::string functionName); 
     
     char* GetBytecode() { return mBytecode; }
     int GetBytecodeLength() { return mBytecodeLength; }
+	
+	// Bytecode decoded into instructions. There is always a final ReturnV, so execution never runs off the end.
+	const std::vector<SheepDecodedInstruction>& GetInstructions() const { return mInstructions; }
+	
+	// Converts a bytecode offset to an instruction index. Returns -1 if the offset isn't the start of an instruction.
+	int GetInstructionIndex(int bytecodeOffset) const;
     
     void Dump();
+	
+	// Writes the script in the binary "GK3Sheep" format, which can be loaded with the binary data constructor.
+	// Variable names aren't kept after loading, so variables are written without names.
+	bool WriteToFile(const std::string& filePath);
     
 private:
     std::vector<SysImport> mSysImports;
@@ -79,6 +119,10 @@ private:
     // Just pass this to the VM and aaaaawayyyyy we go!
     char* mBytecode = nullptr;
     int mBytecodeLength = 0;
+	
+	// Bytecode decoded into instructions, plus a mapping from each bytecode offset to its instruction index.
+	std::vector<SheepDecodedInstruction> mInstructions;
+	std::vector<int> mInstructionIndexes;
     
     void ParseFromData(char* data, int dataLength);
     void ParseSysImportsSection(BinaryReader& reader);
@@ -86,4 +130,14 @@ private:
     void ParseVariablesSection(BinaryReader& reader);
     void ParseFunctionsSection(BinaryReader& reader);
     void ParseCodeSection(BinaryReader& reader);
+	
+	void WriteSysImportsSection(BinaryWriter& writer);
+	void WriteStringConstsSection(BinaryWriter& writer);
+	void WriteVariablesSection(BinaryWriter& writer);
+	void WriteFunctionsSection(BinaryWriter& writer);
+	void WriteCodeSection(BinaryWriter& writer);
+	
+	void ResolveStringVariables();
+	void BindSysImports();
+	void DecodeBytecode();
 };
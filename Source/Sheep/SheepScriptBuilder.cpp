@@ -9,6 +9,7 @@
 
 #include "Services.h"
 #include "SheepAPI.h"
+#include "SheepOptimizer.h"
 #include "StringUtil.h"
 
 //#define DEBUG_BUILDER
@@ -78,11 +79,14 @@ void SheepScriptBuilder::AddFloatVariable(std::string name, float defaultValue)
 
 void SheepScriptBuilder::AddStringVariable(std::string name, std::string defaultValue)
 {
+    StringUtil::RemoveQuotes(defaultValue);
     AddStringConst(defaultValue);
     
+    // Like compiled sheep, default value is stored as a string const offset.
+    // The script resolves this to a pointer to its own copy of the string const.
     SheepValue sheepValue;
     sheepValue.type = SheepValueType::String;
-    sheepValue.stringValue = defaultValue.c_str();
+    sheepValue.intValue = GetStringConstOffset(defaultValue);
     
     mVariableIndexByName[name] = (int)mVariables.size();
     mVariables.push_back(sheepValue);
@@ -1170,6 +1174,28 @@ void SheepScriptBuilder::Breakpoint()
     AddInstruction(SheepInstruction::DebugBreakpoint);
 }
 
+void SheepScriptBuilder::Optimize()
+{
+	// Functions can be executed directly, so the optimizer must treat them as entry points.
+	SheepOptimizer optimizer(mBytecode);
+	for(auto& entry : mFunctions)
+	{
+		optimizer.AddEntryPoint(entry.second);
+	}
+	if(!optimizer.Optimize()) { return; }
+	
+	// Instructions moved around, so any offsets we're holding onto must be updated.
+	mBytecode = optimizer.GetBytecode();
+	for(auto& entry : mFunctions)
+	{
+		entry.second = optimizer.GetOptimizedOffset(entry.second);
+	}
+	for(auto& entry : mGotoLabelsToOffsets)
+	{
+		entry.second = optimizer.GetOptimizedOffset(entry.second);
+	}
+}
+
 void SheepScriptBuilder::AddInstruction(SheepInstruction instr)
 {
     mBytecode.push_back((char)instr);
@@ -91,6 +91,9 @@ public:
     
     void Breakpoint();
 	
+	// Optimizes bytecode for all functions. Should only be called after the last function is ended.
+	void Optimize();
+	
 	const std::string& GetName() const { return mScriptName; }
 	const std::string& GetSection() const { return mSection; }
 	
@@ -35,19 +35,6 @@ void SheepStack::PushFloat(float val)
 	#endif
 }
 
-void SheepStack::PushStringOffset(int val)
-{
-	mStackSize++;
-	assert(mStackSize < kMaxStackSize);
-	
-	mStack[mStackSize - 1].type = SheepValueType::String;
-	mStack[mStackSize - 1].intValue = val;
-	
-	#ifdef SHEEP_DEBUG
-	std::cout << "SHEEP STACK: Push 1 (Stack Size = " << mStackSize << ")" << std::endl;
-	#endif
-}
-
 void SheepStack::PushString(const char* str)
 {
 	mStackSize++;
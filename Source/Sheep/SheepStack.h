@@ -6,6 +6,7 @@
 // A stack of Sheep values.
 //
 #pragma once
+#include <cassert>
 
 #include "SheepValue.h"
 
@@ -14,7 +15,6 @@ struct SheepStack
 public:
 	void PushInt(int val);
 	void PushFloat(float val);
-	void PushStringOffset(int val);
 	void PushString(const char* str);
 	
 	SheepValue& Peek() { assert(mStackSize > 0); return mStack[mStackSize - 1]; }
@@ -0,0 +1,109 @@
+//
+// SheepStringArena.cpp
+//
+// Clark Kromenaker
+//
+#include "SheepStringArena.h"
+
+#include <cstring>
+
+SheepStringArena::~SheepStringArena()
+{
+	Clear();
+	for(auto& block : mBlocks)
+	{
+		delete[] block;
+	}
+}
+
+const char* SheepStringArena::Add(const char* str)
+{
+	if(str == nullptr) { str = ""; }
+	return Add(str, strlen(str));
+}
+
+const char* SheepStringArena::Add(const std::string& str)
+{
+	return Add(str.c_str(), str.size());
+}
+
+const char* SheepStringArena::Intern(const char* str)
+{
+	if(str == nullptr) { str = ""; }
+	
+	// Already have this string? Use it.
+	auto it = mInterned.find(str);
+	if(it != mInterned.end())
+	{
+		return *it;
+	}
+	
+	// Otherwise, add a copy and remember it.
+	const char* copy = Add(str, strlen(str));
+	mInterned.insert(copy);
+	return copy;
+}
+
+void SheepStringArena::Clear()
+{
+	// Blocks are kept for reuse, but large strings are freed.
+	mBlockIndex = 0;
+	mBlockOffset = 0;
+	for(auto& str : mLargeStrings)
+	{
+		delete[] str;
+	}
+	mLargeStrings.clear();
+	mInterned.clear();
+}
+
+const char* SheepStringArena::Add(const char* str, size_t length)
+{
+	size_t size = length + 1;
+	
+	// Too big to fit in a block? Give it its own allocation.
+	if(size > kBlockSize)
+	{
+		char* copy = new char[size];
+		memcpy(copy, str, size);
+		mLargeStrings.push_back(copy);
+		return copy;
+	}
+	
+	// Move to the next block if this one is full, creating a new block if needed.
+	if(mBlockIndex >= mBlocks.size() || mBlockOffset + size > kBlockSize)
+	{
+		if(mBlockIndex < mBlocks.size())
+		{
+			++mBlockIndex;
+		}
+		if(mBlockIndex >= mBlocks.size())
+		{
+			mBlocks.push_back(new char[kBlockSize]);
+		}
+		mBlockOffset = 0;
+	}
+	
+	// Copy string, including null terminator, into the block.
+	char* copy = mBlocks[mBlockIndex] + mBlockOffset;
+	memcpy(copy, str, length);
+	copy[length] = '\0';
+	mBlockOffset += size;
+	return copy;
+}
+
+size_t SheepStringArena::Hash::operator()(const char* str) const
+{
+	// FNV-1a hash.
+	size_t hash = 2166136261u;
+	for(; *str != '\0'; ++str)
+	{
+		hash = (hash ^ static_cast<unsigned char>(*str)) * 16777619u;
+	}
+	return hash;
+}
+
+bool SheepStringArena::Equal::operator()(const char* a, const char* b) const
+{
+	return strcmp(a, b) == 0;
+}
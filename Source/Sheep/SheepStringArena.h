@@ -0,0 +1,66 @@
+//
+// SheepStringArena.h
+//
+// Clark Kromenaker
+//
+// Storage for strings used during sheep execution.
+//
+// Sheep values only hold a "const char*" for strings, so whatever that points to
+// must stay valid for as long as the value is in use. Strings copied into an arena
+// stay valid until the arena is cleared.
+//
+// Strings are copied into large blocks of memory, so adding a string usually
+// doesn't require an allocation. Clearing keeps the blocks around for reuse.
+//
+#pragma once
+#include <cstddef>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+class SheepStringArena
+{
+public:
+	SheepStringArena() = default;
+	SheepStringArena(const SheepStringArena& other) = delete;
+	SheepStringArena& operator=(const SheepStringArena& other) = delete;
+	~SheepStringArena();
+	
+	// Copies a string into the arena.
+	const char* Add(const char* str);
+	const char* Add(const std::string& str);
+	
+	// Like Add, but if an equal string was already interned, returns that one instead of making another copy.
+	const char* Intern(const char* str);
+	
+	// Frees all strings in the arena. Any pointers previously returned are no longer valid!
+	void Clear();
+	
+	// Number of strings interned since the arena was last cleared.
+	size_t GetInternedCount() const { return mInterned.size(); }
+	
+private:
+	// Size of each block of memory that strings are copied into.
+	static const size_t kBlockSize = 4096;
+	
+	// Blocks of memory, and where the next string goes.
+	std::vector<char*> mBlocks;
+	size_t mBlockIndex = 0;
+	size_t mBlockOffset = 0;
+	
+	// Strings too big for a block get their own allocation.
+	std::vector<char*> mLargeStrings;
+	
+	// Interned strings, for finding an existing copy of a string.
+	struct Hash
+	{
+		size_t operator()(const char* str) const;
+	};
+	struct Equal
+	{
+		bool operator()(const char* a, const char* b) const;
+	};
+	std::unordered_set<const char*, Hash, Equal> mInterned;
+	
+	const char* Add(const char* str, size_t length);
+};
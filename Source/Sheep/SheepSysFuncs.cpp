@@ -0,0 +1,134 @@
+//
+// SheepSysFuncs.cpp
+//
+// Clark Kromenaker
+//
+#include "SheepSysFuncs.h"
+
+#include <functional> // for std::hash
+#include <map>
+#include <unordered_map>
+#include <vector>
+
+#include "StringUtil.h"
+
+// Functions are declared by static initializers in other files, which may run before this file's globals are constructed.
+// Wrapping the lists in functions makes sure they exist on first use.
+
+// A big array of all our defined system functions.
+// This is populated at program start and then never changed.
+static std::vector<SysFuncDecl>& GetSysFuncs()
+{
+	static std::vector<SysFuncDecl> sysFuncs;
+	return sysFuncs;
+}
+
+// Maps from system function name (or hash) to index in the sysFuncs vector.
+// We can't map to SysFuncDecl& because vector might move memory around when populating the list.
+// It IS OK to get references after initial population, since the vector never changes!
+static std::map<std::string, int>& GetNameToSysFunc()
+{
+	static std::map<std::string, int> nameToSysFunc;
+	return nameToSysFunc;
+}
+
+static std::unordered_map<size_t, int>& GetHashToSysFunc()
+{
+	static std::unordered_map<size_t, int> hashToSysFunc;
+	return hashToSysFunc;
+}
+
+// Kept up to date as functions are declared, so it can be read from any thread without recalculating.
+static uint64_t& GetDeclsHash()
+{
+	// FNV-1a offset basis.
+	static uint64_t declsHash = 14695981039346656037ull;
+	return declsHash;
+}
+
+static void HashDeclBytes(const void* bytes, size_t count)
+{
+	uint64_t& hash = GetDeclsHash();
+	const unsigned char* data = static_cast<const unsigned char*>(bytes);
+	for(size_t i = 0; i < count; ++i)
+	{
+		hash = (hash ^ data[i]) * 1099511628211ull;
+	}
+}
+
+static size_t CalcHashForSysFunc(const SysImport& sysImport)
+{
+	// This is a variation of Bernstein hash, also called djb2.
+	// Original uses values 5381/33 instead of 17/31.
+	// It's actually unknown why these values result in a good hash...hope it works out!
+	size_t res = 17;
+	std::string lowerName = StringUtil::ToLowerCopy(sysImport.name);
+	res = res * 31 + std::hash<std::string>()(lowerName);
+	res = res * 31 + std::hash<int>()((int)sysImport.argumentTypes.size());
+	for(auto& argType : sysImport.argumentTypes)
+	{
+		res = res * 31 + std::hash<char>()(argType);
+	}
+	return res;
+}
+
+// A list of every defined system function. Add to this by calling AddSysFuncDecl.
+// Functions are added by using RegFuncX macros, which in turn call AddSysFuncDecl with a pointer to the function's call function.
+void AddSysFuncDecl(const std::string& name, char retType, std::initializer_list<char> argTypes, bool waitable, bool dev, SysFuncCall call)
+{
+	SysFuncDecl sysFunc;
+	sysFunc.name = name;
+	sysFunc.returnType = retType;
+	for(auto argType : argTypes)
+	{
+		sysFunc.argumentTypes.push_back(argType);
+	}
+	sysFunc.waitable = waitable;
+	sysFunc.devOnly = dev;
+	sysFunc.call = call;
+
+	std::vector<SysFuncDecl>& sysFuncs = GetSysFuncs();
+	sysFuncs.push_back(sysFunc);
+
+	// Store a mapping from name and hash to index in the vector of system functions.
+	// We can't store references because std::vector can move items around on us during population of the vector.
+	GetNameToSysFunc()[StringUtil::ToLowerCopy(name)] = (int)sysFuncs.size() - 1;
+	GetHashToSysFunc()[CalcHashForSysFunc(sysFunc)] = (int)sysFuncs.size() - 1;
+	
+	// Include everything that affects how calls to this function compile. Name includes its null terminator, so names don't run together.
+	HashDeclBytes(name.c_str(), name.size() + 1);
+	HashDeclBytes(&retType, 1);
+	char argCount = static_cast<char>(sysFunc.argumentTypes.size());
+	HashDeclBytes(&argCount, 1);
+	HashDeclBytes(sysFunc.argumentTypes.data(), sysFunc.argumentTypes.size());
+	char flags = (waitable ? 1 : 0) | (dev ? 2 : 0);
+	HashDeclBytes(&flags, 1);
+}
+
+SysFuncDecl* GetSysFuncDecl(const std::string& name)
+{
+	std::map<std::string, int>& nameToSysFunc = GetNameToSysFunc();
+	auto it = nameToSysFunc.find(name);
+	if(it != nameToSysFunc.end())
+	{
+		return &GetSysFuncs()[it->second];
+	}
+	return nullptr;
+}
+
+SysFuncDecl* GetSysFuncDecl(const SysImport* sysImport)
+{
+	size_t hash = CalcHashForSysFunc(*sysImport);
+	std::unordered_map<size_t, int>& hashToSysFunc = GetHashToSysFunc();
+	auto it = hashToSysFunc.find(hash);
+	if(it != hashToSysFunc.end())
+	{
+		return &GetSysFuncs()[it->second];
+	}
+	return nullptr;
+}
+
+uint64_t GetSysFuncDeclsHash()
+{
+	return GetDeclsHash();
+}
@@ -0,0 +1,48 @@
+//
+// SheepSysFuncs.h
+//
+// Clark Kromenaker
+//
+// The list of system functions that sheep can call.
+//
+// The functions themselves are in SheepAPI, which registers each one with AddSysFuncDecl at program start.
+// This is kept separate so the sheep compiler and VM can be used without the rest of the engine.
+//
+#pragma once
+#include <cstdint>
+#include <initializer_list>
+#include <string>
+
+#include "SheepScript.h"
+
+// A "full" system function declaration.
+// Contains extra data about a function that is helpful, but doesn't uniquely identify the function signature.
+// Inherits from SysImport because that DOES uniquely identify the signature!
+struct SysFuncDecl : public SysImport
+{
+	// If true, this function can be "waited" upon.
+	// If false, it executes and returns immediately.
+	bool waitable = false;
+	
+	// If true, this function can only work in dev builds.
+	bool devOnly = false;
+	
+	//TODO: For in-game help output, we may need to store argument names AND description text.
+	// For example, HelpCommand("AddStreamContent") outputs this:
+	/*
+	 ----- 'Dump' * 03/16/2019 * 11:39:21 -----
+	 ** [DEBUG] AddStreamContent(string streamName, string content) **
+	 Adds an additional content type to the stream. Possible values for the 'content' parameter are: 'begin' (report headers), 'content' (report content), 'end' (report footers), 'category' (the category of the report), 'date' (the date the report was made), 'time' (the time the report was made), 'debug' (file/line debug info), 'timeblock' (the current timeblock if there is one), and 'location' (the current game scene location if there is one).
+	*/
+};
+
+void AddSysFuncDecl(const std::string& name, char retType, std::initializer_list<char> argTypes, bool waitable, bool dev, SysFuncCall call);
+
+// System functions are all declared at program start, and never change after that.
+// So, it's safe to look them up from any thread (e.g. when compiling sheep on worker threads).
+SysFuncDecl* GetSysFuncDecl(const std::string& name);
+SysFuncDecl* GetSysFuncDecl(const SysImport* sysImport);
+
+// A hash of every declaration (name, return/argument types, waitable, dev only), in the order they were added.
+// The same declarations always give the same hash, even across runs, so it can be saved to disk.
+uint64_t GetSysFuncDeclsHash();
@@ -12,6 +12,7 @@
 #include <string>
 
 #include "SheepStack.h"
+#include "SheepStringArena.h"
 
 class SheepVM;
 class SheepInstance;
@@ -27,6 +28,10 @@ struct SheepThread
 	// Each thread has its own stack.
 	SheepStack mStack;
 	
+	// Strings created while this thread executes (e.g. sys func results).
+	// Freed when the thread is reused, so they're valid until the thread (and any evaluation result) is done.
+	SheepStringArena mStrings;
+	
 	// Current code offset for attached sheep (aka the instruction pointer).
 	int mCodeOffset = 0;
 	
@@ -7,7 +7,6 @@
 
 #include <iostream>
 
-#include "BinaryReader.h"
 #include "GMath.h"
 #include "SheepAPI.h"
 #include "SheepScript.h"
@@ -16,6 +15,12 @@
 
 //#define SHEEP_DEBUG
 
+// GCC and Clang support "computed goto" (jumping to a label address stored in a table).
+// This lets the VM jump directly from one instruction's handler to the next, rather than going back through a switch.
+#if defined(__GNUC__) || defined(__clang__)
+#define SHEEP_COMPUTED_GOTO
+#endif
+
 std::string SheepInstance::GetName()
 {
 	if(mSheepScript != nullptr)
@@ -79,8 +84,30 @@ void SheepVM::Execute(SheepScript* script, int bytecodeOffset, std::function<voi
 
 bool SheepVM::Evaluate(SheepScript* script, int n, int v)
 {
-	// Get an execution context.
-	SheepInstance* instance = GetInstance(script);
+	if(script == nullptr) { return false; }
+	
+	// Get an execution context and thread.
+	// Usually, the dedicated evaluation thread is used. But if it's busy (e.g. a sys func evaluated another case mid-evaluation), use the pools.
+	SheepInstance* instance = nullptr;
+	SheepThread* thread = nullptr;
+	if(!mEvalThread.mRunning)
+	{
+		instance = &mEvalInstance;
+		instance->mSheepScript = script;
+		
+		// Assign reuses the vector's memory.
+		const std::vector<SheepValue>& variables = script->GetVariables();
+		instance->mVariables.assign(variables.begin(), variables.end());
+		
+		thread = &mEvalThread;
+		thread->mVirtualMachine = this;
+		thread->mStack.Clear();
+	}
+	else
+	{
+		instance = GetInstance(script);
+		thread = GetThread();
+	}
 	
 	// For NVC evaluation logic, scripts can use built-in variables $n and $v.
 	// These variables refer to whatever the current noun and current verb are, using an int identifier.
@@ -94,9 +121,8 @@ bool SheepVM::Evaluate(SheepScript* script, int n, int v)
 		instance->mVariables[1].intValue = v;
 	}
 	
-	//std::cout << "SHEEP EVALUATE START - Stack size is " << mStackSize << std::endl;
     // Execute the script, per usual.
-    SheepThread* thread = ExecuteInternal(instance, 0, "X$", nullptr);
+    ExecuteInternal(thread, instance, 0, "X$", nullptr);
     
     // If stack is empty, return false.
 	if(thread->mStack.Size() == 0) { return false; }
@@ -113,8 +139,7 @@ bool SheepVM::Evaluate(SheepScript* script, int n, int v)
     }
     else if(result.type == SheepValueType::String)
     {
-        std::string str(result.stringValue);
-        return !str.empty();
+        return result.stringValue[0] != '\0';
     }
 
     // Default to false.
@@ -123,11 +148,7 @@ bool SheepVM::Evaluate(SheepScript* script, int n, int v)
 
 bool SheepVM::IsAnyRunning() const
 {
-	for(auto& thread : mSheepThreads)
-	{
-		if(thread->mRunning) { return true; }
-	}
-	return false;
+	return mRunningThreadCount > 0;
 }
 
 SheepInstance* SheepVM::GetInstance(SheepScript* script)
@@ -138,23 +159,22 @@ SheepInstance* SheepVM::GetInstance(SheepScript* script)
 	// If an instance already exists for this sheep, just reuse that one.
 	// This *might* be important b/c we want variables in the same script to be shared.
 	// Ex: call IncCounter$ in same sheep, the counter variable should still be incremented after returning.
-	for(auto& instance : mSheepInstances)
+	auto it = mInstancesByScript.find(script);
+	if(it != mInstancesByScript.end())
 	{
-		if(instance->mSheepScript == script)
-		{
-			return instance;
-		}
+		return it->second;
 	}
 	
 	// Try to reuse an execution context that is no longer being used.
 	SheepInstance* context = nullptr;
-	for(auto& instance : mSheepInstances)
+	if(!mFreeInstances.empty())
 	{
-		if(instance->mReferenceCount == 0)
-		{
-			context = instance;
-			break;
-		}
+		context = mFreeInstances.back();
+		mFreeInstances.pop_back();
+		context->mFreeIndex = -1;
+		
+		// The instance's previous script no longer has an instance.
+		mInstancesByScript.erase(context->mSheepScript);
 	}
 	
 	// Create a new instance if we have to.
@@ -164,133 +184,64 @@ SheepInstance* SheepVM::GetInstance(SheepScript* script)
 		mSheepInstances.push_back(context);
 	}
 	context->mSheepScript = script;
+	mInstancesByScript[script] = context;
 	
 	// Create copy of variables for assignment during execution.
-	context->mVariables = script->GetVariables();
+	// Assign reuses the vector's memory, if a previous script used this instance.
+	const std::vector<SheepValue>& variables = script->GetVariables();
+	context->mVariables.assign(variables.begin(), variables.end());
 	return context;
 }
 
 SheepThread* SheepVM::GetThread()
 {
 	// Recycle a previously used thread, if possible.
-	SheepThread* useThread = nullptr;
-	for(auto& thread : mSheepThreads)
+	if(!mFreeThreads.empty())
 	{
-		if(!thread->mRunning)
-		{
-			useThread = thread;
-			break;
-		}
+		SheepThread* thread = mFreeThreads.back();
+		mFreeThreads.pop_back();
+		return thread;
 	}
 	
 	// If needed, create a new thread instead.
-	if(useThread == nullptr)
-	{
-		useThread = new SheepThread();
-		useThread->mVirtualMachine = this;
-		mSheepThreads.push_back(useThread);
-	}
-	return useThread;
+	SheepThread* thread = new SheepThread();
+	thread->mVirtualMachine = this;
+	mSheepThreads.push_back(thread);
+	return thread;
 }
 
-Value SheepVM::CallSysFunc(SheepThread* thread, SysImport* sysImport)
+void SheepVM::CallSysFunc(SheepThread* thread, SysImport* sysImport)
 {
-	// Retrieve system function declaration for the system function import.
-	// We need the full declaration to know whether this is a waitable function!
-	SysFuncDecl* sysFunc = GetSysFuncDecl(sysImport);
-	if(sysFunc == nullptr)
-	{
-		std::cout << "Sheep uses undeclared function " << sysImport->name << std::endl;
-		return Value(0);
-	}
+	// Default result, in case the call fails.
+	mSysFuncResult.value = SheepValue(0);
+	mSysFuncResult.stringValue.clear();
 	
 	// Number on top of stack is argument count.
-	// Make sure it matches the argument count from the system function declaration.
+	// Make sure it matches the argument count from the system function import.
 	int argCount = thread->mStack.Pop().intValue;
-	assert(argCount == sysFunc->argumentTypes.size());
+	assert(argCount == sysImport->argumentTypes.size());
 	
-	// Retrieve the arguments, of the expected types, from the stack.
-	std::vector<Value> args;
-	for(int i = 0; i < argCount; i++)
+	// The import was bound to a system function when the script loaded.
+	if(sysImport->call == nullptr)
 	{
-		SheepValue& sheepValue = thread->mStack.Peek(argCount - 1 - i);
-		//SheepValue sheepValue = mStack[mStackSize - (argCount - i)];
-		int argType = sysFunc->argumentTypes[i];
-		switch(argType)
-		{
-		case 1:
-			args.push_back(sheepValue.GetInt());
-			break;
-		case 2:
-			args.push_back(sheepValue.GetFloat());
-			break;
-		case 3:
-			args.push_back(sheepValue.GetString());
-			break;
-		default:
-			std::cout << "Invalid arg type: " << argType << std::endl;
-			break;
-		}
+		std::cout << "Sheep uses undeclared function " << sysImport->name << std::endl;
+		thread->mStack.Pop(argCount);
+		return;
 	}
-	thread->mStack.Pop(argCount);
 	
-	/*
+	// Arguments are contiguous on the stack, first argument deepest. Pass them directly to the call function.
+	SheepValue* args = argCount > 0 ? &thread->mStack.Peek(argCount - 1) : nullptr;
+	if(mProfiler.IsEnabled())
 	{
-		// Pretty useful for seeing the function that was called output to the console.
-		std::cout << "SysFunc " << sysFunc->name << "(";
-		for(int i = 0; i < argCount; i++)
-		{
-			switch(sysFunc->argumentTypes[i])
-			{
-			case 1:
-				std::cout << args[i].to<int>();
-				break;
-			case 2:
-				std::cout << args[i].to<float>();
-				break;
-			case 3:
-				std::cout << args[i].to<std::string>();
-				break;
-			}
-
-			if(i < argCount - 1)
-			{
-				std::cout << ", ";
-			}
-		}
-		std::cout << ")" << std::endl;
+		SheepProfiler::Clock::time_point startTime = SheepProfiler::Clock::now();
+		sysImport->call(args, mSysFuncResult);
+		mProfiler.AddSysFuncSample(sysImport->name, startTime, SheepProfiler::Clock::now());
 	}
-	*/
-	
-	// Based on argument count, call the appropriate function variant.
-	Value v = Value(0);
-	switch(argCount)
+	else
 	{
-	case 0:
-		v = ::CallSysFunc(sysFunc->name);
-		break;
-	case 1:
-		v = ::CallSysFunc(sysFunc->name, args[0]);
-		break;
-	case 2:
-		v = ::CallSysFunc(sysFunc->name, args[0], args[1]);
-		break;
-	case 3:
-		v = ::CallSysFunc(sysFunc->name, args[0], args[1], args[2]);
-		break;
-	case 4:
-		v = ::CallSysFunc(sysFunc->name, args[0], args[1], args[2], args[3]);
-		break;
-	case 5:
-		v = ::CallSysFunc(sysFunc->name, args[0], args[1], args[2], args[3], args[4]);
-		break;
-	case 6:
-		v = ::CallSysFunc(sysFunc->name, args[0], args[1], args[2], args[3], args[4], args[5]);
-		break;
-	default:
-		std::cout << "SheepVM: Unimplemented arg count: " << argCount << std::endl;
-		break;
+		sysImport->call(args, mSysFuncResult);
 	}
+	thread->mStack.Pop(argCount);
 	
 	// Output a general execution exception if we encountered a problem in the sys func call.
 	if(mExecutionError)
@@ -298,9 +249,6 @@ Value SheepVM::CallSysFunc(SheepThread* thread, SysImport* sysImport)
 		Services::GetReports()->Log("Error", StringUtil::Format("An error occurred while executing %s", thread->GetName().c_str()));
 		mExecutionError = false;
 	}
-	
-	// Return result of sys func call.
-	return v;
 }
 
 SheepThread* SheepVM::ExecuteInternal(SheepScript *script, int bytecodeOffset,
@@ -324,6 +272,13 @@ SheepThread* SheepVM::ExecuteInternal(SheepInstance* instance, int bytecodeOffse
 	
 	// Create a sheep thread to perform the execution.
 	SheepThread* thread = GetThread();
+	ExecuteInternal(thread, instance, bytecodeOffset, functionName, finishCallback);
+	return thread;
+}
+
+void SheepVM::ExecuteInternal(SheepThread* thread, SheepInstance* instance, int bytecodeOffset,
+							  const std::string& functionName, std::function<void()> finishCallback)
+{
 	thread->mContext = instance;
 	thread->mWaitCallback = finishCallback;
 	thread->mCodeOffset = bytecodeOffset;
@@ -332,12 +287,63 @@ SheepThread* SheepVM::ExecuteInternal(SheepInstance* instance, int bytecodeOffse
 	thread->mFunctionName = functionName;
 	thread->mFunctionStartOffset = bytecodeOffset;
 	
+	// Strings from this thread's previous use are no longer needed.
+	thread->mStrings.Clear();
+	
+	// If no other sheep is running, no thread's stack can point to an interned string, so unused ones can be freed.
+	if(mRunningThreadCount == 0 && mCurrentThread == nullptr && mInternedStrings.GetInternedCount() >= mInternedStringCompactCount)
+	{
+		CompactInternedStrings();
+	}
+	
 	// The thread is using this execution context.
+	// If the instance was unused, it can't be recycled anymore.
 	instance->mReferenceCount++;
+	if(instance->mFreeIndex >= 0)
+	{
+		SheepInstance* last = mFreeInstances.back();
+		mFreeInstances[instance->mFreeIndex] = last;
+		last->mFreeIndex = instance->mFreeIndex;
+		mFreeInstances.pop_back();
+		instance->mFreeIndex = -1;
+	}
 	
 	// Start the thread of execution.
 	ExecuteInternal(thread);
-	return thread;
+}
+
+void SheepVM::CompactInternedStrings()
+{
+	// Copy out strings that are still stored in variables.
+	// Some may point to script data rather than the arena, but it doesn't hurt to intern those too.
+	std::vector<SheepValue*> stringVariables;
+	std::vector<std::string> strings;
+	auto addVariables = [&stringVariables, &strings](SheepInstance* instance) {
+		for(auto& variable : instance->mVariables)
+		{
+			if(variable.type == SheepValueType::String)
+			{
+				stringVariables.push_back(&variable);
+				strings.push_back(variable.stringValue != nullptr ? variable.stringValue : "");
+			}
+		}
+	};
+	for(auto& instance : mSheepInstances)
+	{
+		addVariables(instance);
+	}
+	addVariables(&mEvalInstance);
+	
+	// Start over with only those strings.
+	mInternedStrings.Clear();
+	for(size_t i = 0; i < stringVariables.size(); ++i)
+	{
+		stringVariables[i]->stringValue = mInternedStrings.Intern(strings[i].c_str());
+	}
+	
+	// Don't compact again until the number of strings has grown a good amount, or this would happen on every execution.
+	size_t compactCount = mInternedStrings.GetInternedCount() * 2;
+	mInternedStringCompactCount = compactCount > kMinInternedStringCompactCount ? compactCount : kMinInternedStringCompactCount;
 }
 
 void SheepVM::ExecuteInternal(SheepThread* thread)
@@ -346,10 +352,20 @@ void SheepVM::ExecuteInternal(SheepThread* thread)
 	SheepThread* prevThread = mCurrentThread;
 	mCurrentThread = thread;
 	
+	// If profiling, record when execution started.
+	bool profiling = mProfiler.IsEnabled();
+	bool starting = !thread->mRunning;
+	SheepProfiler::Clock::time_point startTime;
+	if(profiling)
+	{
+		startTime = SheepProfiler::Clock::now();
+	}
+	
 	// Sheep is either being created/started, or was released from a wait block.
 	if(!thread->mRunning)
 	{
 		thread->mRunning = true;
+		++mRunningThreadCount;
 		Services::GetReports()->Log("SheepMachine", "Sheep " + thread->GetName() + " created and starting");
 	}
 	else if(thread->mInWaitBlock)
@@ -363,56 +379,80 @@ void SheepVM::ExecuteInternal(SheepThread* thread)
 	SheepInstance* instance = thread->mContext;
 	SheepScript* script = instance->mSheepScript;
 	
-    // Get bytecode and generate a binary reader for easier parsing.
-    char* bytecode = script->GetBytecode();
-    int bytecodeLength = script->GetBytecodeLength();
-    
-    // Create reader for the bytecode.
-    BinaryReader reader(bytecode, bytecodeLength);
-    if(!reader.OK()) { return; }
-    
-    // Skip ahead to desired offset.
-    reader.Skip(thread->mCodeOffset);
-    
-    // Read each byte in turn, interpret and execute the instruction.
-	bool stopReading = false;
-	while(!stopReading)
-    {
-		// Read instruction.
-        char instruction = reader.ReadUByte();
-		
-		// Break when read instruction fails (perhaps due to reading past end of file/mem stream).
-		if(!reader.OK()) { break; }
-		
-		// Perform the action associated with each instruction.
-        switch((SheepInstruction)instruction)
-        {
-            case SheepInstruction::SitnSpin:
+	// Bytecode was decoded into instructions when the script loaded. Find the instruction to start at.
+	const std::vector<SheepDecodedInstruction>& scriptInstructions = script->GetInstructions();
+	const SheepDecodedInstruction* instructions = &scriptInstructions[0];
+	int instructionCount = static_cast<int>(scriptInstructions.size());
+	int startIndex = script->GetInstructionIndex(thread->mCodeOffset);
+	if(startIndex < 0)
+	{
+		// Offset isn't the start of an instruction. Start at the final ReturnV, so the thread just ends.
+		std::cout << "Sheep " << thread->GetName() << " can't execute from invalid offset " << thread->mCodeOffset << std::endl;
+		startIndex = instructionCount - 1;
+	}
+	
+	// Instruction pointer (next instruction to execute) and instruction currently executing.
+	const SheepDecodedInstruction* ip = instructions + startIndex;
+	const SheepDecodedInstruction* op = nullptr;
+	
+	// Number of instructions executed (for profiling).
+	int executedCount = 0;
+	
+	// Execute each instruction in turn, until the thread finishes or must stop and wait.
+	// With computed goto, each instruction's handler jumps straight to the next instruction's handler.
+	// Otherwise, a loop and a switch is used.
+	#ifdef SHEEP_COMPUTED_GOTO
+	static void* dispatchTable[] = {
+		&&Op_SitnSpin, &&Op_Yield, &&Op_CallSysFunctionV, &&Op_CallSysFunctionI, &&Op_CallSysFunctionF, &&Op_CallSysFunctionS,
+		&&Op_Branch, &&Op_BranchGoto, &&Op_BranchIfZero, &&Op_BeginWait, &&Op_EndWait, &&Op_ReturnV, &&Op_Unknown,
+		&&Op_StoreI, &&Op_StoreF, &&Op_StoreS, &&Op_LoadI, &&Op_LoadF, &&Op_LoadS, &&Op_PushI, &&Op_PushF, &&Op_PushS, &&Op_Pop,
+		&&Op_AddI, &&Op_AddF, &&Op_SubtractI, &&Op_SubtractF, &&Op_MultiplyI, &&Op_MultiplyF, &&Op_DivideI, &&Op_DivideF,
+		&&Op_NegateI, &&Op_NegateF, &&Op_IsEqualI, &&Op_IsEqualF, &&Op_IsNotEqualI, &&Op_IsNotEqualF,
+		&&Op_IsGreaterI, &&Op_IsGreaterF, &&Op_IsLessI, &&Op_IsLessF, &&Op_IsGreaterEqualI, &&Op_IsGreaterEqualF,
+		&&Op_IsLessEqualI, &&Op_IsLessEqualF, &&Op_IToF, &&Op_FToI, &&Op_Modulo, &&Op_And, &&Op_Or, &&Op_Not,
+		&&Op_GetString, &&Op_DebugBreakpoint
+	};
+	#define SHEEP_OP(name) Op_##name:
+	#define SHEEP_OP_UNKNOWN() Op_Unknown:
+	#define SHEEP_NEXT() op = ip++; ++executedCount; goto *dispatchTable[static_cast<int>(op->instruction)]
+	#define SHEEP_STOP() goto stop
+	SHEEP_NEXT();
+	#else
+	#define SHEEP_OP(name) case SheepInstruction::name:
+	#define SHEEP_OP_UNKNOWN() default:
+	#define SHEEP_NEXT() continue
+	#define SHEEP_STOP() goto stop
+	while(true)
+	{
+		op = ip++;
+		++executedCount;
+		switch(op->instruction)
+		{
+	#endif
+            SHEEP_OP(SitnSpin)
             {
                 // No-op; do nothing.
 				#ifdef SHEEP_DEBUG
 				std::cout << "SitnSpin" << std::endl;
 				#endif
-                break;
+                SHEEP_NEXT();
             }
-            case SheepInstruction::Yield:
+            SHEEP_OP(Yield)
             {
                 // Not totally sure what this instruction does.
 				// Maybe it yields sheep execution until next frame?
 				#ifdef SHEEP_DEBUG
 				std::cout << "Yield" << std::endl;
 				#endif
-				stopReading = true;
-                break;
+				SHEEP_STOP();
             }
-            case SheepInstruction::CallSysFunctionV:
+            SHEEP_OP(CallSysFunctionV)
             {
-                int functionIndex = reader.ReadInt();
-                SysImport* sysFunc = script->GetSysImport(functionIndex);
+                SysImport* sysFunc = op->sysImport;
 				if(sysFunc == nullptr)
 				{
-					std::cout << "Invalid function index " << functionIndex << std::endl;
-					break;
+					std::cout << "Invalid function index at offset " << op->bytecodeOffset << std::endl;
+					SHEEP_NEXT();
 				}
 				
 				#ifdef SHEEP_DEBUG
@@ -420,22 +460,21 @@ void SheepVM::ExecuteInternal(SheepThread* thread)
 				#endif
 				
 				// Execute the system function.
-                Value value = CallSysFunc(thread, sysFunc);
+                CallSysFunc(thread, sysFunc);
 				
 				// Though this is void return, we still push type of "shpvoid" onto stack.
 				// The compiler generates an extra "Pop" instruction after a CallSysFunctionV.
 				// This matches how the original game's compiler generated instructions!
-				thread->mStack.PushInt(value.to<shpvoid>());
-                break;
+				thread->mStack.PushInt(mSysFuncResult.value.intValue);
+                SHEEP_NEXT();
             }
-            case SheepInstruction::CallSysFunctionI:
+            SHEEP_OP(CallSysFunctionI)
             {
-                int functionIndex = reader.ReadInt();
-                SysImport* sysFunc = script->GetSysImport(functionIndex);
+                SysImport* sysFunc = op->sysImport;
 				if(sysFunc == nullptr)
 				{
-					std::cout << "Invalid function index " << functionIndex << std::endl;
-					break;
+					std::cout << "Invalid function index at offset " << op->bytecodeOffset << std::endl;
+					SHEEP_NEXT();
 				}
 				
 				#ifdef SHEEP_DEBUG
@@ -443,20 +482,19 @@ void SheepVM::ExecuteInternal(SheepThread* thread)
 				#endif
 				
 				// Execute the system function.
-                Value value = CallSysFunc(thread, sysFunc);
+                CallSysFunc(thread, sysFunc);
 				
 				// Push the int result onto the stack.
-				thread->mStack.PushInt(value.to<int>());
-                break;
+				thread->mStack.PushInt(mSysFuncResult.value.intValue);
+                SHEEP_NEXT();
             }
-            case SheepInstruction::CallSysFunctionF:
+            SHEEP_OP(CallSysFunctionF)
             {
-                int functionIndex = reader.ReadInt();
-                SysImport* sysFunc = script->GetSysImport(functionIndex);
+                SysImport* sysFunc = op->sysImport;
 				if(sysFunc == nullptr)
 				{
-					std::cout << "Invalid function index " << functionIndex << std::endl;
-					break;
+					std::cout << "Invalid function index at offset " << op->bytecodeOffset << std::endl;
+					SHEEP_NEXT();
 				}
 				
 				#ifdef SHEEP_DEBUG
@@ -464,20 +502,19 @@ void SheepVM::ExecuteInternal(SheepThread* thread)
 				#endif
 				
 				// Execute the system function.
-                Value value = CallSysFunc(thread, sysFunc);
+                CallSysFunc(thread, sysFunc);
 				
 				// Push the float result onto the stack.
-				thread->mStack.PushFloat(value.to<float>());
-                break;
+				thread->mStack.PushFloat(mSysFuncResult.value.floatValue);
+                SHEEP_NEXT();
             }
-            case SheepInstruction::CallSysFunctionS:
+            SHEEP_OP(CallSysFunctionS)
             {
-                int functionIndex = reader.ReadInt();
-                SysImport* sysFunc = script->GetSysImport(functionIndex);
+                SysImport* sysFunc = op->sysImport;
 				if(sysFunc == nullptr)
 				{
-					std::cout << "Invalid function index " << functionIndex << std::endl;
-					break;
+					std::cout << "Invalid function index at offset " << op->bytecodeOffset << std::endl;
+					SHEEP_NEXT();
 				}
 				
 				#ifdef SHEEP_DEBUG
@@ -485,35 +522,34 @@ void SheepVM::ExecuteInternal(SheepThread* thread)
 				#endif
 				
 				// Execute the system function.
-                Value value = CallSysFunc(thread, sysFunc);
+                CallSysFunc(thread, sysFunc);
 				
 				// Push the string result onto the stack.
-				thread->mStack.PushString(value.to<std::string>().c_str()); //TODO: Seems like this could cause problems? Where is value's string coming from? What if it is deallocated???
-                break;
+				// The result is overwritten by the next sys func call, so the thread keeps its own copy.
+				thread->mStack.PushString(thread->mStrings.Add(mSysFuncResult.stringValue));
+                SHEEP_NEXT();
             }
-            case SheepInstruction::Branch:
+            SHEEP_OP(Branch)
             {
 				#ifdef SHEEP_DEBUG
 				std::cout << "Branch" << std::endl;
 				#endif
-				int branchAddress = reader.ReadInt();
-				reader.Seek(branchAddress);
-                break;
+				int branchIndex = op->intArg;
+				ip = instructions + branchIndex;
+                SHEEP_NEXT();
             }
-            case SheepInstruction::BranchGoto:
+            SHEEP_OP(BranchGoto)
             {
 				#ifdef SHEEP_DEBUG
 				std::cout << "BranchGoto" << std::endl;
 				#endif
-				int branchAddress = reader.ReadInt();
-				reader.Seek(branchAddress);
-                break;
+				int branchIndex = op->intArg;
+				ip = instructions + branchIndex;
+                SHEEP_NEXT();
             }
-            case SheepInstruction::BranchIfZero:
+            SHEEP_OP(BranchIfZero)
             {
-				// Regardless of whether we do branch, we need to pull
-				// the branch address from the reader.
-				int branchAddress = reader.ReadInt();
+				int branchIndex = op->intArg;
 				
 				#ifdef SHEEP_DEBUG
 				std::cout << "BranchIfZero" << std::endl;
@@ -524,19 +560,19 @@ void SheepVM::ExecuteInternal(SheepThread* thread)
 				SheepValue& result = thread->mStack.Pop();
 				if(result.intValue == 0)
 				{
-					reader.Seek(branchAddress);
+					ip = instructions + branchIndex;
 				}
-                break;
+                SHEEP_NEXT();
             }
-            case SheepInstruction::BeginWait:
+            SHEEP_OP(BeginWait)
             {
 				#ifdef SHEEP_DEBUG
 				std::cout << "BeginWait" << std::endl;
 				#endif
 				thread->mInWaitBlock = true;
-                break;
+                SHEEP_NEXT();
             }
-            case SheepInstruction::EndWait:
+            SHEEP_OP(EndWait)
             {
 				#ifdef SHEEP_DEBUG
 				std::cout << "EndWait " << thread->mInWaitBlock << ", " << thread->mWaitCounter << std::endl;
@@ -546,15 +582,15 @@ void SheepVM::ExecuteInternal(SheepThread* thread)
 				if(thread->mWaitCounter > 0)
 				{
 					thread->mBlocked = true;
-					stopReading = true;
+					SHEEP_STOP();
 				}
 				else
 				{
 					thread->mInWaitBlock = false;
 				}
-                break;
+                SHEEP_NEXT();
             }
-            case SheepInstruction::ReturnV:
+            SHEEP_OP(ReturnV)
             {
                 // This means we've reached the end of the executing function.
                 // So, we just return to the caller, for realz.
@@ -562,12 +598,11 @@ void SheepVM::ExecuteInternal(SheepThread* thread)
 				std::cout << "ReturnV" << std::endl;
 				#endif
 				thread->mRunning = false;
-				stopReading = true;
-				break;
+				SHEEP_STOP();
             }
-            case SheepInstruction::StoreI:
+            SHEEP_OP(StoreI)
             {
-                int varIndex = reader.ReadInt();
+                int varIndex = op->intArg;
                 if(varIndex >= 0 && varIndex < instance->mVariables.size())
                 {
 					#ifdef SHEEP_DEBUG
@@ -578,11 +613,11 @@ void SheepVM::ExecuteInternal(SheepThread* thread)
 					SheepValue& value = thread->mStack.Pop();
 					instance->mVariables[varIndex].intValue = value.intValue;
                 }
-                break;
+                SHEEP_NEXT();
             }
-            case SheepInstruction::StoreF:
+            SHEEP_OP(StoreF)
             {
-                int varIndex = reader.ReadInt();
+                int varIndex = op->intArg;
                 if(varIndex >= 0 && varIndex < instance->mVariables.size())
                 {
 					#ifdef SHEEP_DEBUG
@@ -593,11 +628,11 @@ void SheepVM::ExecuteInternal(SheepThread* thread)
 					SheepValue& value = thread->mStack.Pop();
                     instance->mVariables[varIndex].floatValue = value.floatValue;
                 }
-                break;
+                SHEEP_NEXT();
             }
-            case SheepInstruction::StoreS:
+            SHEEP_OP(StoreS)
             {
-                int varIndex = reader.ReadInt();
+                int varIndex = op->intArg;
                 if(varIndex >= 0 && varIndex < instance->mVariables.size())
                 {
 					#ifdef SHEEP_DEBUG
@@ -606,13 +641,13 @@ void SheepVM::ExecuteInternal(SheepThread* thread)
 					
                     assert(instance->mVariables[varIndex].type == SheepValueType::String);
 					SheepValue& value = thread->mStack.Pop();
-                    instance->mVariables[varIndex].stringValue = value.stringValue;
+                    instance->mVariables[varIndex].stringValue = mInternedStrings.Intern(value.stringValue);
                 }
-                break;
+                SHEEP_NEXT();
             }
-            case SheepInstruction::LoadI:
+            SHEEP_OP(LoadI)
             {
-                int varIndex = reader.ReadInt();
+                int varIndex = op->intArg;
                 if(varIndex >= 0 && varIndex < instance->mVariables.size())
                 {
 					#ifdef SHEEP_DEBUG
@@ -622,11 +657,11 @@ void SheepVM::ExecuteInternal(SheepThread* thread)
                     assert(instance->mVariables[varIndex].type == SheepValueType::Int);
 					thread->mStack.PushInt(instance->mVariables[varIndex].intValue);
                 }
-                break;
+                SHEEP_NEXT();
             }
-            case SheepInstruction::LoadF:
+            SHEEP_OP(LoadF)
             {
-                int varIndex = reader.ReadInt();
+                int varIndex = op->intArg;
                 if(varIndex >= 0 && varIndex < instance->mVariables.size())
                 {
 					#ifdef SHEEP_DEBUG
@@ -636,11 +671,11 @@ void SheepVM::ExecuteInternal(SheepThread* thread)
                     assert(instance->mVariables[varIndex].type == SheepValueType::Float);
 					thread->mStack.PushFloat(instance->mVariables[varIndex].floatValue);
                 }
-                break;
+                SHEEP_NEXT();
             }
-            case SheepInstruction::LoadS:
+            SHEEP_OP(LoadS)
             {
-                int varIndex = reader.ReadInt();
+                int varIndex = op->intArg;
                 if(varIndex >= 0 && varIndex < instance->mVariables.size())
                 {
 					#ifdef SHEEP_DEBUG
@@ -650,57 +685,52 @@ void SheepVM::ExecuteInternal(SheepThread* thread)
                     assert(instance->mVariables[varIndex].type == SheepValueType::String);
 					thread->mStack.PushString(instance->mVariables[varIndex].stringValue);
                 }
-                break;
+                SHEEP_NEXT();
             }
-            case SheepInstruction::PushI:
+            SHEEP_OP(PushI)
             {
-                int int1 = reader.ReadInt();
+                int int1 = op->intArg;
 				#ifdef SHEEP_DEBUG
 				std::cout << "PushI " << int1 << std::endl;
 				#endif
 				thread->mStack.PushInt(int1);
-                break;
+                SHEEP_NEXT();
             }
-            case SheepInstruction::PushF:
+            SHEEP_OP(PushF)
             {
-                float float1 = reader.ReadFloat();
+                float float1 = op->floatArg;
 				#ifdef SHEEP_DEBUG
 				std::cout << "PushF " << float1 << std::endl;
 				#endif
 				thread->mStack.PushFloat(float1);
-                break;
+                SHEEP_NEXT();
             }
-            case SheepInstruction::PushS:
+            SHEEP_OP(PushS)
             {
-                int stringConstOffset = reader.ReadInt();
+				// String const was looked up when the script loaded.
 				#ifdef SHEEP_DEBUG
-				std::cout << "PushS " << stringConstOffset << std::endl;
+				std::cout << "PushS " << op->stringArg << std::endl;
 				#endif
-				thread->mStack.PushStringOffset(stringConstOffset);
-                break;
+				thread->mStack.PushString(op->stringArg);
+                SHEEP_NEXT();
             }
-			case SheepInstruction::GetString:
+			SHEEP_OP(GetString)
 			{
-				SheepValue& offsetValue = thread->mStack.Pop();
-				std::string* stringPtr = script->GetStringConst(offsetValue.intValue);
-				if(stringPtr != nullptr)
-				{
-					thread->mStack.PushString(stringPtr->c_str());
-				}
+				// PushS already pushed the string itself (rather than its offset), so there's nothing left to do.
 				#ifdef SHEEP_DEBUG
 				std::cout << "GetString " << thread->mStack.Peek().stringValue << std::endl;
 				#endif
-				break;
+				SHEEP_NEXT();
 			}
-            case SheepInstruction::Pop:
+            SHEEP_OP(Pop)
             {
 				#ifdef SHEEP_DEBUG
 				std::cout << "Pop" << std::endl;
 				#endif
 				thread->mStack.Pop(1);
-                break;
+                SHEEP_NEXT();
             }
-            case SheepInstruction::AddI:
+            SHEEP_OP(AddI)
             {
                 assert(thread->mStack.Size() >= 2);
 				int int1 = thread->mStack.Peek(1).intValue;
@@ -711,9 +741,9 @@ void SheepVM::ExecuteInternal(SheepThread* thread)
 				std::cout << "AddI " << int1 << " + " << int2 << std::endl;
 				#endif
 				thread->mStack.PushInt(int1 + int2);
-                break;
+                SHEEP_NEXT();
             }
-            case SheepInstruction::AddF:
+            SHEEP_OP(AddF)
             {
 				assert(thread->mStack.Size() >= 2);
                 float float1 = thread->mStack.Peek(1).floatValue;
@@ -724,9 +754,9 @@ void SheepVM::ExecuteInternal(SheepThread* thread)
 				std::cout << "AddF " << float1 << " + " << float2 << std::endl;
 				#endif
 				thread->mStack.PushFloat(float1 + float2);
-                break;
+                SHEEP_NEXT();
             }
-            case SheepInstruction::SubtractI:
+            SHEEP_OP(SubtractI)
             {
                 assert(thread->mStack.Size() >= 2);
                 int int1 = thread->mStack.Peek(1).intValue;
@@ -737,9 +767,9 @@ void SheepVM::ExecuteInternal(SheepThread* thread)
 				std::cout << "SubtractI " << int1 << " - " << int2 << std::endl;
 				#endif
 				thread->mStack.PushInt(int1 - int2);
-                break;
+                SHEEP_NEXT();
             }
-            case SheepInstruction::SubtractF:
+            SHEEP_OP(SubtractF)
             {
                 assert(thread->mStack.Size() >= 2);
                 float float1 = thread->mStack.Peek(1).floatValue;
@@ -750,9 +780,9 @@ void SheepVM::ExecuteInternal(SheepThread* thread)
 				std::cout << "SubtractF " << float1 << " - " << float2 << std::endl;
 				#endif
 				thread->mStack.PushFloat(float1 - float2);
-                break;
+                SHEEP_NEXT();
             }
-            case SheepInstruction::MultiplyI:
+            SHEEP_OP(MultiplyI)
             {
                 assert(thread->mStack.Size() >= 2);
                 int int1 = thread->mStack.Peek(1).intValue;
@@ -763,9 +793,9 @@ void SheepVM::ExecuteInternal(SheepThread* thread)
 				std::cout << "MultiplyI " << int1 << " * " << int2 << std::endl;
 				#endif
 				thread->mStack.PushInt(int1 * int2);
-                break;
+                SHEEP_NEXT();
             }
-            case SheepInstruction::MultiplyF:
+            SHEEP_OP(MultiplyF)
             {
                 assert(thread->mStack.Size() >= 2);
                 float float1 = thread->mStack.Peek(1).floatValue;
@@ -776,9 +806,9 @@ void SheepVM::ExecuteInternal(SheepThread* thread)
 				std::cout << "MultiplyF " << float1 << " * " << float2 << std::endl;
 				#endif
 				thread->mStack.PushFloat(float1 * float2);
-                break;
+                SHEEP_NEXT();
             }
-            case SheepInstruction::DivideI:
+            SHEEP_OP(DivideI)
             {
                 assert(thread->mStack.Size() >= 2);
                 int int1 = thread->mStack.Peek(1).intValue;
@@ -798,9 +828,9 @@ void SheepVM::ExecuteInternal(SheepThread* thread)
 					std::cout << "Divide by zero!" << std::endl;
 					thread->mStack.PushInt(0);
 				}
-                break;
+                SHEEP_NEXT();
             }
-            case SheepInstruction::DivideF:
+            SHEEP_OP(DivideF)
             {
                 assert(thread->mStack.Size() >= 2);
                 float float1 = thread->mStack.Peek(1).floatValue;
@@ -820,9 +850,9 @@ void SheepVM::ExecuteInternal(SheepThread* thread)
 					std::cout << "Divide by zero!" << std::endl;
 					thread->mStack.PushFloat(0.0f);
 				}
-                break;
+                SHEEP_NEXT();
             }
-            case SheepInstruction::NegateI:
+            SHEEP_OP(NegateI)
             {
                 assert(thread->mStack.Size() >= 1);
 				
@@ -830,9 +860,9 @@ void SheepVM::ExecuteInternal(SheepThread* thread)
 				std::cout << "NegateI " << thread->mStack.Peek(0).intValue << std::endl;
 				#endif
                 thread->mStack.Peek(0).intValue *= -1;
-                break;
+                SHEEP_NEXT();
             }
-            case SheepInstruction::NegateF:
+            SHEEP_OP(NegateF)
             {
                 assert(thread->mStack.Size() >= 1);
 				
@@ -840,9 +870,9 @@ void SheepVM::ExecuteInternal(SheepThread* thread)
 				std::cout << "NegateF " << thread->mStack.Peek(0).floatValue << std::endl;
 				#endif
                 thread->mStack.Peek(0).floatValue *= -1.0f;
-                break;
+                SHEEP_NEXT();
             }
-            case SheepInstruction::IsEqualI:
+            SHEEP_OP(IsEqualI)
             {
                 assert(thread->mStack.Size() >= 2);
                 int int1 = thread->mStack.Peek(1).intValue;
@@ -853,9 +883,9 @@ void SheepVM::ExecuteInternal(SheepThread* thread)
 				std::cout << "IsEqualI " << int1 << " == " << int2 << std::endl;
 				#endif
 				thread->mStack.PushInt(int1 == int2 ? 1 : 0);
-                break;
+                SHEEP_NEXT();
             }
-            case SheepInstruction::IsEqualF:
+            SHEEP_OP(IsEqualF)
             {
                 assert(thread->mStack.Size() >= 2);
                 float float1 = thread->mStack.Peek(1).floatValue;
@@ -866,9 +896,9 @@ void SheepVM::ExecuteInternal(SheepThread* thread)
 				std::cout << "IsEqualF " << float1 << " == " << float2 << std::endl;
 				#endif
 				thread->mStack.PushInt(Math::AreEqual(float1, float2) ? 1 : 0);
-                break;
+                SHEEP_NEXT();
             }
-            case SheepInstruction::IsNotEqualI:
+            SHEEP_OP(IsNotEqualI)
             {
                 assert(thread->mStack.Size() >= 2);
                 int int1 = thread->mStack.Peek(1).intValue;
@@ -879,9 +909,9 @@ void SheepVM::ExecuteInternal(SheepThread* thread)
 				std::cout << "IsNotEqualI " << int1 << " != " << int2 << std::endl;
 				#endif
 				thread->mStack.PushInt(int1 != int2 ? 1 : 0);
-                break;
+                SHEEP_NEXT();
             }
-            case SheepInstruction::IsNotEqualF:
+            SHEEP_OP(IsNotEqualF)
             {
                 assert(thread->mStack.Size() >= 2);
                 float float1 = thread->mStack.Peek(1).floatValue;
@@ -892,9 +922,9 @@ void SheepVM::ExecuteInternal(SheepThread* thread)
 				std::cout << "IsNotEqualF " << float1 << " != " << float2 << std::endl;
 				#endif
 				thread->mStack.PushInt(!Math::AreEqual(float1, float2) ? 1 : 0);
-                break;
+                SHEEP_NEXT();
             }
-            case SheepInstruction::IsGreaterI:
+            SHEEP_OP(IsGreaterI)
             {
                 assert(thread->mStack.Size() >= 2);
                 int int1 = thread->mStack.Peek(1).intValue;
@@ -905,9 +935,9 @@ void SheepVM::ExecuteInternal(SheepThread* thread)
 				std::cout << "IsGreaterI " << int1 << " > " << int2 << std::endl;
 				#endif
 				thread->mStack.PushInt(int1 > int2 ? 1 : 0);
-                break;
+                SHEEP_NEXT();
             }
-            case SheepInstruction::IsGreaterF:
+            SHEEP_OP(IsGreaterF)
             {
                 assert(thread->mStack.Size() >= 2);
                 float float1 = thread->mStack.Peek(1).floatValue;
@@ -918,9 +948,9 @@ void SheepVM::ExecuteInternal(SheepThread* thread)
 				std::cout << "IsGreaterF " << float1 << " > " << float2 << std::endl;
 				#endif
 				thread->mStack.PushInt(float1 > float2 ? 1 : 0);
-                break;
+                SHEEP_NEXT();
             }
-			case SheepInstruction::IsLessI:
+			SHEEP_OP(IsLessI)
 			{
 				assert(thread->mStack.Size() >= 2);
 				int int1 = thread->mStack.Peek(1).intValue;
@@ -931,9 +961,9 @@ void SheepVM::ExecuteInternal(SheepThread* thread)
 				std::cout << "IsLessI " << int1 << " < " << int2 << std::endl;
 				#endif
 				thread->mStack.PushInt(int1 < int2 ? 1 : 0);
-				break;
+				SHEEP_NEXT();
 			}
-			case SheepInstruction::IsLessF:
+			SHEEP_OP(IsLessF)
 			{
 				assert(thread->mStack.Size() >= 2);
 				float float1 = thread->mStack.Peek(1).floatValue;
@@ -944,9 +974,9 @@ void SheepVM::ExecuteInternal(SheepThread* thread)
 				std::cout << "IsLessF " << float1 << " < " << float2 << std::endl;
 				#endif
 				thread->mStack.PushInt(float1 < float2 ? 1 : 0);
-				break;
+				SHEEP_NEXT();
 			}
-            case SheepInstruction::IsGreaterEqualI:
+            SHEEP_OP(IsGreaterEqualI)
             {
                 assert(thread->mStack.Size() >= 2);
                 int int1 = thread->mStack.Peek(1).intValue;
@@ -957,9 +987,9 @@ void SheepVM::ExecuteInternal(SheepThread* thread)
 				std::cout << "IsGreaterEqualI " << int1 << " >= " << int2 << std::endl;
 				#endif
 				thread->mStack.PushInt(int1 >= int2 ? 1 : 0);
-                break;
+                SHEEP_NEXT();
             }
-            case SheepInstruction::IsGreaterEqualF:
+            SHEEP_OP(IsGreaterEqualF)
             {
                 assert(thread->mStack.Size() >= 2);
                 float float1 = thread->mStack.Peek(1).floatValue;
@@ -970,9 +1000,9 @@ void SheepVM::ExecuteInternal(SheepThread* thread)
 				std::cout << "IsGreaterEqualF " << float1 << " >= " << float2 << std::endl;
 				#endif
 				thread->mStack.PushInt(float1 >= float2 ? 1 : 0);
-                break;
+                SHEEP_NEXT();
             }
-            case SheepInstruction::IsLessEqualI:
+            SHEEP_OP(IsLessEqualI)
             {
                 assert(thread->mStack.Size() >= 2);
                 int int1 = thread->mStack.Peek(1).intValue;
@@ -983,9 +1013,9 @@ void SheepVM::ExecuteInternal(SheepThread* thread)
 				std::cout << "IsLessEqualI " << int1 << " <= " << int2 << std::endl;
 				#endif
 				thread->mStack.PushInt(int1 <= int2 ? 1 : 0);
-                break;
+                SHEEP_NEXT();
             }
-            case SheepInstruction::IsLessEqualF:
+            SHEEP_OP(IsLessEqualF)
             {
                 assert(thread->mStack.Size() >= 2);
                 float float1 = thread->mStack.Peek(1).floatValue;
@@ -996,11 +1026,11 @@ void SheepVM::ExecuteInternal(SheepThread* thread)
 				std::cout << "IsLessEqualF " << float1 << " <= " << float2 << std::endl;
 				#endif
 				thread->mStack.PushInt(float1 <= float2 ? 1 : 0);
-                break;
+                SHEEP_NEXT();
             }
-            case SheepInstruction::IToF:
+            SHEEP_OP(IToF)
             {
-                int index = reader.ReadInt();
+                int index = op->intArg;
 				SheepValue& value = thread->mStack.Peek(index);
 				
 				#ifdef SHEEP_DEBUG
@@ -1008,11 +1038,11 @@ void SheepVM::ExecuteInternal(SheepThread* thread)
 				#endif
                 value.floatValue = value.intValue;
                 value.type = SheepValueType::Float;
-                break;
+                SHEEP_NEXT();
             }
-            case SheepInstruction::FToI:
+            SHEEP_OP(FToI)
             {
-                int index = reader.ReadInt();
+                int index = op->intArg;
 				SheepValue& value = thread->mStack.Peek(index);
 				
 				#ifdef SHEEP_DEBUG
@@ -1020,9 +1050,9 @@ void SheepVM::ExecuteInternal(SheepThread* thread)
 				#endif
                 value.intValue = value.floatValue;
                 value.type = SheepValueType::Int;
-                break;
+                SHEEP_NEXT();
             }
-            case SheepInstruction::Modulo:
+            SHEEP_OP(Modulo)
             {
                 assert(thread->mStack.Size() >= 2);
                 int int1 = thread->mStack.Peek(1).intValue;
@@ -1033,9 +1063,9 @@ void SheepVM::ExecuteInternal(SheepThread* thread)
 				std::cout << "Modulo " << int1 << " % " << int2 << std::endl;
 				#endif
 				thread->mStack.PushInt(int1 % int2);
-                break;
+                SHEEP_NEXT();
             }
-            case SheepInstruction::And:
+            SHEEP_OP(And)
             {
                 assert(thread->mStack.Size() >= 2);
                 int int1 = thread->mStack.Peek(1).intValue;
@@ -1046,9 +1076,9 @@ void SheepVM::ExecuteInternal(SheepThread* thread)
 				std::cout << "And " << int1 << " && " << int2 << std::endl;
 				#endif
 				thread->mStack.PushInt(int1 && int2 ? 1 : 0);
-                break;
+                SHEEP_NEXT();
             }
-            case SheepInstruction::Or:
+            SHEEP_OP(Or)
             {
                 assert(thread->mStack.Size() >= 2);
                 int int1 = thread->mStack.Peek(1).intValue;
@@ -1059,9 +1089,9 @@ void SheepVM::ExecuteInternal(SheepThread* thread)
 				std::cout << "Or " << int1 << " || " << int2 << std::endl;
 				#endif
 				thread->mStack.PushInt(int1 || int2 ? 1 : 0);
-                break;
+                SHEEP_NEXT();
             }
-            case SheepInstruction::Not:
+            SHEEP_OP(Not)
             {
                 assert(thread->mStack.Size() >= 1);
 				int int1 = thread->mStack.Peek(0).intValue;
@@ -1070,31 +1100,39 @@ void SheepVM::ExecuteInternal(SheepThread* thread)
 				std::cout << "Not " << int1 << std::endl;
 				#endif
                 thread->mStack.Peek(0).intValue = (int1 == 0 ? 1 : 0);
-                break;
+                SHEEP_NEXT();
             }
-            case SheepInstruction::DebugBreakpoint:
+            SHEEP_OP(DebugBreakpoint)
             {
 				#ifdef SHEEP_DEBUG
 				std::cout << "DebugBreakpoint" << std::endl;
 				#endif
 				//TODO: Break in Xcode/VS.
-                break;
+                SHEEP_NEXT();
             }
-            default:
+            SHEEP_OP_UNKNOWN()
             {
-				std::cout << "Unaccounted for Sheep Instruction: " << (int)instruction << std::endl;
-                break;
+				std::cout << "Unaccounted for Sheep Instruction: " << op->intArg << std::endl;
+                SHEEP_NEXT();
             }
-        }
-    }
+	#ifndef SHEEP_COMPUTED_GOTO
+		}
+	}
+	#endif
+	#undef SHEEP_OP
+	#undef SHEEP_OP_UNKNOWN
+	#undef SHEEP_NEXT
+	#undef SHEEP_STOP
 	
-	// Update thread's code offset value.
-	thread->mCodeOffset = reader.GetPosition();
+stop:
+	// Update thread's code offset value, so execution can resume from here.
+	int nextIndex = static_cast<int>(ip - instructions);
+	thread->mCodeOffset = nextIndex < instructionCount ? instructions[nextIndex].bytecodeOffset : script->GetBytecodeLength();
 	
-	// If reached end of file, assume the thread is no longer running.
-	if(!reader.OK())
+	// Record execution time before calling any callbacks, since those may execute other sheep.
+	if(profiling)
 	{
-		thread->mRunning = false;
+		mProfiler.AddFunctionSample(thread->GetName(), starting, executedCount, startTime, SheepProfiler::Clock::now());
 	}
 	
 	// If thread is no longer running, notify anyone who was waiting for the thread to finish.
@@ -1103,14 +1141,28 @@ void SheepVM::ExecuteInternal(SheepThread* thread)
 	{
 		Services::GetReports()->Log("SheepMachine", "Sheep " + thread->GetName() + " is exiting");
 		
+		--mRunningThreadCount;
+		
 		// Thread is no longer using execution context.
+		// Once unused, an instance can be recycled (the evaluation instance is never recycled).
 		thread->mContext->mReferenceCount--;
+		if(thread->mContext->mReferenceCount == 0 && thread->mContext != &mEvalInstance)
+		{
+			thread->mContext->mFreeIndex = static_cast<int>(mFreeInstances.size());
+			mFreeInstances.push_back(thread->mContext);
+		}
 		
 		// Call my wait callback - someone might have been waiting for this thread to finish.
 		if(thread->mWaitCallback)
 		{
 			thread->mWaitCallback();
 		}
+		
+		// Thread can be recycled. Done after the callback, so the callback can't reuse the thread while it's being called.
+		if(thread != &mEvalThread)
+		{
+			mFreeThreads.push_back(thread);
+		}
 	}
 	else if(thread->mInWaitBlock)
 	{
@@ -8,11 +8,12 @@
 #pragma once
 #include <functional>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
+#include "SheepProfiler.h"
 #include "SheepThread.h"
 #include "SheepValue.h"
-#include "Value.h"
 
 class SheepScript;
 struct SysImport;
@@ -35,6 +36,9 @@ struct SheepInstance
 	// For example, if one function calls another in the same SheepScript.
 	int mReferenceCount = 0;
 	
+	// Index in the VM's list of unused instances, or -1 if in use (or never used).
+	int mFreeIndex = -1;
+	
 	std::string GetName();
 };
 
@@ -115,20 +119,53 @@ public:
 	
 	void FlagExecutionError() { mExecutionError = true; }
 	
+	SheepProfiler& GetProfiler() { return mProfiler; }
+	
 private:
 	std::vector<SheepInstance*> mSheepInstances;
 	std::vector<SheepThread*> mSheepThreads;
 	
+	// Maps a script to the instance used to execute it.
+	std::unordered_map<SheepScript*, SheepInstance*> mInstancesByScript;
+	
+	// Instances and threads that aren't being used, and can be recycled.
+	std::vector<SheepInstance*> mFreeInstances;
+	std::vector<SheepThread*> mFreeThreads;
+	
+	// Number of threads currently running (including ones blocked in a wait).
+	int mRunningThreadCount = 0;
+	
 	SheepThread* mCurrentThread = nullptr;
 	
+	// Evaluations always run to completion right away, so one thread and instance can be reused for all of them.
+	// This avoids searching the thread/instance pools on every evaluation.
+	SheepThread mEvalThread;
+	SheepInstance mEvalInstance;
+	
 	bool mExecutionError = false;
 		
 	SheepInstance* GetInstance(SheepScript* script);
 	SheepThread* GetThread();
 	
-    Value CallSysFunc(SheepThread* thread, SysImport* sysImport);
+	// Result of the most recent sys func call.
+	SysFuncResult mSysFuncResult;
+	
+	// Strings stored in sheep variables. Variables outlive the threads that set them,
+	// so strings are interned here, rather than in the thread's arena.
+	SheepStringArena mInternedStrings;
+	
+	// Once this many strings are interned, strings no longer stored in any variable are freed (see CompactInternedStrings).
+	static const size_t kMinInternedStringCompactCount = 256;
+	size_t mInternedStringCompactCount = kMinInternedStringCompactCount;
+	
+	// Records execution times, if enabled.
+	SheepProfiler mProfiler;
+	
+	void CallSysFunc(SheepThread* thread, SysImport* sysImport);
+	void CompactInternedStrings();
 	
 	SheepThread* ExecuteInternal(SheepScript* script, int bytecodeOffset, const std::string& functionName, std::function<void()> finishCallback);
 	SheepThread* ExecuteInternal(SheepInstance* instance, int bytecodeOffset, const std::string& functionName, std::function<void()> finishCallback);
+	void ExecuteInternal(SheepThread* thread, SheepInstance* instance, int bytecodeOffset, const std::string& functionName, std::function<void()> finishCallback);
 	void ExecuteInternal(SheepThread* thread);
 };
@@ -93,3 +93,13 @@ struct SheepValue
 		}
 	}
 };
+
+// Result of a system function call.
+struct SysFuncResult
+{
+	// Int and float results (void functions return an int too).
+	SheepValue value;
+	
+	// String results.
+	std::string stringValue;
+};
@@ -120,21 +120,21 @@ bool Submesh::Raycast(const Ray& ray)
 		return false;
 	}
 	
-    RaycastHit hitInfo;
-	for(int i = 0; i < mIndexCount; i += 3)
+	// Triangles are copied into a batch for faster testing. Only need to do this when vertex positions or indexes change.
+	if(mTriangleBatchDirty)
 	{
-		Vector3 vert1 = GetVertexPosition(mIndexes[i]);
-		Vector3 vert2 = GetVertexPosition(mIndexes[i + 1]);
-		Vector3 vert3 = GetVertexPosition(mIndexes[i + 2]);
-		
-		if(Collisions::TestRayTriangle(ray, vert1, vert2, vert3, hitInfo))
+		mTriangleBatch.Clear();
+		mTriangleBatch.Reserve(mIndexCount / 3);
+		for(int i = 0; i + 2 < mIndexCount; i += 3)
 		{
-			return true;
+			mTriangleBatch.Add(GetVertexPosition(mIndexes[i]), GetVertexPosition(mIndexes[i + 1]), GetVertexPosition(mIndexes[i + 2]));
 		}
+		mTriangleBatchDirty = false;
 	}
 	
-	// Ray did not hit any triangles.
-	return false;
+	// Returns -1 if the ray did not hit any triangles.
+    RaycastHit hitInfo;
+	return Collisions::TestRayTriangles(ray, mTriangleBatch, hitInfo) >= 0;
 }
 
 void Submesh::SetPositions(float* positions, bool createCopy)
@@ -153,6 +153,7 @@ void Submesh::SetPositions(float* positions, bool createCopy)
         mPositions = positions;
     }
     mVertexArray.ChangeVertexData(VertexAttribute::Semantic::Position, mPositions);
+    mTriangleBatchDirty = true;
 }
 
 void Submesh::SetColors(float* colors, bool createCopy)
@@ -225,4 +226,5 @@ void Submesh::SetIndexes(unsigned short* indexes, bool createCopy)
         mIndexes = indexes;
     }
     mVertexArray.ChangeIndexData(mIndexes, mIndexCount);
+    mTriangleBatchDirty = true;
 }
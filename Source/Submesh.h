@@ -9,6 +9,7 @@
 #pragma once
 #include <string>
 
+#include "TriangleBatch.h"
 #include "Vector3.h"
 #include "VertexArray.h"
 
@@ -82,6 +83,10 @@ private:
     // Vertex array that actually renders using the underlying rendering system.
     VertexArray mVertexArray;
     
+    // Copy of triangles used for raycasts - rebuilt whenever positions or indexes change.
+    TriangleBatch mTriangleBatch;
+    bool mTriangleBatchDirty = true;
+    
 	// Name of the default texture to use for this submesh.
 	std::string mTextureName;
 };
@@ -5,6 +5,7 @@
 //
 #include "Texture.h"
 
+#include <cstring>
 #include <iostream>
 
 #include <SDL2/SDL.h>
@@ -183,6 +184,41 @@ void Texture::Blit(Texture* source, int destX, int destY)
 }
 */
  
+void Texture::CopyPixels(const Texture& source, Texture& dest, int destX, int destY)
+{
+	CopyPixels(source, 0, 0, source.mWidth, source.mHeight, dest, destX, destY);
+}
+
+void Texture::CopyPixels(const Texture& source, int sourceX, int sourceY, int sourceWidth, int sourceHeight,
+						 Texture& dest, int destX, int destY)
+{
+	if(source.mPixels == nullptr || dest.mPixels == nullptr) { return; }
+	
+	// Clip source rect to source bounds.
+	if(sourceX < 0) { sourceWidth += sourceX; destX -= sourceX; sourceX = 0; }
+	if(sourceY < 0) { sourceHeight += sourceY; destY -= sourceY; sourceY = 0; }
+	sourceWidth = Math::Min(sourceWidth, static_cast<int>(source.mWidth) - sourceX);
+	sourceHeight = Math::Min(sourceHeight, static_cast<int>(source.mHeight) - sourceY);
+	
+	// Clip to dest bounds.
+	if(destX < 0) { sourceWidth += destX; sourceX -= destX; destX = 0; }
+	if(destY < 0) { sourceHeight += destY; sourceY -= destY; destY = 0; }
+	sourceWidth = Math::Min(sourceWidth, static_cast<int>(dest.mWidth) - destX);
+	sourceHeight = Math::Min(sourceHeight, static_cast<int>(dest.mHeight) - destY);
+	if(sourceWidth <= 0 || sourceHeight <= 0) { return; }
+	
+	// No blending, so each row can be copied in one go.
+	for(int y = 0; y < sourceHeight; ++y)
+	{
+		int sourcePixelIndex = ((sourceY + y) * source.mWidth + sourceX) * 4;
+		int destPixelIndex = ((destY + y) * dest.mWidth + destX) * 4;
+		memcpy(dest.mPixels + destPixelIndex, source.mPixels + sourcePixelIndex, sourceWidth * 4);
+	}
+	
+	// Mark dirty so it uploads to GPU on next use.
+	dest.mDirty = true;
+}
+
 void Texture::BlendPixels(const Texture& source, Texture& dest, int destX, int destY)
 {
 	BlendPixels(source, 0, 0, source.mWidth, source.mHeight, dest, destX, destY);
@@ -78,6 +78,11 @@ public:
 	
 	//void Blit(Texture* source, int destX, int destY);
 	
+	// Copies source pixels into dest, replacing whatever was there (including alpha).
+	static void CopyPixels(const Texture& source, Texture& dest, int destX, int destY);
+	static void CopyPixels(const Texture& source, int sourceX, int sourceY, int sourceWidth, int sourceHeight,
+						   Texture& dest, int destX, int destY);
+	
 	// Blend's source pixels into dest based on source's alpha channel.
 	static void BlendPixels(const Texture& source, Texture& dest, int destX, int destY);
 	static void BlendPixels(const Texture& source, int sourceX, int sourceY, int sourceWidth, int sourceHeight,
@@ -0,0 +1,177 @@
+//
+// ThreadPool.cpp
+//
+// Clark Kromenaker
+//
+#include "ThreadPool.h"
+
+// The pool and queue of the worker running on this thread, if any.
+// Lets jobs that queue more jobs keep them on the same worker.
+static thread_local ThreadPool* sWorkerPool = nullptr;
+static thread_local unsigned int sWorkerQueueIndex = 0;
+
+ThreadPool::ThreadPool(unsigned int threadCount)
+{
+	// Default to one worker per hardware thread, leaving one for the main thread.
+	// Hardware concurrency can be reported as zero if unknown, so always create at least one worker.
+	if(threadCount == 0)
+	{
+		unsigned int hardwareThreadCount = std::thread::hardware_concurrency();
+		threadCount = hardwareThreadCount > 1 ? hardwareThreadCount - 1 : 1;
+	}
+
+	// All queues must exist before any worker starts, since workers steal from each other.
+	mQueues.reserve(threadCount);
+	for(unsigned int i = 0; i < threadCount; ++i)
+	{
+		mQueues.push_back(new JobQueue());
+	}
+
+	mThreads.reserve(threadCount);
+	for(unsigned int i = 0; i < threadCount; ++i)
+	{
+		mThreads.emplace_back(&ThreadPool::WorkerLoop, this, i);
+	}
+}
+
+ThreadPool::~ThreadPool()
+{
+	// Tell workers to stop, and wait for them to exit.
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+		mStopping = true;
+	}
+	mJobAvailable.notify_all();
+	for(auto& thread : mThreads)
+	{
+		thread.join();
+	}
+
+	for(auto& queue : mQueues)
+	{
+		delete queue;
+	}
+	mQueues.clear();
+}
+
+void ThreadPool::Enqueue(std::function<void()> job)
+{
+	// Keep a worker's jobs on that worker, since the data they use is likely still in its cache.
+	unsigned int queueIndex = sWorkerQueueIndex;
+	if(sWorkerPool != this)
+	{
+		queueIndex = mNextQueueIndex++ % mQueues.size();
+	}
+
+	{
+		// Job must count as unfinished before it's visible in a queue, or it might finish before being counted.
+		std::lock_guard<std::mutex> lock(mMutex);
+		++mUnfinishedJobCount;
+		{
+			std::lock_guard<std::mutex> queueLock(mQueues[queueIndex]->mutex);
+			mQueues[queueIndex]->jobs.push_back(job);
+		}
+		++mQueuedJobCount;
+	}
+	mJobAvailable.notify_one();
+	mJobProgress.notify_all();
+}
+
+void ThreadPool::WaitForAll()
+{
+	// Rather than sit idle, help out by executing queued jobs.
+	unsigned int queueIndex = (sWorkerPool == this) ? sWorkerQueueIndex : 0;
+	std::function<void()> job;
+	while(TryGetJob(queueIndex, job))
+	{
+		job();
+		FinishJob();
+	}
+
+	// Queues are empty, but workers may still be finishing up their jobs.
+	std::unique_lock<std::mutex> lock(mMutex);
+	mJobProgress.wait(lock, [this]() { return mUnfinishedJobCount == 0; });
+}
+
+void ThreadPool::WaitForCount(const std::atomic<int>& count)
+{
+	unsigned int queueIndex = (sWorkerPool == this) ? sWorkerQueueIndex : 0;
+	std::function<void()> job;
+	while(count > 0)
+	{
+		// Help out with any queued job - it may well be one we're waiting on.
+		if(TryGetJob(queueIndex, job))
+		{
+			job();
+			FinishJob();
+			continue;
+		}
+
+		// Nothing to help with, so wait for a job to finish (or for more jobs to be queued).
+		// Jobs change the count before finishing, so a finish can't be missed between checking and waiting.
+		std::unique_lock<std::mutex> lock(mMutex);
+		mJobProgress.wait(lock, [this, &count]() { return count <= 0 || mQueuedJobCount > 0; });
+	}
+}
+
+void ThreadPool::WorkerLoop(unsigned int queueIndex)
+{
+	sWorkerPool = this;
+	sWorkerQueueIndex = queueIndex;
+	while(true)
+	{
+		// Execute a job if one is available - either our own, or one stolen from another worker.
+		std::function<void()> job;
+		if(TryGetJob(queueIndex, job))
+		{
+			job();
+			FinishJob();
+			continue;
+		}
+
+		// No jobs anywhere, so wait for a job to be queued (or for the pool to be shut down).
+		std::unique_lock<std::mutex> lock(mMutex);
+		mJobAvailable.wait(lock, [this]() { return mStopping || mQueuedJobCount > 0; });
+		if(mStopping && mQueuedJobCount <= 0) { return; }
+	}
+}
+
+bool ThreadPool::TryGetJob(unsigned int queueIndex, std::function<void()>& outJob)
+{
+	// Newest job from our own queue first.
+	{
+		JobQueue* queue = mQueues[queueIndex];
+		std::lock_guard<std::mutex> lock(queue->mutex);
+		if(!queue->jobs.empty())
+		{
+			outJob = std::move(queue->jobs.back());
+			queue->jobs.pop_back();
+			--mQueuedJobCount;
+			return true;
+		}
+	}
+
+	// Otherwise, steal the oldest job from another queue.
+	for(unsigned int i = 1; i < mQueues.size(); ++i)
+	{
+		JobQueue* queue = mQueues[(queueIndex + i) % mQueues.size()];
+		std::lock_guard<std::mutex> lock(queue->mutex);
+		if(!queue->jobs.empty())
+		{
+			outJob = std::move(queue->jobs.front());
+			queue->jobs.pop_front();
+			--mQueuedJobCount;
+			return true;
+		}
+	}
+	return false;
+}
+
+void ThreadPool::FinishJob()
+{
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+		--mUnfinishedJobCount;
+	}
+	mJobProgress.notify_all();
+}
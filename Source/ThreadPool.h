@@ -0,0 +1,83 @@
+//
+// ThreadPool.h
+//
+// Clark Kromenaker
+//
+// A fixed set of worker threads that execute queued jobs.
+//
+// Each worker has its own job queue. A worker runs jobs from its own queue first,
+// and when that runs dry, it steals jobs from other workers' queues. That keeps
+// workers busy when jobs take uneven amounts of time, without every worker fighting
+// over a single queue.
+//
+// Jobs must be safe to run on any thread - they shouldn't touch GL,
+// SDL windowing, or any other main-thread-only systems.
+//
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class ThreadPool
+{
+public:
+	// If thread count is zero, one worker is created per hardware thread, minus one for the main thread.
+	ThreadPool(unsigned int threadCount = 0);
+	~ThreadPool();
+
+	// Queues a job to be executed on a worker thread.
+	// Jobs queued from one of this pool's workers go to that worker's queue. Otherwise, jobs are spread between queues.
+	void Enqueue(std::function<void()> job);
+
+	// Blocks until all queued jobs have completed.
+	// The calling thread helps execute queued jobs while it waits.
+	void WaitForAll();
+
+	// Blocks until the count reaches zero. Each job in a batch decrements the count when it's done,
+	// so a caller can wait on its own jobs without also waiting on unrelated jobs in the pool.
+	// The calling thread helps execute queued jobs while it waits.
+	void WaitForCount(const std::atomic<int>& count);
+
+	unsigned int GetThreadCount() const { return static_cast<unsigned int>(mThreads.size()); }
+
+private:
+	// A worker's jobs. The worker takes the newest job from the back, while other threads steal the oldest job from the front.
+	struct JobQueue
+	{
+		std::deque<std::function<void()>> jobs;
+		std::mutex mutex;
+	};
+
+	// Worker threads, and a job queue for each one.
+	std::vector<std::thread> mThreads;
+	std::vector<JobQueue*> mQueues;
+
+	// Queue that the next job from outside the pool goes to.
+	std::atomic<unsigned int> mNextQueueIndex { 0 };
+
+	// Number of jobs waiting in queues. Workers sleep while there are none.
+	std::atomic<int> mQueuedJobCount { 0 };
+
+	// Number of jobs that are queued or currently executing.
+	unsigned int mUnfinishedJobCount = 0;
+
+	// Guards unfinished job count and stopping flag, and is used for sleeping/waking workers.
+	std::mutex mMutex;
+
+	// Signaled when a job is queued (or on shutdown).
+	std::condition_variable mJobAvailable;
+
+	// Signaled when a job is queued or finished, for threads waiting on jobs.
+	std::condition_variable mJobProgress;
+
+	// Set on destruction to tell workers to exit.
+	bool mStopping = false;
+
+	void WorkerLoop(unsigned int queueIndex);
+	bool TryGetJob(unsigned int queueIndex, std::function<void()>& outJob);
+	void FinishJob();
+};
@@ -0,0 +1,248 @@
+//
+// TriangleBVH.cpp
+//
+// Clark Kromenaker
+//
+#include "TriangleBVH.h"
+
+#include <algorithm>
+
+#include "GMath.h"
+#include "Ray.h"
+
+void TriangleBVH::AddTriangle(const Vector3& p0, const Vector3& p1, const Vector3& p2, int id)
+{
+	Triangle triangle;
+	triangle.p0 = p0;
+	triangle.p1 = p1;
+	triangle.p2 = p2;
+	triangle.id = id;
+	mUnbuiltTriangles.push_back(triangle);
+}
+
+void TriangleBVH::Build()
+{
+	mNodes.clear();
+	mTriangles.Clear();
+	mTriangleIds.clear();
+	if(mUnbuiltTriangles.empty()) { return; }
+
+	// Median splits leave roughly half-full leaves, and a binary tree with N leaves has 2N-1 nodes.
+	mNodes.reserve(4 * (mUnbuiltTriangles.size() / kMaxLeafTriangles + 1));
+	mNodes.emplace_back();
+	BuildNode(0, 0, static_cast<int>(mUnbuiltTriangles.size()));
+
+	// Triangles are now sorted in leaf order - copy them into the batch used for raycasts.
+	mTriangles.Reserve(static_cast<int>(mUnbuiltTriangles.size()));
+	mTriangleIds.reserve(mUnbuiltTriangles.size());
+	for(auto& triangle : mUnbuiltTriangles)
+	{
+		mTriangles.Add(triangle.p0, triangle.p1, triangle.p2);
+		mTriangleIds.push_back(triangle.id);
+	}
+
+	// Don't need these anymore.
+	std::vector<Triangle>().swap(mUnbuiltTriangles);
+}
+
+void TriangleBVH::Clear()
+{
+	mUnbuiltTriangles.clear();
+	mTriangles.Clear();
+	mTriangleIds.clear();
+	mNodes.clear();
+}
+
+bool TriangleBVH::RaycastNearest(const Ray& ray, Hit& outHit, const Filter& filter) const
+{
+	outHit.t = FLT_MAX;
+	outHit.id = -1;
+	if(mNodes.empty()) { return false; }
+
+	// Inverse direction is used for all box tests. Division by zero gives infinity, which the slab test handles fine.
+	Vector3 inverseDirection(1.0f / ray.direction.x, 1.0f / ray.direction.y, 1.0f / ray.direction.z);
+
+	// Tree depth is logarithmic, so a small fixed stack is plenty.
+	int stack[64];
+	int stackSize = 0;
+	stack[stackSize++] = 0;
+	while(stackSize > 0)
+	{
+		const Node& node = mNodes[stack[--stackSize]];
+
+		// Skip any box that's missed, or that's further than the closest hit so far.
+		float nodeT = 0.0f;
+		if(!TestRayBounds(ray.origin, inverseDirection, node, outHit.t, nodeT)) { continue; }
+
+		if(node.count > 0)
+		{
+			// Test all leaf triangles at once.
+			RaycastHit hitInfo;
+			int index = Collisions::TestRayTriangles(ray, mTriangles, node.offset, node.count, hitInfo);
+			if(index < 0 || hitInfo.t >= outHit.t) { continue; }
+
+			// If nearest triangle passes the filter (or there is no filter), we're done with this leaf.
+			if(!filter || filter(mTriangleIds[index]))
+			{
+				outHit.t = hitInfo.t;
+				outHit.id = mTriangleIds[index];
+				continue;
+			}
+
+			// Otherwise, some other triangle in the leaf may still be hit - need to check them one at a time.
+			for(int i = node.offset; i < node.offset + node.count; ++i)
+			{
+				if(Collisions::TestRayTriangles(ray, mTriangles, i, 1, hitInfo) >= 0 && hitInfo.t < outHit.t && filter(mTriangleIds[i]))
+				{
+					outHit.t = hitInfo.t;
+					outHit.id = mTriangleIds[i];
+				}
+			}
+		}
+		else
+		{
+			// Visit the nearer child first - its hits let us skip the farther child entirely.
+			// Stack is LIFO, so push the farther child first.
+			int leftIndex = node.offset;
+			int rightIndex = node.offset + 1;
+			float leftT = 0.0f;
+			float rightT = 0.0f;
+			bool hitLeft = TestRayBounds(ray.origin, inverseDirection, mNodes[leftIndex], outHit.t, leftT);
+			bool hitRight = TestRayBounds(ray.origin, inverseDirection, mNodes[rightIndex], outHit.t, rightT);
+			if(hitLeft && hitRight)
+			{
+				if(leftT <= rightT)
+				{
+					stack[stackSize++] = rightIndex;
+					stack[stackSize++] = leftIndex;
+				}
+				else
+				{
+					stack[stackSize++] = leftIndex;
+					stack[stackSize++] = rightIndex;
+				}
+			}
+			else if(hitLeft)
+			{
+				stack[stackSize++] = leftIndex;
+			}
+			else if(hitRight)
+			{
+				stack[stackSize++] = rightIndex;
+			}
+		}
+	}
+	return outHit.id >= 0;
+}
+
+void TriangleBVH::RaycastAll(const Ray& ray, std::vector<Hit>& outHits, const Filter& filter) const
+{
+	if(mNodes.empty()) { return; }
+
+	Vector3 inverseDirection(1.0f / ray.direction.x, 1.0f / ray.direction.y, 1.0f / ray.direction.z);
+
+	int stack[64];
+	int stackSize = 0;
+	stack[stackSize++] = 0;
+	while(stackSize > 0)
+	{
+		const Node& node = mNodes[stack[--stackSize]];
+
+		float nodeT = 0.0f;
+		if(!TestRayBounds(ray.origin, inverseDirection, node, FLT_MAX, nodeT)) { continue; }
+
+		if(node.count > 0)
+		{
+			for(int i = node.offset; i < node.offset + node.count; ++i)
+			{
+				RaycastHit hitInfo;
+				if(Collisions::TestRayTriangles(ray, mTriangles, i, 1, hitInfo) >= 0)
+				{
+					if(filter && !filter(mTriangleIds[i])) { continue; }
+
+					Hit hit;
+					hit.id = mTriangleIds[i];
+					hit.t = hitInfo.t;
+					outHits.push_back(hit);
+				}
+			}
+		}
+		else
+		{
+			stack[stackSize++] = node.offset;
+			stack[stackSize++] = node.offset + 1;
+		}
+	}
+}
+
+void TriangleBVH::BuildNode(int nodeIndex, int offset, int count)
+{
+	// Calculate bounds of all triangles, and bounds of triangle centers.
+	// Center bounds are used to pick a split axis - triangle bounds can overlap a lot, centers don't.
+	Vector3 min(FLT_MAX, FLT_MAX, FLT_MAX);
+	Vector3 max(-FLT_MAX, -FLT_MAX, -FLT_MAX);
+	Vector3 centerMin = min;
+	Vector3 centerMax = max;
+	for(int i = offset; i < offset + count; ++i)
+	{
+		const Triangle& triangle = mUnbuiltTriangles[i];
+		Vector3 center = (triangle.p0 + triangle.p1 + triangle.p2) / 3.0f;
+		for(int axis = 0; axis < 3; ++axis)
+		{
+			min[axis] = Math::Min(min[axis], Math::Min(triangle.p0[axis], Math::Min(triangle.p1[axis], triangle.p2[axis])));
+			max[axis] = Math::Max(max[axis], Math::Max(triangle.p0[axis], Math::Max(triangle.p1[axis], triangle.p2[axis])));
+			centerMin[axis] = Math::Min(centerMin[axis], center[axis]);
+			centerMax[axis] = Math::Max(centerMax[axis], center[axis]);
+		}
+	}
+	mNodes[nodeIndex].min = min;
+	mNodes[nodeIndex].max = max;
+
+	// Few enough triangles? Make this a leaf.
+	Vector3 centerSize = centerMax - centerMin;
+	if(count <= kMaxLeafTriangles || (centerSize.x <= 0.0f && centerSize.y <= 0.0f && centerSize.z <= 0.0f))
+	{
+		mNodes[nodeIndex].offset = offset;
+		mNodes[nodeIndex].count = count;
+		return;
+	}
+
+	// Split along the longest axis at the median triangle, which guarantees a balanced tree.
+	int axis = 0;
+	if(centerSize.y > centerSize[axis]) { axis = 1; }
+	if(centerSize.z > centerSize[axis]) { axis = 2; }
+	int half = count / 2;
+	std::nth_element(mUnbuiltTriangles.begin() + offset, mUnbuiltTriangles.begin() + offset + half, mUnbuiltTriangles.begin() + offset + count,
+					 [axis](const Triangle& a, const Triangle& b) {
+						 return (a.p0[axis] + a.p1[axis] + a.p2[axis]) < (b.p0[axis] + b.p1[axis] + b.p2[axis]);
+					 });
+
+	// Children are always allocated as a pair. Careful: emplace_back may invalidate node references.
+	int leftIndex = static_cast<int>(mNodes.size());
+	mNodes.emplace_back();
+	mNodes.emplace_back();
+	mNodes[nodeIndex].offset = leftIndex;
+	mNodes[nodeIndex].count = 0;
+
+	BuildNode(leftIndex, offset, half);
+	BuildNode(leftIndex + 1, offset + half, count - half);
+}
+
+/*static*/ bool TriangleBVH::TestRayBounds(const Vector3& origin, const Vector3& inverseDirection, const Node& node, float maxT, float& outT)
+{
+	// Standard "slab" test - intersect ray with each pair of axis planes, and see whether the overlapping ranges agree.
+	float tMin = 0.0f;
+	float tMax = maxT;
+	for(int axis = 0; axis < 3; ++axis)
+	{
+		float t1 = (node.min[axis] - origin[axis]) * inverseDirection[axis];
+		float t2 = (node.max[axis] - origin[axis]) * inverseDirection[axis];
+
+		// If the ray is parallel to this axis AND on a slab plane, this is 0 * infinity (NaN).
+		// Min/Max with NaN ignores that axis, which is fine - ray is touching the box edge.
+		tMin = Math::Max(tMin, Math::Min(t1, t2));
+		tMax = Math::Min(tMax, Math::Max(t1, t2));
+	}
+	outT = tMin;
+	return tMin <= tMax;
+}
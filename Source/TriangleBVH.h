@@ -0,0 +1,90 @@
+//
+// TriangleBVH.h
+//
+// Clark Kromenaker
+//
+// A "bounding volume hierarchy" over a set of triangles.
+// Triangles are grouped into a tree of nested AABBs, so a ray only needs to
+// test triangles inside boxes it actually passes through. This makes raycasts
+// roughly logarithmic in the number of triangles, rather than linear.
+//
+// Each triangle is tagged with an ID (e.g. a polygon index) so callers can
+// map a hit back to whatever the triangle belongs to.
+//
+#pragma once
+#include <functional>
+#include <vector>
+
+#include "Collisions.h"
+#include "TriangleBatch.h"
+#include "Vector3.h"
+
+class Ray;
+
+class TriangleBVH
+{
+public:
+	struct Hit
+	{
+		// ID of triangle that was hit.
+		int id = -1;
+
+		// The "t" value at which the hit occurred.
+		float t = FLT_MAX;
+	};
+
+	// Optional filter for raycasts - return false to ignore triangles with the given ID.
+	typedef std::function<bool(int)> Filter;
+
+	// Triangles must all be added before calling Build.
+	void AddTriangle(const Vector3& p0, const Vector3& p1, const Vector3& p2, int id);
+	void Build();
+
+	void Clear();
+	bool IsEmpty() const { return mTriangleIds.empty(); }
+
+	bool RaycastNearest(const Ray& ray, Hit& outHit, const Filter& filter = nullptr) const;
+	void RaycastAll(const Ray& ray, std::vector<Hit>& outHits, const Filter& filter = nullptr) const;
+
+	int GetTriangleCount() const { return static_cast<int>(mTriangleIds.size()); }
+	int GetNodeCount() const { return static_cast<int>(mNodes.size()); }
+
+private:
+	struct Triangle
+	{
+		Vector3 p0;
+		Vector3 p1;
+		Vector3 p2;
+		int id = -1;
+	};
+
+	struct Node
+	{
+		// Bounds of all triangles under this node.
+		Vector3 min;
+		Vector3 max;
+
+		// For leaf nodes, offset + count into triangle list.
+		// For inner nodes, count is zero and offset is the index of the left child (right child immediately follows).
+		int offset = 0;
+		int count = 0;
+	};
+
+	// Leaves hold at most this many triangles.
+	static const int kMaxLeafTriangles = 8;
+
+	// Triangles that have been added, but not yet built into the tree.
+	std::vector<Triangle> mUnbuiltTriangles;
+
+	// Triangles and their IDs, sorted during build so each leaf's triangles are contiguous.
+	// Leaf triangles are tested as a batch, using SIMD when available.
+	TriangleBatch mTriangles;
+	std::vector<int> mTriangleIds;
+
+	// Tree nodes - root is at index zero.
+	std::vector<Node> mNodes;
+
+	void BuildNode(int nodeIndex, int offset, int count);
+
+	static bool TestRayBounds(const Vector3& origin, const Vector3& inverseDirection, const Node& node, float maxT, float& outT);
+};
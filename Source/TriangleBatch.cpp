@@ -0,0 +1,50 @@
+//
+// TriangleBatch.cpp
+//
+// Clark Kromenaker
+//
+#include "TriangleBatch.h"
+
+void TriangleBatch::Add(const Vector3& p0, const Vector3& p1, const Vector3& p2)
+{
+	mP0X.push_back(p0.x);
+	mP0Y.push_back(p0.y);
+	mP0Z.push_back(p0.z);
+
+	// Calculated the same way as the single triangle test, so results match exactly.
+	Vector3 e1 = p1 - p0;
+	mEdge1X.push_back(e1.x);
+	mEdge1Y.push_back(e1.y);
+	mEdge1Z.push_back(e1.z);
+
+	Vector3 e2 = p2 - p0;
+	mEdge2X.push_back(e2.x);
+	mEdge2Y.push_back(e2.y);
+	mEdge2Z.push_back(e2.z);
+}
+
+void TriangleBatch::Reserve(int count)
+{
+	mP0X.reserve(count);
+	mP0Y.reserve(count);
+	mP0Z.reserve(count);
+	mEdge1X.reserve(count);
+	mEdge1Y.reserve(count);
+	mEdge1Z.reserve(count);
+	mEdge2X.reserve(count);
+	mEdge2Y.reserve(count);
+	mEdge2Z.reserve(count);
+}
+
+void TriangleBatch::Clear()
+{
+	mP0X.clear();
+	mP0Y.clear();
+	mP0Z.clear();
+	mEdge1X.clear();
+	mEdge1Y.clear();
+	mEdge1Z.clear();
+	mEdge2X.clear();
+	mEdge2Y.clear();
+	mEdge2Z.clear();
+}
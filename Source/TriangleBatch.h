@@ -0,0 +1,53 @@
+//
+// TriangleBatch.h
+//
+// Clark Kromenaker
+//
+// A list of triangles stored as "structure of arrays" - each component of each
+// point lives in its own array. This lets SIMD code load the same component of
+// several triangles at once, so many triangles can be tested in parallel.
+//
+// Rather than storing all three points, each triangle stores its first point and the
+// two edges from that point, since that's what intersection tests need anyway.
+//
+#pragma once
+#include <vector>
+
+#include "Vector3.h"
+
+class TriangleBatch
+{
+public:
+	void Add(const Vector3& p0, const Vector3& p1, const Vector3& p2);
+	void Reserve(int count);
+	void Clear();
+
+	int GetCount() const { return static_cast<int>(mP0X.size()); }
+
+	// Raw component arrays, each with GetCount() elements.
+	const float* GetP0X() const { return mP0X.data(); }
+	const float* GetP0Y() const { return mP0Y.data(); }
+	const float* GetP0Z() const { return mP0Z.data(); }
+	const float* GetEdge1X() const { return mEdge1X.data(); }
+	const float* GetEdge1Y() const { return mEdge1Y.data(); }
+	const float* GetEdge1Z() const { return mEdge1Z.data(); }
+	const float* GetEdge2X() const { return mEdge2X.data(); }
+	const float* GetEdge2Y() const { return mEdge2Y.data(); }
+	const float* GetEdge2Z() const { return mEdge2Z.data(); }
+
+private:
+	// First point of each triangle.
+	std::vector<float> mP0X;
+	std::vector<float> mP0Y;
+	std::vector<float> mP0Z;
+
+	// Edge from p0 to p1.
+	std::vector<float> mEdge1X;
+	std::vector<float> mEdge1Y;
+	std::vector<float> mEdge1Z;
+
+	// Edge from p0 to p2.
+	std::vector<float> mEdge2X;
+	std::vector<float> mEdge2Y;
+	std::vector<float> mEdge2Z;
+};
@@ -108,6 +108,12 @@ VerbManager::VerbManager()
 			
 			// Insert mapping from keyword to the button icons.
 			map->insert({ keyword, buttonIcon });
+			
+			// Verb icons are used for the whole game, so the textures must stay loaded across scenes.
+			Services::GetAssets()->AcquireAsset(upTexture);
+			Services::GetAssets()->AcquireAsset(downTexture);
+			Services::GetAssets()->AcquireAsset(hoverTexture);
+			Services::GetAssets()->AcquireAsset(disableTexture);
 		}
 	}
 	delete[] buffer;
@@ -5,6 +5,7 @@
 //
 #include "VertexAnimation.h"
 
+#include <algorithm>
 #include <cassert>
 #include <iostream>
 #include <vector>
@@ -16,78 +17,86 @@
 
 //#define DEBUG_OUTPUT
 
-VertexAnimation::VertexAnimation(std::string name, char* data, int dataLength) : Asset(name)
+// SSE is guaranteed on all x64 CPUs. Other targets (e.g. ARM) use the scalar path.
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+	#define VERTEX_ANIMATION_USE_SSE
+	#include <xmmintrin.h>
+#endif
+
+// Finds the two keyframes to interpolate between at a time, and how far (0 to 1) the time is between them.
+// Frame numbers must be in order. After the last keyframe, the last keyframe is used.
+static void FindKeyframes(const int* frameNumbers, int keyframeCount, float localTime, int framesPerSecond, int& outCurrentIndex, int& outNextIndex, float& outT)
 {
-    ParseFromData(data, dataLength);
+	// Calculate how many seconds should be used for a single frame.
+	float secondsPerFrame = 1.0f / framesPerSecond;
+	
+	// The current keyframe is the last one at or before the time, which is just before the first one after the time.
+	const int* it = std::upper_bound(frameNumbers, frameNumbers + keyframeCount, localTime, [secondsPerFrame](float time, int frameNumber) {
+		return time < secondsPerFrame * frameNumber;
+	});
+	outCurrentIndex = std::max(static_cast<int>(it - frameNumbers) - 1, 0);
+	
+	// If there is no "next" keyframe, we can either loop to the first keyframe, or "clamp" on the last keyframe.
+	// Testing suggests GK3 expects the "clamp" approach, but more generally, a parameter for this might make sense.
+	outNextIndex = std::min(outCurrentIndex + 1, keyframeCount - 1);
+	
+	// Determine our "t" value between the current and next keyframe.
+	float currentPoseTime = secondsPerFrame * frameNumbers[outCurrentIndex];
+	float nextPoseTime = secondsPerFrame * frameNumbers[outNextIndex];
+	outT = 1.0f;
+	if(!Math::IsZero(nextPoseTime - currentPoseTime))
+	{
+		outT = Math::Clamp((localTime - currentPoseTime) / (nextPoseTime - currentPoseTime), 0.0f, 1.0f);
+	}
 }
 
-Vector3 VertexAnimation::SampleVertexPosition(float time, int framesPerSecond, int meshIndex, int submeshIndex, int vertexIndex)
+// Same math as Vector3::Lerp, but on many floats at once.
+static void LerpFloats(const float* from, const float* to, float t, float* out, int count)
 {
-	float duration = GetDuration(framesPerSecond);
-	float localTime = time;
-	if(localTime > duration)
+	int index = 0;
+	#if defined(VERTEX_ANIMATION_USE_SSE)
+	__m128 fromScale = _mm_set1_ps(1.0f - t);
+	__m128 toScale = _mm_set1_ps(t);
+	for(; index + 4 <= count; index += 4)
 	{
-		localTime = Math::Mod(time, duration);
+		__m128 fromValues = _mm_mul_ps(_mm_loadu_ps(from + index), fromScale);
+		__m128 toValues = _mm_mul_ps(_mm_loadu_ps(to + index), toScale);
+		_mm_storeu_ps(out + index, _mm_add_ps(fromValues, toValues));
 	}
+	#endif
 	
-	float currentPoseTime = 0.0f;
-    float nextPoseTime = 0.0f;
-	
-	// Find the first vertex pose defined for this mesh/submesh.
-	VertexAnimationVertexPose* firstVertexPose = nullptr;
-	auto it = mVertexPoses.find(meshIndex);
-	if(it != mVertexPoses.end())
+	// Scalar path - handles any floats left over from SIMD path, or all floats if SIMD isn't available.
+	for(; index < count; ++index)
 	{
-		auto it2 = it->second.find(submeshIndex);
-		if(it2 != it->second.end())
-		{
-			firstVertexPose = it2->second;
-		}
+		out[index] = ((1.0f - t) * from[index]) + (t * to[index]);
 	}
-	
-	// If no vertex pose was found, we'll have to return an error state.
-	if(firstVertexPose == nullptr)
+}
+
+// Every keyframe in a track needs the same number of vertices. If a keyframe is missing some, the previous keyframe's positions fill the gap.
+static void FillKeyframe(std::vector<Vector3>& positions, size_t keyframeCount, int vertexCount)
+{
+	size_t positionCount = keyframeCount * vertexCount;
+	while(positions.size() < positionCount)
 	{
-		return Vector3::Zero;
+		Vector3 position = positions.size() >= vertexCount ? positions[positions.size() - vertexCount] : Vector3::Zero;
+		positions.push_back(position);
 	}
-	
-	// Calculate how many seconds should be used for a single frame - used later.
-    float secondsPerFrame = 1.0f / framesPerSecond;
-	
-	// Determine the poses right before the desired local time on the animation.
-    VertexAnimationVertexPose* currentVertexPose = firstVertexPose;
-    while(currentVertexPose->mNext != nullptr)
-    {
-        currentPoseTime = secondsPerFrame * currentVertexPose->mFrameNumber;
-        nextPoseTime = secondsPerFrame * currentVertexPose->mNext->mFrameNumber;
-        if(nextPoseTime > localTime) { break; }
-		
-        currentVertexPose = currentVertexPose->mNext;
-    }
-	
-	// Get the next pose, after the desired local time.
-	// If it doesn't exist, loop back to the first pose.
-    VertexAnimationVertexPose* nextVertexPose = currentVertexPose->mNext;
-    if(nextVertexPose == nullptr)
-    {
-		nextVertexPose = currentVertexPose;
-		nextPoseTime = currentPoseTime;
-    }
-    
-    // Determine our "t" value between the current and next pose.
-    float t = 1.0f;
-    if(!Math::IsZero(nextPoseTime - currentPoseTime))
-    {
-        t = (localTime - currentPoseTime) / (nextPoseTime - currentPoseTime);
-    }
-    assert(t >= 0.0f && t <= 1.0f);
-	
-    // Now calculate interpolated positions between current and next poses for this time t.
-	return Vector3::Lerp(currentVertexPose->mVertexPositions[vertexIndex], nextVertexPose->mVertexPositions[vertexIndex], t);
 }
 
-VertexAnimationVertexPose VertexAnimation::SampleVertexPose(float time, int framesPerSecond, int meshIndex, int submeshIndex)
+VertexAnimation::VertexAnimation(std::string name, char* data, int dataLength) : Asset(name)
 {
+    ParseFromData(data, dataLength);
+}
+
+Vector3 VertexAnimation::SampleVertexPosition(float time, int framesPerSecond, int meshIndex, int submeshIndex, int vertexIndex) const
+{
+	// If no vertex pose was found, we'll have to return an error state.
+	const Track* track = GetVertexTrack(meshIndex, submeshIndex);
+	if(track == nullptr || vertexIndex < 0 || vertexIndex >= track->vertexCount)
+	{
+		return Vector3::Zero;
+	}
+	
 	float duration = GetDuration(framesPerSecond);
 	float localTime = time;
 	if(localTime > duration)
@@ -95,78 +104,67 @@ VertexAnimationVertexPose VertexAnimation::SampleVertexPose(float time, int fram
 		localTime = Math::Mod(time, duration);
 	}
 	
-    float currentPoseTime = 0.0f;
-    float nextPoseTime = 0.0f;
+	// Determine the keyframes on either side of the desired local time on the animation.
+	int currentIndex = 0;
+	int nextIndex = 0;
+	float t = 0.0f;
+	FindKeyframes(&mVertexFrameNumbers[track->firstKeyframe], track->keyframeCount, localTime, framesPerSecond, currentIndex, nextIndex, t);
 	
-	// Find the first vertex pose defined for this mesh/submesh.
-	VertexAnimationVertexPose* firstVertexPose = nullptr;
-	auto it = mVertexPoses.find(meshIndex);
-	if(it != mVertexPoses.end())
+    // Now calculate interpolated position between current and next keyframes for this time t.
+	const float* current = GetVertexPositions(*track, currentIndex) + vertexIndex * 3;
+	const float* next = GetVertexPositions(*track, nextIndex) + vertexIndex * 3;
+	return Vector3::Lerp(Vector3(current[0], current[1], current[2]), Vector3(next[0], next[1], next[2]), t);
+}
+
+bool VertexAnimation::SampleVertexPose(float time, int framesPerSecond, int meshIndex, int submeshIndex, float* outPositions, int vertexCount) const
+{
+	// If no vertex pose was found, there's nothing to sample.
+	VertexAnimationKeyframes keyframes;
+	if(!SampleVertexKeyframes(time, framesPerSecond, meshIndex, submeshIndex, keyframes))
 	{
-		auto it2 = it->second.find(submeshIndex);
-		if(it2 != it->second.end())
-		{
-			firstVertexPose = it2->second;
-		}
+		return false;
 	}
 	
-	// If no vertex pose was found, we'll have to return an error state.
-	if(firstVertexPose == nullptr)
+    // Now calculate interpolated positions between current and next keyframes for this time t.
+	int count = std::min(vertexCount, keyframes.vertexCount);
+	LerpFloats(&mVertexPositions[keyframes.fromOffset], &mVertexPositions[keyframes.toOffset], keyframes.t, outPositions, count * 3);
+    return true;
+}
+
+bool VertexAnimation::SampleVertexKeyframes(float time, int framesPerSecond, int meshIndex, int submeshIndex, VertexAnimationKeyframes& outKeyframes) const
+{
+	const Track* track = GetVertexTrack(meshIndex, submeshIndex);
+	if(track == nullptr)
 	{
-		VertexAnimationVertexPose pose;
-		pose.mFrameNumber = -1;
-		return pose;
+		return false;
 	}
 	
-	// Calculate how many seconds should be used for a single frame - used later.
-    float secondsPerFrame = 1.0f / framesPerSecond;
-	
-	// Determine the poses right before the desired local time on the animation.
-    VertexAnimationVertexPose* currentVertexPose = firstVertexPose;
-    while(currentVertexPose->mNext != nullptr)
-    {
-        currentPoseTime = secondsPerFrame * currentVertexPose->mFrameNumber;
-        nextPoseTime = secondsPerFrame * currentVertexPose->mNext->mFrameNumber;
-        if(nextPoseTime > localTime) { break; }
-		
-        currentVertexPose = currentVertexPose->mNext;
-    }
-	
-	// Get the next pose, after the desired local time.
-	// If it doesn't exist, loop back to the first pose.
-    VertexAnimationVertexPose* nextVertexPose = currentVertexPose->mNext;
-    if(nextVertexPose == nullptr)
-    {
-		// Clamp approach.
-		nextVertexPose = currentVertexPose;
-		nextPoseTime = currentPoseTime;
-		
-		// Loop approach.
-        //nextVertexPose = firstVertexPose;
-        //nextPoseTime = GetDuration(framesPerSecond);
-    }
-    
-    // Determine our "t" value between the current and next pose.
-    float t = 1.0f;
-    if(!Math::IsZero(nextPoseTime - currentPoseTime))
-    {
-        t = (localTime - currentPoseTime) / (nextPoseTime - currentPoseTime);
-    }
-    assert(t >= 0.0f && t <= 1.0f);
+	float duration = GetDuration(framesPerSecond);
+	float localTime = time;
+	if(localTime > duration)
+	{
+		localTime = Math::Mod(time, duration);
+	}
 	
-    // Now calculate interpolated positions between current and next poses for this time t.
-	VertexAnimationVertexPose pose;
-    for(int i = 0; i < currentVertexPose->mVertexPositions.size(); i++)
-    {
-        pose.mVertexPositions.push_back(Vector3::Lerp(currentVertexPose->mVertexPositions[i], nextVertexPose->mVertexPositions[i], t));
-    }
-    return pose;
+	// Determine the keyframes on either side of the desired local time on the animation.
+	int currentIndex = 0;
+	int nextIndex = 0;
+	FindKeyframes(&mVertexFrameNumbers[track->firstKeyframe], track->keyframeCount, localTime, framesPerSecond, currentIndex, nextIndex, outKeyframes.t);
+	outKeyframes.fromOffset = track->positionsOffset + currentIndex * track->vertexCount * 3;
+	outKeyframes.toOffset = track->positionsOffset + nextIndex * track->vertexCount * 3;
+	outKeyframes.vertexCount = track->vertexCount;
+	return true;
 }
 
-VertexAnimationTransformPose VertexAnimation::SampleTransformPose(float time, int framesPerSecond, int meshIndex)
+VertexAnimationTransformPose VertexAnimation::SampleTransformPose(float time, int framesPerSecond, int meshIndex) const
 {
-	// Calculate how many seconds should be used for a single frame.
-	float secondsPerFrame = 1.0f / framesPerSecond;
+	// If no transform pose was found, return an error state.
+	VertexAnimationTransformPose pose;
+	if(meshIndex < 0 || meshIndex >= mTransformTracks.size() || mTransformTracks[meshIndex].keyframeCount == 0)
+	{
+		pose.mFrameNumber = -1;
+		return pose;
+	}
 	
 	// Caller may pass in a global time that extends beyond the local time of this particular animation.
 	// Desire here is for the animation to "loop", so we calculate how many seconds in we are.
@@ -177,49 +175,21 @@ VertexAnimationTransformPose VertexAnimation::SampleTransformPose(float time, in
 		localTime = Math::Mod(time, duration);
 	}
 	
-	// Determine between which two transform poses the desired local time is located.
-	// E.g. if local time is 50% between pose 5 and 6, we  want to interpolate 50% between those two poses.
-    float currentPoseTime = 0.0f;
-    float nextPoseTime = 0.0f;
-    VertexAnimationTransformPose* firstTransformPose = mTransformPoses[meshIndex];
-    VertexAnimationTransformPose* currentTransformPose = firstTransformPose;
-    while(currentTransformPose->mNext != nullptr)
-    {
-        currentPoseTime = secondsPerFrame * currentTransformPose->mFrameNumber;
-        nextPoseTime = secondsPerFrame * currentTransformPose->mNext->mFrameNumber;
-        if(nextPoseTime > localTime) { break; }
-        
-        // Move on to next one.
-        currentTransformPose = currentTransformPose->mNext;
-    }
-	
-	// If there is no "next" pose, we can either loop to the first pose, or "clamp" on the last pose.
-	// Testing suggests GK3 expects the "clamp" approach, but more generally, a parameter for this might make sense.
-    VertexAnimationTransformPose* nextTransformPose = currentTransformPose->mNext;
-    if(nextTransformPose == nullptr)
-    {
-		// Clamp approach.
-		nextTransformPose = currentTransformPose;
-		nextPoseTime = currentPoseTime;
-		
-		// Loop approach.
-        //nextTransformPose = firstTransformPose;
-        //nextPoseTime = GetDuration(framesPerSecond);
-    }
-	
-    // Determine our "t" value between the prev and next pose.
-    float t = 1.0f;
-	if(!Math::IsZero(nextPoseTime - currentPoseTime))
-    {
-        t = (localTime - currentPoseTime) / (nextPoseTime - currentPoseTime);
-    }
-    assert(t >= 0.0f && t <= 1.0f);
+	// Determine between which two transform keyframes the desired local time is located.
+	// E.g. if local time is 50% between keyframe 5 and 6, we  want to interpolate 50% between those two keyframes.
+	const Track& track = mTransformTracks[meshIndex];
+	int currentIndex = 0;
+	int nextIndex = 0;
+	float t = 0.0f;
+	FindKeyframes(&mTransformFrameNumbers[track.firstKeyframe], track.keyframeCount, localTime, framesPerSecond, currentIndex, nextIndex, t);
+	currentIndex += track.firstKeyframe;
+	nextIndex += track.firstKeyframe;
 	
-	// Finally, create a pose with lerp/slerp that is interpolated between the two poses.
-    VertexAnimationTransformPose pose;
-    pose.mLocalPosition = Vector3::Lerp(currentTransformPose->mLocalPosition, nextTransformPose->mLocalPosition, t);
-	pose.mLocalScale = Vector3::Lerp(currentTransformPose->mLocalScale, nextTransformPose->mLocalScale, t);
-    Quaternion::Slerp(pose.mLocalRotation, currentTransformPose->mLocalRotation, nextTransformPose->mLocalRotation, t);
+	// Finally, create a pose with lerp/slerp that is interpolated between the two keyframes.
+	pose.mFrameNumber = mTransformFrameNumbers[currentIndex];
+    pose.mLocalPosition = Vector3::Lerp(mTransformPositions[currentIndex], mTransformPositions[nextIndex], t);
+	pose.mLocalScale = Vector3::Lerp(mTransformScales[currentIndex], mTransformScales[nextIndex], t);
+    Quaternion::Slerp(pose.mLocalRotation, mTransformRotations[currentIndex], mTransformRotations[nextIndex], t);
     return pose;
 }
 
@@ -269,8 +239,16 @@ void VertexAnimation::ParseFromData(char *data, int dataLength)
         offsets.push_back(reader.ReadUInt());
     }
     
-    std::unordered_map<int, VertexAnimationVertexPose*> lastVertexPoseLookup;
-    std::unordered_map<int, VertexAnimationTransformPose*> lastTransformPoseLookup;
+    // Each track's keyframes are spread throughout the file, mixed in with other tracks' keyframes.
+    // So, each track's keyframes are collected here first, then packed together once everything is read.
+    struct VertexTrackData
+    {
+        std::vector<int> frameNumbers;
+        std::vector<Vector3> positions;
+        int vertexCount = 0;
+    };
+    std::vector<std::vector<VertexTrackData>> vertexTrackData(meshCount);
+    std::vector<std::vector<VertexAnimationTransformPose>> transformPoses(meshCount);
 	
 	// Read in data for each keyframe.
     for(int i = 0; i < mFrameCount; i++)
@@ -322,29 +300,24 @@ void VertexAnimation::ParseFromData(char *data, int dataLength)
                     std::cout << "        Submesh Index: " << submeshIndex << std::endl;
                     #endif
 					
-					// This is a pretty sorry hash...but assuming we'll never
-					// have more than 1000 submeshes (pretty likely for GK3), this'll do OK.
-                    int hash = meshIndex * 1000 + submeshIndex;
-					
-					// Create a vertex pose for this frame and stick it in our dictionary and linked list.
-                    VertexAnimationVertexPose* vertexPose = new VertexAnimationVertexPose();
-                    vertexPose->mFrameNumber = i;
-                    if(i == 0)
-                    {
-                        mVertexPoses[meshIndex][submeshIndex] = vertexPose;
-                        lastVertexPoseLookup[hash] = vertexPose;
-                    }
-                    else
-                    {
-                        lastVertexPoseLookup[hash]->mNext = vertexPose;
-                        lastVertexPoseLookup[hash] = vertexPose;
-                    }
-                    
                     // 2 bytes: Vertex count.
                     unsigned short vertexCount = reader.ReadUShort();
                     #ifdef DEBUG_OUTPUT
                     std::cout << "        Vertex Count: " << vertexCount << std::endl;
                     #endif
+					
+					// Add a keyframe for this frame to the submesh's track.
+					// The first keyframe decides how many vertices every keyframe in the track has.
+                    if(vertexTrackData[meshIndex].size() <= submeshIndex)
+                    {
+                        vertexTrackData[meshIndex].resize(submeshIndex + 1);
+                    }
+                    VertexTrackData& trackData = vertexTrackData[meshIndex][submeshIndex];
+                    if(trackData.frameNumbers.empty())
+                    {
+                        trackData.vertexCount = vertexCount;
+                    }
+                    trackData.frameNumbers.push_back(i);
                     
                     // Next, three floats per vertex (X, Y, Z).
                     for(int k = 0; k < vertexCount; k++)
@@ -352,8 +325,12 @@ void VertexAnimation::ParseFromData(char *data, int dataLength)
                         float x = reader.ReadFloat();
 						float z = reader.ReadFloat();
                         float y = reader.ReadFloat();
-                        vertexPose->mVertexPositions.push_back(Vector3(x, y, z));
+                        if(k < trackData.vertexCount)
+                        {
+                            trackData.positions.push_back(Vector3(x, y, z));
+                        }
                     }
+                    FillKeyframe(trackData.positions, trackData.frameNumbers.size(), trackData.vertexCount);
                 }
                 // Identifier 1 also is vertex data, but in a compressed format.
                 else if(dataId == 1)
@@ -373,22 +350,15 @@ void VertexAnimation::ParseFromData(char *data, int dataLength)
                     #endif
                     
                     // Find position data from last recorded frame.
-                    int hash = meshIndex * 1000 + submeshIndex;
-                    std::vector<Vector3>& prevPositions = lastVertexPoseLookup[hash]->mVertexPositions;
+                    // Compressed data is relative to a previous frame, so there must be one.
+                    assert(vertexTrackData[meshIndex].size() > submeshIndex);
+                    VertexTrackData& trackData = vertexTrackData[meshIndex][submeshIndex];
+                    assert(!trackData.frameNumbers.empty());
+                    size_t prevPositionsIndex = trackData.positions.size() - trackData.vertexCount;
 					
-					// Create a vertex pose to hold this new data and insert it into the vertex pose chain.
-                    VertexAnimationVertexPose* vertexPose = new VertexAnimationVertexPose();
-                    vertexPose->mFrameNumber = i;
-                    if(i == 0)
-                    {
-						mVertexPoses[meshIndex][submeshIndex] = vertexPose;
-                        lastVertexPoseLookup[hash] = vertexPose;
-                    }
-                    else
-                    {
-                        lastVertexPoseLookup[hash]->mNext = vertexPose;
-                        lastVertexPoseLookup[hash] = vertexPose;
-                    }
+					// Add a keyframe to hold this new data to the submesh's track.
+                    trackData.frameNumbers.push_back(i);
+                    trackData.positions.reserve(trackData.positions.size() + trackData.vertexCount);
 					
                     // 2 bytes: Vertex count.
                     unsigned short vertexCount = reader.ReadUShort();
@@ -431,11 +401,13 @@ void VertexAnimation::ParseFromData(char *data, int dataLength)
                     // Now that we have deciphered how each vertex is compressed, we can read in each vertex.
                     for(int k = 0; k < vertexCount; k++)
                     {
+                        Vector3 delta;
+						
 						// 0 means no vertex data, so just use whatever we had for the previous frame.
 						// If the vertex data hasn't changed since last frame, it isn't stored, to save space.
                         if(vertexDataFormat[k] == 0)
                         {
-                            vertexPose->mVertexPositions.push_back(prevPositions[k]);
+                            delta = Vector3::Zero;
                         }
                         // 1 means (X, Y, Z) are compressed in next 3 bytes.
 						// This tends to be used for storing vertex position delta for internal vertices in a mesh.
@@ -444,7 +416,7 @@ void VertexAnimation::ParseFromData(char *data, int dataLength)
                             float x = DecompressFloatFromByte(reader.ReadByte());
 							float z = DecompressFloatFromByte(reader.ReadByte());
                             float y = DecompressFloatFromByte(reader.ReadByte());
-                            vertexPose->mVertexPositions.push_back(prevPositions[k] + Vector3(x, y, z));
+                            delta = Vector3(x, y, z);
                         }
                         // 2 means (X, Y, Z) are compressed in next 3 ushorts.
 						// This tends to be used for storing vertex position deltas where meshes meet (like a knee or elbow).
@@ -453,7 +425,7 @@ void VertexAnimation::ParseFromData(char *data, int dataLength)
                             float x = DecompressFloatFromUShort(reader.ReadUShort());
 							float z = DecompressFloatFromUShort(reader.ReadUShort());
 							float y = DecompressFloatFromUShort(reader.ReadUShort());
-							vertexPose->mVertexPositions.push_back(prevPositions[k] + Vector3(x, y, z));
+                            delta = Vector3(x, y, z);
                         }
                         // 3 means (X, Y, Z) are not compressed - just floats.
                         else if(vertexDataFormat[k] == 3)
@@ -461,9 +433,16 @@ void VertexAnimation::ParseFromData(char *data, int dataLength)
                             float x = reader.ReadFloat();
 							float z = reader.ReadFloat();
                             float y = reader.ReadFloat();
-                            vertexPose->mVertexPositions.push_back(prevPositions[k] + Vector3(x, y, z));
+                            delta = Vector3(x, y, z);
+                        }
+						
+						// Deltas are relative to the same vertex in the previous keyframe.
+                        if(k < trackData.vertexCount)
+                        {
+                            trackData.positions.push_back(trackData.positions[prevPositionsIndex + k] + delta);
                         }
                     }
+                    FillKeyframe(trackData.positions, trackData.frameNumbers.size(), trackData.vertexCount);
                     
                     // Don't need these anymore!
                     delete[] compressionInfo;
@@ -519,21 +498,12 @@ void VertexAnimation::ParseFromData(char *data, int dataLength)
                     std::cout << "        Mesh Position: " << meshPos << std::endl;
                     #endif
                     
-                    VertexAnimationTransformPose* transformPose = new VertexAnimationTransformPose();
-                    transformPose->mFrameNumber = i;
-                    transformPose->mLocalPosition = meshPos;
-                    transformPose->mLocalRotation = rotQuat;
-					transformPose->mLocalScale = scale;
-                    if(i == 0)
-                    {
-                        mTransformPoses.push_back(transformPose);
-                        lastTransformPoseLookup[meshIndex] = transformPose;
-                    }
-                    else
-                    {
-                        lastTransformPoseLookup[meshIndex]->mNext = transformPose;
-                        lastTransformPoseLookup[meshIndex] = transformPose;
-                    }
+                    transformPoses[meshIndex].emplace_back();
+                    VertexAnimationTransformPose& transformPose = transformPoses[meshIndex].back();
+                    transformPose.mFrameNumber = i;
+                    transformPose.mLocalPosition = meshPos;
+                    transformPose.mLocalRotation = rotQuat;
+					transformPose.mLocalScale = scale;
                 }
                 // Identifier 3 is min/max data.
                 else if(dataId == 3)
@@ -566,6 +536,85 @@ void VertexAnimation::ParseFromData(char *data, int dataLength)
             } // while(byteCount > 0)
         } // iterate mesh groups
     } // iterate keyframes
+	
+	// Pack vertex keyframes together, with each mesh's tracks in submesh order.
+	// Arrays are sized exactly up front, since animations stay loaded for a while, and there are a lot of them.
+	int vertexTrackCount = 0;
+	size_t vertexKeyframeCount = 0;
+	size_t vertexPositionCount = 0;
+	for(auto& meshTrackData : vertexTrackData)
+	{
+		vertexTrackCount += meshTrackData.size();
+		for(auto& trackData : meshTrackData)
+		{
+			vertexKeyframeCount += trackData.frameNumbers.size();
+			vertexPositionCount += trackData.positions.size() * 3;
+		}
+	}
+	mVertexTracks.reserve(vertexTrackCount);
+	mVertexTrackOffsets.reserve(meshCount + 1);
+	mVertexFrameNumbers.reserve(vertexKeyframeCount);
+	mVertexPositions.reserve(vertexPositionCount);
+	for(auto& meshTrackData : vertexTrackData)
+	{
+		mVertexTrackOffsets.push_back(static_cast<int>(mVertexTracks.size()));
+		for(auto& trackData : meshTrackData)
+		{
+			Track track;
+			track.firstKeyframe = static_cast<int>(mVertexFrameNumbers.size());
+			track.keyframeCount = static_cast<int>(trackData.frameNumbers.size());
+			track.vertexCount = trackData.vertexCount;
+			track.positionsOffset = static_cast<int>(mVertexPositions.size());
+			mVertexTracks.push_back(track);
+			
+			mVertexFrameNumbers.insert(mVertexFrameNumbers.end(), trackData.frameNumbers.begin(), trackData.frameNumbers.end());
+			for(auto& position : trackData.positions)
+			{
+				mVertexPositions.push_back(position.x);
+				mVertexPositions.push_back(position.y);
+				mVertexPositions.push_back(position.z);
+			}
+		}
+	}
+	mVertexTrackOffsets.push_back(static_cast<int>(mVertexTracks.size()));
+	
+	// Same for transform keyframes, with one track per mesh.
+	size_t transformKeyframeCount = 0;
+	for(auto& meshTransformPoses : transformPoses)
+	{
+		transformKeyframeCount += meshTransformPoses.size();
+	}
+	mTransformTracks.reserve(meshCount);
+	mTransformFrameNumbers.reserve(transformKeyframeCount);
+	mTransformPositions.reserve(transformKeyframeCount);
+	mTransformRotations.reserve(transformKeyframeCount);
+	mTransformScales.reserve(transformKeyframeCount);
+	for(auto& meshTransformPoses : transformPoses)
+	{
+		Track track;
+		track.firstKeyframe = static_cast<int>(mTransformFrameNumbers.size());
+		track.keyframeCount = static_cast<int>(meshTransformPoses.size());
+		mTransformTracks.push_back(track);
+		
+		for(auto& transformPose : meshTransformPoses)
+		{
+			mTransformFrameNumbers.push_back(transformPose.mFrameNumber);
+			mTransformPositions.push_back(transformPose.mLocalPosition);
+			mTransformRotations.push_back(transformPose.mLocalRotation);
+			mTransformScales.push_back(transformPose.mLocalScale);
+		}
+	}
+}
+
+const VertexAnimation::Track* VertexAnimation::GetVertexTrack(int meshIndex, int submeshIndex) const
+{
+	if(meshIndex < 0 || meshIndex + 1 >= mVertexTrackOffsets.size()) { return nullptr; }
+	
+	int trackIndex = mVertexTrackOffsets[meshIndex] + submeshIndex;
+	if(submeshIndex < 0 || trackIndex >= mVertexTrackOffsets[meshIndex + 1]) { return nullptr; }
+	
+	const Track& track = mVertexTracks[trackIndex];
+	return track.keyframeCount > 0 ? &track : nullptr;
 }
 
 float VertexAnimation::DecompressFloatFromByte(unsigned char val)
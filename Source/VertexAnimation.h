@@ -12,19 +12,10 @@
 #include "Asset.h"
 
 #include <vector>
-#include <unordered_map>
 
 #include "Matrix4.h"
 #include "Vector3.h"
 
-struct VertexAnimationVertexPose
-{
-    int mFrameNumber = 0;
-    
-    std::vector<Vector3> mVertexPositions;
-    VertexAnimationVertexPose* mNext = nullptr;
-};
-
 struct VertexAnimationTransformPose
 {
     int mFrameNumber = 0;
@@ -32,8 +23,6 @@ struct VertexAnimationTransformPose
     Quaternion mLocalRotation;
     Vector3 mLocalPosition;
 	Vector3 mLocalScale;
-	
-    VertexAnimationTransformPose* mNext = nullptr;
     
     Matrix4 GetMeshToLocalMatrix()
     {
@@ -43,19 +32,44 @@ struct VertexAnimationTransformPose
     }
 };
 
+// The two keyframes to blend between to get a submesh's vertex pose at some time.
+// Enough for a shader to calculate the pose itself from a GPU copy of the packed vertex positions.
+struct VertexAnimationKeyframes
+{
+	// Offsets (in floats) of each keyframe's first vertex in the packed vertex positions.
+	int fromOffset = 0;
+	int toOffset = 0;
+	
+	// How far (0 to 1) to blend from the "from" keyframe to the "to" keyframe.
+	float t = 0.0f;
+	
+	// Number of vertices in each keyframe.
+	int vertexCount = 0;
+};
+
 class VertexAnimation : public Asset
 {
 public:
     VertexAnimation(std::string name, char* data, int dataLength);
     
 	// Queries the position of a single vertex at a particular time of the animation.
-	Vector3 SampleVertexPosition(float time, int framesPerSecond, int meshIndex, int submeshIndex, int vertexIndex);
+	Vector3 SampleVertexPosition(float time, int framesPerSecond, int meshIndex, int submeshIndex, int vertexIndex) const;
 	
 	// Queries positions of ALL vertices for a submesh at a particular time of the animation.
-	VertexAnimationVertexPose SampleVertexPose(float time, int framesPerSecond, int meshIndex, int submeshIndex);
+	// Positions are written to "outPositions" (x/y/z per vertex), which must have room for "vertexCount" vertices.
+	// Returns false if the animation has no vertex poses for the submesh, in which case nothing is written.
+	bool SampleVertexPose(float time, int framesPerSecond, int meshIndex, int submeshIndex, float* outPositions, int vertexCount) const;
+	
+	// Finds the keyframes to blend between for a submesh's vertex pose at a particular time of the animation, without blending them.
+	// Returns false if the animation has no vertex poses for the submesh.
+	bool SampleVertexKeyframes(float time, int framesPerSecond, int meshIndex, int submeshIndex, VertexAnimationKeyframes& outKeyframes) const;
+	
+	// Positions (x/y/z per vertex) of every vertex keyframe in the animation, which keyframe offsets refer to.
+	const std::vector<float>& GetPackedVertexPositions() const { return mVertexPositions; }
 	
 	// Queries a mesh's transform properties (position, rotation, scale) at a particular time of the animation.
-	VertexAnimationTransformPose SampleTransformPose(float time, int framesPerSecond, int meshIndex);
+	// If the animation has no transform poses for the mesh, the returned pose's frame number is -1.
+	VertexAnimationTransformPose SampleTransformPose(float time, int framesPerSecond, int meshIndex) const;
     
 	// Length and duration.
 	int GetFrameCount() const { return mFrameCount; }
@@ -71,15 +85,39 @@ private:
 	// If we ever play the animation on a mismatched model, the graphics will probably glitch out.
 	std::string mModelName;
     
-	// Each array element is the FIRST vertex pose for each mesh/submesh index.
-	// Subsequent poses for the mesh are stored in the "next" of the first pose.
-	std::unordered_map<int, std::unordered_map<int, VertexAnimationVertexPose*>> mVertexPoses;
+	// The keyframes of one animated submesh (vertex poses) or mesh (transform poses).
+	// Keyframe data for all tracks is packed into the arrays below - a track just says where its keyframes are.
+	struct Track
+	{
+		// Index of the track's first keyframe in the frame number/data arrays, and number of keyframes.
+		int firstKeyframe = 0;
+		int keyframeCount = 0;
+		
+		// For vertex tracks, the number of vertices in each keyframe, and where the first keyframe's positions start.
+		int vertexCount = 0;
+		int positionsOffset = 0;
+	};
+	
+	// Vertex tracks for every mesh's submeshes. Mesh N's tracks start at index mVertexTrackOffsets[N], in submesh order.
+	// A submesh with no vertex poses has a track with no keyframes.
+	std::vector<Track> mVertexTracks;
+	std::vector<int> mVertexTrackOffsets;
 	
-	// Each element of array is the FIRST transform poses for each mesh index.
-	// Subsequent poses for the mesh are stored in the "next" of the first pose.
-    std::vector<VertexAnimationTransformPose*> mTransformPoses;
+	// Frame number of each vertex keyframe, and positions (x/y/z per vertex) for all vertex keyframes.
+	std::vector<int> mVertexFrameNumbers;
+	std::vector<float> mVertexPositions;
+	
+	// Transform tracks, one per mesh. Transform keyframe data is stored as one array per property.
+	std::vector<Track> mTransformTracks;
+	std::vector<int> mTransformFrameNumbers;
+	std::vector<Vector3> mTransformPositions;
+	std::vector<Quaternion> mTransformRotations;
+	std::vector<Vector3> mTransformScales;
     
     void ParseFromData(char* data, int dataLength);
+	
+	const Track* GetVertexTrack(int meshIndex, int submeshIndex) const;
+	const float* GetVertexPositions(const Track& track, int keyframeIndex) const { return &mVertexPositions[track.positionsOffset + keyframeIndex * track.vertexCount * 3]; }
     
     float DecompressFloatFromByte(unsigned char val);
     float DecompressFloatFromUShort(unsigned short val);
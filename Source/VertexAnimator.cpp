@@ -5,20 +5,42 @@
 //
 #include "VertexAnimator.h"
 
+#include <cstring>
 #include <vector>
 
 #include "Actor.h"
+#include "BufferTexture.h"
 #include "Mesh.h"
 #include "MeshRenderer.h"
+#include "Services.h"
 #include "VertexAnimation.h"
 
 TYPE_DEF_CHILD(Component, VertexAnimator);
 
+bool VertexAnimator::sGPUAnimationEnabled = false;
+std::unordered_map<VertexAnimation*, VertexAnimator::PositionsTexture> VertexAnimator::sPositionsTextures;
+
+// Names of vertex animation uniforms in the shader. Kept around as strings, since they're set every frame.
+static const std::string kPositionsUniform = "uVertexAnimPositions";
+static const std::string kFromUniform = "uVertexAnimFrom";
+static const std::string kToUniform = "uVertexAnimTo";
+static const std::string kBlendUniform = "uVertexAnimBlend";
+static const std::string kVertexCountUniform = "uVertexAnimVertexCount";
+
 VertexAnimator::VertexAnimator(Actor* owner) : Component(owner)
 {
 	mMeshRenderer = owner->GetComponent<MeshRenderer>();
 }
 
+VertexAnimator::~VertexAnimator()
+{
+	// The mesh renderer's materials may already be gone, but the keyframes and animation must still be released.
+	if(mSamplingOnGPU)
+	{
+		ReleaseGPUAnimation(mVertexAnimation);
+	}
+}
+
 void VertexAnimator::Start(VertexAnimation* anim, int framesPerSecond, std::function<void()> stopCallback)
 {
 	// If we're interrupting some other anim, fire the stop callback for that other anim.
@@ -31,6 +53,9 @@ void VertexAnimator::Start(VertexAnimation* anim, int framesPerSecond, std::func
 	
 	// Reset animation timer.
 	mVertexAnimationTimer = 0.0f;
+	
+	// Sample on the GPU if possible.
+	mSamplingOnGPU = sGPUAnimationEnabled && StartGPUSampling(anim);
 }
 
 void VertexAnimator::Start(VertexAnimation* anim, int framesPerSecond, std::function<void()> stopCallback, float time)
@@ -47,6 +72,14 @@ void VertexAnimator::Stop(VertexAnimation* anim)
 	// Stop if animation matches playing one OR null was passed in.
 	if(mVertexAnimation != nullptr && (mVertexAnimation == anim || anim == nullptr))
 	{
+		// Mesh data on the CPU isn't updated during GPU sampling, so it needs one last sample to match what was rendered.
+		if(mSamplingOnGPU)
+		{
+			StopGPUSampling(mVertexAnimation);
+			mSamplingOnGPU = false;
+			TakeSample(mVertexAnimation, Math::Clamp(mVertexAnimationTimer, 0.0f, mVertexAnimation->GetDuration(mFramesPerSecond)));
+		}
+		
 		// Fire stop callback if an animation was in progress.
 		if(mStopCallback != nullptr)
 		{
@@ -78,34 +111,249 @@ void VertexAnimator::OnUpdate(float deltaTime)
 		
 		// Sample animation at current timer value, clamping to anim duration.
 		float animDuration = mVertexAnimation->GetDuration(mFramesPerSecond);
-		TakeSample(mVertexAnimation, Math::Clamp(mVertexAnimationTimer, 0.0f, animDuration));
+		float sampleTime = Math::Clamp(mVertexAnimationTimer, 0.0f, animDuration);
 		
 		// If at the end of the animation, clear animation.
 		// GK3 doesn't really have the concept of a "looping" animation. Looping is handled by higher-level control scripts.
 		if(mVertexAnimationTimer >= animDuration)
 		{
+			// The stop callback may start another animation, so the last sample must be taken right away.
+			TakeSample(mVertexAnimation, sampleTime);
 			Stop(nullptr);
 		}
+		else if(mSamplingOnGPU)
+		{
+			// Only a few uniforms to set - not worth doing in parallel.
+			TakeSample(mVertexAnimation, sampleTime);
+		}
+		else
+		{
+			// Sampling vertex poses is CPU-heavy, so it's done in parallel with other actors once all actors have updated.
+			mParallelSampleAnimation = mVertexAnimation;
+			mParallelSampleTime = sampleTime;
+		}
+	}
+}
+
+void VertexAnimator::ParallelUpdate()
+{
+	// Sample into the animator's own buffers, rather than the meshes.
+	// Different actors can use the same meshes (e.g. props with the same model), so meshes are only changed on the main thread.
+	VertexAnimation* animation = mParallelSampleAnimation;
+	float time = mParallelSampleTime;
+	mSampledFloatCounts.clear();
+	mSampledTransformPoses.clear();
+	
+	size_t positionsOffset = 0;
+	const std::vector<Mesh*>& meshes = mMeshRenderer->GetMeshes();
+	for(int i = 0; i < meshes.size(); i++)
+	{
+		const std::vector<Submesh*>& submeshes = meshes[i]->GetSubmeshes();
+		for(int j = 0; j < submeshes.size(); j++)
+		{
+			// Only vertices that the animation has are sampled, so only those are applied.
+			int floatCount = 0;
+			VertexAnimationKeyframes keyframes;
+			if(submeshes[j]->GetPositions() != nullptr && animation->SampleVertexKeyframes(time, mFramesPerSecond, i, j, keyframes))
+			{
+				int vertexCount = Math::Min(keyframes.vertexCount, static_cast<int>(submeshes[j]->GetVertexCount()));
+				floatCount = vertexCount * 3;
+				if(floatCount > 0)
+				{
+					if(mSampledPositions.size() < positionsOffset + floatCount)
+					{
+						mSampledPositions.resize(positionsOffset + floatCount);
+					}
+					animation->SampleVertexPose(time, mFramesPerSecond, i, j, &mSampledPositions[positionsOffset], vertexCount);
+				}
+			}
+			mSampledFloatCounts.push_back(floatCount);
+			positionsOffset += floatCount;
+		}
+		mSampledTransformPoses.push_back(animation->SampleTransformPose(time, mFramesPerSecond, i));
 	}
 }
 
+void VertexAnimator::FinishParallelUpdate()
+{
+	// Copy sampled positions to the submeshes, which uploads them to the GPU.
+	int submeshIndex = 0;
+	size_t positionsOffset = 0;
+	const std::vector<Mesh*>& meshes = mMeshRenderer->GetMeshes();
+	for(int i = 0; i < meshes.size() && i < mSampledTransformPoses.size(); i++)
+	{
+		const std::vector<Submesh*>& submeshes = meshes[i]->GetSubmeshes();
+		for(int j = 0; j < submeshes.size() && submeshIndex < mSampledFloatCounts.size(); j++)
+		{
+			int floatCount = mSampledFloatCounts[submeshIndex];
+			++submeshIndex;
+			if(floatCount > 0)
+			{
+				float* positions = submeshes[j]->GetPositions();
+				memcpy(positions, &mSampledPositions[positionsOffset], floatCount * sizeof(float));
+				submeshes[j]->SetPositions(positions);
+				positionsOffset += floatCount;
+			}
+		}
+		
+		if(mSampledTransformPoses[i].mFrameNumber >= 0)
+		{
+			meshes[i]->SetMeshToLocalMatrix(mSampledTransformPoses[i].GetMeshToLocalMatrix());
+		}
+	}
+	mParallelSampleAnimation = nullptr;
+}
+
 void VertexAnimator::TakeSample(VertexAnimation* animation, float time)
 {
+	// This sample replaces any sample waiting to be taken in parallel.
+	mParallelSampleAnimation = nullptr;
+	
+	if(mSamplingOnGPU && animation == mVertexAnimation)
+	{
+		TakeGPUSample(animation, time);
+		return;
+	}
+	
 	// Iterate through each mesh and sample it in the vertex animation.
 	// We need to sample both vertex poses and transform poses to get the right result.
-	const std::vector<Mesh*> meshes = mMeshRenderer->GetMeshes();
+	const std::vector<Mesh*>& meshes = mMeshRenderer->GetMeshes();
 	for(int i = 0; i < meshes.size(); i++)
 	{
 		const std::vector<Submesh*>& submeshes = meshes[i]->GetSubmeshes();
 		for(int j = 0; j < submeshes.size(); j++)
 		{
-			VertexAnimationVertexPose sample = animation->SampleVertexPose(time, mFramesPerSecond, i, j);
-			if(sample.mFrameNumber >= 0)
+			// Sample straight into the submesh's positions, then let the submesh know they changed.
+			float* positions = submeshes[j]->GetPositions();
+			if(positions != nullptr && animation->SampleVertexPose(time, mFramesPerSecond, i, j, positions, submeshes[j]->GetVertexCount()))
+			{
+                submeshes[j]->SetPositions(positions);
+			}
+		}
+	}
+	SampleTransforms(animation, time);
+}
+
+bool VertexAnimator::StartGPUSampling(VertexAnimation* animation)
+{
+	// Same as the default shader, but blends between keyframe positions.
+	Shader* shader = Services::GetAssets()->LoadShader("3D-Diffuse-Tex-VertexAnim", "3D-Diffuse-Tex");
+	if(shader == nullptr) { return false; }
+	
+	// Upload keyframes, unless another animator is already sampling this animation on the GPU. Some GPUs can't fit big animations.
+	PositionsTexture& positionsTexture = sPositionsTextures[animation];
+	if(positionsTexture.texture == nullptr)
+	{
+		const std::vector<float>& positions = animation->GetPackedVertexPositions();
+		if(positions.empty() || positions.size() > BufferTexture::GetMaxCount())
+		{
+			sPositionsTextures.erase(animation);
+			return false;
+		}
+		positionsTexture.texture = new BufferTexture(positions.data(), static_cast<int>(positions.size()));
+	}
+	++positionsTexture.userCount;
+	
+	// Swap each submesh's material over to the vertex animation shader.
+	// Materials are in submesh order, one per submesh.
+	mCPUShaders.clear();
+	int materialIndex = 0;
+	for(auto& mesh : mMeshRenderer->GetMeshes())
+	{
+		for(int i = 0; i < mesh->GetSubmeshCount(); ++i)
+		{
+			Material* material = mMeshRenderer->GetMaterial(materialIndex);
+			++materialIndex;
+			
+			// Shaders are restored by material index, so submeshes without a material still need an entry.
+			if(material == nullptr)
 			{
-                submeshes[j]->SetPositions(reinterpret_cast<float*>(sample.mVertexPositions.data()), true);
+				mCPUShaders.push_back(nullptr);
+				continue;
 			}
+			
+			mCPUShaders.push_back(material->GetShader());
+			material->SetShader(shader);
+			material->SetBufferTexture(kPositionsUniform, positionsTexture.texture);
+			material->SetInt(kVertexCountUniform, 0);
 		}
+	}
+	
+	// The animation is sampled again when GPU sampling stops, so it can't be unloaded until then.
+	animation->AddRef();
+	return true;
+}
+
+void VertexAnimator::StopGPUSampling(VertexAnimation* animation)
+{
+	for(int i = 0; i < mCPUShaders.size(); ++i)
+	{
+		Material* material = mMeshRenderer->GetMaterial(i);
+		if(material == nullptr || mCPUShaders[i] == nullptr) { continue; }
 		
+		// Remove the vertex animation uniforms too, so they aren't set on the CPU shader.
+		material->SetShader(mCPUShaders[i]);
+		material->SetBufferTexture(kPositionsUniform, nullptr);
+		material->RemoveInt(kFromUniform);
+		material->RemoveInt(kToUniform);
+		material->RemoveFloat(kBlendUniform);
+		material->RemoveInt(kVertexCountUniform);
+	}
+	mCPUShaders.clear();
+	ReleaseGPUAnimation(animation);
+}
+
+void VertexAnimator::ReleaseGPUAnimation(VertexAnimation* animation)
+{
+	// Delete the keyframes once no animator is sampling this animation on the GPU.
+	auto it = sPositionsTextures.find(animation);
+	if(it != sPositionsTextures.end() && --it->second.userCount <= 0)
+	{
+		delete it->second.texture;
+		sPositionsTextures.erase(it);
+	}
+	animation->Release();
+}
+
+void VertexAnimator::TakeGPUSample(VertexAnimation* animation, float time)
+{
+	// Rather than sampling vertex poses, just tell each submesh's shader which keyframes to blend.
+	// Submeshes with no vertex poses use mesh positions, like they would on the CPU.
+	const std::vector<Mesh*>& meshes = mMeshRenderer->GetMeshes();
+	int materialIndex = 0;
+	for(int i = 0; i < meshes.size(); i++)
+	{
+		const std::vector<Submesh*>& submeshes = meshes[i]->GetSubmeshes();
+		for(int j = 0; j < submeshes.size(); j++)
+		{
+			Material* material = mMeshRenderer->GetMaterial(materialIndex);
+			++materialIndex;
+			if(material == nullptr) { continue; }
+			
+			VertexAnimationKeyframes keyframes;
+			if(animation->SampleVertexKeyframes(time, mFramesPerSecond, i, j, keyframes))
+			{
+				material->SetInt(kFromUniform, keyframes.fromOffset);
+				material->SetInt(kToUniform, keyframes.toOffset);
+				material->SetFloat(kBlendUniform, keyframes.t);
+				material->SetInt(kVertexCountUniform, Math::Min(keyframes.vertexCount, static_cast<int>(submeshes[j]->GetVertexCount())));
+			}
+			else
+			{
+				material->SetInt(kVertexCountUniform, 0);
+			}
+		}
+	}
+	
+	// Transform poses are only a matrix per mesh, so they're still sampled on the CPU.
+	SampleTransforms(animation, time);
+}
+
+void VertexAnimator::SampleTransforms(VertexAnimation* animation, float time)
+{
+	const std::vector<Mesh*>& meshes = mMeshRenderer->GetMeshes();
+	for(int i = 0; i < meshes.size(); i++)
+	{
 		VertexAnimationTransformPose transformSample = animation->SampleTransformPose(time, mFramesPerSecond, i);
 		if(transformSample.mFrameNumber >= 0)
 		{
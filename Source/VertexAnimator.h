@@ -9,9 +9,14 @@
 #include "Component.h"
 
 #include <functional>
+#include <unordered_map>
+#include <vector>
 
+#include "VertexAnimation.h"
+
+class BufferTexture;
 class MeshRenderer;
-class VertexAnimation;
+class Shader;
 
 /*
 struct VertexAnimParams
@@ -35,6 +40,7 @@ class VertexAnimator : public Component
 	TYPE_DECL_CHILD();
 public:
 	VertexAnimator(Actor* owner);
+	~VertexAnimator();
 	
 	void Start(VertexAnimation* anim, int framesPerSecond, std::function<void()> stopCallback);
 	void Start(VertexAnimation* anim, int framesPerSecond, std::function<void()> stopCallback, float time);
@@ -44,10 +50,31 @@ public:
 	
 	bool IsPlaying() const { return mVertexAnimation != nullptr; }
 	
+	bool HasParallelWork() const override { return mParallelSampleAnimation != nullptr; }
+	void ParallelUpdate() override;
+	void FinishParallelUpdate() override;
+	
+	// When enabled, each animation's keyframes are uploaded to the GPU once, and the vertex shader blends between them.
+	// Otherwise, vertex poses are sampled on the CPU and uploaded every frame.
+	// Off by default, since mesh positions on the CPU (used for raycasts) aren't updated until the animation stops.
+	static void SetGPUAnimationEnabled(bool enabled) { sGPUAnimationEnabled = enabled; }
+	static bool IsGPUAnimationEnabled() { return sGPUAnimationEnabled; }
+	
 protected:
 	void OnUpdate(float deltaTime) override;
 	
 private:
+	static bool sGPUAnimationEnabled;
+	
+	// GPU copies of animations' packed vertex positions, shared by all animators sampling the same animation on the GPU.
+	// A copy is deleted once no animator is sampling its animation on the GPU.
+	struct PositionsTexture
+	{
+		BufferTexture* texture = nullptr;
+		int userCount = 0;
+	};
+	static std::unordered_map<VertexAnimation*, PositionsTexture> sPositionsTextures;
+	
 	// The mesh renderer that will be animated.
 	MeshRenderer* mMeshRenderer = nullptr;
 	
@@ -64,5 +91,29 @@ private:
 	// Timer for tracking progress on vertex animation.
 	float mVertexAnimationTimer = 0.0f;
 	
+	// If true, the currently running vertex animation is sampled on the GPU.
+	bool mSamplingOnGPU = false;
+	
+	// A sample to take in parallel with other actors' updates, after all actors update.
+	VertexAnimation* mParallelSampleAnimation = nullptr;
+	float mParallelSampleTime = 0.0f;
+	
+	// Results of the parallel sample, applied to the meshes on the main thread.
+	// Positions for all submeshes are back to back. Float counts say how many floats each submesh has (zero if not sampled).
+	std::vector<float> mSampledPositions;
+	std::vector<int> mSampledFloatCounts;
+	std::vector<VertexAnimationTransformPose> mSampledTransformPoses;
+	
+	// Shaders used by the mesh renderer's materials before GPU sampling started, restored when it stops.
+	// One per material index - null for submeshes without a material.
+	std::vector<Shader*> mCPUShaders;
+	
 	void TakeSample(VertexAnimation* animation, float time);
+	
+	bool StartGPUSampling(VertexAnimation* animation);
+	void StopGPUSampling(VertexAnimation* animation);
+	void ReleaseGPUAnimation(VertexAnimation* animation);
+	void TakeGPUSample(VertexAnimation* animation, float time);
+	
+	void SampleTransforms(VertexAnimation* animation, float time);
 };
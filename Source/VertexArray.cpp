@@ -11,6 +11,8 @@
 // This macro just makes the syntax clearer for the reader.
 #define BUFFER_OFFSET(i) ((char *)NULL + (i))
 
+unsigned int VertexArray::sDrawCallCount = 0;
+
 VertexArray::VertexArray(const MeshDefinition& data) :
     mData(data)
 {
@@ -179,6 +181,15 @@ void VertexArray::ChangeIndexData(unsigned short* indexes, unsigned int count)
     RefreshIBOContents(indexes, count);
 }
 
+void VertexArray::ChangeIndexData(unsigned short* indexes, unsigned int offset, unsigned int count)
+{
+    // Only changes a portion of existing index data - buffer must already exist and be large enough.
+    if(mIBO == GL_NONE || offset + count > mData.indexCount) { return; }
+    
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, mIBO);
+    glBufferSubData(GL_ELEMENT_ARRAY_BUFFER, offset * sizeof(GLushort), count * sizeof(GLushort), indexes);
+}
+
 void VertexArray::DrawTriangles() const
 {
     DrawTriangles(0, mData.indexCount > 0 ? mData.indexCount : mData.vertexCount);
@@ -226,6 +237,8 @@ void VertexArray::Draw(GLenum mode) const
 
 void VertexArray::Draw(GLenum mode, unsigned int offset, unsigned int count) const
 {
+    ++sDrawCallCount;
+    
     // Bind vertex array object.
     glBindVertexArray(mVAO);
     
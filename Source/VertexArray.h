@@ -65,6 +65,7 @@ public:
     void ChangeVertexData(VertexAttribute::Semantic semantic, void* data);
     
     void ChangeIndexData(unsigned short* indexes, unsigned int count);
+    void ChangeIndexData(unsigned short* indexes, unsigned int offset, unsigned int count);
     
     void DrawTriangles() const;
     void DrawTriangles(unsigned int offset, unsigned int count) const;
@@ -81,7 +82,13 @@ public:
     void Draw(GLenum mode) const;
     void Draw(GLenum mode, unsigned int offset, unsigned int count) const;
     
+    // Total number of draw calls issued by all vertex arrays. Useful for profiling.
+    static unsigned int GetDrawCallCount() { return sDrawCallCount; }
+    
 private:
+    // Incremented each time any vertex array draws.
+    static unsigned int sDrawCallCount;
+    
     // Definition data passed in.
     // Note that vertex/index data pointers SHOULD NOT be considered valid after construction!
     MeshDefinition mData;
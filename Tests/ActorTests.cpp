@@ -0,0 +1,73 @@
+//
+// ActorTests.cpp
+//
+// Clark Kromenaker
+//
+// Tests for Actor class.
+//
+#include "catch.hh"
+#include "Actor.h"
+
+#include "RectTransform.h"
+
+namespace
+{
+	class TestComponent : public Component
+	{
+		TYPE_DECL_CHILD();
+	public:
+		TestComponent(Actor* owner) : Component(owner) { }
+	};
+
+	class TestSubComponent : public TestComponent
+	{
+		TYPE_DECL_CHILD();
+	public:
+		TestSubComponent(Actor* owner) : TestComponent(owner) { }
+	};
+
+	TYPE_DEF_CHILD(Component, TestComponent);
+	TYPE_DEF_CHILD(TestComponent, TestSubComponent);
+}
+
+TEST_CASE("Actor finds components by base type")
+{
+	Actor actor(Actor::TransformType::RectTransform);
+	RectTransform* rectTransform = actor.GetComponent<RectTransform>();
+	REQUIRE(rectTransform != nullptr);
+	REQUIRE(actor.GetComponent<Transform>() == rectTransform);
+	REQUIRE(actor.GetTransform() == rectTransform);
+
+	TestSubComponent* subComponent = actor.AddComponent<TestSubComponent>();
+	REQUIRE(actor.GetComponent<TestComponent>() == subComponent);
+	REQUIRE(actor.GetComponent<TestSubComponent>() == subComponent);
+}
+
+TEST_CASE("Actor finds components added after a failed lookup")
+{
+	Actor actor;
+	REQUIRE(actor.GetComponent<TestComponent>() == nullptr);
+	REQUIRE(actor.GetComponent<TestSubComponent>() == nullptr);
+
+	// Adding a component fills in earlier lookups it matches, but not others.
+	TestComponent* component = actor.AddComponent<TestComponent>();
+	REQUIRE(actor.GetComponent<TestComponent>() == component);
+	REQUIRE(actor.GetComponent<TestSubComponent>() == nullptr);
+
+	// A lookup that already found a component keeps returning the first one added.
+	TestSubComponent* subComponent = actor.AddComponent<TestSubComponent>();
+	REQUIRE(actor.GetComponent<TestComponent>() == component);
+	REQUIRE(actor.GetComponent<TestSubComponent>() == subComponent);
+}
+
+TEST_CASE("Actor returns the same component for repeated lookups")
+{
+	Actor actor;
+	TestComponent* component = actor.AddComponent<TestComponent>();
+	for(int i = 0; i < 10; ++i)
+	{
+		REQUIRE(actor.GetComponent<TestComponent>() == component);
+		REQUIRE(actor.GetComponent<Transform>() == actor.GetTransform());
+		REQUIRE(actor.GetComponent<RectTransform>() == nullptr);
+	}
+}
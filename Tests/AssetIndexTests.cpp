@@ -0,0 +1,146 @@
+//
+// AssetIndexTests.cpp
+//
+// Clark Kromenaker
+//
+// Tests for finding assets in search paths and loaded barns.
+//
+#include "catch.hh"
+#include "AssetIndex.h"
+
+#include <cstdio>
+#include <fstream>
+#include <string>
+
+#include "BarnFile.h"
+#include "FileSystem.h"
+#include "TestBarn.h"
+
+namespace
+{
+	void WriteLooseFile(const std::string& filePath)
+	{
+		std::ofstream file(filePath);
+		file << filePath;
+	}
+
+	// The barn containing an asset's data, or null if the asset isn't in a barn (or its barn isn't loaded).
+	BarnFile* GetBarn(const AssetIndex& index, const std::string& assetName)
+	{
+		BarnFile* barn = nullptr;
+		const BarnAsset* barnAsset = nullptr;
+		index.FindInBarn(assetName, barn, barnAsset);
+		return barn;
+	}
+}
+
+TEST_CASE("Asset index finds loose files in earlier search paths first")
+{
+	const std::string firstPath = "AssetIndexTests_First";
+	const std::string secondPath = "AssetIndexTests_Second";
+	Directory::CreateAll(firstPath);
+	Directory::CreateAll(secondPath);
+	WriteLooseFile(Path::Combine({ firstPath, "SHARED.TXT" }));
+	WriteLooseFile(Path::Combine({ secondPath, "SHARED.TXT" }));
+	WriteLooseFile(Path::Combine({ secondPath, "Second.txt" }));
+
+	AssetIndex index;
+	REQUIRE(index.AddSearchPath(firstPath));
+	REQUIRE(index.AddSearchPath(secondPath));
+	REQUIRE(!index.AddSearchPath("AssetIndexTests_Missing"));
+
+	// Lookups ignore case, but the path keeps the file's actual name.
+	REQUIRE(index.GetFilePath("SHARED.TXT") == Path::Combine({ firstPath, "SHARED.TXT" }));
+	REQUIRE(index.GetFilePath("second.TXT") == Path::Combine({ secondPath, "Second.txt" }));
+	REQUIRE(index.GetFilePath("MISSING.TXT").empty());
+
+	// Loose files aren't in any barn.
+	BarnFile* barn = nullptr;
+	const BarnAsset* barnAsset = nullptr;
+	REQUIRE(!index.FindInBarn("SHARED.TXT", barn, barnAsset));
+
+	std::remove(Path::Combine({ firstPath, "SHARED.TXT" }).c_str());
+	std::remove(Path::Combine({ secondPath, "SHARED.TXT" }).c_str());
+	std::remove(Path::Combine({ secondPath, "Second.txt" }).c_str());
+	std::remove(firstPath.c_str());
+	std::remove(secondPath.c_str());
+}
+
+TEST_CASE("Asset index finds assets in earlier barns first, and rebuilds when a barn is removed")
+{
+	// Barn A has a pointer to an asset in barn C. A and B both have the same asset.
+	// Barn names in pointers aren't necessarily uppercase.
+	TestBarn testBarnA;
+	testBarnA.AddAsset("SHARED.TXT", "A");
+	testBarnA.AddAsset("LOOSE.TXT", "A");
+	testBarnA.AddPointer("POINTER.TXT", "assetindextests_c.brn");
+	REQUIRE(testBarnA.Write("AssetIndexTests_A.brn"));
+
+	TestBarn testBarnB;
+	testBarnB.AddAsset("SHARED.TXT", "B");
+	testBarnB.AddAsset("ONLYB.TXT", "B");
+	REQUIRE(testBarnB.Write("AssetIndexTests_B.brn"));
+
+	TestBarn testBarnC;
+	testBarnC.AddAsset("POINTER.TXT", "C");
+	REQUIRE(testBarnC.Write("AssetIndexTests_C.brn"));
+
+	BarnFile barnA("AssetIndexTests_A.brn");
+	BarnFile barnB("AssetIndexTests_B.brn");
+	BarnFile barnC("AssetIndexTests_C.brn");
+
+	// An asset can be both a loose file and in a barn.
+	const std::string searchPath = "AssetIndexTests_Loose";
+	Directory::CreateAll(searchPath);
+	WriteLooseFile(Path::Combine({ searchPath, "LOOSE.TXT" }));
+
+	AssetIndex index;
+	REQUIRE(index.AddSearchPath(searchPath));
+	index.AddBarn("AssetIndexTests_A.brn", &barnA);
+	index.AddBarn("AssetIndexTests_B.brn", &barnB);
+	REQUIRE(GetBarn(index, "SHARED.TXT") == &barnA);
+	REQUIRE(GetBarn(index, "shared.txt") == &barnA);
+	REQUIRE(GetBarn(index, "ONLYB.TXT") == &barnB);
+	REQUIRE(GetBarn(index, "LOOSE.TXT") == &barnA);
+	REQUIRE(!index.GetFilePath("LOOSE.TXT").empty());
+
+	// Until barn C is added, the pointer is in a barn, but its data isn't available.
+	BarnFile* barn = nullptr;
+	const BarnAsset* barnAsset = nullptr;
+	REQUIRE(index.FindInBarn("POINTER.TXT", barn, barnAsset));
+	REQUIRE(barn == nullptr);
+	REQUIRE(barnAsset->IsPointer());
+
+	index.AddBarn("AssetIndexTests_C.brn", &barnC);
+	REQUIRE(index.FindInBarn("POINTER.TXT", barn, barnAsset));
+	REQUIRE(barn == &barnC);
+	REQUIRE(barnAsset == barnC.GetAsset("POINTER.TXT"));
+
+	// Removing a later barn doesn't change which barn earlier assets are found in.
+	index.RemoveBarn("AssetIndexTests_B.brn");
+	REQUIRE(GetBarn(index, "SHARED.TXT") == &barnA);
+	REQUIRE(!index.FindInBarn("ONLYB.TXT", barn, barnAsset));
+
+	// Removing the barn a pointer redirects to leaves the pointer unresolved.
+	index.RemoveBarn("AssetIndexTests_C.brn");
+	REQUIRE(index.FindInBarn("POINTER.TXT", barn, barnAsset));
+	REQUIRE(barn == nullptr);
+	REQUIRE(barnAsset->IsPointer());
+
+	// Re-adding barn B puts it after barn A, and barn A's removal falls back on B.
+	index.AddBarn("AssetIndexTests_B.brn", &barnB);
+	REQUIRE(GetBarn(index, "SHARED.TXT") == &barnA);
+	index.RemoveBarn("assetindextests_a.brn");
+	REQUIRE(GetBarn(index, "SHARED.TXT") == &barnB);
+	REQUIRE(!index.FindInBarn("POINTER.TXT", barn, barnAsset));
+
+	// Loose files stay in the index, even once no barn has them.
+	REQUIRE(!index.FindInBarn("LOOSE.TXT", barn, barnAsset));
+	REQUIRE(index.GetFilePath("LOOSE.TXT") == Path::Combine({ searchPath, "LOOSE.TXT" }));
+
+	std::remove(Path::Combine({ searchPath, "LOOSE.TXT" }).c_str());
+	std::remove(searchPath.c_str());
+	std::remove("AssetIndexTests_A.brn");
+	std::remove("AssetIndexTests_B.brn");
+	std::remove("AssetIndexTests_C.brn");
+}
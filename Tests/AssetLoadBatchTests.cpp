@@ -0,0 +1,98 @@
+//
+// AssetLoadBatchTests.cpp
+//
+// Clark Kromenaker
+//
+// Tests for loading a batch of assets, extracted from a barn in parallel.
+//
+#include "catch.hh"
+#include "AssetLoadBatch.h"
+
+#include <cstdio>
+#include <string>
+
+#include "BarnFile.h"
+#include "Services.h"
+#include "TestBarn.h"
+#include "ThreadPool.h"
+
+TEST_CASE("Asset load batch only adds each asset once, in order")
+{
+	AssetLoadBatch batch;
+	REQUIRE(batch.Add("A.TXT") != nullptr);
+	REQUIRE(batch.Add("B.TXT") != nullptr);
+	REQUIRE(batch.Add("A.TXT") == nullptr);
+	REQUIRE(batch.Add("C.TXT") != nullptr);
+	REQUIRE(batch.Add("B.TXT") == nullptr);
+
+	REQUIRE(batch.GetItems().size() == 3);
+	REQUIRE(batch.GetItems()[0].name == "A.TXT");
+	REQUIRE(batch.GetItems()[1].name == "B.TXT");
+	REQUIRE(batch.GetItems()[2].name == "C.TXT");
+
+	// Nothing to extract, so nothing to wait on.
+	batch.WaitForExtracts();
+}
+
+TEST_CASE("Asset load batch extracts assets in parallel")
+{
+	ThreadPool threadPool(4);
+	Services::SetJobs(&threadPool);
+
+	// Plenty of assets, so several workers are extracting at once.
+	// The last asset's data is cut off, so it can't be extracted.
+	TestBarn testBarn;
+	std::vector<std::string> assetNames;
+	std::vector<std::string> assetData;
+	for(int i = 0; i < 32; ++i)
+	{
+		assetNames.push_back("ASSET" + std::to_string(i) + ".TXT");
+		assetData.push_back(std::string(1000 + i, static_cast<char>('a' + i % 26)));
+		testBarn.AddAsset(assetNames.back(), assetData.back(), i % 2 == 0 ? CompressionType::Zlib : CompressionType::Lzo);
+	}
+	testBarn.AddAsset("TRUNCATED.TXT", std::string(1000, 'z'));
+	const std::string barnPath = "AssetLoadBatchTests.brn";
+	REQUIRE(testBarn.Write(barnPath, testBarn.GetSize() - 10));
+	BarnFile barn(barnPath, true);
+
+	// Request every asset twice, along with one that doesn't exist, and the truncated one.
+	AssetLoadBatch batch;
+	for(int pass = 0; pass < 2; ++pass)
+	{
+		for(auto& assetName : assetNames)
+		{
+			AssetLoadBatch::Item* item = batch.Add(assetName);
+			REQUIRE((item != nullptr) == (pass == 0));
+			if(item != nullptr)
+			{
+				batch.Extract(item, &barn, barn.GetAsset(assetName)->uncompressedSize);
+			}
+		}
+	}
+	batch.Extract(batch.Add("MISSING.TXT"), &barn, 100);
+	batch.Extract(batch.Add("TRUNCATED.TXT"), &barn, 1000);
+	batch.WaitForExtracts();
+
+	// Each asset was extracted once, in the order requested.
+	std::deque<AssetLoadBatch::Item>& items = batch.GetItems();
+	REQUIRE(items.size() == assetNames.size() + 2);
+	for(size_t i = 0; i < assetNames.size(); ++i)
+	{
+		REQUIRE(items[i].name == assetNames[i]);
+		REQUIRE(!items[i].extractFailed);
+		REQUIRE(std::string(items[i].buffer, items[i].bufferSize) == assetData[i]);
+	}
+
+	// Assets that couldn't be extracted are flagged, rather than left with garbage data.
+	REQUIRE(items[assetNames.size()].name == "MISSING.TXT");
+	REQUIRE(items[assetNames.size()].extractFailed);
+	REQUIRE(items[assetNames.size() + 1].name == "TRUNCATED.TXT");
+	REQUIRE(items[assetNames.size() + 1].extractFailed);
+
+	for(auto& item : items)
+	{
+		delete[] item.buffer;
+	}
+	Services::SetJobs(nullptr);
+	std::remove(barnPath.c_str());
+}
@@ -0,0 +1,158 @@
+//
+// AssetResidencyTests.cpp
+//
+// Clark Kromenaker
+//
+// Tests for tracking which loaded assets are in use.
+//
+#include "catch.hh"
+#include "AssetResidency.h"
+
+#include "Asset.h"
+
+TEST_CASE("Asset residency references used assets until the scene changes")
+{
+	AssetResidency residency;
+	Asset asset("TEST.BMP");
+	residency.Add(&asset, 100, { });
+
+	// Using an asset references it, but only once per scene.
+	residency.Use(&asset);
+	residency.Use(&asset);
+	REQUIRE(asset.GetRefCount() == 1);
+	REQUIRE(residency.GetAssetsToEvict({ &asset }, 0).empty());
+
+	residency.ReleaseSceneAssets();
+	REQUIRE(asset.GetRefCount() == 0);
+	REQUIRE((residency.GetAssetsToEvict({ &asset }, 0) == std::vector<Asset*> { &asset }));
+
+	// Untracked assets aren't referenced.
+	Asset untrackedAsset("UNTRACKED.BMP");
+	residency.Use(&untrackedAsset);
+	residency.Acquire(&untrackedAsset);
+	REQUIRE(untrackedAsset.GetRefCount() == 0);
+}
+
+TEST_CASE("Asset residency keeps acquired assets until released")
+{
+	AssetResidency residency;
+	Asset asset("TEST.BMP");
+	residency.Add(&asset, 100, { });
+	residency.Use(&asset);
+
+	// Acquired references outlive the scene.
+	residency.Acquire(&asset);
+	residency.Acquire(&asset);
+	residency.ReleaseSceneAssets();
+	REQUIRE(asset.GetRefCount() == 2);
+
+	residency.Release(&asset);
+	REQUIRE(asset.GetRefCount() == 1);
+	residency.Release(&asset);
+	REQUIRE(asset.GetRefCount() == 0);
+
+	// Releasing more than was acquired does nothing - including dropping the scene's reference.
+	residency.Use(&asset);
+	residency.Release(&asset);
+	REQUIRE(asset.GetRefCount() == 1);
+
+	// Null is ignored.
+	residency.Acquire(nullptr);
+	residency.Release(nullptr);
+}
+
+TEST_CASE("Asset residency pins dependencies while their dependents are loaded")
+{
+	AssetResidency residency;
+	Asset bsp("TEST.BSP");
+	Asset texture("TEST.BMP");
+
+	// Creating the BSP uses the texture, which makes it a dependency.
+	residency.Add(&texture, 100, { });
+	residency.BeginDependencies();
+	residency.Use(&texture);
+	std::vector<Asset*> dependencies = residency.EndDependencies();
+	REQUIRE((dependencies == std::vector<Asset*> { &texture }));
+	residency.Add(&bsp, 100, dependencies);
+	residency.ReleaseSceneAssets();
+
+	// Nothing references the texture, but the loaded BSP depends on it.
+	REQUIRE(texture.GetRefCount() == 0);
+	REQUIRE(residency.GetAssetsToEvict({ &texture }, 0).empty());
+	REQUIRE((residency.GetAssetsToEvict({ &bsp }, 0) == std::vector<Asset*> { &bsp }));
+
+	// Once the BSP is unloaded, the texture can be too.
+	residency.Remove(&bsp);
+	REQUIRE((residency.GetAssetsToEvict({ &texture }, 0) == std::vector<Asset*> { &texture }));
+}
+
+TEST_CASE("Asset residency tracks dependencies of nested asset creation separately")
+{
+	AssetResidency residency;
+	Asset model("TEST.MOD");
+	Asset texture("TEST.BMP");
+	residency.Add(&texture, 100, { });
+
+	// The scene asset loads a model while being created, and the model loads a texture.
+	residency.BeginDependencies();
+	residency.BeginDependencies();
+	residency.Use(&texture);
+	std::vector<Asset*> modelDependencies = residency.EndDependencies();
+	residency.Add(&model, 100, modelDependencies);
+	residency.Use(&model);
+	std::vector<Asset*> sceneDependencies = residency.EndDependencies();
+
+	REQUIRE((modelDependencies == std::vector<Asset*> { &texture }));
+	REQUIRE((sceneDependencies == std::vector<Asset*> { &model }));
+}
+
+TEST_CASE("Asset residency evicts least recently used assets until within budget")
+{
+	AssetResidency residency;
+	Asset a("A.BMP");
+	Asset b("B.BMP");
+	Asset c("C.BMP");
+	Asset d("D.BMP");
+	residency.Add(&a, 100, { });
+	residency.Add(&b, 100, { });
+	residency.Add(&c, 100, { });
+	residency.Add(&d, 100, { });
+
+	// Use order, least recent first: C, A, D, B.
+	residency.Use(&c);
+	residency.Use(&a);
+	residency.Use(&d);
+	residency.Use(&b);
+	residency.ReleaseSceneAssets();
+	std::vector<Asset*> assets = { &a, &b, &c, &d };
+
+	// Within budget - nothing to do.
+	REQUIRE(residency.GetAssetsToEvict(assets, 400).empty());
+
+	// Least recently used go first, and only as many as needed.
+	REQUIRE((residency.GetAssetsToEvict(assets, 250) == std::vector<Asset*> { &c, &a }));
+	REQUIRE((residency.GetAssetsToEvict(assets, 0) == std::vector<Asset*> { &c, &a, &d, &b }));
+
+	// Using an asset again makes it most recently used.
+	residency.Use(&c);
+	residency.ReleaseSceneAssets();
+	REQUIRE((residency.GetAssetsToEvict(assets, 250) == std::vector<Asset*> { &a, &d }));
+
+	// Referenced assets are skipped, even if that means staying over budget.
+	residency.Acquire(&a);
+	residency.Acquire(&d);
+	residency.Acquire(&b);
+	REQUIRE((residency.GetAssetsToEvict(assets, 0) == std::vector<Asset*> { &c }));
+}
+
+TEST_CASE("Asset residency forgets removed assets")
+{
+	AssetResidency residency;
+	Asset asset("TEST.BMP");
+	residency.Add(&asset, 100, { });
+	REQUIRE(residency.GetByteCount(&asset) == 100);
+
+	residency.Remove(&asset);
+	REQUIRE(residency.GetByteCount(&asset) == 0);
+	REQUIRE(residency.GetAssetsToEvict({ &asset }, 0).empty());
+}
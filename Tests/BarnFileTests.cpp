@@ -0,0 +1,157 @@
+//
+// BarnFileTests.cpp
+//
+// Clark Kromenaker
+//
+// Tests for reading assets out of barn files, memory mapped or not.
+//
+#include "catch.hh"
+#include "BarnFile.h"
+
+#include <cstdio>
+#include <fstream>
+#include <string>
+
+#include "MemoryMappedFile.h"
+#include "TestBarn.h"
+
+namespace
+{
+	// Big and repetitive enough that compression actually shrinks it.
+	std::string MakeAssetData(const std::string& seed)
+	{
+		std::string data;
+		for(int i = 0; i < 200; ++i)
+		{
+			data += seed + std::to_string(i) + '\0';
+		}
+		return data;
+	}
+
+	std::string ExtractAsset(BarnFile& barn, const std::string& assetName)
+	{
+		BarnAsset* asset = barn.GetAsset(assetName);
+		if(asset == nullptr) { return "<missing>"; }
+
+		std::string data(asset->uncompressedSize, '\0');
+		if(!barn.Extract(assetName, &data[0], static_cast<int>(data.size()))) { return "<failed>"; }
+		return data;
+	}
+}
+
+TEST_CASE("Barn file reads the same bytes whether memory mapped or not")
+{
+	std::string uncompressedData = MakeAssetData("uncompressed");
+	std::string zlibData = MakeAssetData("zlib");
+	std::string lzoData = MakeAssetData("lzo");
+
+	TestBarn testBarn;
+	testBarn.AddAsset("UNCOMPRESSED.TXT", uncompressedData);
+	testBarn.AddAsset("ZLIB.TXT", zlibData, CompressionType::Zlib);
+	testBarn.AddAsset("LZO.TXT", lzoData, CompressionType::Lzo);
+	testBarn.AddPointer("POINTER.TXT", "OTHER.BRN");
+	const std::string barnPath = "BarnFileTests.brn";
+	REQUIRE(testBarn.Write(barnPath));
+
+	BarnFile mappedBarn(barnPath, true);
+	BarnFile streamedBarn(barnPath, false);
+	REQUIRE(mappedBarn.IsMemoryMapped());
+	REQUIRE(!streamedBarn.IsMemoryMapped());
+	REQUIRE(mappedBarn.CanRead());
+	REQUIRE(streamedBarn.CanRead());
+	REQUIRE(mappedBarn.GetAssets().size() == 4);
+	REQUIRE(streamedBarn.GetAssets().size() == 4);
+
+	// Compressed assets really are compressed.
+	REQUIRE(mappedBarn.GetAsset("ZLIB.TXT")->compressedSize < zlibData.size());
+	REQUIRE(mappedBarn.GetAsset("LZO.TXT")->compressedSize < lzoData.size());
+
+	// Extracting gives the original data either way.
+	REQUIRE(ExtractAsset(mappedBarn, "UNCOMPRESSED.TXT") == uncompressedData);
+	REQUIRE(ExtractAsset(streamedBarn, "UNCOMPRESSED.TXT") == uncompressedData);
+	REQUIRE(ExtractAsset(mappedBarn, "ZLIB.TXT") == zlibData);
+	REQUIRE(ExtractAsset(streamedBarn, "ZLIB.TXT") == zlibData);
+	REQUIRE(ExtractAsset(mappedBarn, "LZO.TXT") == lzoData);
+	REQUIRE(ExtractAsset(streamedBarn, "LZO.TXT") == lzoData);
+
+	// Uncompressed assets in a mapped barn can be read in-place, and match what's extracted.
+	unsigned int viewSize = 0;
+	const char* view = mappedBarn.GetAssetView("UNCOMPRESSED.TXT", viewSize);
+	REQUIRE(view != nullptr);
+	REQUIRE(std::string(view, viewSize) == uncompressedData);
+
+	// Nothing else can be viewed in-place.
+	REQUIRE(mappedBarn.GetAssetView("ZLIB.TXT", viewSize) == nullptr);
+	REQUIRE(mappedBarn.GetAssetView("LZO.TXT", viewSize) == nullptr);
+	REQUIRE(mappedBarn.GetAssetView("POINTER.TXT", viewSize) == nullptr);
+	REQUIRE(streamedBarn.GetAssetView("UNCOMPRESSED.TXT", viewSize) == nullptr);
+
+	// Pointers only say where the data is - there's nothing to extract.
+	REQUIRE(mappedBarn.GetAsset("POINTER.TXT")->IsPointer());
+	REQUIRE(mappedBarn.GetAsset("POINTER.TXT")->barnFileName == "OTHER.BRN");
+	REQUIRE(ExtractAsset(mappedBarn, "POINTER.TXT") == "<failed>");
+	REQUIRE(ExtractAsset(streamedBarn, "POINTER.TXT") == "<failed>");
+
+	// A buffer that's too small is rejected, rather than overrun.
+	char smallBuffer[4];
+	REQUIRE(!mappedBarn.Extract("ZLIB.TXT", smallBuffer, sizeof(smallBuffer)));
+	REQUIRE(!streamedBarn.Extract("UNCOMPRESSED.TXT", smallBuffer, sizeof(smallBuffer)));
+
+	std::remove(barnPath.c_str());
+}
+
+TEST_CASE("Barn file falls back on a file stream when it can't be memory mapped")
+{
+	// Missing and empty files can't be mapped.
+	const std::string emptyPath = "BarnFileTests_Empty.brn";
+	{
+		std::ofstream emptyFile(emptyPath);
+	}
+	REQUIRE(!MemoryMappedFile("BarnFileTests_Missing.brn").IsMapped());
+	REQUIRE(!MemoryMappedFile(emptyPath).IsMapped());
+
+	// The barn isn't mapped, and since it can't be read either, nothing can be found in it.
+	BarnFile missingBarn("BarnFileTests_Missing.brn", true);
+	REQUIRE(!missingBarn.IsMemoryMapped());
+	REQUIRE(!missingBarn.CanRead());
+	REQUIRE(missingBarn.GetAssets().empty());
+
+	unsigned int viewSize = 0;
+	char buffer[4];
+	REQUIRE(missingBarn.GetAssetView("UNCOMPRESSED.TXT", viewSize) == nullptr);
+	REQUIRE(!missingBarn.Extract("UNCOMPRESSED.TXT", buffer, sizeof(buffer)));
+
+	std::remove(emptyPath.c_str());
+}
+
+TEST_CASE("Barn file fails to read assets past the end of a truncated file")
+{
+	// The last asset's data is cut off.
+	std::string uncompressedData = MakeAssetData("uncompressed");
+	std::string zlibData = MakeAssetData("zlib");
+	std::string lastData = MakeAssetData("last");
+
+	TestBarn testBarn;
+	testBarn.AddAsset("UNCOMPRESSED.TXT", uncompressedData);
+	testBarn.AddAsset("ZLIB.TXT", zlibData, CompressionType::Zlib);
+	testBarn.AddAsset("LAST.TXT", lastData);
+	const std::string barnPath = "BarnFileTests_Truncated.brn";
+	REQUIRE(testBarn.Write(barnPath, testBarn.GetSize() - 10));
+
+	BarnFile mappedBarn(barnPath, true);
+	BarnFile streamedBarn(barnPath, false);
+	REQUIRE(mappedBarn.IsMemoryMapped());
+
+	unsigned int viewSize = 0;
+	REQUIRE(mappedBarn.GetAssetView("LAST.TXT", viewSize) == nullptr);
+	REQUIRE(ExtractAsset(mappedBarn, "LAST.TXT") == "<failed>");
+	REQUIRE(ExtractAsset(streamedBarn, "LAST.TXT") == "<failed>");
+
+	// Failing to read one asset doesn't affect reading others.
+	REQUIRE(ExtractAsset(mappedBarn, "UNCOMPRESSED.TXT") == uncompressedData);
+	REQUIRE(ExtractAsset(streamedBarn, "UNCOMPRESSED.TXT") == uncompressedData);
+	REQUIRE(ExtractAsset(mappedBarn, "ZLIB.TXT") == zlibData);
+	REQUIRE(ExtractAsset(streamedBarn, "ZLIB.TXT") == zlibData);
+
+	std::remove(barnPath.c_str());
+}
@@ -0,0 +1,145 @@
+//
+// CaseLogicCacheTests.cpp
+//
+// Clark Kromenaker
+//
+// Tests for CaseLogicCache class.
+//
+#include "catch.hh"
+#include "CaseLogicCache.h"
+
+#include <string>
+#include <unordered_map>
+
+#include "Console.h"
+#include "ReportManager.h"
+#include "SheepManager.h"
+#include "SheepScript.h"
+#include "SheepSysFuncs.h"
+#include "Services.h"
+
+namespace
+{
+	// Stand-ins for game state, and how many times case logic read it.
+	std::unordered_map<std::string, int> sFlags;
+	std::string sInventoryItem;
+	int sCallCount = 0;
+
+	// Has the same name and signature as the real GetFlag, so it's cacheable.
+	void GetFlag_Call(SheepValue* args, SysFuncResult& result)
+	{
+		++sCallCount;
+		result.value = SheepValue(sFlags[args[0].stringValue]);
+	}
+
+	// Reads inventory, which isn't tracked by change counts, so it isn't cacheable.
+	void DoesEgoHaveInvItem_Call(SheepValue* args, SysFuncResult& result)
+	{
+		++sCallCount;
+		result.value = SheepValue(sInventoryItem == args[0].stringValue ? 1 : 0);
+	}
+
+	void DeclareSysFuncs()
+	{
+		static bool declared = false;
+		if(!declared)
+		{
+			AddSysFuncDecl("GetFlag", 1, { 3 }, false, false, &GetFlag_Call);
+			AddSysFuncDecl("DoesEgoHaveInvItem", 1, { 3 }, false, false, &DoesEgoHaveInvItem_Call);
+			declared = true;
+		}
+	}
+}
+
+TEST_CASE("Case logic cache reuses results until game progress or location changes")
+{
+	DeclareSysFuncs();
+	ReportManager reportManager;
+	Console console;
+	SheepManager sheepManager;
+	Services::SetReports(&reportManager);
+	Services::SetConsole(&console);
+	Services::SetSheep(&sheepManager);
+
+	// Reads game progress, and n$/v$.
+	SheepScript* script = sheepManager.CompileEval("{ GetFlag(\"Open\") && n$ == 1 }");
+	REQUIRE(script != nullptr);
+	REQUIRE(CaseLogicCache::IsCacheable(script));
+
+	CaseLogicCache cache;
+	sFlags.clear();
+	sFlags["Open"] = 1;
+	sCallCount = 0;
+	REQUIRE(cache.Evaluate(script, 1, 0, 0, 0));
+	REQUIRE(sCallCount == 1);
+
+	// Same n$/v$ and change counts: the cached result is used, even though the flag changed behind the cache's back.
+	sFlags["Open"] = 0;
+	REQUIRE(cache.Evaluate(script, 1, 0, 0, 0));
+	REQUIRE(sCallCount == 1);
+
+	// Results are cached separately for each n$/v$.
+	REQUIRE(!cache.Evaluate(script, 2, 0, 0, 0));
+	REQUIRE(sCallCount == 2);
+	REQUIRE(!cache.Evaluate(script, 2, 0, 0, 0));
+	REQUIRE(sCallCount == 2);
+
+	// A game progress change throws out cached results.
+	REQUIRE(!cache.Evaluate(script, 1, 0, 1, 0));
+	REQUIRE(sCallCount == 3);
+
+	// So does a location change.
+	sFlags["Open"] = 1;
+	REQUIRE(cache.Evaluate(script, 1, 0, 1, 1));
+	REQUIRE(sCallCount == 4);
+	REQUIRE(cache.Evaluate(script, 1, 0, 1, 1));
+	REQUIRE(sCallCount == 4);
+
+	// Clearing the cache means evaluating again.
+	cache.Clear();
+	REQUIRE(cache.Evaluate(script, 1, 0, 1, 1));
+	REQUIRE(sCallCount == 5);
+
+	// No script is always true.
+	REQUIRE(cache.Evaluate(nullptr, 1, 0, 1, 1));
+
+	delete script;
+	Services::SetSheep(nullptr);
+	Services::SetReports(nullptr);
+	Services::SetConsole(nullptr);
+}
+
+TEST_CASE("Case logic cache evaluates every time if case logic reads untracked state")
+{
+	DeclareSysFuncs();
+	ReportManager reportManager;
+	Console console;
+	SheepManager sheepManager;
+	Services::SetReports(&reportManager);
+	Services::SetConsole(&console);
+	Services::SetSheep(&sheepManager);
+
+	// Calling any sys func that isn't known to only read game progress or location makes the whole script uncacheable.
+	SheepScript* script = sheepManager.CompileEval("{ GetFlag(\"Open\") && DoesEgoHaveInvItem(\"Key\") }");
+	REQUIRE(script != nullptr);
+	REQUIRE(!CaseLogicCache::IsCacheable(script));
+
+	CaseLogicCache cache;
+	sFlags.clear();
+	sFlags["Open"] = 1;
+	sInventoryItem = "Key";
+	sCallCount = 0;
+	REQUIRE(cache.Evaluate(script, 0, 0, 0, 0));
+	int callCount = sCallCount;
+	REQUIRE(callCount > 0);
+
+	// Inventory changes don't change the change counts, but the result still updates.
+	sInventoryItem.clear();
+	REQUIRE(!cache.Evaluate(script, 0, 0, 0, 0));
+	REQUIRE(sCallCount > callCount);
+
+	delete script;
+	Services::SetSheep(nullptr);
+	Services::SetReports(nullptr);
+	Services::SetConsole(nullptr);
+}
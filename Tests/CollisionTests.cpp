@@ -7,8 +7,14 @@
 //
 #include "catch.hh"
 #include "Collisions.h"
+
+#include <cstdlib>
+#include <vector>
+
+#include "Ray.h"
 #include "Sphere.h"
 #include "Triangle.h"
+#include "TriangleBatch.h"
 
 TEST_CASE("Sphere intersect triangle works")
 {
@@ -28,3 +34,75 @@ TEST_CASE("Sphere intersect triangle works")
 	Sphere s2(Vector3::Zero + intersect, 10.0f);
 	REQUIRE(!Collisions::TestSphereTriangle(s2, t, intersect));
 }
+
+TEST_CASE("Ray intersect triangle batch matches single triangle test")
+{
+	// Scatter random triangles - use an odd count so both the SIMD and leftover scalar paths get used.
+	std::srand(4321);
+	auto random = [](float min, float max) { return min + (max - min) * (static_cast<float>(std::rand()) / RAND_MAX); };
+	
+	std::vector<Triangle> triangles;
+	TriangleBatch batch;
+	for(int i = 0; i < 203; ++i)
+	{
+		Vector3 center(random(-50.0f, 50.0f), random(-50.0f, 50.0f), random(-50.0f, 50.0f));
+		Triangle triangle(center + Vector3(random(-8.0f, 8.0f), random(-8.0f, 8.0f), random(-8.0f, 8.0f)),
+						  center + Vector3(random(-8.0f, 8.0f), random(-8.0f, 8.0f), random(-8.0f, 8.0f)),
+						  center + Vector3(random(-8.0f, 8.0f), random(-8.0f, 8.0f), random(-8.0f, 8.0f)));
+		triangles.push_back(triangle);
+		batch.Add(triangle.p0, triangle.p1, triangle.p2);
+	}
+	REQUIRE(batch.GetCount() == 203);
+	
+	int hitCount = 0;
+	for(int i = 0; i < 500; ++i)
+	{
+		Vector3 origin(random(-100.0f, 100.0f), random(-100.0f, 100.0f), random(-100.0f, 100.0f));
+		Vector3 target(random(-30.0f, 30.0f), random(-30.0f, 30.0f), random(-30.0f, 30.0f));
+		Ray ray(origin, (target - origin).Normalize());
+		
+		// Find nearest hit one triangle at a time.
+		int expectedIndex = -1;
+		float expectedT = FLT_MAX;
+		for(int j = 0; j < triangles.size(); ++j)
+		{
+			RaycastHit hitInfo;
+			if(Collisions::TestRayTriangle(ray, triangles[j], hitInfo) && hitInfo.t < expectedT)
+			{
+				expectedT = hitInfo.t;
+				expectedIndex = j;
+			}
+		}
+		
+		// Batch test should find the same triangle.
+		RaycastHit hitInfo;
+		int index = Collisions::TestRayTriangles(ray, batch, hitInfo);
+		REQUIRE(index == expectedIndex);
+		if(index >= 0)
+		{
+			REQUIRE(hitInfo.t == Approx(expectedT));
+			++hitCount;
+		}
+		
+		// Same for a sub-range that doesn't start on a multiple of four.
+		expectedIndex = -1;
+		expectedT = FLT_MAX;
+		for(int j = 5; j < 5 + 150; ++j)
+		{
+			RaycastHit singleHitInfo;
+			if(Collisions::TestRayTriangle(ray, triangles[j], singleHitInfo) && singleHitInfo.t < expectedT)
+			{
+				expectedT = singleHitInfo.t;
+				expectedIndex = j;
+			}
+		}
+		REQUIRE(Collisions::TestRayTriangles(ray, batch, 5, 150, hitInfo) == expectedIndex);
+	}
+	
+	// Make sure the test actually exercised some hits.
+	REQUIRE(hitCount > 0);
+	
+	// An empty range never hits anything.
+	RaycastHit hitInfo;
+	REQUIRE(Collisions::TestRayTriangles(Ray(Vector3::Zero, Vector3::UnitX), batch, 0, 0, hitInfo) == -1);
+}
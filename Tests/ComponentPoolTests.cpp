@@ -0,0 +1,92 @@
+//
+// ComponentPoolTests.cpp
+//
+// Clark Kromenaker
+//
+// Tests for ComponentPool class.
+//
+#include "catch.hh"
+#include "ComponentPool.h"
+
+#include <vector>
+
+namespace
+{
+	// Pools don't need a real component, just something constructed from an owner.
+	struct TestComponent
+	{
+		static int sLiveCount;
+		Actor* mOwner = nullptr;
+		int mValue = 0;
+
+		TestComponent(Actor* owner) : mOwner(owner) { ++sLiveCount; }
+		~TestComponent() { --sLiveCount; }
+	};
+	int TestComponent::sLiveCount = 0;
+}
+
+TEST_CASE("Component pool reuses memory of destroyed components")
+{
+	// Enough to need more than one chunk.
+	std::vector<TestComponent*> components;
+	for(int i = 0; i < 100; ++i)
+	{
+		TestComponent* component = ComponentPool<TestComponent>::Create(nullptr);
+		component->mValue = i;
+		components.push_back(component);
+	}
+	REQUIRE(ComponentPool<TestComponent>::GetCount() == 100);
+	REQUIRE(TestComponent::sLiveCount == 100);
+
+	// Growing the pool doesn't move existing components.
+	for(int i = 0; i < 100; ++i)
+	{
+		REQUIRE(components[i]->mValue == i);
+	}
+
+	// Destroying runs the destructor, and the next component goes in the freed memory.
+	TestComponent* destroyed = components[50];
+	ComponentPool<TestComponent>::Destroy(destroyed);
+	REQUIRE(TestComponent::sLiveCount == 99);
+	TestComponent* created = ComponentPool<TestComponent>::Create(nullptr);
+	REQUIRE(created == destroyed);
+	REQUIRE(created->mValue == 0);
+	components[50] = created;
+
+	for(auto& component : components)
+	{
+		ComponentPool<TestComponent>::Destroy(component);
+	}
+	REQUIRE(ComponentPool<TestComponent>::GetCount() == 0);
+	REQUIRE(TestComponent::sLiveCount == 0);
+}
+
+TEST_CASE("Component pool iterates only live components")
+{
+	std::vector<TestComponent*> components;
+	for(int i = 0; i < 10; ++i)
+	{
+		components.push_back(ComponentPool<TestComponent>::Create(nullptr));
+		components.back()->mValue = 1 << i;
+	}
+	ComponentPool<TestComponent>::Destroy(components[3]);
+	ComponentPool<TestComponent>::Destroy(components[7]);
+
+	int count = 0;
+	int valueMask = 0;
+	ComponentPool<TestComponent>::ForEach([&count, &valueMask](TestComponent* component) {
+		++count;
+		valueMask |= component->mValue;
+	});
+	REQUIRE(count == 8);
+	REQUIRE(valueMask == (0x3FF & ~((1 << 3) | (1 << 7))));
+
+	for(int i = 0; i < 10; ++i)
+	{
+		if(i != 3 && i != 7)
+		{
+			ComponentPool<TestComponent>::Destroy(components[i]);
+		}
+	}
+	REQUIRE(ComponentPool<TestComponent>::GetCount() == 0);
+}
@@ -0,0 +1,119 @@
+//
+// LoadSequenceTests.cpp
+//
+// Clark Kromenaker
+//
+// Tests for running load steps over several frames.
+//
+#include "catch.hh"
+#include "LoadSequence.h"
+
+#include <string>
+
+TEST_CASE("Load sequence runs one step per update, in order")
+{
+	LoadSequence sequence;
+	REQUIRE(!sequence.IsLoading());
+
+	std::string log;
+	sequence.Start({
+		[&log]() { log += "A"; },
+		[&log]() { log += "B"; },
+		[&log]() { log += "C"; }
+	});
+	REQUIRE(sequence.IsLoading());
+	REQUIRE(sequence.GetProgress() == 0.0f);
+
+	sequence.Update();
+	REQUIRE(log == "A");
+	REQUIRE(sequence.GetProgress() == Approx(1.0f / 3.0f));
+
+	sequence.Update();
+	REQUIRE(log == "AB");
+	REQUIRE(sequence.IsLoading());
+
+	sequence.Update();
+	REQUIRE(log == "ABC");
+	REQUIRE(!sequence.IsLoading());
+	REQUIRE(sequence.GetProgress() == 1.0f);
+
+	// Nothing left to do.
+	sequence.Update();
+	REQUIRE(log == "ABC");
+}
+
+TEST_CASE("Load sequence waits until the next step is ready")
+{
+	LoadSequence sequence;
+	bool ready = false;
+	sequence.SetReadyCheck([&ready]() { return ready; });
+
+	int stepsDone = 0;
+	sequence.Start({
+		[&stepsDone]() { ++stepsDone; },
+		[&stepsDone]() { ++stepsDone; }
+	});
+
+	// Not ready - updating does nothing, however many frames go by.
+	sequence.Update();
+	sequence.Update();
+	REQUIRE(stepsDone == 0);
+
+	ready = true;
+	sequence.Update();
+	REQUIRE(stepsDone == 1);
+
+	// Readiness is checked again before every step.
+	ready = false;
+	sequence.Update();
+	REQUIRE(stepsDone == 1);
+	REQUIRE(sequence.IsLoading());
+
+	ready = true;
+	sequence.Update();
+	REQUIRE(stepsDone == 2);
+	REQUIRE(!sequence.IsLoading());
+}
+
+TEST_CASE("Load sequence calls step callbacks around each step")
+{
+	LoadSequence sequence;
+	std::string log;
+	sequence.SetStepCallbacks([&log, &sequence]() {
+		log += "[";
+		log += sequence.IsLoading() ? "" : "!";
+	}, [&log, &sequence]() {
+		log += sequence.IsLoading() ? "]" : "]done";
+	});
+	sequence.Start({
+		[&log, &sequence]() { log += sequence.IsLoading() ? "A" : "!"; },
+		[&log, &sequence]() { log += sequence.IsLoading() ? "B" : "!"; }
+	});
+
+	// The sequence is still loading while a step runs, even the final one.
+	sequence.Update();
+	REQUIRE(log == "[A]");
+	sequence.Update();
+	REQUIRE(log == "[A][B]done");
+}
+
+TEST_CASE("Load sequence can be restarted")
+{
+	LoadSequence sequence;
+	std::string log;
+	sequence.Start({
+		[&log]() { log += "A"; },
+		[&log]() { log += "B"; }
+	});
+	sequence.Update();
+
+	// Starting over drops any steps that haven't run yet.
+	sequence.Start({
+		[&log]() { log += "C"; }
+	});
+	REQUIRE(sequence.GetProgress() == 0.0f);
+	sequence.Update();
+	sequence.Update();
+	REQUIRE(log == "AC");
+	REQUIRE(!sequence.IsLoading());
+}
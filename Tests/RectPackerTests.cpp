@@ -0,0 +1,105 @@
+//
+// RectPackerTests.cpp
+//
+// Clark Kromenaker
+//
+// Tests for RectPacker class.
+//
+#include "catch.hh"
+#include "RectPacker.h"
+
+#include <vector>
+
+namespace
+{
+	bool Overlaps(const RectPacker& packer, int a, int b, const std::vector<int>& widths, const std::vector<int>& heights)
+	{
+		const RectPacker::Placement& pa = packer.GetPlacement(a);
+		const RectPacker::Placement& pb = packer.GetPlacement(b);
+		if(pa.page != pb.page) { return false; }
+		return pa.x < pb.x + widths[b] && pb.x < pa.x + widths[a] &&
+			   pa.y < pb.y + heights[b] && pb.y < pa.y + heights[a];
+	}
+}
+
+TEST_CASE("Rect packer places rects without overlap")
+{
+	// A mix of sizes, similar to BSP lightmaps.
+	std::vector<int> widths;
+	std::vector<int> heights;
+	RectPacker packer(256, 256);
+	for(int i = 0; i < 200; ++i)
+	{
+		int width = 4 + (i * 7) % 40;
+		int height = 4 + (i * 13) % 30;
+		widths.push_back(width);
+		heights.push_back(height);
+		REQUIRE(packer.Add(width, height) == i);
+	}
+	packer.Pack();
+	REQUIRE(packer.GetPageCount() >= 1);
+
+	for(int i = 0; i < widths.size(); ++i)
+	{
+		// Every rect is placed within the bounds of its page.
+		const RectPacker::Placement& placement = packer.GetPlacement(i);
+		REQUIRE(placement.page >= 0);
+		REQUIRE(placement.page < packer.GetPageCount());
+		REQUIRE(placement.x >= 0);
+		REQUIRE(placement.y >= 0);
+		REQUIRE(placement.x + widths[i] <= packer.GetPageWidth(placement.page));
+		REQUIRE(placement.y + heights[i] <= packer.GetPageHeight(placement.page));
+		REQUIRE(packer.GetPageWidth(placement.page) <= 256);
+		REQUIRE(packer.GetPageHeight(placement.page) <= 256);
+
+		// No two rects overlap.
+		for(int j = i + 1; j < widths.size(); ++j)
+		{
+			REQUIRE_FALSE(Overlaps(packer, i, j, widths, heights));
+		}
+	}
+}
+
+TEST_CASE("Rect packer gives oversized rects their own page")
+{
+	RectPacker packer(64, 64);
+	packer.Add(16, 16);
+	packer.Add(100, 20);
+	packer.Add(16, 16);
+	packer.Pack();
+
+	REQUIRE(packer.GetPageCount() == 2);
+	REQUIRE(packer.GetPlacement(0).page == packer.GetPlacement(2).page);
+
+	const RectPacker::Placement& oversized = packer.GetPlacement(1);
+	REQUIRE(oversized.page != packer.GetPlacement(0).page);
+	REQUIRE(oversized.x == 0);
+	REQUIRE(oversized.y == 0);
+	REQUIRE(packer.GetPageWidth(oversized.page) == 100);
+	REQUIRE(packer.GetPageHeight(oversized.page) == 20);
+
+	// Two small rects side-by-side on a shelf.
+	REQUIRE(packer.GetPageWidth(packer.GetPlacement(0).page) == 32);
+	REQUIRE(packer.GetPageHeight(packer.GetPlacement(0).page) == 16);
+}
+
+TEST_CASE("Rect packer layout is deterministic")
+{
+	// Same sizes packed twice (e.g. lightmaps for different timeblocks) gives same layout.
+	RectPacker packer1(128, 128);
+	RectPacker packer2(128, 128);
+	for(int i = 0; i < 50; ++i)
+	{
+		packer1.Add(8 + i % 5, 8 + i % 3);
+		packer2.Add(8 + i % 5, 8 + i % 3);
+	}
+	packer1.Pack();
+	packer2.Pack();
+	REQUIRE(packer1.GetPageCount() == packer2.GetPageCount());
+	for(int i = 0; i < 50; ++i)
+	{
+		REQUIRE(packer1.GetPlacement(i).page == packer2.GetPlacement(i).page);
+		REQUIRE(packer1.GetPlacement(i).x == packer2.GetPlacement(i).x);
+		REQUIRE(packer1.GetPlacement(i).y == packer2.GetPlacement(i).y);
+	}
+}
@@ -0,0 +1,283 @@
+//
+// SheepManagerTests.cpp
+//
+// Clark Kromenaker
+//
+// Tests for SheepManager class.
+//
+#include "catch.hh"
+#include "SheepManager.h"
+
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#include "Console.h"
+#include "FileSystem.h"
+#include "ReportManager.h"
+#include "SheepScript.h"
+#include "SheepSysFuncs.h"
+#include "Services.h"
+#include "ThreadPool.h"
+
+namespace
+{
+	// Values passed to the Record sys funcs, in call order.
+	std::vector<std::string> sRecorded;
+
+	void SheepManagerTestsRecord_Call(SheepValue* args, SysFuncResult& /*result*/)
+	{
+		sRecorded.push_back(args[0].stringValue);
+	}
+
+	void SheepManagerTestsRecordInt_Call(SheepValue* args, SysFuncResult& /*result*/)
+	{
+		sRecorded.push_back(std::to_string(args[0].intValue));
+	}
+
+	void DeclareSysFuncs()
+	{
+		static bool declared = false;
+		if(!declared)
+		{
+			AddSysFuncDecl("SheepManagerTestsRecord", 0, { 3 }, false, false, &SheepManagerTestsRecord_Call);
+			AddSysFuncDecl("SheepManagerTestsRecordInt", 0, { 1 }, false, false, &SheepManagerTestsRecordInt_Call);
+			declared = true;
+		}
+	}
+
+	// Uses every section of a compiled script: sys imports, string constants, variables, functions, and bytecode.
+	const std::string kSheepA = "symbols { int count$ = 2; string text$ = \"A\"; } code { Run$() { loop$: SheepManagerTestsRecord(text$); count$ = count$ - 1; if(count$ > 0) { goto loop$; } SheepManagerTestsRecord(\"done\"); } }";
+	const std::string kSheepB = "code { Run$() { SheepManagerTestsRecord(\"B\"); } }";
+
+	std::vector<std::string> Run(SheepScript* script)
+	{
+		sRecorded.clear();
+		SheepVM vm;
+		bool finished = false;
+		vm.Execute(script, "Run$", [&finished]() { finished = true; });
+		REQUIRE(finished);
+		return sRecorded;
+	}
+
+	std::vector<char> ReadFile(const std::string& filePath)
+	{
+		std::ifstream file(filePath, std::ios::in | std::ios::binary);
+		return std::vector<char>((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+	}
+
+	// Sheep to compile in a batch, some with warnings or errors.
+	std::vector<SheepBatchItem> CreateBatchItems()
+	{
+		std::vector<SheepBatchItem> items;
+		for(int i = 0; i < 40; ++i)
+		{
+			SheepBatchItem item;
+			item.name = "Item" + std::to_string(i);
+			switch(i % 5)
+			{
+			case 0:
+				item.sheep = "symbols { int x$ = " + std::to_string(i) + "; } code { Run$() { x$ = x$ * 2; SheepManagerTestsRecord(\"" + item.name + "\"); } }";
+				break;
+			case 1:
+				item.eval = true;
+				item.sheep = "{ n$ == " + std::to_string(i) + " && v$ > 0 }";
+				break;
+			case 2:
+				// Undeclared variable, and undeclared sys func.
+				item.sheep = "code { Run$() { y" + std::to_string(i) + "$ = 1; SheepManagerTestsMissing" + std::to_string(i) + "(); } }";
+				break;
+			case 3:
+				// Syntax error.
+				item.sheep = "code { Run$() { SheepManagerTestsRecord(; } }";
+				break;
+			case 4:
+				// Float passed for an int parameter.
+				item.sheep = "code { Run$() { SheepManagerTestsRecordInt(" + std::to_string(i) + ".5); } }";
+				break;
+			}
+			items.push_back(item);
+		}
+		return items;
+	}
+
+	// Logs compile warnings and errors to the console, without headers, so compile reports can be compared.
+	void ReportCompileToConsole(ReportManager& reportManager)
+	{
+		for(auto& streamName : { "SheepCompilerWarning", "SheepCompilerError" })
+		{
+			reportManager.ClearStreamOutput(streamName);
+			reportManager.AddStreamOutput(streamName, ReportOutput::Console);
+			reportManager.ClearStreamContent(streamName);
+			reportManager.AddStreamContent(streamName, ReportContent::Content);
+		}
+	}
+
+	// Names of compiled scripts in the cache directory.
+	std::vector<std::string> GetCachedFileNames(const std::string& cacheDirectory)
+	{
+		std::vector<std::string> fileNames;
+		Directory::GetFiles(cacheDirectory, fileNames);
+
+		std::vector<std::string> cachedFileNames;
+		for(auto& fileName : fileNames)
+		{
+			if(fileName.size() > 4 && fileName.compare(fileName.size() - 4, 4, ".shp") == 0)
+			{
+				cachedFileNames.push_back(fileName);
+			}
+		}
+		return cachedFileNames;
+	}
+}
+
+TEST_CASE("Sheep script written to file loads back the same")
+{
+	DeclareSysFuncs();
+	ReportManager reportManager;
+	Console console;
+	Services::SetReports(&reportManager);
+	Services::SetConsole(&console);
+
+	SheepManager sheepManager;
+	SheepScript* compiled = sheepManager.Compile("Test", kSheepA);
+	REQUIRE(compiled != nullptr);
+
+	const std::string filePath = "SheepManagerTests.shp";
+	REQUIRE(compiled->WriteToFile(filePath));
+	std::vector<char> data = ReadFile(filePath);
+	REQUIRE(!data.empty());
+	SheepScript* loaded = new SheepScript("Test", data.data(), static_cast<int>(data.size()));
+
+	// Bytecode is identical, and it runs the same, so imports, constants, and variables came back too.
+	REQUIRE(loaded->GetBytecodeLength() == compiled->GetBytecodeLength());
+	REQUIRE(std::string(loaded->GetBytecode(), loaded->GetBytecodeLength()) == std::string(compiled->GetBytecode(), compiled->GetBytecodeLength()));
+	std::vector<std::string> expected = { "A", "A", "done" };
+	REQUIRE(Run(compiled) == expected);
+	REQUIRE(Run(loaded) == expected);
+
+	delete compiled;
+	delete loaded;
+	std::remove(filePath.c_str());
+	Services::SetReports(nullptr);
+	Services::SetConsole(nullptr);
+}
+
+TEST_CASE("Sheep manager reuses cached scripts until sys func declarations change")
+{
+	DeclareSysFuncs();
+	ReportManager reportManager;
+	Console console;
+	Services::SetReports(&reportManager);
+	Services::SetConsole(&console);
+
+	// Without a cache directory, nothing is written.
+	const std::string cacheDirectory = "SheepManagerTests_Cache";
+	SheepManager sheepManager;
+	SheepScript* script = sheepManager.Compile("A", kSheepA);
+	REQUIRE(script != nullptr);
+	delete script;
+	REQUIRE(!Directory::Exists(cacheDirectory));
+
+	// The first compile with a cache directory writes one compiled script.
+	sheepManager.SetCacheDirectory(cacheDirectory);
+	script = sheepManager.Compile("A", kSheepA);
+	REQUIRE(script != nullptr);
+	delete script;
+	std::vector<std::string> cachedFileNames = GetCachedFileNames(cacheDirectory);
+	REQUIRE(cachedFileNames.size() == 1);
+	std::string cachePathA = Path::Combine({ cacheDirectory, cachedFileNames[0] });
+
+	// Swap B's compiled script into A's cache file. If A's next compile gives B's script, it came from the cache.
+	SheepScript* scriptB = sheepManager.Compile("B", kSheepB);
+	REQUIRE(scriptB != nullptr);
+	REQUIRE(scriptB->WriteToFile(cachePathA));
+	delete scriptB;
+	for(auto& fileName : GetCachedFileNames(cacheDirectory))
+	{
+		std::string cachePath = Path::Combine({ cacheDirectory, fileName });
+		if(cachePath != cachePathA)
+		{
+			std::remove(cachePath.c_str());
+		}
+	}
+
+	script = sheepManager.Compile("A", kSheepA);
+	REQUIRE(script != nullptr);
+	std::vector<std::string> expectedB = { "B" };
+	REQUIRE(Run(script) == expectedB);
+	delete script;
+	REQUIRE(GetCachedFileNames(cacheDirectory).size() == 1);
+
+	// Declaring another sys func changes the cache key, so A compiles again, to a new cache file.
+	uint64_t declsHash = GetSysFuncDeclsHash();
+	AddSysFuncDecl("SheepManagerTestsInvalidate", 0, { }, false, false, &SheepManagerTestsRecord_Call);
+	REQUIRE(GetSysFuncDeclsHash() != declsHash);
+
+	script = sheepManager.Compile("A", kSheepA);
+	REQUIRE(script != nullptr);
+	std::vector<std::string> expectedA = { "A", "A", "done" };
+	REQUIRE(Run(script) == expectedA);
+	delete script;
+	cachedFileNames = GetCachedFileNames(cacheDirectory);
+	REQUIRE(cachedFileNames.size() == 2);
+
+	std::vector<std::string> fileNames;
+	Directory::GetFiles(cacheDirectory, fileNames);
+	for(auto& fileName : fileNames)
+	{
+		std::remove(Path::Combine({ cacheDirectory, fileName }).c_str());
+	}
+	std::remove(cacheDirectory.c_str());
+	Services::SetReports(nullptr);
+	Services::SetConsole(nullptr);
+}
+
+TEST_CASE("Sheep manager batch compiles match compiling one at a time")
+{
+	DeclareSysFuncs();
+	ReportManager reportManager;
+	Console console;
+	ThreadPool threadPool(4);
+	Services::SetReports(&reportManager);
+	Services::SetConsole(&console);
+	Services::SetJobs(&threadPool);
+	ReportCompileToConsole(reportManager);
+
+	// Compile one at a time.
+	SheepManager sheepManager;
+	std::vector<SheepBatchItem> items = CreateBatchItems();
+	std::vector<SheepScript*> serialScripts;
+	for(auto& item : items)
+	{
+		serialScripts.push_back(item.eval ? sheepManager.CompileEval(item.sheep) : sheepManager.Compile(item.name, item.sheep));
+	}
+	std::vector<std::string> serialReports = console.GetScrollback();
+	REQUIRE(!serialReports.empty());
+
+	// Compile as a batch. The same scripts compile, to the same bytecode.
+	Console batchConsole;
+	Services::SetConsole(&batchConsole);
+	sheepManager.CompileBatch(items);
+	for(size_t i = 0; i < items.size(); ++i)
+	{
+		REQUIRE((items[i].script != nullptr) == (serialScripts[i] != nullptr));
+		if(items[i].script != nullptr)
+		{
+			REQUIRE(items[i].script->GetBytecodeLength() == serialScripts[i]->GetBytecodeLength());
+			REQUIRE(std::string(items[i].script->GetBytecode(), items[i].script->GetBytecodeLength()) ==
+					std::string(serialScripts[i]->GetBytecode(), serialScripts[i]->GetBytecodeLength()));
+		}
+		delete items[i].script;
+		delete serialScripts[i];
+	}
+
+	// Warnings and errors are queued on worker threads, but logged in item order, like when compiling one at a time.
+	REQUIRE(batchConsole.GetScrollback() == serialReports);
+
+	Services::SetJobs(nullptr);
+	Services::SetReports(nullptr);
+	Services::SetConsole(nullptr);
+}
@@ -0,0 +1,376 @@
+//
+// SheepOptimizerTests.cpp
+//
+// Clark Kromenaker
+//
+// Tests for SheepOptimizer class.
+//
+#include "catch.hh"
+#include "SheepOptimizer.h"
+
+#include <cstring>
+#include <iomanip>
+#include <sstream>
+#include <vector>
+
+#include "Console.h"
+#include "ReportManager.h"
+#include "SheepCompiler.h"
+#include "SheepScript.h"
+#include "SheepSysFuncs.h"
+#include "SheepVM.h"
+#include "Services.h"
+
+namespace
+{
+	void Add(std::vector<char>& bytecode, SheepInstruction instruction)
+	{
+		bytecode.push_back(static_cast<char>(instruction));
+	}
+
+	void Add(std::vector<char>& bytecode, SheepInstruction instruction, int arg)
+	{
+		bytecode.push_back(static_cast<char>(instruction));
+		for(int i = 0; i < 4; ++i)
+		{
+			bytecode.push_back(static_cast<char>((static_cast<unsigned int>(arg) >> (i * 8)) & 0xFF));
+		}
+	}
+
+	void Add(std::vector<char>& bytecode, SheepInstruction instruction, float arg)
+	{
+		int intArg = 0;
+		memcpy(&intArg, &arg, sizeof(int));
+		Add(bytecode, instruction, intArg);
+	}
+
+	// Values passed to the Record sys funcs, in call order.
+	std::vector<std::string> sRecorded;
+
+	void RecordInt_Call(SheepValue* args, SysFuncResult& /*result*/)
+	{
+		sRecorded.push_back(std::to_string(args[0].intValue));
+	}
+
+	void RecordFloat_Call(SheepValue* args, SysFuncResult& /*result*/)
+	{
+		// Enough precision to tell apart any two floats.
+		std::ostringstream ss;
+		ss << std::setprecision(9) << args[0].floatValue;
+		sRecorded.push_back(ss.str());
+	}
+
+	void RecordString_Call(SheepValue* args, SysFuncResult& /*result*/)
+	{
+		sRecorded.push_back(args[0].stringValue);
+	}
+
+	// Compiles the sheep, runs each function in order, and returns everything the functions recorded.
+	std::vector<std::string> CompileAndRun(const std::string& sheep, const std::vector<std::string>& functionNames, bool optimize, int* bytecodeLength = nullptr)
+	{
+		static bool declared = false;
+		if(!declared)
+		{
+			AddSysFuncDecl("RecordInt", 0, { 1 }, false, false, &RecordInt_Call);
+			AddSysFuncDecl("RecordFloat", 0, { 2 }, false, false, &RecordFloat_Call);
+			AddSysFuncDecl("RecordString", 0, { 3 }, false, false, &RecordString_Call);
+			declared = true;
+		}
+
+		// The compiler and VM log through the report manager, which may output to the console.
+		ReportManager reportManager;
+		Console console;
+		Services::SetReports(&reportManager);
+		Services::SetConsole(&console);
+
+		SheepCompiler compiler;
+		compiler.SetOptimize(optimize);
+		SheepScript* script = compiler.Compile("Test", sheep);
+		REQUIRE(script != nullptr);
+		if(bytecodeLength != nullptr)
+		{
+			*bytecodeLength = script->GetBytecodeLength();
+		}
+
+		sRecorded.clear();
+		{
+			SheepVM vm;
+			for(auto& functionName : functionNames)
+			{
+				bool finished = false;
+				vm.Execute(script, functionName, [&finished]() { finished = true; });
+				REQUIRE(finished);
+			}
+		}
+		delete script;
+
+		Services::SetReports(nullptr);
+		Services::SetConsole(nullptr);
+		return sRecorded;
+	}
+}
+
+TEST_CASE("Sheep optimizer folds constant expressions")
+{
+	// 1 + 2 * 3 => 7
+	std::vector<char> bytecode;
+	Add(bytecode, SheepInstruction::PushI, 1);
+	Add(bytecode, SheepInstruction::PushI, 2);
+	Add(bytecode, SheepInstruction::PushI, 3);
+	Add(bytecode, SheepInstruction::MultiplyI);
+	Add(bytecode, SheepInstruction::AddI);
+	Add(bytecode, SheepInstruction::StoreI, 0);
+	Add(bytecode, SheepInstruction::ReturnV);
+
+	SheepOptimizer optimizer(bytecode);
+	REQUIRE(optimizer.Optimize());
+
+	std::vector<char> expected;
+	Add(expected, SheepInstruction::PushI, 7);
+	Add(expected, SheepInstruction::StoreI, 0);
+	Add(expected, SheepInstruction::ReturnV);
+	REQUIRE(optimizer.GetBytecode() == expected);
+}
+
+TEST_CASE("Sheep optimizer matches VM math edge cases")
+{
+	// Divide by zero is an error in the VM, so it's left alone. Float compare gives an int, and IToF converts.
+	std::vector<char> bytecode;
+	Add(bytecode, SheepInstruction::PushI, 5);
+	Add(bytecode, SheepInstruction::PushI, 0);
+	Add(bytecode, SheepInstruction::DivideI);
+	Add(bytecode, SheepInstruction::StoreI, 0);
+	Add(bytecode, SheepInstruction::PushF, 5.0f);
+	Add(bytecode, SheepInstruction::PushF, 0.0f);
+	Add(bytecode, SheepInstruction::DivideF);
+	Add(bytecode, SheepInstruction::StoreF, 1);
+	Add(bytecode, SheepInstruction::PushF, 1.5f);
+	Add(bytecode, SheepInstruction::PushI, 1);
+	Add(bytecode, SheepInstruction::IToF, 0);
+	Add(bytecode, SheepInstruction::IsGreaterF);
+	Add(bytecode, SheepInstruction::StoreI, 2);
+	Add(bytecode, SheepInstruction::ReturnV);
+
+	SheepOptimizer optimizer(bytecode);
+	REQUIRE(optimizer.Optimize());
+
+	std::vector<char> expected;
+	Add(expected, SheepInstruction::PushI, 5);
+	Add(expected, SheepInstruction::PushI, 0);
+	Add(expected, SheepInstruction::DivideI);
+	Add(expected, SheepInstruction::StoreI, 0);
+	Add(expected, SheepInstruction::PushF, 5.0f);
+	Add(expected, SheepInstruction::PushF, 0.0f);
+	Add(expected, SheepInstruction::DivideF);
+	Add(expected, SheepInstruction::StoreF, 1);
+	Add(expected, SheepInstruction::PushI, 1);
+	Add(expected, SheepInstruction::StoreI, 2);
+	Add(expected, SheepInstruction::ReturnV);
+	REQUIRE(optimizer.GetBytecode() == expected);
+}
+
+TEST_CASE("Sheep optimizer removes unused pushes and padding")
+{
+	std::vector<char> bytecode;
+	Add(bytecode, SheepInstruction::PushI, 10);
+	Add(bytecode, SheepInstruction::Pop);
+	Add(bytecode, SheepInstruction::ReturnV);
+	Add(bytecode, SheepInstruction::SitnSpin);
+	Add(bytecode, SheepInstruction::SitnSpin);
+	int secondFunctionOffset = static_cast<int>(bytecode.size());
+	Add(bytecode, SheepInstruction::LoadI, 0);
+	Add(bytecode, SheepInstruction::Pop);
+	Add(bytecode, SheepInstruction::ReturnV);
+
+	SheepOptimizer optimizer(bytecode);
+	optimizer.AddEntryPoint(0);
+	optimizer.AddEntryPoint(secondFunctionOffset);
+	REQUIRE(optimizer.Optimize());
+
+	std::vector<char> expected;
+	Add(expected, SheepInstruction::ReturnV);
+	Add(expected, SheepInstruction::ReturnV);
+	REQUIRE(optimizer.GetBytecode() == expected);
+
+	// Entry points map to their new offsets.
+	REQUIRE(optimizer.GetOptimizedOffset(0) == 0);
+	REQUIRE(optimizer.GetOptimizedOffset(secondFunctionOffset) == 1);
+
+	// Not the start of an instruction.
+	REQUIRE(optimizer.GetOptimizedOffset(1) == -1);
+}
+
+TEST_CASE("Sheep optimizer threads branches")
+{
+	// An if/else nested in an if/else ends with a branch to a branch, with padding in between.
+	std::vector<char> bytecode;
+	Add(bytecode, SheepInstruction::LoadI, 0);          // 0
+	Add(bytecode, SheepInstruction::BranchIfZero, 16);  // 5
+	Add(bytecode, SheepInstruction::Yield);             // 10
+	Add(bytecode, SheepInstruction::Branch, 21);        // 11
+	Add(bytecode, SheepInstruction::SitnSpin);          // 16
+	Add(bytecode, SheepInstruction::SitnSpin);          // 17
+	Add(bytecode, SheepInstruction::SitnSpin);          // 18
+	Add(bytecode, SheepInstruction::SitnSpin);          // 19
+	Add(bytecode, SheepInstruction::SitnSpin);          // 20
+	Add(bytecode, SheepInstruction::Branch, 26);        // 21
+	Add(bytecode, SheepInstruction::ReturnV);           // 26
+
+	SheepOptimizer optimizer(bytecode);
+	optimizer.AddEntryPoint(0);
+	REQUIRE(optimizer.Optimize());
+
+	// Branch to 16 lands on padding, then a branch to the next instruction, so all of it goes.
+	std::vector<char> expected;
+	Add(expected, SheepInstruction::LoadI, 0);          // 0
+	Add(expected, SheepInstruction::BranchIfZero, 11);  // 5
+	Add(expected, SheepInstruction::Yield);             // 10
+	Add(expected, SheepInstruction::ReturnV);           // 11
+	REQUIRE(optimizer.GetBytecode() == expected);
+}
+
+TEST_CASE("Sheep optimizer doesn't fold across branch targets")
+{
+	// The AddI can be reached with a different value on the stack, so it can't be folded.
+	std::vector<char> bytecode;
+	Add(bytecode, SheepInstruction::PushI, 1);          // 0
+	Add(bytecode, SheepInstruction::LoadI, 0);          // 5
+	Add(bytecode, SheepInstruction::BranchIfZero, 25);  // 10
+	Add(bytecode, SheepInstruction::PushI, 2);          // 15
+	Add(bytecode, SheepInstruction::Branch, 26);        // 20
+	Add(bytecode, SheepInstruction::Yield);             // 25
+	Add(bytecode, SheepInstruction::AddI);              // 26
+	Add(bytecode, SheepInstruction::StoreI, 0);         // 27
+	Add(bytecode, SheepInstruction::ReturnV);           // 32
+
+	SheepOptimizer optimizer(bytecode);
+	optimizer.AddEntryPoint(0);
+	REQUIRE(optimizer.Optimize());
+	REQUIRE(optimizer.GetBytecode() == bytecode);
+}
+
+TEST_CASE("Sheep optimizer resolves constant conditions")
+{
+	// if(0) { Yield } else { BeginWait; EndWait }
+	std::vector<char> bytecode;
+	Add(bytecode, SheepInstruction::PushI, 0);          // 0
+	Add(bytecode, SheepInstruction::BranchIfZero, 16);  // 5
+	Add(bytecode, SheepInstruction::Yield);             // 10
+	Add(bytecode, SheepInstruction::Branch, 18);        // 11
+	Add(bytecode, SheepInstruction::BeginWait);         // 16
+	Add(bytecode, SheepInstruction::EndWait);           // 17
+	Add(bytecode, SheepInstruction::ReturnV);           // 18
+
+	SheepOptimizer optimizer(bytecode);
+	optimizer.AddEntryPoint(0);
+	REQUIRE(optimizer.Optimize());
+
+	// The condition always branches, so it becomes an unconditional branch.
+	// The "if" block is left in place, since the optimizer doesn't remove unreachable code.
+	std::vector<char> expected;
+	Add(expected, SheepInstruction::Branch, 11);        // 0
+	Add(expected, SheepInstruction::Yield);             // 5
+	Add(expected, SheepInstruction::Branch, 13);        // 6
+	Add(expected, SheepInstruction::BeginWait);         // 11
+	Add(expected, SheepInstruction::EndWait);           // 12
+	Add(expected, SheepInstruction::ReturnV);           // 13
+	REQUIRE(optimizer.GetBytecode() == expected);
+
+	// A non-zero condition never branches, so it's removed entirely.
+	bytecode[1] = 1;
+	SheepOptimizer optimizer2(bytecode);
+	optimizer2.AddEntryPoint(0);
+	REQUIRE(optimizer2.Optimize());
+
+	expected.clear();
+	Add(expected, SheepInstruction::Yield);             // 0
+	Add(expected, SheepInstruction::Branch, 8);         // 1
+	Add(expected, SheepInstruction::BeginWait);         // 6
+	Add(expected, SheepInstruction::EndWait);           // 7
+	Add(expected, SheepInstruction::ReturnV);           // 8
+	REQUIRE(optimizer2.GetBytecode() == expected);
+}
+
+TEST_CASE("Sheep optimizer doesn't change what compiled sheep does")
+{
+	const std::string sheep = R"(
+		symbols
+		{
+			int i$ = 0;
+			int total$ = 0;
+			int zero$ = 0;
+			float f$ = 2.5;
+			string s$ = "sheep";
+		}
+		code
+		{
+			Math$()
+			{
+				RecordInt(1 + 2 * 3 - 8 / 2);
+				RecordInt(7 / 2);
+				RecordInt(5 / 0);
+				RecordInt(5 / zero$);
+				RecordFloat(2.0 / 0.0);
+				RecordFloat(1.5 * 4.0 + 0.25);
+				RecordFloat(f$ / 2.0 - 1.0);
+				RecordFloat(1.0 / 3.0);
+			}
+
+			Logic$()
+			{
+				if(2.0 < 1.5)
+				{
+					RecordString("less");
+				}
+				if(2.0 >= 2.0)
+				{
+					RecordString("greater or equal");
+				}
+				RecordInt(1 && 0 || !0);
+				RecordInt(!(3 == 4) && 5 != 5);
+				if(1 < 2)
+				{
+					RecordString(s$);
+				}
+				else
+				{
+					RecordString("unreachable");
+				}
+				if(0)
+				{
+					RecordInt(-1);
+				}
+			}
+
+			Loop$()
+			{
+				i$ = 0;
+				total$ = 0;
+			loop$:
+				total$ = total$ + i$ * 2;
+				i$ = i$ + 1;
+				if(i$ < 10)
+				{
+					goto loop$;
+				}
+				RecordInt(total$);
+			}
+		}
+	)";
+	const std::vector<std::string> functionNames = { "Math$", "Logic$", "Loop$" };
+
+	int unoptimizedLength = 0;
+	int optimizedLength = 0;
+	std::vector<std::string> unoptimized = CompileAndRun(sheep, functionNames, false, &unoptimizedLength);
+	std::vector<std::string> optimized = CompileAndRun(sheep, functionNames, true, &optimizedLength);
+	REQUIRE(optimized == unoptimized);
+	REQUIRE(optimizedLength < unoptimizedLength);
+
+	// Spot check against known results, so both can't be wrong in the same way.
+	std::vector<std::string> expected = {
+		"3", "3", "0", "0", "0", "6.25", "0.25", "0.333333343",
+		"greater or equal", "1", "0", "sheep",
+		"90"
+	};
+	REQUIRE(unoptimized == expected);
+}
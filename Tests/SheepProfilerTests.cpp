@@ -0,0 +1,63 @@
+//
+// SheepProfilerTests.cpp
+//
+// Clark Kromenaker
+//
+// Tests for SheepProfiler class.
+//
+#include "catch.hh"
+#include "SheepProfiler.h"
+
+#include <string>
+
+TEST_CASE("Sheep profiler accumulates samples")
+{
+	SheepProfiler profiler;
+	profiler.SetEnabled(true);
+	
+	SheepProfiler::Clock::time_point start;
+	profiler.AddFunctionSample("Script:Func$", true, 10, start, start + std::chrono::milliseconds(2));
+	profiler.AddFunctionSample("Script:Func$", false, 5, start, start + std::chrono::milliseconds(3));
+	profiler.AddFunctionSample("Script:Func$", true, 1, start, start + std::chrono::milliseconds(1));
+	profiler.AddSysFuncSample("PrintString", start, start + std::chrono::microseconds(500));
+	profiler.AddSysFuncSample("PrintString", start, start + std::chrono::microseconds(250));
+	
+	// Continuing after a wait isn't a new call.
+	const SheepProfiler::Record& function = profiler.GetFunctionRecords().at("Script:Func$");
+	REQUIRE(function.callCount == 2);
+	REQUIRE(function.instructionCount == 16);
+	REQUIRE(function.totalNanoseconds == 6000000);
+	REQUIRE(function.maxNanoseconds == 3000000);
+	
+	const SheepProfiler::Record& sysFunc = profiler.GetSysFuncRecords().at("PrintString");
+	REQUIRE(sysFunc.callCount == 2);
+	REQUIRE(sysFunc.instructionCount == 0);
+	REQUIRE(sysFunc.totalNanoseconds == 750000);
+	REQUIRE(sysFunc.maxNanoseconds == 500000);
+	
+	// Re-enabling clears old data.
+	profiler.SetEnabled(false);
+	REQUIRE(profiler.GetFunctionRecords().size() == 1);
+	profiler.SetEnabled(true);
+	REQUIRE(profiler.GetFunctionRecords().empty());
+	REQUIRE(profiler.GetSysFuncRecords().empty());
+}
+
+TEST_CASE("Sheep profiler report lists most expensive first")
+{
+	SheepProfiler profiler;
+	profiler.SetEnabled(true);
+	
+	SheepProfiler::Clock::time_point start;
+	profiler.AddFunctionSample("A:Cheap$", true, 100, start, start + std::chrono::milliseconds(1));
+	profiler.AddFunctionSample("B:Expensive$", true, 5, start, start + std::chrono::milliseconds(20));
+	profiler.AddSysFuncSample("Fast", start, start + std::chrono::milliseconds(1));
+	profiler.AddSysFuncSample("Slow", start, start + std::chrono::milliseconds(4));
+	
+	std::string report = profiler.GetReport();
+	REQUIRE(report.find("B:Expensive$: 1 calls, 5 instructions, 20.000 ms total, 20.000 ms max") != std::string::npos);
+	REQUIRE(report.find("B:Expensive$") < report.find("A:Cheap$"));
+	REQUIRE(report.find("A:Cheap$") < report.find("System functions:"));
+	REQUIRE(report.find("System functions:") < report.find("Slow"));
+	REQUIRE(report.find("Slow") < report.find("Fast"));
+}
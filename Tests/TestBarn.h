@@ -0,0 +1,209 @@
+//
+// TestBarn.h
+//
+// Clark Kromenaker
+//
+// Writes small barn files for tests, laid out like GK3's barns:
+// a header, a table of contents, one directory per barn that assets are stored in, and then the asset data.
+//
+#pragma once
+#include <algorithm>
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "minilzo.h"
+#include "zlib.h"
+
+#include "BarnAsset.h"
+
+class TestBarn
+{
+public:
+	// Adds an asset whose data is stored in this barn.
+	void AddAsset(const std::string& name, const std::string& data, CompressionType compressionType = CompressionType::None)
+	{
+		mEntries.push_back({ name, data, compressionType, std::string() });
+	}
+
+	// Adds an asset that's only a pointer to the same asset in another barn.
+	void AddPointer(const std::string& name, const std::string& barnName)
+	{
+		mEntries.push_back({ name, std::string(), CompressionType::None, barnName });
+	}
+
+	// Writes the barn to a file. Only the first "length" bytes are written, if a length is given (to simulate a truncated file).
+	bool Write(const std::string& filePath, size_t length = SIZE_MAX) const
+	{
+		std::vector<char> bytes = Build();
+		std::ofstream file(filePath, std::ios::out | std::ios::binary | std::ios::trunc);
+		file.write(bytes.data(), std::min(length, bytes.size()));
+		return file.good();
+	}
+
+	// Size of the barn file, if written in full.
+	size_t GetSize() const { return Build().size(); }
+
+private:
+	struct Entry
+	{
+		std::string name;
+		std::string data;
+		CompressionType compressionType;
+		std::string barnName;
+	};
+	std::vector<Entry> mEntries;
+
+	static void WriteUInt(std::vector<char>& bytes, uint32_t value)
+	{
+		for(int i = 0; i < 4; ++i)
+		{
+			bytes.push_back(static_cast<char>((value >> (i * 8)) & 0xFF));
+		}
+	}
+
+	static void SetUInt(std::vector<char>& bytes, size_t offset, uint32_t value)
+	{
+		for(int i = 0; i < 4; ++i)
+		{
+			bytes[offset + i] = static_cast<char>((value >> (i * 8)) & 0xFF);
+		}
+	}
+
+	static void WriteFixedString(std::vector<char>& bytes, const std::string& str, size_t length)
+	{
+		for(size_t i = 0; i < length; ++i)
+		{
+			bytes.push_back(i < str.size() ? str[i] : '\0');
+		}
+	}
+
+	static std::string Compress(const std::string& data, CompressionType compressionType)
+	{
+		if(compressionType == CompressionType::Zlib)
+		{
+			uLongf compressedSize = compressBound(static_cast<uLong>(data.size()));
+			std::vector<char> compressed(compressedSize);
+			compress2(reinterpret_cast<Bytef*>(compressed.data()), &compressedSize,
+					  reinterpret_cast<const Bytef*>(data.data()), static_cast<uLong>(data.size()), Z_BEST_COMPRESSION);
+			return std::string(compressed.data(), compressedSize);
+		}
+		if(compressionType == CompressionType::Lzo)
+		{
+			lzo_init();
+			std::vector<char> workMemory(LZO1X_1_MEM_COMPRESS);
+			lzo_uint compressedSize = data.size() + data.size() / 16 + 64 + 3;
+			std::vector<char> compressed(compressedSize);
+			lzo1x_1_compress(reinterpret_cast<const lzo_bytep>(data.data()), data.size(),
+							 reinterpret_cast<lzo_bytep>(compressed.data()), &compressedSize, workMemory.data());
+			return std::string(compressed.data(), compressedSize);
+		}
+		return data;
+	}
+
+	std::vector<char> Build() const
+	{
+		// Group assets by the barn they're stored in - each barn gets its own directory.
+		// Assets stored in this barn have no barn name.
+		std::vector<std::string> barnNames;
+		for(auto& entry : mEntries)
+		{
+			if(std::find(barnNames.begin(), barnNames.end(), entry.barnName) == barnNames.end())
+			{
+				barnNames.push_back(entry.barnName);
+			}
+		}
+
+		// Header: identifiers, three unknown values, and the table of contents offset.
+		std::vector<char> bytes;
+		WriteUInt(bytes, 0x21334B47); // GK3!
+		WriteUInt(bytes, 0x6E726142); // Barn
+		WriteUInt(bytes, 65536);
+		WriteUInt(bytes, 65536);
+		WriteUInt(bytes, 0);
+		WriteUInt(bytes, static_cast<uint32_t>(bytes.size() + 4));
+
+		// Table of contents: one entry per directory, then the data section.
+		// Offsets are filled in once they're known.
+		WriteUInt(bytes, static_cast<uint32_t>(barnNames.size() + 1));
+		size_t tocEntriesOffset = bytes.size();
+		for(size_t i = 0; i <= barnNames.size(); ++i)
+		{
+			WriteUInt(bytes, i < barnNames.size() ? 0x44446972 : 0x44617461); // DDir or Data
+			for(int j = 0; j < 6; ++j)
+			{
+				WriteUInt(bytes, 0);
+			}
+		}
+
+		// Compressed data has an 8-byte header, starting with the uncompressed size.
+		std::vector<std::string> storedData;
+		for(auto& entry : mEntries)
+		{
+			std::string data = Compress(entry.data, entry.compressionType);
+			if(entry.compressionType != CompressionType::None)
+			{
+				std::vector<char> dataHeader;
+				WriteUInt(dataHeader, static_cast<uint32_t>(entry.data.size()));
+				WriteUInt(dataHeader, static_cast<uint32_t>(data.size()));
+				data.insert(0, dataHeader.data(), dataHeader.size());
+			}
+			storedData.push_back(data);
+		}
+
+		// Directories: a header naming the barn, then an entry per asset.
+		uint32_t nextDataOffset = 0;
+		std::vector<uint32_t> dataOffsets(mEntries.size(), 0);
+		for(size_t i = 0; i < mEntries.size(); ++i)
+		{
+			if(!mEntries[i].barnName.empty()) { continue; }
+			dataOffsets[i] = nextDataOffset;
+			nextDataOffset += static_cast<uint32_t>(storedData[i].size());
+		}
+		for(size_t i = 0; i < barnNames.size(); ++i)
+		{
+			size_t tocEntryOffset = tocEntriesOffset + i * 28;
+			SetUInt(bytes, tocEntryOffset + 20, static_cast<uint32_t>(bytes.size()));
+
+			int assetCount = 0;
+			for(auto& entry : mEntries)
+			{
+				if(entry.barnName == barnNames[i]) { ++assetCount; }
+			}
+			WriteFixedString(bytes, barnNames[i], 32);
+			WriteUInt(bytes, 0);
+			WriteFixedString(bytes, "Test Barn", 40);
+			WriteUInt(bytes, 0);
+			WriteUInt(bytes, assetCount);
+
+			SetUInt(bytes, tocEntryOffset + 24, static_cast<uint32_t>(bytes.size()));
+			for(size_t j = 0; j < mEntries.size(); ++j)
+			{
+				const Entry& entry = mEntries[j];
+				if(entry.barnName != barnNames[i]) { continue; }
+
+				// Size is the compressed size (not including the compressed data header) for compressed assets.
+				bool compressed = entry.compressionType != CompressionType::None;
+				WriteUInt(bytes, static_cast<uint32_t>(entry.barnName.empty() ? storedData[j].size() - (compressed ? 8 : 0) : entry.data.size()));
+				WriteUInt(bytes, dataOffsets[j]);
+				WriteUInt(bytes, 0);
+				bytes.push_back(0);
+				bytes.push_back(static_cast<char>(entry.compressionType));
+				bytes.push_back(static_cast<char>(entry.name.size()));
+				WriteFixedString(bytes, entry.name, entry.name.size() + 1);
+			}
+		}
+
+		// Data section.
+		SetUInt(bytes, tocEntriesOffset + barnNames.size() * 28 + 20, static_cast<uint32_t>(bytes.size()));
+		for(size_t i = 0; i < mEntries.size(); ++i)
+		{
+			if(mEntries[i].barnName.empty())
+			{
+				bytes.insert(bytes.end(), storedData[i].begin(), storedData[i].end());
+			}
+		}
+		return bytes;
+	}
+};
@@ -0,0 +1,74 @@
+//
+// ThreadPoolTests.cpp
+//
+// Clark Kromenaker
+//
+// Tests for ThreadPool class.
+//
+#include "catch.hh"
+#include "ThreadPool.h"
+
+#include <atomic>
+
+TEST_CASE("Thread pool runs every job before WaitForAll returns")
+{
+	ThreadPool threadPool(4);
+	std::atomic<int> count(0);
+	for(int round = 0; round < 20; ++round)
+	{
+		for(int i = 0; i < 500; ++i)
+		{
+			threadPool.Enqueue([&count]() { ++count; });
+		}
+		threadPool.WaitForAll();
+		REQUIRE(count == (round + 1) * 500);
+	}
+}
+
+TEST_CASE("Thread pool runs jobs queued from other jobs")
+{
+	// Jobs queued from a worker go to that worker's queue, so other workers have to steal them.
+	ThreadPool threadPool(3);
+	std::atomic<int> count(0);
+	for(int i = 0; i < 50; ++i)
+	{
+		threadPool.Enqueue([&threadPool, &count]() {
+			for(int j = 0; j < 20; ++j)
+			{
+				threadPool.Enqueue([&count]() { ++count; });
+			}
+			++count;
+		});
+	}
+	threadPool.WaitForAll();
+	REQUIRE(count == 50 * 21);
+}
+
+TEST_CASE("Thread pool waits on a batch without waiting on other jobs")
+{
+	ThreadPool threadPool(2);
+	
+	// An unrelated job that doesn't finish until after the batch has been waited on.
+	std::atomic<bool> blockerStarted(false);
+	std::atomic<bool> releaseBlocker(false);
+	threadPool.Enqueue([&blockerStarted, &releaseBlocker]() {
+		blockerStarted = true;
+		while(!releaseBlocker) { std::this_thread::yield(); }
+	});
+	while(!blockerStarted) { std::this_thread::yield(); }
+	
+	std::atomic<int> pendingCount(100);
+	std::atomic<int> doneCount(0);
+	for(int i = 0; i < 100; ++i)
+	{
+		threadPool.Enqueue([&pendingCount, &doneCount]() {
+			++doneCount;
+			--pendingCount;
+		});
+	}
+	threadPool.WaitForCount(pendingCount);
+	REQUIRE(doneCount == 100);
+	
+	releaseBlocker = true;
+	threadPool.WaitForAll();
+}
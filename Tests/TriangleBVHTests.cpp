@@ -0,0 +1,231 @@
+//
+// TriangleBVHTests.cpp
+//
+// Clark Kromenaker
+//
+// Tests for TriangleBVH class.
+//
+#include "catch.hh"
+#include "TriangleBVH.h"
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+
+#include "Ray.h"
+#include "TriangleBatch.h"
+
+namespace
+{
+	// Fills a BVH with a grid of quads (two triangles each) on the XZ plane at the given height.
+	// Each quad gets its own ID.
+	void AddQuadGrid(TriangleBVH& bvh, int size, float height, int firstId)
+	{
+		for(int x = 0; x < size; ++x)
+		{
+			for(int z = 0; z < size; ++z)
+			{
+				Vector3 p0(x, height, z);
+				Vector3 p1(x + 1, height, z);
+				Vector3 p2(x + 1, height, z + 1);
+				Vector3 p3(x, height, z + 1);
+				int id = firstId + x * size + z;
+				bvh.AddTriangle(p0, p1, p2, id);
+				bvh.AddTriangle(p0, p2, p3, id);
+			}
+		}
+	}
+
+	float RandomRange(float min, float max)
+	{
+		return min + (max - min) * (static_cast<float>(std::rand()) / RAND_MAX);
+	}
+}
+
+TEST_CASE("Empty BVH hits nothing")
+{
+	TriangleBVH bvh;
+	bvh.Build();
+	REQUIRE(bvh.IsEmpty());
+
+	TriangleBVH::Hit hit;
+	REQUIRE_FALSE(bvh.RaycastNearest(Ray(Vector3::Zero, Vector3::UnitX), hit));
+	REQUIRE(hit.id == -1);
+
+	std::vector<TriangleBVH::Hit> hits;
+	bvh.RaycastAll(Ray(Vector3::Zero, Vector3::UnitX), hits);
+	REQUIRE(hits.empty());
+}
+
+TEST_CASE("BVH raycasts find nearest triangle")
+{
+	// Two stacked grids - a floor at y=0 and a ceiling at y=10.
+	TriangleBVH bvh;
+	AddQuadGrid(bvh, 16, 0.0f, 0);
+	AddQuadGrid(bvh, 16, 10.0f, 1000);
+	bvh.Build();
+	REQUIRE(bvh.GetTriangleCount() == 16 * 16 * 2 * 2);
+	REQUIRE(bvh.GetNodeCount() > 1);
+
+	// Cast down from above - should hit the ceiling first.
+	TriangleBVH::Hit hit;
+	REQUIRE(bvh.RaycastNearest(Ray(Vector3(3.25f, 20.0f, 5.5f), -Vector3::UnitY), hit));
+	REQUIRE(hit.id == 1000 + 3 * 16 + 5);
+	REQUIRE(hit.t == Approx(10.0f));
+
+	// Cast up from between the grids - should hit the ceiling.
+	REQUIRE(bvh.RaycastNearest(Ray(Vector3(7.5f, 5.0f, 2.5f), Vector3::UnitY), hit));
+	REQUIRE(hit.id == 1000 + 7 * 16 + 2);
+	REQUIRE(hit.t == Approx(5.0f));
+
+	// Cast outside the grids - nothing to hit.
+	REQUIRE_FALSE(bvh.RaycastNearest(Ray(Vector3(-5.0f, 20.0f, -5.0f), -Vector3::UnitY), hit));
+
+	// Filter out the ceiling - should hit the floor instead.
+	REQUIRE(bvh.RaycastNearest(Ray(Vector3(3.25f, 20.0f, 5.5f), -Vector3::UnitY), hit, [](int id) { return id < 1000; }));
+	REQUIRE(hit.id == 3 * 16 + 5);
+	REQUIRE(hit.t == Approx(20.0f));
+
+	// Raycast all should get both grids.
+	std::vector<TriangleBVH::Hit> hits;
+	bvh.RaycastAll(Ray(Vector3(3.25f, 20.0f, 5.5f), -Vector3::UnitY), hits);
+	REQUIRE(hits.size() == 2);
+}
+
+TEST_CASE("BVH raycasts match brute force")
+{
+	// Scatter a bunch of random triangles, and keep a copy to brute force against.
+	std::srand(1234);
+	std::vector<Vector3> points;
+	TriangleBVH bvh;
+	for(int i = 0; i < 2000; ++i)
+	{
+		Vector3 center(RandomRange(-100.0f, 100.0f), RandomRange(-100.0f, 100.0f), RandomRange(-100.0f, 100.0f));
+		Vector3 p0 = center + Vector3(RandomRange(-5.0f, 5.0f), RandomRange(-5.0f, 5.0f), RandomRange(-5.0f, 5.0f));
+		Vector3 p1 = center + Vector3(RandomRange(-5.0f, 5.0f), RandomRange(-5.0f, 5.0f), RandomRange(-5.0f, 5.0f));
+		Vector3 p2 = center + Vector3(RandomRange(-5.0f, 5.0f), RandomRange(-5.0f, 5.0f), RandomRange(-5.0f, 5.0f));
+		bvh.AddTriangle(p0, p1, p2, i);
+		points.push_back(p0);
+		points.push_back(p1);
+		points.push_back(p2);
+	}
+	bvh.Build();
+
+	for(int i = 0; i < 500; ++i)
+	{
+		Vector3 origin(RandomRange(-150.0f, 150.0f), RandomRange(-150.0f, 150.0f), RandomRange(-150.0f, 150.0f));
+		Vector3 target(RandomRange(-50.0f, 50.0f), RandomRange(-50.0f, 50.0f), RandomRange(-50.0f, 50.0f));
+		Ray ray(origin, (target - origin).Normalize());
+
+		int bruteForceId = -1;
+		int bruteForceCount = 0;
+		float bruteForceT = FLT_MAX;
+		for(int j = 0; j < points.size(); j += 3)
+		{
+			RaycastHit hitInfo;
+			if(Collisions::TestRayTriangle(ray, points[j], points[j + 1], points[j + 2], hitInfo))
+			{
+				++bruteForceCount;
+				if(hitInfo.t < bruteForceT)
+				{
+					bruteForceT = hitInfo.t;
+					bruteForceId = j / 3;
+				}
+			}
+		}
+
+		TriangleBVH::Hit hit;
+		REQUIRE(bvh.RaycastNearest(ray, hit) == (bruteForceId >= 0));
+		REQUIRE(hit.id == bruteForceId);
+
+		std::vector<TriangleBVH::Hit> hits;
+		bvh.RaycastAll(ray, hits);
+		REQUIRE(hits.size() == bruteForceCount);
+	}
+}
+
+// Hidden by default - run explicitly with the "[benchmark]" tag.
+TEST_CASE("BVH raycast benchmark", "[.][benchmark]")
+{
+	// Roughly the triangle count of a large scene BSP.
+	const int kGridSize = 100;
+	std::vector<Vector3> points;
+	TriangleBVH bvh;
+	AddQuadGrid(bvh, kGridSize, 0.0f, 0);
+	for(int x = 0; x < kGridSize; ++x)
+	{
+		for(int z = 0; z < kGridSize; ++z)
+		{
+			points.push_back(Vector3(x, 0.0f, z));
+			points.push_back(Vector3(x + 1, 0.0f, z));
+			points.push_back(Vector3(x + 1, 0.0f, z + 1));
+			points.push_back(Vector3(x, 0.0f, z));
+			points.push_back(Vector3(x + 1, 0.0f, z + 1));
+			points.push_back(Vector3(x, 0.0f, z + 1));
+		}
+	}
+
+	auto buildStart = std::chrono::high_resolution_clock::now();
+	bvh.Build();
+	auto buildEnd = std::chrono::high_resolution_clock::now();
+
+	// Same set of rays for both approaches.
+	std::srand(5678);
+	std::vector<Ray> rays;
+	for(int i = 0; i < 1000; ++i)
+	{
+		Vector3 origin(RandomRange(0.0f, kGridSize), 50.0f, RandomRange(0.0f, kGridSize));
+		Vector3 target(RandomRange(0.0f, kGridSize), 0.0f, RandomRange(0.0f, kGridSize));
+		rays.push_back(Ray(origin, (target - origin).Normalize()));
+	}
+
+	int bruteForceHitCount = 0;
+	auto bruteForceStart = std::chrono::high_resolution_clock::now();
+	for(auto& ray : rays)
+	{
+		float nearestT = FLT_MAX;
+		for(int j = 0; j < points.size(); j += 3)
+		{
+			RaycastHit hitInfo;
+			if(Collisions::TestRayTriangle(ray, points[j], points[j + 1], points[j + 2], hitInfo) && hitInfo.t < nearestT)
+			{
+				nearestT = hitInfo.t;
+			}
+		}
+		if(nearestT < FLT_MAX) { ++bruteForceHitCount; }
+	}
+	auto bruteForceEnd = std::chrono::high_resolution_clock::now();
+
+	// Brute force again, but testing triangles in batches.
+	TriangleBatch batch;
+	for(int j = 0; j < points.size(); j += 3)
+	{
+		batch.Add(points[j], points[j + 1], points[j + 2]);
+	}
+	int batchHitCount = 0;
+	auto batchStart = std::chrono::high_resolution_clock::now();
+	for(auto& ray : rays)
+	{
+		RaycastHit hitInfo;
+		if(Collisions::TestRayTriangles(ray, batch, hitInfo) >= 0) { ++batchHitCount; }
+	}
+	auto batchEnd = std::chrono::high_resolution_clock::now();
+	REQUIRE(batchHitCount == bruteForceHitCount);
+
+	int bvhHitCount = 0;
+	auto bvhStart = std::chrono::high_resolution_clock::now();
+	for(auto& ray : rays)
+	{
+		TriangleBVH::Hit hit;
+		if(bvh.RaycastNearest(ray, hit)) { ++bvhHitCount; }
+	}
+	auto bvhEnd = std::chrono::high_resolution_clock::now();
+	REQUIRE(bvhHitCount == bruteForceHitCount);
+
+	typedef std::chrono::duration<double, std::micro> Microseconds;
+	std::cout << "BVH benchmark (" << bvh.GetTriangleCount() << " triangles, " << rays.size() << " rays)" << std::endl;
+	std::cout << "  Build: " << Microseconds(buildEnd - buildStart).count() << "us" << std::endl;
+	std::cout << "  Brute force: " << Microseconds(bruteForceEnd - bruteForceStart).count() << "us" << std::endl;
+	std::cout << "  Brute force (batched): " << Microseconds(batchEnd - batchStart).count() << "us" << std::endl;
+	std::cout << "  BVH: " << Microseconds(bvhEnd - bvhStart).count() << "us" << std::endl;
+}
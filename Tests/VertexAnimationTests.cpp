@@ -0,0 +1,233 @@
+//
+// VertexAnimationTests.cpp
+//
+// Clark Kromenaker
+//
+// Tests for VertexAnimation class.
+//
+#include "catch.hh"
+#include "VertexAnimation.h"
+
+#include <cstring>
+#include <vector>
+
+namespace
+{
+	void Add(std::vector<char>& data, const void* bytes, int count)
+	{
+		data.insert(data.end(), static_cast<const char*>(bytes), static_cast<const char*>(bytes) + count);
+	}
+
+	template<typename T> void Add(std::vector<char>& data, T value)
+	{
+		Add(data, &value, sizeof(T));
+	}
+
+	// Positions of every vertex in a keyframe of the test animation.
+	Vector3 GetTestPosition(int frame, int vertex)
+	{
+		return Vector3(vertex + frame * 10.0f, vertex * 2.0f - frame, frame * 0.5f);
+	}
+
+	// Builds an ACT file with one mesh and one submesh of "vertexCount" vertices.
+	// Vertex poses are stored on frames 0 and 2 (frame 1 has no data). Transform poses are stored on frames 0 and 2 too.
+	std::vector<char> BuildTestAnimation(int vertexCount)
+	{
+		const int kFrameCount = 3;
+		std::vector<char> data;
+		Add(data, "HTCA", 4);
+		Add<unsigned int>(data, 0);				// Version
+		Add<unsigned int>(data, kFrameCount);
+		Add<unsigned int>(data, 1);				// Mesh count
+		Add<unsigned int>(data, 0);				// Contents size
+		char modelName[32] = "TEST.MOD";
+		Add(data, modelName, 32);
+
+		// Frame offsets are filled in as each frame is written.
+		size_t offsetsStart = data.size();
+		for(int i = 0; i < kFrameCount; ++i)
+		{
+			Add<unsigned int>(data, 0);
+		}
+
+		for(int frame = 0; frame < kFrameCount; ++frame)
+		{
+			unsigned int offset = static_cast<unsigned int>(data.size());
+			memcpy(&data[offsetsStart + frame * 4], &offset, 4);
+
+			Add<unsigned short>(data, 0);		// Mesh index
+			if(frame == 1)
+			{
+				Add<unsigned int>(data, 0);		// No data for this mesh on this frame
+				continue;
+			}
+
+			unsigned int vertexBlockSize = 4 + vertexCount * 12;
+			unsigned int transformBlockSize = 48;
+			Add<unsigned int>(data, (1 + 4 + vertexBlockSize) + (1 + 4 + transformBlockSize));
+
+			// Uncompressed vertex data - positions are in x/z/y order.
+			Add<unsigned char>(data, 0);
+			Add<unsigned int>(data, vertexBlockSize);
+			Add<unsigned short>(data, 0);		// Submesh index
+			Add<unsigned short>(data, static_cast<unsigned short>(vertexCount));
+			for(int vertex = 0; vertex < vertexCount; ++vertex)
+			{
+				Vector3 position = GetTestPosition(frame, vertex);
+				Add(data, position.x);
+				Add(data, position.z);
+				Add(data, position.y);
+			}
+
+			// Transform data - identity basis (i/k/j), then position.
+			Add<unsigned char>(data, 2);
+			Add<unsigned int>(data, transformBlockSize);
+			float basis[9] = { 1.0f, 0.0f, 0.0f, 0.0f, 0.0f, 1.0f, 0.0f, 1.0f, 0.0f };
+			Add(data, basis, sizeof(basis));
+			Add(data, frame * 4.0f);
+			Add(data, 0.0f);
+			Add(data, 0.0f);
+		}
+		return data;
+	}
+}
+
+TEST_CASE("Vertex animation samples poses into a buffer")
+{
+	// Odd vertex count, so some floats aren't a multiple of 4.
+	const int kVertexCount = 5;
+	std::vector<char> data = BuildTestAnimation(kVertexCount);
+	VertexAnimation animation("TEST.ACT", data.data(), static_cast<int>(data.size()));
+	REQUIRE(animation.GetFrameCount() == 3);
+	REQUIRE(animation.GetModelName() == "TEST.MOD");
+
+	// At 10 FPS, 0.1 seconds is frame 1, which is halfway between the poses on frames 0 and 2.
+	std::vector<float> positions(kVertexCount * 3);
+	REQUIRE(animation.SampleVertexPose(0.1f, 10, 0, 0, positions.data(), kVertexCount));
+	for(int i = 0; i < kVertexCount; ++i)
+	{
+		Vector3 expected = Vector3::Lerp(GetTestPosition(0, i), GetTestPosition(2, i), 0.5f);
+		REQUIRE(positions[i * 3] == Approx(expected.x));
+		REQUIRE(positions[i * 3 + 1] == Approx(expected.y));
+		REQUIRE(positions[i * 3 + 2] == Approx(expected.z));
+
+		// Single vertex sampling gives the same result.
+		Vector3 vertex = animation.SampleVertexPosition(0.1f, 10, 0, 0, i);
+		REQUIRE(vertex.x == Approx(expected.x));
+		REQUIRE(vertex.y == Approx(expected.y));
+		REQUIRE(vertex.z == Approx(expected.z));
+	}
+
+	// Past the last pose, the last pose is used.
+	REQUIRE(animation.SampleVertexPose(0.25f, 10, 0, 0, positions.data(), kVertexCount));
+	for(int i = 0; i < kVertexCount; ++i)
+	{
+		Vector3 expected = GetTestPosition(2, i);
+		REQUIRE(positions[i * 3] == Approx(expected.x));
+		REQUIRE(positions[i * 3 + 1] == Approx(expected.y));
+		REQUIRE(positions[i * 3 + 2] == Approx(expected.z));
+	}
+
+	// Transform poses are interpolated the same way.
+	VertexAnimationTransformPose transformPose = animation.SampleTransformPose(0.1f, 10, 0);
+	REQUIRE(transformPose.mFrameNumber == 0);
+	REQUIRE(transformPose.mLocalPosition.x == Approx(4.0f));
+}
+
+TEST_CASE("Vertex animation only writes requested vertices")
+{
+	const int kVertexCount = 6;
+	std::vector<char> data = BuildTestAnimation(kVertexCount);
+	VertexAnimation animation("TEST.ACT", data.data(), static_cast<int>(data.size()));
+
+	// Buffer is only filled up to the requested count.
+	std::vector<float> positions(kVertexCount * 3, -1.0f);
+	REQUIRE(animation.SampleVertexPose(0.0f, 10, 0, 0, positions.data(), 2));
+	REQUIRE(positions[3] == Approx(GetTestPosition(0, 1).x));
+	REQUIRE(positions[6] == -1.0f);
+
+	// No poses for this submesh or mesh, so nothing is written.
+	REQUIRE_FALSE(animation.SampleVertexPose(0.0f, 10, 0, 1, positions.data(), kVertexCount));
+	REQUIRE_FALSE(animation.SampleVertexPose(0.0f, 10, 1, 0, positions.data(), kVertexCount));
+	REQUIRE(positions[6] == -1.0f);
+	REQUIRE(animation.SampleTransformPose(0.0f, 10, 1).mFrameNumber == -1);
+}
+
+TEST_CASE("Vertex animation applies compressed keyframes to previous keyframe")
+{
+	// Two frames, one submesh with two vertices. Frame 0 is uncompressed, frame 1 is compressed.
+	std::vector<char> data;
+	Add(data, "HTCA", 4);
+	Add<unsigned int>(data, 0);				// Version
+	Add<unsigned int>(data, 2);				// Frame count
+	Add<unsigned int>(data, 1);				// Mesh count
+	Add<unsigned int>(data, 0);				// Contents size
+	char modelName[32] = "TEST.MOD";
+	Add(data, modelName, 32);
+	size_t offsetsStart = data.size();
+	Add<unsigned int>(data, 0);
+	Add<unsigned int>(data, 0);
+	
+	unsigned int offset = static_cast<unsigned int>(data.size());
+	memcpy(&data[offsetsStart], &offset, 4);
+	Add<unsigned short>(data, 0);			// Mesh index
+	Add<unsigned int>(data, 1 + 4 + 4 + 24);
+	Add<unsigned char>(data, 0);
+	Add<unsigned int>(data, 4 + 24);
+	Add<unsigned short>(data, 0);			// Submesh index
+	Add<unsigned short>(data, 2);			// Vertex count
+	float positions0[6] = { 1.0f, 3.0f, 2.0f, 4.0f, 6.0f, 5.0f };
+	Add(data, positions0, sizeof(positions0));
+	
+	offset = static_cast<unsigned int>(data.size());
+	memcpy(&data[offsetsStart + 4], &offset, 4);
+	Add<unsigned short>(data, 0);			// Mesh index
+	Add<unsigned int>(data, 1 + 4 + 4 + 1 + 12);
+	Add<unsigned char>(data, 1);
+	Add<unsigned int>(data, 4 + 1 + 12);
+	Add<unsigned short>(data, 0);			// Submesh index
+	Add<unsigned short>(data, 2);			// Vertex count
+	Add<unsigned char>(data, 0x3);			// Vertex 0 is a float delta, vertex 1 is unchanged
+	float delta[3] = { 10.0f, 30.0f, 20.0f };
+	Add(data, delta, sizeof(delta));
+	
+	VertexAnimation animation("TEST.ACT", data.data(), static_cast<int>(data.size()));
+	float pose[6] = { 0.0f };
+	REQUIRE(animation.SampleVertexPose(0.1f, 10, 0, 0, pose, 2));
+	REQUIRE(pose[0] == Approx(11.0f));
+	REQUIRE(pose[1] == Approx(22.0f));
+	REQUIRE(pose[2] == Approx(33.0f));
+	REQUIRE(pose[3] == Approx(4.0f));
+	REQUIRE(pose[4] == Approx(5.0f));
+	REQUIRE(pose[5] == Approx(6.0f));
+}
+
+TEST_CASE("Vertex animation keyframes match sampled poses")
+{
+	const int kVertexCount = 5;
+	std::vector<char> data = BuildTestAnimation(kVertexCount);
+	VertexAnimation animation("TEST.ACT", data.data(), static_cast<int>(data.size()));
+	const std::vector<float>& packedPositions = animation.GetPackedVertexPositions();
+	
+	// Blends keyframes the same way the vertex animation shader does, which should give the same pose as the CPU.
+	float times[] = { 0.0f, 0.05f, 0.1f, 0.18f, 0.3f };
+	for(float time : times)
+	{
+		VertexAnimationKeyframes keyframes;
+		REQUIRE(animation.SampleVertexKeyframes(time, 10, 0, 0, keyframes));
+		REQUIRE(keyframes.vertexCount == kVertexCount);
+		
+		std::vector<float> positions(kVertexCount * 3);
+		REQUIRE(animation.SampleVertexPose(time, 10, 0, 0, positions.data(), kVertexCount));
+		for(int i = 0; i < kVertexCount * 3; ++i)
+		{
+			float from = packedPositions[keyframes.fromOffset + i];
+			float to = packedPositions[keyframes.toOffset + i];
+			REQUIRE(positions[i] == Approx(from * (1.0f - keyframes.t) + to * keyframes.t));
+		}
+	}
+	
+	// No keyframes for this submesh.
+	VertexAnimationKeyframes keyframes;
+	REQUIRE_FALSE(animation.SampleVertexKeyframes(0.0f, 10, 0, 1, keyframes));
+}
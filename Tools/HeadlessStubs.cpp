@@ -0,0 +1,73 @@
+//
+// HeadlessStubs.cpp
+//
+// Clark Kromenaker
+//
+// Stand-ins for engine code that the sheep, barn, report, and actor code refers to,
+// but that headless builds (SheepRunner and GEngine-Tests) never call.
+//
+// Linking the real versions would bring in the renderer, audio, and the rest of the game.
+// Don't add this file to a target that also builds the engine!
+//
+#include "AssetManager.h"
+#include "Camera.h"
+#include "Debug.h"
+#include "GameProgress.h"
+#include "GEngine.h"
+#include "LocationManager.h"
+#include "Texture.h"
+
+// ReportStream only looks these services up by type, and they're never registered in headless builds.
+TYPE_DEF_BASE(GameProgress);
+TYPE_DEF_BASE(LocationManager);
+
+// SheepManager loads sheep by name through AssetManager, which headless builds don't create.
+// Headless builds only execute scripts they've loaded or compiled themselves.
+SheepScript* AssetManager::LoadSheep(const std::string& /*name*/)
+{
+	return nullptr;
+}
+
+// BarnFile converts textures to bitmaps when writing assets to file, which needs OpenGL.
+Texture::Texture(std::string name, char* /*data*/, int /*dataLength*/) : Asset(name)
+{
+
+}
+
+Texture::~Texture()
+{
+
+}
+
+void Texture::WriteToFile(std::string /*filePath*/)
+{
+
+}
+
+// Tests create actors without an engine, so actors aren't registered anywhere.
+GEngine* GEngine::sInstance = nullptr;
+
+void GEngine::AddActor(Actor* /*actor*/)
+{
+	
+}
+
+// Debug drawing is always off, since there's no renderer.
+bool Debug::sRenderActorTransformAxes = false;
+bool Debug::sRenderRectTransformRects = false;
+
+void Debug::DrawLine(const Vector3& /*from*/, const Vector3& /*to*/, const Color32& /*color*/, float /*duration*/)
+{
+	
+}
+
+void Debug::DrawAxes(const Matrix4& /*worldTransform*/, float /*duration*/)
+{
+	
+}
+
+// RectTransform uses the camera for world space rects, which is only needed for debug drawing.
+Vector3 Camera::ScreenToWorldPoint(const Vector2& /*screenPoint*/, float /*distance*/)
+{
+	return Vector3::Zero;
+}
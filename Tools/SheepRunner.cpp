@@ -0,0 +1,373 @@
+//
+// SheepRunner.cpp
+//
+// Clark Kromenaker
+//
+// A command-line tool that runs sheep scripts without the rest of the engine - no window, renderer, or audio.
+// Used to measure sheep compiler and VM performance.
+//
+// Only the sheep, barn, and report code is built in, so this runs anywhere with a C++ compiler and zlib (e.g. a headless Linux box).
+// Build it with the SheepRunner target in the Xcode project, or with CMakeLists.txt in the repo root on any platform.
+// The Visual Studio project doesn't include it - use CMake on Windows.
+//
+// Usage: SheepRunner [options] [script] [function...]
+//  -path <dir>         Adds a barn search path (defaults to "Assets/" and "Assets/GK3/").
+//  -barn <name>        Loads a barn, so scripts can be loaded from it.
+//  -eval <expression>  Evaluates a sheep expression, e.g. -eval "{ IsCurrentEgo(\"GABRIEL\") }".
+//  -iterations <n>     Number of times to run each function and expression (default 1000).
+//
+// The script is either a path to a sheep file (compiled or text) or the name of a sheep in a loaded barn.
+// If no functions are given, the script's first function is run.
+//
+// All system functions are replaced with stubs that do nothing and return zero (or an empty string),
+// so the results only measure the VM itself. Their declarations (used to compile sheep text) are generated
+// from the RegFuncX lines in SheepAPI.cpp when building.
+//
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <new>
+#include <string>
+#include <vector>
+
+#include "BarnFile.h"
+#include "Console.h"
+#include "FileSystem.h"
+#include "ReportManager.h"
+#include "Services.h"
+#include "SheepAPI.h"
+#include "SheepManager.h"
+#include "SheepScript.h"
+#include "StringUtil.h"
+#include "ThreadPool.h"
+
+// Every allocation in the program goes through here, so we can report allocations per run.
+// All forms are replaced, so nothing allocated here is freed by (or counted in) a library's own version.
+static std::atomic<int64_t> sAllocationCount(0);
+
+void* operator new(std::size_t size)
+{
+	++sAllocationCount;
+	void* ptr = std::malloc(size > 0 ? size : 1);
+	if(ptr == nullptr) { throw std::bad_alloc(); }
+	return ptr;
+}
+
+void* operator new[](std::size_t size)
+{
+	return operator new(size);
+}
+
+void operator delete(void* ptr) noexcept
+{
+	std::free(ptr);
+}
+
+void operator delete[](void* ptr) noexcept
+{
+	std::free(ptr);
+}
+
+void operator delete(void* ptr, std::size_t /*size*/) noexcept
+{
+	std::free(ptr);
+}
+
+void operator delete[](void* ptr, std::size_t /*size*/) noexcept
+{
+	std::free(ptr);
+}
+
+static void DeclareSysFuncs()
+{
+	// Declarations only - the implementations in SheepAPI.cpp need the whole engine.
+	#define WAITABLE true
+	#define IMMEDIATE false
+	#define DEV_FUNC true
+	#define REL_FUNC false
+	#undef RegFunc0
+	#undef RegFunc1
+	#undef RegFunc2
+	#undef RegFunc3
+	#undef RegFunc4
+	#undef RegFunc5
+	#define RegFunc0(name, ret, waitable, dev) AddSysFuncDecl(#name, ret##_TYPE, { }, waitable, dev, nullptr)
+	#define RegFunc1(name, ret, t1, waitable, dev) AddSysFuncDecl(#name, ret##_TYPE, { t1##_TYPE }, waitable, dev, nullptr)
+	#define RegFunc2(name, ret, t1, t2, waitable, dev) AddSysFuncDecl(#name, ret##_TYPE, { t1##_TYPE, t2##_TYPE }, waitable, dev, nullptr)
+	#define RegFunc3(name, ret, t1, t2, t3, waitable, dev) AddSysFuncDecl(#name, ret##_TYPE, { t1##_TYPE, t2##_TYPE, t3##_TYPE }, waitable, dev, nullptr)
+	#define RegFunc4(name, ret, t1, t2, t3, t4, waitable, dev) AddSysFuncDecl(#name, ret##_TYPE, { t1##_TYPE, t2##_TYPE, t3##_TYPE, t4##_TYPE }, waitable, dev, nullptr)
+	#define RegFunc5(name, ret, t1, t2, t3, t4, t5, waitable, dev) AddSysFuncDecl(#name, ret##_TYPE, { t1##_TYPE, t2##_TYPE, t3##_TYPE, t4##_TYPE, t5##_TYPE }, waitable, dev, nullptr)
+	#include "SheepSysFuncDecls.inc"
+}
+
+static void StubSysFunc(SheepValue* /*args*/, SysFuncResult& /*result*/)
+{
+	// The VM resets the result before every call, so leaving it alone returns zero (or an empty string).
+}
+
+static void StubSysFuncs(SheepScript* script)
+{
+	for(int i = 0; i < script->GetSysImportCount(); ++i)
+	{
+		script->GetSysImport(i)->call = &StubSysFunc;
+	}
+}
+
+static SheepScript* LoadScriptFromBarns(const std::vector<BarnFile*>& barns, const std::string& name)
+{
+	// Barn asset names are uppercase, and sheep may be referred to without an extension.
+	std::string assetName = StringUtil::ToUpperCopy(name);
+	if(assetName.find('.') == std::string::npos)
+	{
+		assetName += ".SHP";
+	}
+	for(auto& barn : barns)
+	{
+		BarnAsset* asset = barn->GetAsset(assetName);
+		if(asset == nullptr || asset->IsPointer()) { continue; }
+
+		std::vector<char> data(asset->uncompressedSize);
+		if(barn->Extract(assetName, data.data(), static_cast<int>(data.size())))
+		{
+			return new SheepScript(assetName, data.data(), static_cast<int>(data.size()));
+		}
+	}
+	return nullptr;
+}
+
+static SheepScript* LoadScript(SheepManager& sheepManager, const std::vector<BarnFile*>& barns, const std::string& nameOrPath)
+{
+	// Not a file? Try loading it from the loaded barns instead.
+	std::ifstream file(nameOrPath, std::ios::in | std::ios::binary);
+	if(!file.good())
+	{
+		return LoadScriptFromBarns(barns, nameOrPath);
+	}
+
+	std::vector<char> data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+	// Compiled sheep files start with an identifier. Anything else is assumed to be sheep text.
+	const char* kIdentifier = "GK3Sheep";
+	if(data.size() >= 8 && memcmp(data.data(), kIdentifier, 8) == 0)
+	{
+		return new SheepScript(nameOrPath, data.data(), static_cast<int>(data.size()));
+	}
+	return sheepManager.Compile(nameOrPath, std::string(data.begin(), data.end()));
+}
+
+static int64_t CountInstructions(SheepManager& sheepManager, const std::function<void()>& run)
+{
+	// Run once with the profiler on, which counts instructions executed.
+	SheepProfiler& profiler = sheepManager.GetProfiler();
+	profiler.SetEnabled(true);
+	run();
+
+	int64_t instructionCount = 0;
+	for(auto& entry : profiler.GetFunctionRecords())
+	{
+		instructionCount += entry.second.instructionCount;
+	}
+	profiler.SetEnabled(false);
+	return instructionCount;
+}
+
+static void Benchmark(SheepManager& sheepManager, const std::string& label, const char* unit, int iterations, const std::function<void()>& run)
+{
+	// Doubles as a warm up run, so first-run allocations (e.g. creating the instance) aren't counted.
+	int64_t instructionCount = CountInstructions(sheepManager, run);
+
+	int64_t startAllocationCount = sAllocationCount;
+	std::chrono::steady_clock::time_point startTime = std::chrono::steady_clock::now();
+	for(int i = 0; i < iterations; ++i)
+	{
+		run();
+	}
+	std::chrono::steady_clock::time_point endTime = std::chrono::steady_clock::now();
+	int64_t allocationCount = sAllocationCount - startAllocationCount;
+
+	double seconds = std::chrono::duration<double>(endTime - startTime).count();
+	double runsPerSecond = seconds > 0.0 ? iterations / seconds : 0.0;
+	std::cout << label << ": " << iterations << " " << unit << "s in " << std::fixed << std::setprecision(3) << seconds * 1000.0 << " ms" << std::endl;
+	std::cout << "  " << std::setprecision(0) << runsPerSecond << " " << unit << "s/sec" << std::endl;
+	std::cout << "  " << instructionCount << " instructions per " << unit << ", " << runsPerSecond * instructionCount << " instructions/sec" << std::endl;
+	std::cout << "  " << std::setprecision(2) << static_cast<double>(allocationCount) / iterations << " allocations per " << unit << std::endl;
+	std::cout.unsetf(std::ios::fixed);
+}
+
+static void PrintUsage()
+{
+	std::cout << "Usage: SheepRunner [-path <dir>] [-barn <name>] [-eval <expression>] [-iterations <n>] [script] [function...]" << std::endl;
+}
+
+int main(int argc, const char* argv[])
+{
+	std::vector<std::string> searchPaths;
+	std::vector<std::string> barnNames;
+	std::vector<std::string> expressions;
+	std::string scriptName;
+	std::vector<std::string> functionNames;
+	int iterations = 1000;
+	for(int i = 1; i < argc; ++i)
+	{
+		std::string arg = argv[i];
+		bool hasValue = i + 1 < argc;
+		if(arg == "-path" && hasValue)
+		{
+			searchPaths.push_back(argv[++i]);
+		}
+		else if(arg == "-barn" && hasValue)
+		{
+			barnNames.push_back(argv[++i]);
+		}
+		else if(arg == "-eval" && hasValue)
+		{
+			expressions.push_back(argv[++i]);
+		}
+		else if(arg == "-iterations" && hasValue)
+		{
+			iterations = std::atoi(argv[++i]);
+		}
+		else if(arg[0] == '-')
+		{
+			PrintUsage();
+			return 1;
+		}
+		else if(scriptName.empty())
+		{
+			scriptName = arg;
+		}
+		else
+		{
+			functionNames.push_back(arg);
+		}
+	}
+	if((scriptName.empty() && expressions.empty()) || iterations <= 0)
+	{
+		PrintUsage();
+		return 1;
+	}
+
+	// Only the services that sheep compilation and execution need.
+	ReportManager reportManager;
+	Services::SetReports(&reportManager);
+
+	// Logs each time a sheep thread starts, which would measure string formatting more than the VM.
+	reportManager.DisableStream("SheepMachine");
+
+	Console console;
+	Services::SetConsole(&console);
+	console.SetReportStream(&reportManager.GetReportStream("Console"));
+
+	// SheepManager compiles batches on the shared worker threads.
+	ThreadPool jobs;
+	Services::SetJobs(&jobs);
+
+	// Barns are read directly, rather than through AssetManager, which would bring in every asset type.
+	if(searchPaths.empty())
+	{
+		searchPaths.push_back("Assets/");
+		searchPaths.push_back("Assets/GK3/");
+	}
+	std::vector<BarnFile*> barns;
+	for(auto& barnName : barnNames)
+	{
+		std::string barnPath;
+		for(auto& searchPath : searchPaths)
+		{
+			if(Path::FindFullPath(barnName, searchPath, barnPath)) { break; }
+			barnPath.clear();
+		}
+		BarnFile* barn = barnPath.empty() ? nullptr : new BarnFile(barnPath);
+		if(barn == nullptr || !barn->CanRead())
+		{
+			std::cout << "Couldn't load barn " << barnName << std::endl;
+			return 1;
+		}
+		barns.push_back(barn);
+	}
+
+	DeclareSysFuncs();
+	SheepManager sheepManager;
+	Services::SetSheep(&sheepManager);
+
+	// Always compile fresh, so timings and reported warnings reflect the sheep as it is now.
+	sheepManager.SetCacheDirectory("");
+
+	int result = 0;
+	if(!scriptName.empty())
+	{
+		std::chrono::steady_clock::time_point loadStartTime = std::chrono::steady_clock::now();
+		SheepScript* script = LoadScript(sheepManager, barns, scriptName);
+		std::chrono::steady_clock::time_point loadEndTime = std::chrono::steady_clock::now();
+		if(script == nullptr)
+		{
+			std::cout << "Couldn't load sheep " << scriptName << std::endl;
+			return 1;
+		}
+		double loadMilliseconds = std::chrono::duration<double, std::milli>(loadEndTime - loadStartTime).count();
+		std::cout << "Loaded " << scriptName << " in " << std::fixed << std::setprecision(3) << loadMilliseconds << " ms" << std::endl;
+		std::cout.unsetf(std::ios::fixed);
+		StubSysFuncs(script);
+
+		// With stubbed system functions, nothing ever waits, so each run finishes before Execute returns.
+		int finishCount = 0;
+		int expectedFinishCount = 0;
+		std::function<void()> finishCallback = [&finishCount]() { ++finishCount; };
+		if(functionNames.empty())
+		{
+			Benchmark(sheepManager, script->GetName(), "run", iterations, [&]() {
+				sheepManager.Execute(script, finishCallback);
+			});
+			expectedFinishCount += iterations + 1;
+		}
+		for(auto& functionName : functionNames)
+		{
+			if(script->GetFunctionOffset(functionName) < 0)
+			{
+				std::cout << "Couldn't find function " << functionName << std::endl;
+				result = 1;
+				continue;
+			}
+			Benchmark(sheepManager, functionName, "run", iterations, [&]() {
+				sheepManager.Execute(script, functionName, finishCallback);
+			});
+			expectedFinishCount += iterations + 1;
+		}
+		if(finishCount != expectedFinishCount)
+		{
+			std::cout << "Some runs didn't finish" << std::endl;
+			result = 1;
+		}
+		delete script;
+	}
+
+	for(auto& expression : expressions)
+	{
+		SheepScript* script = sheepManager.CompileEval(expression);
+		if(script == nullptr)
+		{
+			std::cout << "Couldn't compile expression " << expression << std::endl;
+			result = 1;
+			continue;
+		}
+		StubSysFuncs(script);
+
+		bool value = false;
+		Benchmark(sheepManager, expression, "evaluation", iterations, [&]() {
+			value = sheepManager.Evaluate(script);
+		});
+		std::cout << "  Evaluates to " << (value ? "true" : "false") << std::endl;
+		delete script;
+	}
+
+	for(auto& barn : barns)
+	{
+		delete barn;
+	}
+	return result;
+}
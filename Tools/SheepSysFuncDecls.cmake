@@ -0,0 +1,14 @@
+#
+# SheepSysFuncDecls.cmake
+#
+# Writes every RegFuncX line in SheepAPI.cpp to a file, so tools can declare system functions without the engine.
+# Usage: cmake -DINPUT=<SheepAPI.cpp> -DOUTPUT=<SheepSysFuncDecls.inc> -P SheepSysFuncDecls.cmake
+#
+file(STRINGS "${INPUT}" REG_FUNC_LINES REGEX "^RegFunc[0-9]\\(")
+set(DECLS "// Generated from SheepAPI.cpp by SheepSysFuncDecls.cmake - don't edit!\n")
+foreach(REG_FUNC_LINE IN LISTS REG_FUNC_LINES)
+	# Drop anything after the statement, like comments.
+	string(REGEX REPLACE "\\);.*$" ");" REG_FUNC_LINE "${REG_FUNC_LINE}")
+	string(APPEND DECLS "${REG_FUNC_LINE}\n")
+endforeach()
+file(WRITE "${OUTPUT}" "${DECLS}")